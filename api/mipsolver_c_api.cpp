@@ -2,6 +2,14 @@
 #include "../src/core.h"
 #include "../src/solution.h"
 #include "../src/branch_bound_solver.h"
+#include "../src/batch_solver.h"
+#include "../src/problem_snapshot.h"
+#include <vector>
+#include <string>
+#include <limits>
+#include <cmath>
+#include <atomic>
+#include <algorithm>
 
 /*
  * MIPSolver C API 实现
@@ -33,6 +41,134 @@
 // 这些宏提供类型安全的转换，避免直接的强制类型转换
 #define GET_PROBLEM(handle) static_cast<MIPSolver::Problem*>(handle)
 #define GET_SOLUTION(handle) static_cast<MIPSolver::Solution*>(handle)
+#define GET_PARAMS(handle) static_cast<SolverParams*>(handle)
+#define GET_SOLVER(handle) static_cast<MIPSolver::BranchBoundSolver*>(handle)
+
+namespace {
+    /*
+     * 求解参数集（MIPSolver_ParamsHandle指向的对象）
+     *
+     * 只保存设置值，每次求解时应用到新建的BranchBoundSolver上，
+     * 因此同一个参数集可以同时用于多个线程上的求解
+     */
+    struct SolverParams {
+        double time_limit = 3600.0;
+        double work_limit = 0.0;
+        int node_limit = 100000;
+        int num_threads = 1;
+        bool deterministic = false;
+        double relative_gap = 0.0;
+        double absolute_gap = 0.0;
+        bool verbose = false;
+        bool presolve = true;
+        bool cutting_planes = true;
+        MIPSolver_ProgressCallback progress_callback = nullptr;
+        double progress_interval = 1.0;
+        void* progress_user_data = nullptr;
+        std::vector<MIPSolver::SolverInterface::MIPStart> mip_starts;
+        int solution_pool_size = 10;
+
+        /*
+         * @param stop: 本次求解的停止标志；进度回调返回非零时置位
+         */
+        void applyTo(MIPSolver::BranchBoundSolver& solver, std::atomic<bool>& stop) const {
+            solver.setTimeLimit(time_limit);
+            solver.setWorkLimit(work_limit);
+            solver.setIterationLimit(node_limit);
+            solver.setNumThreads(num_threads);
+            solver.setDeterministic(deterministic);
+            solver.setRelativeGap(relative_gap);
+            solver.setAbsoluteGap(absolute_gap);
+            solver.setVerbose(verbose);
+            solver.setPresolve(presolve);
+            solver.setCuttingPlanes(cutting_planes);
+            solver.setStopFlag(&stop);
+            solver.clearMIPStarts();
+            for (const auto& start : mip_starts) {
+                solver.addMIPStart(start.indices, start.values);
+            }
+            solver.setSolutionPoolSize(solution_pool_size);
+            if (!progress_callback) return;
+
+            MIPSolver_ProgressCallback callback = progress_callback;
+            void* user_data = progress_user_data;
+            solver.setProgressCallback([callback, user_data, &stop](const MIPSolver::SolveProgress& progress) {
+                MIPSolver_Progress report;
+                report.event = progress.event == MIPSolver::SolveProgress::Event::INCUMBENT
+                    ? MIPSOLVER_EVENT_INCUMBENT : MIPSOLVER_EVENT_PROGRESS;
+                report.time = progress.time;
+                report.nodes = progress.nodes;
+                report.open_nodes = progress.open_nodes;
+                report.objective = progress.objective;
+                report.dual_bound = progress.dual_bound;
+                report.gap = progress.gap;
+                if (callback(&report, user_data) != 0) {
+                    stop.store(true);
+                }
+            }, progress_interval);
+        }
+    };
+
+    // 批量接口的名字数组（可为NULL）转换为std::string
+    std::vector<std::string> copyNames(const char* const* names, int count) {
+        std::vector<std::string> result;
+        if (names) {
+            result.reserve(count);
+            for (int i = 0; i < count; ++i) {
+                result.emplace_back(names[i] ? names[i] : "");
+            }
+        }
+        return result;
+    }
+
+    /*
+     * 批量添加变量时的列数据
+     *
+     * NULL数组按默认值补齐（边界为负无穷到正无穷、目标系数0、连续变量），
+     * 类型值越界时valid为false
+     */
+    struct ColumnData {
+        std::vector<double> lower, upper, objective;
+        std::vector<MIPSolver::VariableType> types;
+        std::vector<std::string> names;
+        bool valid = true;
+
+        ColumnData(int count, const double* lo, const double* up, const double* obj,
+                   const int* var_types, const char* const* var_names)
+            : lower(lo ? std::vector<double>(lo, lo + count)
+                       : std::vector<double>(count, -std::numeric_limits<double>::infinity())),
+              upper(up ? std::vector<double>(up, up + count)
+                       : std::vector<double>(count, std::numeric_limits<double>::infinity())),
+              objective(obj ? std::vector<double>(obj, obj + count) : std::vector<double>(count, 0.0)),
+              types(count, MIPSolver::VariableType::CONTINUOUS),
+              names(copyNames(var_names, count)) {
+            for (int i = 0; var_types && i < count; ++i) {
+                if (var_types[i] < MIPSOLVER_VAR_CONTINUOUS || var_types[i] > MIPSOLVER_VAR_BINARY) {
+                    valid = false;
+                    return;
+                }
+                types[i] = static_cast<MIPSolver::VariableType>(var_types[i]);
+            }
+        }
+
+        const std::string* namesOrNull() const { return names.empty() ? nullptr : names.data(); }
+    };
+
+    MIPSolver_SolutionStatus toCStatus(MIPSolver::Solution::Status status) {
+        switch (status) {
+            case MIPSolver::Solution::Status::FEASIBLE: return MIPSOLVER_STATUS_FEASIBLE;
+            case MIPSolver::Solution::Status::INFEASIBLE: return MIPSOLVER_STATUS_INFEASIBLE;
+            case MIPSolver::Solution::Status::OPTIMAL: return MIPSOLVER_STATUS_OPTIMAL;
+            case MIPSolver::Solution::Status::UNBOUNDED: return MIPSOLVER_STATUS_UNBOUNDED;
+            case MIPSolver::Solution::Status::ITERATION_LIMIT: return MIPSOLVER_STATUS_NODE_LIMIT;
+            case MIPSolver::Solution::Status::TIME_LIMIT: return MIPSOLVER_STATUS_TIME_LIMIT;
+            case MIPSolver::Solution::Status::UNKNOWN: return MIPSOLVER_STATUS_UNKNOWN;
+            case MIPSolver::Solution::Status::INTERRUPTED: return MIPSOLVER_STATUS_INTERRUPTED;
+            case MIPSolver::Solution::Status::WORK_LIMIT: return MIPSOLVER_STATUS_WORK_LIMIT;
+        }
+        return MIPSOLVER_STATUS_UNKNOWN;
+    }
+}
 
 extern "C" {
 
@@ -136,7 +272,11 @@ MIPSOLVER_API void MIPSolver_SetVariableBounds(MIPSolver_ProblemHandle handle, i
      * @param upper: 变量上界
      */
     if (!handle) return;
-    GET_PROBLEM(handle)->getVariable(var_index).setBounds(lower, upper);
+    try {
+        GET_PROBLEM(handle)->setVariableBounds(var_index, lower, upper);
+    } catch (const std::exception&) {
+        // Invalid index: nothing to change
+    }
 }
 
 MIPSOLVER_API void MIPSolver_SetObjectiveCoefficient(MIPSolver_ProblemHandle handle, int var_index, double coeff) {
@@ -176,9 +316,9 @@ MIPSOLVER_API int MIPSolver_AddConstraint(MIPSolver_ProblemHandle handle, const
      * - 返回约束索引，用于后续添加变量系数
      * 
      * 约束类型：
-     * - MIPSOLVER_CONSTRAINT_LESS_EQUAL (1): 小于等于约束 (<=)
-     * - MIPSOLVER_CONSTRAINT_GREATER_EQUAL (2): 大于等于约束 (>=)
-     * - MIPSOLVER_CONSTRAINT_EQUAL (3): 等式约束 (=)
+     * - MIPSOLVER_CONSTRAINT_LESS_EQUAL (0): 小于等于约束 (<=)
+     * - MIPSOLVER_CONSTRAINT_GREATER_EQUAL (1): 大于等于约束 (>=)
+     * - MIPSOLVER_CONSTRAINT_EQUAL (2): 等式约束 (=)
      * 
      * 约束表示：
      * - 形式：a1*x1 + a2*x2 + ... + an*xn ⊲ rhs
@@ -222,7 +362,153 @@ MIPSOLVER_API void MIPSolver_AddConstraintCoefficient(MIPSolver_ProblemHandle ha
      * @param coeff: 变量在约束中的系数
      */
     if (!handle) return;
-    GET_PROBLEM(handle)->getConstraint(constraint_index).addVariable(var_index, coeff);
+    GET_PROBLEM(handle)->addConstraintCoefficient(constraint_index, var_index, coeff);
+}
+
+MIPSOLVER_API int MIPSolver_AddVariables(MIPSolver_ProblemHandle handle, int count, const double* lower, const double* upper,
+                                         const double* objective, const int* types, const char* const* names) {
+    /*
+     * 批量添加变量
+     *
+     * 一次调用添加count个变量，代替逐个调用AddVariable / SetVariableBounds / SetObjectiveCoefficient，
+     * 适合通过FFI调用的前端（每次跨语言调用都有固定开销）
+     *
+     * @param lower/upper/objective: 长度为count的数组，NULL分别表示负无穷、正无穷和0
+     * @param types: MIPSolver_VariableType值的数组，NULL表示全部为连续变量
+     * @param names: 长度为count的名字数组，NULL时自动命名为 x<序号>
+     * @return: 第一个新变量的索引，参数无效时返回-1
+     */
+    if (!handle || count < 0) return -1;
+    try {
+        ColumnData columns(count, lower, upper, objective, types, names);
+        if (!columns.valid) return -1;
+        return GET_PROBLEM(handle)->addVariables(count, columns.lower.data(), columns.upper.data(),
+                                                 columns.objective.data(), columns.types.data(), columns.namesOrNull());
+    } catch (const std::exception&) {
+        return -1;
+    }
+}
+
+MIPSOLVER_API int MIPSolver_AddRowsCSR(MIPSolver_ProblemHandle handle, int num_rows, const int* row_start, const int* col_index,
+                                       const double* values, const int* types, const double* rhs, const char* const* names) {
+    /*
+     * 批量添加约束（CSR格式）
+     *
+     * 系数直接追加到问题的CSR约束矩阵末尾，不经过逐个系数的三元组缓冲区；
+     * 行内的列索引不必有序，同一列重复出现时以最后一次为准
+     *
+     * @param row_start: 长度为num_rows+1，第r行的系数位于 [row_start[r], row_start[r+1])
+     * @param col_index/values: 系数的变量索引（必须是已有变量）和数值
+     * @param types: MIPSolver_ConstraintType值的数组
+     * @param rhs: 右侧常数值
+     * @param names: 长度为num_rows的名字数组，NULL时自动命名为 c<序号>
+     * @return: 第一个新约束的索引；参数无效时返回-1，问题保持不变
+     */
+    if (!handle || num_rows < 0 || !row_start || !types || !rhs) return -1;
+    if (num_rows > 0 && row_start[num_rows] > row_start[0] && (!col_index || !values)) return -1;
+    try {
+        std::vector<MIPSolver::ConstraintType> row_types(num_rows);
+        for (int r = 0; r < num_rows; ++r) {
+            if (types[r] < MIPSOLVER_CONSTRAINT_LESS_EQUAL || types[r] > MIPSOLVER_CONSTRAINT_EQUAL) return -1;
+            row_types[r] = static_cast<MIPSolver::ConstraintType>(types[r]);
+        }
+        std::vector<std::string> row_names = copyNames(names, num_rows);
+        return GET_PROBLEM(handle)->addConstraintsCSR(num_rows, row_types.data(), rhs, row_start, col_index, values,
+                                                      row_names.empty() ? nullptr : row_names.data());
+    } catch (const std::exception&) {
+        return -1;
+    }
+}
+
+MIPSOLVER_API int MIPSolver_AddColsCSC(MIPSolver_ProblemHandle handle, int num_cols, const int* col_start, const int* row_index,
+                                       const double* values, const double* lower, const double* upper, const double* objective,
+                                       const int* types, const char* const* names) {
+    /*
+     * 批量添加变量及其约束系数（CSC格式）
+     *
+     * 用于先建约束、再按列生成变量的模型（例如列生成）：第j个新变量在已有约束中的系数
+     * 位于 [col_start[j], col_start[j+1])，其余参数与MIPSolver_AddVariables相同
+     *
+     * @return: 第一个新变量的索引；参数无效时返回-1，问题保持不变
+     */
+    if (!handle || num_cols < 0 || !col_start) return -1;
+    if (num_cols > 0 && col_start[num_cols] > col_start[0] && (!row_index || !values)) return -1;
+    try {
+        ColumnData columns(num_cols, lower, upper, objective, types, names);
+        if (!columns.valid) return -1;
+        return GET_PROBLEM(handle)->addColumnsCSC(num_cols, col_start, row_index, values, columns.lower.data(),
+                                                  columns.upper.data(), columns.objective.data(), columns.types.data(),
+                                                  columns.namesOrNull());
+    } catch (const std::exception&) {
+        return -1;
+    }
+}
+
+MIPSOLVER_API int MIPSolver_SetConstraintRHS(MIPSolver_ProblemHandle handle, int constraint_index, double rhs) {
+    /*
+     * 修改约束右端项（按种类记录，见Problem::changesSince）
+     *
+     * @return: 成功返回0；句柄或下标无效时返回-1
+     */
+    if (!handle) return -1;
+    try {
+        GET_PROBLEM(handle)->setConstraintRHS(constraint_index, rhs);
+        return 0;
+    } catch (const std::exception&) {
+        return -1;
+    }
+}
+
+MIPSOLVER_API int MIPSolver_RemoveConstraints(MIPSolver_ProblemHandle handle, int count, const int* indices) {
+    /*
+     * 删除若干约束，其余约束按原顺序前移
+     *
+     * @return: 成功返回0；参数无效时返回-1，问题保持不变
+     */
+    if (!handle || count < 0 || (count > 0 && !indices)) return -1;
+    try {
+        GET_PROBLEM(handle)->removeConstraints(std::vector<int>(indices, indices + count));
+        return 0;
+    } catch (const std::exception&) {
+        return -1;
+    }
+}
+
+MIPSOLVER_API int MIPSolver_SaveProblemBinary(MIPSolver_ProblemHandle handle, const char* filename, int include_names) {
+    /*
+     * 保存二进制快照
+     *
+     * 快照包含矩阵、边界、类型、目标系数和可选的名字表，
+     * 之后可以用MIPSolver_LoadProblemBinary直接映射载入，无需重新解析模型文件
+     *
+     * @param handle: 问题实例句柄
+     * @param filename: 输出文件路径
+     * @param include_names: 非零时写入变量名和约束名
+     * @return: 成功返回0，失败（无效参数或写文件失败）返回-1
+     */
+    if (!handle || !filename) return -1;
+    try {
+        MIPSolver::ProblemSnapshot::save(*GET_PROBLEM(handle), filename, include_names != 0);
+    } catch (const std::exception&) {
+        return -1;
+    }
+    return 0;
+}
+
+MIPSOLVER_API MIPSolver_ProblemHandle MIPSolver_LoadProblemBinary(const char* filename) {
+    /*
+     * 载入二进制快照
+     *
+     * @param filename: 由MIPSolver_SaveProblemBinary写出的快照文件
+     * @return: 新的问题实例句柄，调用者必须使用MIPSolver_DestroyProblem释放；
+     *          文件无法读取或格式无效时返回NULL
+     */
+    if (!filename) return nullptr;
+    try {
+        return new MIPSolver::Problem(MIPSolver::ProblemSnapshot::load(filename));
+    } catch (const std::exception&) {
+        return nullptr;
+    }
 }
 
 
@@ -267,6 +553,274 @@ MIPSOLVER_API MIPSolver_SolutionHandle MIPSolver_Solve(MIPSolver_ProblemHandle p
     return solution;
 }
 
+MIPSOLVER_API MIPSolver_SolutionHandle MIPSolver_SolveWithThreads(MIPSolver_ProblemHandle problem_handle, int num_threads, int deterministic) {
+    /*
+     * 多线程求解函数
+     * 
+     * 与MIPSolver_Solve相同，但使用并行分支定界：
+     * - num_threads: 工作线程数，0表示使用全部硬件线程，1等价于MIPSolver_Solve
+     * - deterministic: 非零时使用同步轮次搜索，相同输入下结果可复现
+     * 
+     * 问题对象在求解期间被所有线程只读共享，调用者不得同时修改它
+     * 
+     * @return: 求解结果句柄，失败时返回NULL
+     */
+    if (!problem_handle) return nullptr;
+
+    MIPSolver::BranchBoundSolver solver;
+    solver.setVerbose(false);
+    solver.setNumThreads(num_threads);
+    solver.setDeterministic(deterministic != 0);
+    MIPSolver::Problem* problem = GET_PROBLEM(problem_handle);
+
+    MIPSolver::Solution* solution = new MIPSolver::Solution(solver.solve(*problem));
+    return solution;
+}
+
+MIPSOLVER_API MIPSolver_SolutionHandle MIPSolver_SolveWithParams(MIPSolver_ProblemHandle problem_handle, MIPSolver_ParamsHandle params) {
+    /*
+     * 按参数集求解
+     *
+     * 新建求解器并应用参数集中的全部设置（时间上限、节点上限、线程数、间隙容差等）；
+     * params为NULL时使用默认参数。参数集只被读取，可以同时用于多个求解；
+     * 设置了进度回调时，它在求解线程上被调用，返回非零即中断本次求解
+     *
+     * @return: 求解结果句柄，失败时返回NULL
+     */
+    if (!problem_handle) return nullptr;
+
+    MIPSolver::BranchBoundSolver solver;
+    SolverParams defaults;
+    std::atomic<bool> stop{false};
+    (params ? *GET_PARAMS(params) : defaults).applyTo(solver, stop);
+    try {
+        return new MIPSolver::Solution(solver.solve(*GET_PROBLEM(problem_handle)));
+    } catch (const std::exception&) {
+        return nullptr;
+    }
+}
+
+
+MIPSOLVER_API MIPSolver_SolverHandle MIPSolver_CreateSolver(void) {
+    /*
+     * 创建保持热启动状态的求解器（BranchBoundSolver::setWarmStart）
+     *
+     * 调用者必须使用MIPSolver_DestroySolver释放
+     */
+    auto* solver = new MIPSolver::BranchBoundSolver();
+    solver->setWarmStart(true);
+    return solver;
+}
+
+MIPSOLVER_API void MIPSolver_DestroySolver(MIPSolver_SolverHandle solver) {
+    if (solver) {
+        delete GET_SOLVER(solver);
+    }
+}
+
+MIPSOLVER_API MIPSolver_SolutionHandle MIPSolver_SolveWarm(MIPSolver_SolverHandle solver, MIPSolver_ProblemHandle problem_handle,
+                                                           MIPSolver_ParamsHandle params) {
+    /*
+     * 用求解器句柄求解
+     *
+     * 每次求解前应用参数集；求解器保留上一次求解同一问题的状态（根LP基、伪成本、割、最优解），
+     * 问题只做了小的修改时从这些状态开始。同一个求解器句柄不能同时用于两个求解
+     *
+     * @return: 求解结果句柄，失败时返回NULL
+     */
+    if (!solver || !problem_handle) return nullptr;
+
+    MIPSolver::BranchBoundSolver& warm = *GET_SOLVER(solver);
+    SolverParams defaults;
+    std::atomic<bool> stop{false};
+    (params ? *GET_PARAMS(params) : defaults).applyTo(warm, stop);
+    MIPSolver::Solution* solution = nullptr;
+    try {
+        solution = new MIPSolver::Solution(warm.solve(*GET_PROBLEM(problem_handle)));
+    } catch (const std::exception&) {
+        solution = nullptr;
+    }
+    // Both refer to this call's stack frame
+    warm.setStopFlag(nullptr);
+    warm.setProgressCallback(nullptr);
+    return solution;
+}
+
+MIPSOLVER_API int MIPSolver_SolveBatch(const MIPSolver_ProblemHandle* problems, int count, MIPSolver_ParamsHandle params,
+                                       MIPSolver_SolutionHandle* solutions, MIPSolver_BatchCallback callback, void* user_data) {
+    /*
+     * 批量求解
+     *
+     * 所有调用共用一个进程内的常驻线程池（首次调用时创建，每个硬件线程一个工作线程），
+     * 每个工作线程复用自己的求解器；每个问题都按参数集设置，并有自己的停止标志，
+     * 进度回调返回非零只中断对应的那一个求解
+     *
+     * @param solutions: 可为NULL；非NULL时按输入顺序写入结果句柄，由调用者释放
+     * @param callback: 可为NULL；每个问题结束时在线程池线程上调用。solutions为NULL时结果句柄归回调所有
+     * @return: 失败的求解数（全部成功为0）；参数无效时返回-1
+     */
+    if (!problems || count < 0 || (!solutions && !callback)) return -1;
+    for (int i = 0; i < count; ++i) {
+        if (!problems[i]) return -1;
+    }
+
+    static MIPSolver::BatchSolver pool;
+    SolverParams defaults;
+    const SolverParams& settings = params ? *GET_PARAMS(params) : defaults;
+
+    std::vector<const MIPSolver::Problem*> batch(count);
+    for (int i = 0; i < count; ++i) {
+        batch[i] = GET_PROBLEM(problems[i]);
+    }
+    std::vector<std::unique_ptr<std::atomic<bool>>> stops;
+    for (int i = 0; i < count; ++i) {
+        stops.push_back(std::make_unique<std::atomic<bool>>(false));
+    }
+    std::atomic<int> failures{0};
+
+    try {
+        pool.solve(batch,
+            [&](MIPSolver::BranchBoundSolver& solver, size_t index) {
+                settings.applyTo(solver, *stops[index]);
+            },
+            [&](size_t index, std::unique_ptr<MIPSolver::Solution> solution, std::exception_ptr error) {
+                if (error || !solution) failures.fetch_add(1);
+                MIPSolver_SolutionHandle handle = solution.release();
+                if (solutions) solutions[index] = handle;
+                if (callback) callback(static_cast<int>(index), handle, user_data);
+            });
+    } catch (const std::exception&) {
+        return -1;
+    }
+    return failures.load();
+}
+
+
+// --- Solver Parameters ---
+
+MIPSOLVER_API MIPSolver_ParamsHandle MIPSolver_CreateParams(void) {
+    /*
+     * 创建参数集
+     *
+     * 初始值与BranchBoundSolver的默认设置相同，调用者必须使用MIPSolver_DestroyParams释放
+     */
+    return new SolverParams();
+}
+
+MIPSOLVER_API void MIPSolver_DestroyParams(MIPSolver_ParamsHandle params) {
+    if (params) {
+        delete GET_PARAMS(params);
+    }
+}
+
+MIPSOLVER_API int MIPSolver_SetTimeLimit(MIPSolver_ParamsHandle params, double seconds) {
+    // 0表示不限时
+    if (!params || !(seconds >= 0.0)) return -1;
+    GET_PARAMS(params)->time_limit = seconds;
+    return 0;
+}
+
+MIPSOLVER_API int MIPSolver_SetWorkLimit(MIPSolver_ParamsHandle params, double work_units) {
+    // 0表示不限工作量
+    if (!params || !(work_units >= 0.0)) return -1;
+    GET_PARAMS(params)->work_limit = work_units;
+    return 0;
+}
+
+MIPSOLVER_API int MIPSolver_SetNodeLimit(MIPSolver_ParamsHandle params, int max_nodes) {
+    if (!params || max_nodes < 0) return -1;
+    GET_PARAMS(params)->node_limit = max_nodes;
+    return 0;
+}
+
+MIPSOLVER_API int MIPSolver_SetNumThreads(MIPSolver_ParamsHandle params, int num_threads) {
+    if (!params || num_threads < 0) return -1;
+    GET_PARAMS(params)->num_threads = num_threads;
+    return 0;
+}
+
+MIPSOLVER_API int MIPSolver_SetDeterministic(MIPSolver_ParamsHandle params, int deterministic) {
+    if (!params) return -1;
+    GET_PARAMS(params)->deterministic = deterministic != 0;
+    return 0;
+}
+
+MIPSOLVER_API int MIPSolver_SetRelativeGap(MIPSolver_ParamsHandle params, double gap) {
+    if (!params || !(gap >= 0.0) || !std::isfinite(gap)) return -1;
+    GET_PARAMS(params)->relative_gap = gap;
+    return 0;
+}
+
+MIPSOLVER_API int MIPSolver_SetAbsoluteGap(MIPSolver_ParamsHandle params, double gap) {
+    if (!params || !(gap >= 0.0) || !std::isfinite(gap)) return -1;
+    GET_PARAMS(params)->absolute_gap = gap;
+    return 0;
+}
+
+MIPSOLVER_API int MIPSolver_SetVerbose(MIPSolver_ParamsHandle params, int verbose) {
+    if (!params) return -1;
+    GET_PARAMS(params)->verbose = verbose != 0;
+    return 0;
+}
+
+MIPSOLVER_API int MIPSolver_SetPresolve(MIPSolver_ParamsHandle params, int enable) {
+    if (!params) return -1;
+    GET_PARAMS(params)->presolve = enable != 0;
+    return 0;
+}
+
+MIPSOLVER_API int MIPSolver_SetCuttingPlanes(MIPSolver_ParamsHandle params, int enable) {
+    if (!params) return -1;
+    GET_PARAMS(params)->cutting_planes = enable != 0;
+    return 0;
+}
+
+MIPSOLVER_API int MIPSolver_SetProgressCallback(MIPSolver_ParamsHandle params, MIPSolver_ProgressCallback callback,
+                                                double interval_seconds, void* user_data) {
+    // interval为0时只在找到新最优解时回调
+    if (!params || !(interval_seconds >= 0.0)) return -1;
+    SolverParams* settings = GET_PARAMS(params);
+    settings->progress_callback = callback;
+    settings->progress_interval = interval_seconds;
+    settings->progress_user_data = user_data;
+    return 0;
+}
+
+MIPSOLVER_API int MIPSolver_AddMIPStart(MIPSolver_ParamsHandle params, int count, const int* indices, const double* values) {
+    /*
+     * 添加初始解（SolverInterface::addMIPStart）
+     *
+     * indices非NULL时values[k]是变量indices[k]的取值；indices为NULL时values是前count个变量的取值，
+     * NaN表示不指定。下标只在求解时检查，越界时该次求解失败
+     */
+    if (!params || count < 0 || (count > 0 && !values)) return -1;
+    MIPSolver::SolverInterface::MIPStart start;
+    for (int k = 0; k < count; ++k) {
+        if (indices) {
+            if (indices[k] < 0) return -1;
+            start.indices.push_back(indices[k]);
+            start.values.push_back(values[k]);
+        } else if (!std::isnan(values[k])) {
+            start.indices.push_back(k);
+            start.values.push_back(values[k]);
+        }
+    }
+    GET_PARAMS(params)->mip_starts.push_back(std::move(start));
+    return 0;
+}
+
+MIPSOLVER_API int MIPSolver_ClearMIPStarts(MIPSolver_ParamsHandle params) {
+    if (!params) return -1;
+    GET_PARAMS(params)->mip_starts.clear();
+    return 0;
+}
+
+MIPSOLVER_API int MIPSolver_SetSolutionPoolSize(MIPSolver_ParamsHandle params, int size) {
+    if (!params || size < 0) return -1;
+    GET_PARAMS(params)->solution_pool_size = size;
+    return 0;
+}
+
 
 // --- Solution Management ---
 
@@ -299,13 +853,16 @@ MIPSOLVER_API MIPSolver_SolutionStatus MIPSolver_GetStatus(MIPSolver_SolutionHan
      * - 指示求解过程是否找到最优解
      * - 提供失败原因的详细信息
      * 
-     * 返回值：
-     * - MIPSOLVER_STATUS_OPTIMAL (2): 已找到全局最优解
-     * - MIPSOLVER_STATUS_INFEASIBLE (3): 问题不可行，无解存在
-     * - MIPSOLVER_STATUS_UNBOUNDED (4): 问题无界，目标值可无限优化
+     * 返回值（与Solution::Status一一对应）：
+     * - MIPSOLVER_STATUS_FEASIBLE (0): 找到可行解，但未证明最优
+     * - MIPSOLVER_STATUS_INFEASIBLE (1): 问题不可行，无解存在
+     * - MIPSOLVER_STATUS_OPTIMAL (2): 已找到最优解（在设置的间隙容差内）
+     * - MIPSOLVER_STATUS_UNBOUNDED (3): 问题无界，目标值可无限优化
+     * - MIPSOLVER_STATUS_NODE_LIMIT (4): 达到节点数上限
      * - MIPSOLVER_STATUS_TIME_LIMIT (5): 达到求解时间限制
-     * - MIPSOLVER_STATUS_ITERATION_LIMIT (6): 达到最大迭代次数
-     * - MIPSOLVER_STATUS_UNKNOWN (7): 未知状态或求解失败
+     * - MIPSOLVER_STATUS_UNKNOWN (6): 未知状态或求解失败
+     * - MIPSOLVER_STATUS_INTERRUPTED (7): 求解被外部请求中断
+     * - MIPSOLVER_STATUS_WORK_LIMIT (8): 达到确定性工作量上限
      * 
      * 使用示例：
      * - 检查解的可用性：status == MIPSOLVER_STATUS_OPTIMAL
@@ -316,8 +873,7 @@ MIPSOLVER_API MIPSolver_SolutionStatus MIPSolver_GetStatus(MIPSolver_SolutionHan
      * @return: 求解状态枚举值
      */
     if (!handle) return MIPSOLVER_STATUS_INFEASIBLE;
-    // 注意：需要将C++枚举映射到C API枚举
-    return static_cast<MIPSolver_SolutionStatus>(GET_SOLUTION(handle)->getStatus());
+    return toCStatus(GET_SOLUTION(handle)->getStatus());
 }
 
 MIPSOLVER_API double MIPSolver_GetObjectiveValue(MIPSolver_SolutionHandle handle) {
@@ -346,6 +902,107 @@ MIPSOLVER_API double MIPSolver_GetObjectiveValue(MIPSolver_SolutionHandle handle
     return GET_SOLUTION(handle)->getObjectiveValue();
 }
 
+MIPSOLVER_API double MIPSolver_GetDualBound(MIPSolver_SolutionHandle handle) {
+    /*
+     * 获取对偶界
+     *
+     * 求解过程证明的目标值界（最小化为下界，最大化为上界）；与目标值之差即最终的最优性间隙。
+     * 因时间、节点上限或间隙容差提前结束时，它反映尚未探索的节点
+     *
+     * @return: 对偶界，无效句柄时返回0.0
+     */
+    if (!handle) return 0.0;
+    return GET_SOLUTION(handle)->getDualBound();
+}
+
+MIPSOLVER_API double MIPSolver_GetSolveTime(MIPSolver_SolutionHandle handle) {
+    if (!handle) return 0.0;
+    return GET_SOLUTION(handle)->getSolveTime();
+}
+
+MIPSOLVER_API double MIPSolver_GetWorkUnits(MIPSolver_SolutionHandle handle) {
+    if (!handle) return 0.0;
+    return GET_SOLUTION(handle)->getWorkUnits();
+}
+
+MIPSOLVER_API double MIPSolver_GetGap(MIPSolver_SolutionHandle handle) {
+    if (!handle) return std::numeric_limits<double>::infinity();
+    return GET_SOLUTION(handle)->getGap();
+}
+
+MIPSOLVER_API long long MIPSolver_GetNodeCount(MIPSolver_SolutionHandle handle) {
+    if (!handle) return 0;
+    return GET_SOLUTION(handle)->getNodeCount();
+}
+
+MIPSOLVER_API long long MIPSolver_GetOpenNodeCount(MIPSolver_SolutionHandle handle) {
+    if (!handle) return 0;
+    return GET_SOLUTION(handle)->getOpenNodes();
+}
+
+MIPSOLVER_API int MIPSolver_GetIncumbentHistoryLength(MIPSolver_SolutionHandle handle) {
+    if (!handle) return 0;
+    return static_cast<int>(GET_SOLUTION(handle)->getIncumbentHistory().size());
+}
+
+MIPSOLVER_API void MIPSolver_GetIncumbentHistory(MIPSolver_SolutionHandle handle, double* times, double* objectives) {
+    /*
+     * 复制最优解改进记录（按时间顺序）
+     *
+     * 每条记录是找到该解时距求解开始的秒数和它的目标值（原问题意义下）；
+     * 数组长度由MIPSolver_GetIncumbentHistoryLength给出，任一数组为NULL时跳过该项
+     */
+    if (!handle) return;
+    const auto& history = GET_SOLUTION(handle)->getIncumbentHistory();
+    for (size_t i = 0; i < history.size(); ++i) {
+        if (times) times[i] = history[i].time;
+        if (objectives) objectives[i] = history[i].objective;
+    }
+}
+
+MIPSOLVER_API int MIPSolver_GetPoolSize(MIPSolver_SolutionHandle handle) {
+    if (!handle) return 0;
+    return static_cast<int>(GET_SOLUTION(handle)->getSolutionPool().size());
+}
+
+MIPSOLVER_API double MIPSolver_GetPoolObjective(MIPSolver_SolutionHandle handle, int index) {
+    if (!handle || index < 0 || index >= MIPSolver_GetPoolSize(handle)) return std::numeric_limits<double>::quiet_NaN();
+    return GET_SOLUTION(handle)->getSolutionPool()[index].objective;
+}
+
+MIPSOLVER_API int MIPSolver_GetPoolValues(MIPSolver_SolutionHandle handle, int index, double* values_array) {
+    /*
+     * 复制解池中第index个解（0为最好的解）的变量值
+     *
+     * values_array至少有MIPSolver_GetSolutionNumVars个元素
+     *
+     * @return: 成功返回0，句柄无效或下标越界时返回-1
+     */
+    if (!handle || !values_array || index < 0 || index >= MIPSolver_GetPoolSize(handle)) return -1;
+    const std::vector<double>& values = GET_SOLUTION(handle)->getSolutionPool()[index].values;
+    std::copy(values.begin(), values.end(), values_array);
+    return 0;
+}
+
+MIPSOLVER_API int MIPSolver_WriteTrace(MIPSolver_SolutionHandle handle, const char* filename) {
+    /*
+     * 导出求解轨迹
+     *
+     * 写出Chrome/Perfetto可以打开的JSON轨迹：每个线程上各阶段（预处理、节点、LP、分支……）的时间段，
+     * 以及LP调用、主元、剪枝原因等计数器
+     *
+     * @return: 成功返回0；文件无法写入，或库编译时没有定义MIPSOLVER_ENABLE_INSTRUMENTATION时返回-1
+     */
+    if (!handle || !filename) return -1;
+    const MIPSolver::Instrumentation::Profile& profile = GET_SOLUTION(handle)->getProfile();
+    if (!profile.enabled()) return -1;
+    try {
+        return profile.writeChromeTrace(filename) ? 0 : -1;
+    } catch (const std::exception&) {
+        return -1;
+    }
+}
+
 MIPSOLVER_API int MIPSolver_GetSolutionNumVars(MIPSolver_SolutionHandle handle) {
     /*
      * 获取解向量的变量数量
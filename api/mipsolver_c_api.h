@@ -23,6 +23,8 @@ extern "C" {
 // Opaque pointers to hide C++ implementation details
 typedef void* MIPSolver_ProblemHandle;
 typedef void* MIPSolver_SolutionHandle;
+typedef void* MIPSolver_ParamsHandle;
+typedef void* MIPSolver_SolverHandle;
 
 // C-style enums that mirror the C++ enums
 typedef enum {
@@ -37,11 +39,45 @@ typedef enum {
 } MIPSolver_ObjectiveType;
 
 typedef enum {
-    MIPSOLVER_STATUS_OPTIMAL = 2,
+    MIPSOLVER_CONSTRAINT_LESS_EQUAL = 0,
+    MIPSOLVER_CONSTRAINT_GREATER_EQUAL = 1,
+    MIPSOLVER_CONSTRAINT_EQUAL = 2
+} MIPSolver_ConstraintType;
+
+typedef enum {
+    MIPSOLVER_STATUS_FEASIBLE = 0,         // a solution was found but the solve stopped before proving optimality
     MIPSOLVER_STATUS_INFEASIBLE = 1,
-    // Add other statuses as needed
+    MIPSOLVER_STATUS_OPTIMAL = 2,          // optimal within the requested gap tolerance
+    MIPSOLVER_STATUS_UNBOUNDED = 3,
+    MIPSOLVER_STATUS_NODE_LIMIT = 4,
+    MIPSOLVER_STATUS_TIME_LIMIT = 5,
+    MIPSOLVER_STATUS_UNKNOWN = 6,
+    MIPSOLVER_STATUS_INTERRUPTED = 7,
+    MIPSOLVER_STATUS_WORK_LIMIT = 8        // the deterministic work budget ran out
 } MIPSolver_SolutionStatus;
 
+typedef enum {
+    MIPSOLVER_EVENT_INCUMBENT = 0,         // a better integer solution was found
+    MIPSOLVER_EVENT_PROGRESS = 1           // periodic report, see MIPSolver_SetProgressCallback
+} MIPSolver_ProgressEvent;
+
+// Search state passed to a progress callback; objective and bound are in the space of the original problem
+typedef struct {
+    MIPSolver_ProgressEvent event;
+    double time;                           // seconds since the start of the solve
+    long long nodes;                       // branch-and-bound nodes started so far
+    long long open_nodes;                  // nodes waiting to be explored (approximate in parallel solves)
+    double objective;                      // best objective so far; +/-infinity without a solution
+    double dual_bound;                     // best proven bound; +/-infinity before the root is solved
+    double gap;                            // relative gap |objective - dual_bound| / |objective|
+} MIPSolver_Progress;
+
+/**
+ * @brief Progress callback. Called from a solver thread while the solve runs; calls never overlap.
+ * @return 0 to continue, non-zero to stop the solve (its status becomes MIPSOLVER_STATUS_INTERRUPTED).
+ */
+typedef int (*MIPSolver_ProgressCallback)(const MIPSolver_Progress* progress, void* user_data);
+
 
 // --- Problem Management Functions ---
 
@@ -66,12 +102,195 @@ MIPSOLVER_API int MIPSolver_AddConstraint(MIPSolver_ProblemHandle handle, const
 /** @brief Adds a variable with a coefficient to a specific constraint. */
 MIPSOLVER_API void MIPSolver_AddConstraintCoefficient(MIPSolver_ProblemHandle handle, int constraint_index, int var_index, double coeff);
 
+/**
+ * @brief Adds count variables in one call.
+ * @param lower, upper, objective Arrays of length count; NULL means -infinity, +infinity and 0 respectively.
+ * @param types Array of MIPSolver_VariableType values; NULL means all continuous.
+ * @param names Array of count strings; NULL generates the names x<index>.
+ * @return Index of the first new variable, or -1 on invalid arguments.
+ */
+MIPSOLVER_API int MIPSolver_AddVariables(MIPSolver_ProblemHandle handle, int count, const double* lower, const double* upper,
+                                         const double* objective, const int* types, const char* const* names);
+
+/**
+ * @brief Adds num_rows constraints whose coefficients are given in CSR form.
+ * @param row_start Array of length num_rows + 1; row r uses entries [row_start[r], row_start[r+1]).
+ * @param col_index, values Variable indices (of existing variables) and coefficients.
+ * @param types Array of MIPSolver_ConstraintType values.
+ * @param rhs Right-hand sides.
+ * @param names Array of num_rows strings; NULL generates the names c<index>.
+ * @return Index of the first new constraint, or -1 on invalid arguments (the problem is left unchanged).
+ */
+MIPSOLVER_API int MIPSolver_AddRowsCSR(MIPSolver_ProblemHandle handle, int num_rows, const int* row_start, const int* col_index,
+                                       const double* values, const int* types, const double* rhs, const char* const* names);
+
+/**
+ * @brief Adds num_cols variables together with their coefficients in existing constraints (CSC form).
+ * @param col_start Array of length num_cols + 1; column j uses entries [col_start[j], col_start[j+1]).
+ * @param row_index, values Constraint indices (of existing constraints) and coefficients.
+ * The remaining arguments are as for MIPSolver_AddVariables.
+ * @return Index of the first new variable, or -1 on invalid arguments (the problem is left unchanged).
+ */
+MIPSOLVER_API int MIPSolver_AddColsCSC(MIPSolver_ProblemHandle handle, int num_cols, const int* col_start, const int* row_index,
+                                       const double* values, const double* lower, const double* upper, const double* objective,
+                                       const int* types, const char* const* names);
+
+// Incremental changes. MIPSolver_SetVariableBounds, MIPSolver_SetObjectiveCoefficient and the functions below are
+// tracked by kind, so a solver handle (MIPSolver_SolveWarm) re-solving the problem keeps as much of its state as
+// the changes allow. Adding coefficients to existing constraints counts as an arbitrary change.
+
+/** @brief Changes the right-hand side of a constraint. Returns 0, or -1 for an invalid handle or index. */
+MIPSOLVER_API int MIPSolver_SetConstraintRHS(MIPSolver_ProblemHandle handle, int constraint_index, double rhs);
+
+/**
+ * @brief Removes count constraints (indices in any order, duplicates allowed); later constraints move up.
+ * @return 0 on success, -1 for invalid arguments (the problem is left unchanged).
+ */
+MIPSOLVER_API int MIPSolver_RemoveConstraints(MIPSolver_ProblemHandle handle, int count, const int* indices);
+
+/**
+ * @brief Writes the problem to a binary snapshot file that MIPSolver_LoadProblemBinary reloads without parsing.
+ * @param include_names Non-zero to store variable and constraint names.
+ * @return 0 on success, -1 on failure.
+ */
+MIPSOLVER_API int MIPSolver_SaveProblemBinary(MIPSolver_ProblemHandle handle, const char* filename, int include_names);
+
+/** @brief Loads a problem from a binary snapshot file. Returns NULL if the file cannot be read or is invalid. */
+MIPSOLVER_API MIPSolver_ProblemHandle MIPSolver_LoadProblemBinary(const char* filename);
+
 
 // --- Solving Functions ---
+// Thread safety: different problems may be solved concurrently from different threads, and one problem may be
+// solved by several threads at once as long as nobody modifies it meanwhile (call MIPSolver_SolveBatch, or solve
+// it once, before sharing a freshly built problem: the first solve finalizes its matrix). Parameter sets are only
+// read by solves and may be shared; solution handles are independent objects.
 
 /** @brief Solves the problem using the Branch & Bound solver. */
 MIPSOLVER_API MIPSolver_SolutionHandle MIPSolver_Solve(MIPSolver_ProblemHandle problem_handle);
 
+/**
+ * @brief Solves the problem with a parallel Branch & Bound search.
+ * @param num_threads Number of worker threads; 0 uses one per hardware thread.
+ * @param deterministic Non-zero to use the reproducible synchronized-round search.
+ */
+MIPSOLVER_API MIPSolver_SolutionHandle MIPSolver_SolveWithThreads(MIPSolver_ProblemHandle problem_handle, int num_threads, int deterministic);
+
+/** @brief Solves the problem with the settings of a parameter set; NULL params uses the defaults. */
+MIPSOLVER_API MIPSolver_SolutionHandle MIPSolver_SolveWithParams(MIPSolver_ProblemHandle problem_handle, MIPSolver_ParamsHandle params);
+
+/**
+ * @brief Completion callback of MIPSolver_SolveBatch. Called on a pool thread as each problem finishes;
+ *        calls for different problems may run concurrently.
+ * @param index Position of the problem in the batch.
+ * @param solution The solution, or NULL if that solve failed. Owned by the callback (release it with
+ *        MIPSolver_DestroySolution) unless a solutions array was passed to MIPSolver_SolveBatch.
+ */
+typedef void (*MIPSolver_BatchCallback)(int index, MIPSolver_SolutionHandle solution, void* user_data);
+
+/**
+ * @brief Solves many independent problems on a persistent internal thread pool (one thread per hardware thread).
+ *
+ * Each problem is solved with the settings of params (NULL uses the defaults) by a pool thread that reuses its
+ * solver across problems. Problems are only read; the same handle may appear several times, but no problem may
+ * be modified until the call returns. Blocks until the whole batch has finished. Several threads may call it at
+ * once; it must not be called from a callback running on a pool thread.
+ *
+ * @param solutions Optional array of count entries, filled in input order (NULL for a failed solve).
+ * @param callback Optional completion callback; at least one of solutions and callback must be given.
+ * @return The number of failed solves (0 if all succeeded), or -1 for invalid arguments.
+ */
+MIPSOLVER_API int MIPSolver_SolveBatch(const MIPSolver_ProblemHandle* problems, int count, MIPSolver_ParamsHandle params,
+                                       MIPSolver_SolutionHandle* solutions, MIPSolver_BatchCallback callback, void* user_data);
+
+/**
+ * @brief Creates a solver that keeps its state between solves of the same problem: the optimal root basis,
+ *        pseudocosts, the root cuts (while the changes only shrink the feasible region) and the best solution,
+ *        which is repaired against the new data. Meant for re-solving a model after small changes.
+ *        Release it with MIPSolver_DestroySolver.
+ */
+MIPSOLVER_API MIPSolver_SolverHandle MIPSolver_CreateSolver(void);
+
+/** @brief Destroys a solver created by MIPSolver_CreateSolver. */
+MIPSOLVER_API void MIPSolver_DestroySolver(MIPSolver_SolverHandle solver);
+
+/**
+ * @brief Solves the problem with a solver handle, starting from the state of its previous solve of the same
+ *        problem; NULL params uses the defaults. A solver handle must not be used by two threads at once.
+ * @return The solution, or NULL on failure.
+ */
+MIPSOLVER_API MIPSolver_SolutionHandle MIPSolver_SolveWarm(MIPSolver_SolverHandle solver, MIPSolver_ProblemHandle problem_handle,
+                                                           MIPSolver_ParamsHandle params);
+
+
+// --- Solver Parameters ---
+// Setters return 0 on success and -1 for a NULL handle or an out-of-range value.
+
+/** @brief Creates a parameter set holding the solver defaults. */
+MIPSOLVER_API MIPSolver_ParamsHandle MIPSolver_CreateParams(void);
+
+/** @brief Destroys a parameter set. */
+MIPSOLVER_API void MIPSolver_DestroyParams(MIPSolver_ParamsHandle params);
+
+/** @brief Wall-clock limit in seconds, measured from the start of the solve; 0 disables it (default 3600). */
+MIPSOLVER_API int MIPSolver_SetTimeLimit(MIPSolver_ParamsHandle params, double seconds);
+
+/**
+ * @brief Deterministic work budget; 0 disables it (default).
+ * One work unit is one million LP nonzeros touched, independent of machine speed.
+ * Single-threaded (and deterministic multi-threaded) solves stop at the same node on every machine.
+ */
+MIPSOLVER_API int MIPSolver_SetWorkLimit(MIPSolver_ParamsHandle params, double work_units);
+
+/** @brief Maximum number of branch-and-bound nodes (default 100000). */
+MIPSOLVER_API int MIPSolver_SetNodeLimit(MIPSolver_ParamsHandle params, int max_nodes);
+
+/** @brief Number of worker threads; 0 uses one per hardware thread (default 1). */
+MIPSOLVER_API int MIPSolver_SetNumThreads(MIPSolver_ParamsHandle params, int num_threads);
+
+/** @brief Non-zero selects the reproducible synchronized-round parallel search (default 0). */
+MIPSOLVER_API int MIPSolver_SetDeterministic(MIPSolver_ParamsHandle params, int deterministic);
+
+/** @brief Stop once |incumbent - bound| <= gap * |incumbent| (default 0). */
+MIPSOLVER_API int MIPSolver_SetRelativeGap(MIPSolver_ParamsHandle params, double gap);
+
+/** @brief Stop once |incumbent - bound| <= gap (default 0). */
+MIPSOLVER_API int MIPSolver_SetAbsoluteGap(MIPSolver_ParamsHandle params, double gap);
+
+/** @brief Non-zero prints solver progress to stdout (default 0). */
+MIPSOLVER_API int MIPSolver_SetVerbose(MIPSolver_ParamsHandle params, int verbose);
+
+/** @brief Enables (non-zero) or disables presolve (default on). */
+MIPSOLVER_API int MIPSolver_SetPresolve(MIPSolver_ParamsHandle params, int enable);
+
+/** @brief Enables (non-zero) or disables root cutting planes (default on). */
+MIPSOLVER_API int MIPSolver_SetCuttingPlanes(MIPSolver_ParamsHandle params, int enable);
+
+/**
+ * @brief Registers a progress callback for solves that use this parameter set (NULL removes it).
+ * @param interval_seconds Time between MIPSOLVER_EVENT_PROGRESS reports; 0 reports new incumbents only.
+ * @param user_data Passed through to every call.
+ */
+MIPSOLVER_API int MIPSolver_SetProgressCallback(MIPSolver_ParamsHandle params, MIPSolver_ProgressCallback callback,
+                                                double interval_seconds, void* user_data);
+
+/**
+ * @brief Adds a starting solution (MIP start) used by every solve with this parameter set.
+ *
+ * Values of integer variables must be integral. A start that fixes only some variables is completed by solving
+ * a node-limited sub-MIP over the others. Feasible starts become the initial incumbent and enter the solution
+ * pool; infeasible ones are ignored.
+ *
+ * @param indices Variable indices of the count values; NULL means values holds variables 0..count-1, where
+ *        NaN leaves a variable unspecified. An index beyond the problem makes the solve fail.
+ */
+MIPSOLVER_API int MIPSolver_AddMIPStart(MIPSolver_ParamsHandle params, int count, const int* indices, const double* values);
+
+/** @brief Removes all starting solutions from the parameter set. */
+MIPSOLVER_API int MIPSolver_ClearMIPStarts(MIPSolver_ParamsHandle params);
+
+/** @brief Number of best distinct solutions kept in the solution pool; 0 keeps none (default 10). */
+MIPSOLVER_API int MIPSolver_SetSolutionPoolSize(MIPSolver_ParamsHandle params, int size);
+
 
 // --- Solution Management Functions ---
 
@@ -84,6 +303,52 @@ MIPSOLVER_API MIPSolver_SolutionStatus MIPSolver_GetStatus(MIPSolver_SolutionHan
 /** @brief Gets the objective value of the solution. */
 MIPSOLVER_API double MIPSolver_GetObjectiveValue(MIPSolver_SolutionHandle handle);
 
+/** @brief Gets the best proven bound on the objective (equal to the objective value when solved to optimality). */
+MIPSOLVER_API double MIPSolver_GetDualBound(MIPSolver_SolutionHandle handle);
+
+/** @brief Gets the wall-clock solve time in seconds. */
+MIPSOLVER_API double MIPSolver_GetSolveTime(MIPSolver_SolutionHandle handle);
+
+/** @brief Gets the deterministic work spent by the solve, in the units of MIPSolver_SetWorkLimit. */
+MIPSOLVER_API double MIPSolver_GetWorkUnits(MIPSolver_SolutionHandle handle);
+
+/** @brief Gets the final relative gap |objective - dual bound| / |objective|; infinity without a solution. */
+MIPSOLVER_API double MIPSolver_GetGap(MIPSolver_SolutionHandle handle);
+
+/** @brief Gets the number of branch-and-bound nodes processed. */
+MIPSOLVER_API long long MIPSolver_GetNodeCount(MIPSolver_SolutionHandle handle);
+
+/** @brief Gets the number of nodes left unexplored when the solve stopped. */
+MIPSOLVER_API long long MIPSolver_GetOpenNodeCount(MIPSolver_SolutionHandle handle);
+
+/** @brief Gets the number of improving solutions recorded during the solve. */
+MIPSOLVER_API int MIPSolver_GetIncumbentHistoryLength(MIPSolver_SolutionHandle handle);
+
+/**
+ * @brief Copies the incumbent history, oldest first.
+ * @param times, objectives Arrays of MIPSolver_GetIncumbentHistoryLength entries; either may be NULL.
+ */
+MIPSOLVER_API void MIPSolver_GetIncumbentHistory(MIPSolver_SolutionHandle handle, double* times, double* objectives);
+
+/** @brief Gets the number of solutions in the solution pool (best first; the first one is the returned solution). */
+MIPSOLVER_API int MIPSolver_GetPoolSize(MIPSolver_SolutionHandle handle);
+
+/** @brief Gets the objective value of pool solution index; NaN for an invalid index. */
+MIPSOLVER_API double MIPSolver_GetPoolObjective(MIPSolver_SolutionHandle handle, int index);
+
+/**
+ * @brief Copies the variable values of pool solution index into an array of MIPSolver_GetSolutionNumVars entries.
+ * @return 0 on success, -1 for an invalid handle or index.
+ */
+MIPSOLVER_API int MIPSolver_GetPoolValues(MIPSolver_SolutionHandle handle, int index, double* values_array);
+
+/**
+ * @brief Writes the phase timings of the solve as a Chrome/Perfetto trace (JSON).
+ * @return 0 on success; -1 if the file cannot be written or the library was built without
+ *         MIPSOLVER_ENABLE_INSTRUMENTATION.
+ */
+MIPSOLVER_API int MIPSolver_WriteTrace(MIPSolver_SolutionHandle handle, const char* filename);
+
 /** @brief Gets the number of variables in the solution. */
 MIPSOLVER_API int MIPSolver_GetSolutionNumVars(MIPSolver_SolutionHandle handle);
 
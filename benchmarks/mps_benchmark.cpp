@@ -0,0 +1,636 @@
+/*
+ * MPS基准测试程序
+ *
+ * 对一个目录（或若干文件）中的MPS实例依次运行 MPSParser::parseFromFile 与 BranchBoundSolver::solve，
+ * 输出机器可读的结果，并可以与保存的基线比较，用于在升级求解器之前在自己的实例集上量化变化。
+ *
+ * 1. 每个实例、每个线程数重复 --repeats 次：
+ *    - parse_time: 解析时间（重复中的中位数）
+ *    - root_lp_time: 原问题根LP松弛的求解时间（单独的SimplexSolver，不含预处理和割平面）
+ *    - solve_time / nodes / lp_iterations / work_units: 分支定界的时间与工作量（中位数）
+ *    - status / objective / dual_bound / gap: 最后一次重复的结果
+ *    - peak_rss_kb: 处理该实例期间的进程峰值常驻内存。Linux上每个实例之前通过
+ *      /proc/self/clear_refs 重置峰值；其他平台无法重置，给出的是进程至今的峰值
+ *
+ * 2. 输出：--format json（默认）或 csv，写到 --output 指定的文件或标准输出
+ *
+ * 3. 比较模式（--compare baseline.json）：按 (instance, threads) 与基线逐项比较，标记
+ *    - WRONG: 两次都是OPTIMAL但目标值不同
+ *    - STATUS: 基线为OPTIMAL而本次不是
+ *    - SLOWER: 求解时间超过基线的 (1 + tolerance) 倍，且差值大于 --min-time（排除计时噪声）
+ *    - NODES: 节点数超过基线的 (1 + tolerance) 倍
+ *    - GAP: 最终间隙比基线差
+ *    有任何回归时进程返回码为1，便于在CI中使用
+ *
+ * 构建（仓库中的头文件都是header-only）：
+ *   g++ -std=c++17 -O2 -pthread -Isrc/core -Isrc/solvers benchmarks/mps_benchmark.cpp -o mps_benchmark
+ * 读取压缩的MPS文件时另加 -DMIPSOLVER_HAVE_ZLIB -lz / -DMIPSOLVER_HAVE_ZSTD -lzstd。
+ *
+ * 示例：
+ *   mps_benchmark --repeats 3 --threads 1,4 --output baseline.json examples/mps
+ *   mps_benchmark --repeats 3 --threads 1,4 --compare baseline.json examples/mps
+ */
+
+#include "core.h"
+#include "solution.h"
+#include "parser.h"
+#include "simplex_solver.h"
+#include "branch_bound_solver.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+using namespace MIPSolver;
+
+namespace {
+
+struct Options {
+    std::vector<std::string> inputs;
+    std::vector<int> threads{1};
+    int repeats = 1;
+    double time_limit = 60.0;
+    int node_limit = 100000;
+    double work_limit = 0.0;
+    bool deterministic = false;
+    bool presolve = true;
+    std::string format = "json";
+    std::string output;
+    std::string compare;
+    double tolerance = 0.10;  // Relative slowdown / node growth counted as a regression
+    double min_time = 0.05;   // Time differences below this many seconds are noise
+};
+
+struct RunResult {
+    std::string instance;
+    int threads = 1;
+    int repeats = 0;
+    int num_variables = 0;
+    int num_constraints = 0;
+    long long nonzeros = 0;
+    double parse_time = 0.0;
+    double root_lp_time = 0.0;
+    double solve_time = 0.0;
+    long long nodes = 0;
+    long long lp_iterations = 0;
+    double work_units = 0.0;
+    std::string status;
+    double objective = 0.0;
+    double dual_bound = 0.0;
+    double gap = 0.0;
+    long long peak_rss_kb = 0;
+};
+
+void printUsage() {
+    std::cerr <<
+        "Usage: mps_benchmark [options] <directory|file.mps>...\n"
+        "  --repeats N          runs per instance and thread count (default 1)\n"
+        "  --threads 1,2,4      thread counts to run (default 1)\n"
+        "  --time-limit S       time limit per solve in seconds (default 60, 0 = none)\n"
+        "  --node-limit N       node limit per solve (default 100000)\n"
+        "  --work-limit W       deterministic work limit per solve (default 0 = none)\n"
+        "  --deterministic      use the reproducible parallel search\n"
+        "  --no-presolve        disable presolve\n"
+        "  --format json|csv    output format (default json)\n"
+        "  --output FILE        write results to FILE instead of stdout\n"
+        "  --compare FILE       compare against a JSON baseline; exit code 1 on regressions\n"
+        "  --tolerance T        relative slowdown / node growth allowed by --compare (default 0.10)\n"
+        "  --min-time S         ignore time differences below S seconds (default 0.05)\n";
+}
+
+std::vector<int> parseIntList(const std::string& text) {
+    std::vector<int> values;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) values.push_back(std::stoi(item));
+    }
+    if (values.empty()) throw std::runtime_error("empty list: " + text);
+    return values;
+}
+
+Options parseOptions(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto value = [&]() -> std::string {
+            if (i + 1 >= argc) throw std::runtime_error("missing value for " + arg);
+            return argv[++i];
+        };
+        if (arg == "--repeats") options.repeats = std::max(1, std::stoi(value()));
+        else if (arg == "--threads") options.threads = parseIntList(value());
+        else if (arg == "--time-limit") options.time_limit = std::stod(value());
+        else if (arg == "--node-limit") options.node_limit = std::stoi(value());
+        else if (arg == "--work-limit") options.work_limit = std::stod(value());
+        else if (arg == "--deterministic") options.deterministic = true;
+        else if (arg == "--no-presolve") options.presolve = false;
+        else if (arg == "--format") options.format = value();
+        else if (arg == "--output") options.output = value();
+        else if (arg == "--compare") options.compare = value();
+        else if (arg == "--tolerance") options.tolerance = std::stod(value());
+        else if (arg == "--min-time") options.min_time = std::stod(value());
+        else if (arg == "--help" || arg == "-h") { printUsage(); std::exit(0); }
+        else if (!arg.empty() && arg[0] == '-') throw std::runtime_error("unknown option " + arg);
+        else options.inputs.push_back(arg);
+    }
+    if (options.inputs.empty()) throw std::runtime_error("no input directory or file given");
+    if (options.format != "json" && options.format != "csv") throw std::runtime_error("unknown format " + options.format);
+    return options;
+}
+
+bool isMPSFile(const std::filesystem::path& path) {
+    std::string name = path.filename().string();
+    for (const char* suffix : {".mps", ".mps.gz", ".mps.zst"}) {
+        size_t length = std::char_traits<char>::length(suffix);
+        if (name.size() > length && name.compare(name.size() - length, length, suffix) == 0) return true;
+    }
+    return false;
+}
+
+// Inputs expand to their MPS files; directories are listed in name order so runs are comparable
+std::vector<std::filesystem::path> collectInstances(const std::vector<std::string>& inputs) {
+    std::vector<std::filesystem::path> files;
+    for (const std::string& input : inputs) {
+        std::filesystem::path path(input);
+        if (std::filesystem::is_directory(path)) {
+            std::vector<std::filesystem::path> listed;
+            for (const auto& entry : std::filesystem::directory_iterator(path)) {
+                if (entry.is_regular_file() && isMPSFile(entry.path())) listed.push_back(entry.path());
+            }
+            std::sort(listed.begin(), listed.end());
+            files.insert(files.end(), listed.begin(), listed.end());
+        } else if (std::filesystem::is_regular_file(path)) {
+            files.push_back(path);
+        } else {
+            throw std::runtime_error("not a file or directory: " + input);
+        }
+    }
+    return files;
+}
+
+// Reset the peak RSS counter where the OS allows it (Linux 4.0+); false if the peak is process-wide
+bool resetPeakRss() {
+#if defined(__linux__)
+    std::ofstream clear_refs("/proc/self/clear_refs");
+    if (!clear_refs) return false;
+    clear_refs << "5";
+    return static_cast<bool>(clear_refs.flush());
+#else
+    return false;
+#endif
+}
+
+long long peakRssKb() {
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return static_cast<long long>(counters.PeakWorkingSetSize / 1024);
+    }
+    return 0;
+#else
+#if defined(__linux__)
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, 6, "VmHWM:") == 0) return std::atoll(line.c_str() + 6);
+    }
+#endif
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+#if defined(__APPLE__)
+    return static_cast<long long>(usage.ru_maxrss / 1024);  // bytes on macOS
+#else
+    return static_cast<long long>(usage.ru_maxrss);
+#endif
+#endif
+}
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+template <typename T>
+T median(std::vector<T> values) {
+    std::sort(values.begin(), values.end());
+    return values[values.size() / 2];
+}
+
+const char* statusName(Solution::Status status) {
+    switch (status) {
+        case Solution::Status::FEASIBLE: return "FEASIBLE";
+        case Solution::Status::INFEASIBLE: return "INFEASIBLE";
+        case Solution::Status::OPTIMAL: return "OPTIMAL";
+        case Solution::Status::UNBOUNDED: return "UNBOUNDED";
+        case Solution::Status::ITERATION_LIMIT: return "NODE_LIMIT";
+        case Solution::Status::TIME_LIMIT: return "TIME_LIMIT";
+        case Solution::Status::UNKNOWN: return "UNKNOWN";
+        case Solution::Status::INTERRUPTED: return "INTERRUPTED";
+        case Solution::Status::WORK_LIMIT: return "WORK_LIMIT";
+    }
+    return "UNKNOWN";
+}
+
+/*
+ * 运行一个实例的全部重复
+ *
+ * 每次重复都重新解析文件，使解析时间与求解时间来自同一组样本；
+ * 根LP时间在每次重复中单独测量
+ */
+RunResult runInstance(const std::filesystem::path& file, int threads, const Options& options, bool& rss_resettable) {
+    RunResult result;
+    result.instance = file.filename().string();
+    result.threads = threads;
+    result.repeats = options.repeats;
+    rss_resettable = resetPeakRss();
+
+    std::vector<double> parse_times, root_times, solve_times, work;
+    std::vector<long long> nodes, lp_iterations;
+    for (int r = 0; r < options.repeats; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        Problem problem = MPSParser::parseFromFile(file.string());
+        parse_times.push_back(secondsSince(start));
+
+        result.num_variables = problem.getNumVariables();
+        result.num_constraints = problem.getNumConstraints();
+        result.nonzeros = static_cast<long long>(problem.getMatrix().getNumNonzeros());
+
+        start = std::chrono::steady_clock::now();
+        SimplexSolver root_lp(false);
+        root_lp.solveLPRelaxation(problem);
+        root_times.push_back(secondsSince(start));
+
+        BranchBoundSolver solver;
+        solver.setVerbose(false);
+        solver.setNumThreads(threads);
+        solver.setDeterministic(options.deterministic);
+        solver.setTimeLimit(options.time_limit);
+        solver.setIterationLimit(options.node_limit);
+        solver.setWorkLimit(options.work_limit);
+        solver.setPresolve(options.presolve);
+
+        start = std::chrono::steady_clock::now();
+        Solution solution = solver.solve(problem);
+        solve_times.push_back(secondsSince(start));
+        nodes.push_back(solution.getNodeCount());
+        lp_iterations.push_back(solution.getLPIterations());
+        work.push_back(solution.getWorkUnits());
+
+        result.status = statusName(solution.getStatus());
+        result.objective = solution.getObjectiveValue();
+        result.dual_bound = solution.getDualBound();
+        result.gap = solution.getGap();
+    }
+
+    result.parse_time = median(parse_times);
+    result.root_lp_time = median(root_times);
+    result.solve_time = median(solve_times);
+    result.nodes = median(nodes);
+    result.lp_iterations = median(lp_iterations);
+    result.work_units = median(work);
+    result.peak_rss_kb = peakRssKb();
+    return result;
+}
+
+// JSON has no infinities; they are written as null and read back as +inf
+std::string jsonNumber(double value) {
+    if (!std::isfinite(value)) return "null";
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.10g", value);
+    return buffer;
+}
+
+std::string jsonString(const std::string& text) {
+    std::string quoted = "\"";
+    for (char c : text) {
+        if (c == '"' || c == '\\') quoted += '\\';
+        if (static_cast<unsigned char>(c) < 0x20) {
+            char buffer[8];
+            std::snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+            quoted += buffer;
+        } else {
+            quoted += c;
+        }
+    }
+    return quoted + "\"";
+}
+
+void writeJSON(std::ostream& out, const std::vector<RunResult>& results, const Options& options, bool rss_per_instance) {
+    out << "{\n";
+    out << "  \"tool\": \"mps_benchmark\",\n";
+    out << "  \"settings\": {\"repeats\": " << options.repeats
+        << ", \"time_limit\": " << jsonNumber(options.time_limit)
+        << ", \"node_limit\": " << options.node_limit
+        << ", \"work_limit\": " << jsonNumber(options.work_limit)
+        << ", \"deterministic\": " << (options.deterministic ? "true" : "false")
+        << ", \"presolve\": " << (options.presolve ? "true" : "false")
+        << ", \"peak_rss_per_instance\": " << (rss_per_instance ? "true" : "false") << "},\n";
+    out << "  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const RunResult& r = results[i];
+        out << "    {\"instance\": " << jsonString(r.instance)
+            << ", \"threads\": " << r.threads
+            << ", \"repeats\": " << r.repeats
+            << ", \"variables\": " << r.num_variables
+            << ", \"constraints\": " << r.num_constraints
+            << ", \"nonzeros\": " << r.nonzeros
+            << ", \"parse_time\": " << jsonNumber(r.parse_time)
+            << ", \"root_lp_time\": " << jsonNumber(r.root_lp_time)
+            << ", \"solve_time\": " << jsonNumber(r.solve_time)
+            << ", \"nodes\": " << r.nodes
+            << ", \"lp_iterations\": " << r.lp_iterations
+            << ", \"work_units\": " << jsonNumber(r.work_units)
+            << ", \"status\": " << jsonString(r.status)
+            << ", \"objective\": " << jsonNumber(r.objective)
+            << ", \"dual_bound\": " << jsonNumber(r.dual_bound)
+            << ", \"gap\": " << jsonNumber(r.gap)
+            << ", \"peak_rss_kb\": " << r.peak_rss_kb << "}"
+            << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    out << "  ]\n}\n";
+}
+
+void writeCSV(std::ostream& out, const std::vector<RunResult>& results) {
+    out << "instance,threads,repeats,variables,constraints,nonzeros,parse_time,root_lp_time,solve_time,"
+           "nodes,lp_iterations,work_units,status,objective,dual_bound,gap,peak_rss_kb\n";
+    for (const RunResult& r : results) {
+        out << r.instance << ',' << r.threads << ',' << r.repeats << ',' << r.num_variables << ','
+            << r.num_constraints << ',' << r.nonzeros << ',' << jsonNumber(r.parse_time) << ','
+            << jsonNumber(r.root_lp_time) << ',' << jsonNumber(r.solve_time) << ',' << r.nodes << ','
+            << r.lp_iterations << ',' << jsonNumber(r.work_units) << ',' << r.status << ','
+            << jsonNumber(r.objective) << ',' << jsonNumber(r.dual_bound) << ',' << jsonNumber(r.gap) << ','
+            << r.peak_rss_kb << '\n';
+    }
+}
+
+/*
+ * 基线读取
+ *
+ * 只需要读回本程序写出的JSON：对象、数组、字符串、数字、true/false/null。
+ * 每个结果对象读成 字段名 -> 文本值 的映射（字符串去掉引号，null记为空串）
+ */
+class BaselineReader {
+public:
+    explicit BaselineReader(std::string text) : text_(std::move(text)) {}
+
+    std::vector<std::map<std::string, std::string>> readResults() {
+        std::vector<std::map<std::string, std::string>> results;
+        skipSpace();
+        expect('{');
+        while (true) {
+            skipSpace();
+            if (peek() == '}') break;
+            std::string key = readString();
+            skipSpace();
+            expect(':');
+            skipSpace();
+            if (key == "results") {
+                expect('[');
+                while (true) {
+                    skipSpace();
+                    if (peek() == ']') { ++pos_; break; }
+                    results.push_back(readFlatObject());
+                    skipSpace();
+                    if (peek() == ',') ++pos_;
+                }
+            } else {
+                skipValue();
+            }
+            skipSpace();
+            if (peek() == ',') ++pos_;
+        }
+        return results;
+    }
+
+private:
+    std::string text_;
+    size_t pos_ = 0;
+
+    char peek() const {
+        if (pos_ >= text_.size()) throw std::runtime_error("baseline: unexpected end of file");
+        return text_[pos_];
+    }
+    void expect(char c) {
+        if (peek() != c) throw std::runtime_error(std::string("baseline: expected '") + c + "' at offset " + std::to_string(pos_));
+        ++pos_;
+    }
+    void skipSpace() {
+        while (pos_ < text_.size() && std::isspace(static_cast<unsigned char>(text_[pos_]))) ++pos_;
+    }
+
+    std::string readString() {
+        expect('"');
+        std::string value;
+        while (peek() != '"') {
+            char c = text_[pos_++];
+            if (c == '\\') {
+                char escaped = peek();
+                ++pos_;
+                if (escaped == 'u') {
+                    value += static_cast<char>(std::stoi(text_.substr(pos_, 4), nullptr, 16));
+                    pos_ += 4;
+                } else {
+                    value += escaped == 'n' ? '\n' : escaped == 't' ? '\t' : escaped;
+                }
+            } else {
+                value += c;
+            }
+        }
+        ++pos_;
+        return value;
+    }
+
+    std::string readScalar() {
+        if (peek() == '"') return readString();
+        size_t start = pos_;
+        while (pos_ < text_.size() && text_[pos_] != ',' && text_[pos_] != '}' && text_[pos_] != ']' &&
+               !std::isspace(static_cast<unsigned char>(text_[pos_]))) {
+            ++pos_;
+        }
+        std::string token = text_.substr(start, pos_ - start);
+        return token == "null" ? std::string() : token;
+    }
+
+    void skipValue() {
+        char c = peek();
+        if (c == '{' || c == '[') {
+            char close = (c == '{') ? '}' : ']';
+            ++pos_;
+            while (true) {
+                skipSpace();
+                if (peek() == close) { ++pos_; return; }
+                if (c == '{') {
+                    readString();
+                    skipSpace();
+                    expect(':');
+                    skipSpace();
+                }
+                skipValue();
+                skipSpace();
+                if (peek() == ',') ++pos_;
+            }
+        }
+        readScalar();
+    }
+
+    std::map<std::string, std::string> readFlatObject() {
+        std::map<std::string, std::string> object;
+        expect('{');
+        while (true) {
+            skipSpace();
+            if (peek() == '}') { ++pos_; return object; }
+            std::string key = readString();
+            skipSpace();
+            expect(':');
+            skipSpace();
+            object[key] = readScalar();
+            skipSpace();
+            if (peek() == ',') ++pos_;
+        }
+    }
+};
+
+double toNumber(const std::map<std::string, std::string>& object, const std::string& key) {
+    auto it = object.find(key);
+    if (it == object.end() || it->second.empty()) return std::numeric_limits<double>::infinity();
+    return std::stod(it->second);
+}
+
+/*
+ * 与基线比较，打印每个实例的对比并返回回归数
+ */
+int compareWithBaseline(const std::vector<RunResult>& results, const Options& options) {
+    std::ifstream file(options.compare, std::ios::binary);
+    if (!file) throw std::runtime_error("cannot open baseline " + options.compare);
+    std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    std::map<std::pair<std::string, int>, std::map<std::string, std::string>> baseline;
+    for (auto& entry : BaselineReader(std::move(text)).readResults()) {
+        std::string instance = entry["instance"];
+        int threads = static_cast<int>(toNumber(entry, "threads"));
+        baseline[{instance, threads}] = std::move(entry);
+    }
+
+    int regressions = 0;
+    std::fprintf(stderr, "\n%-24s %4s %10s %10s %8s %10s %10s %8s  %s\n",
+                 "instance", "thr", "base_time", "time", "ratio", "base_nodes", "nodes", "gap", "verdict");
+    for (const RunResult& r : results) {
+        auto it = baseline.find({r.instance, r.threads});
+        if (it == baseline.end()) {
+            std::fprintf(stderr, "%-24s %4d %10s %10.3f %8s %10s %10lld %8.4f  NEW\n",
+                         r.instance.c_str(), r.threads, "-", r.solve_time, "-", "-", r.nodes, r.gap);
+            continue;
+        }
+        const auto& base = it->second;
+        double base_time = toNumber(base, "solve_time");
+        double base_nodes = toNumber(base, "nodes");
+        double base_objective = toNumber(base, "objective");
+        double base_gap = toNumber(base, "gap");
+        std::string base_status = base.count("status") ? base.at("status") : "";
+
+        std::vector<std::string> flags;
+        if (base_status == "OPTIMAL" && r.status == "OPTIMAL" &&
+            std::abs(r.objective - base_objective) > 1e-6 * std::max(1.0, std::abs(base_objective))) {
+            flags.push_back("WRONG");
+        }
+        if (base_status == "OPTIMAL" && r.status != "OPTIMAL") flags.push_back("STATUS");
+        if (r.solve_time > base_time * (1.0 + options.tolerance) && r.solve_time - base_time > options.min_time) {
+            flags.push_back("SLOWER");
+        }
+        if (r.nodes > base_nodes * (1.0 + options.tolerance) && r.nodes - base_nodes > 10) flags.push_back("NODES");
+        double gap = std::isfinite(r.gap) ? r.gap : std::numeric_limits<double>::infinity();
+        if (gap > base_gap + 1e-9 && !(std::isinf(gap) && std::isinf(base_gap))) flags.push_back("GAP");
+
+        std::string verdict;
+        for (const std::string& flag : flags) verdict += (verdict.empty() ? "" : ",") + flag;
+        if (verdict.empty()) verdict = "ok";
+        regressions += flags.empty() ? 0 : 1;
+
+        double ratio = base_time > 0.0 ? r.solve_time / base_time : 1.0;
+        std::fprintf(stderr, "%-24s %4d %10.3f %10.3f %8.2f %10.0f %10lld %8.4f  %s\n",
+                     r.instance.c_str(), r.threads, base_time, r.solve_time, ratio, base_nodes, r.nodes, r.gap,
+                     verdict.c_str());
+    }
+    std::fprintf(stderr, "%d regression(s) against %s\n", regressions, options.compare.c_str());
+    return regressions;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    std::vector<std::filesystem::path> files;
+    try {
+        options = parseOptions(argc, argv);
+        files = collectInstances(options.inputs);
+    } catch (const std::exception& e) {
+        std::cerr << "mps_benchmark: " << e.what() << "\n";
+        printUsage();
+        return 2;
+    }
+
+    std::vector<RunResult> results;
+    bool rss_per_instance = true;
+    for (const auto& file : files) {
+        for (int threads : options.threads) {
+            try {
+                bool resettable = false;
+                results.push_back(runInstance(file, threads, options, resettable));
+                rss_per_instance = rss_per_instance && resettable;
+                const RunResult& r = results.back();
+                std::fprintf(stderr, "%-24s threads=%d %-11s obj=%-14.6g gap=%-8.4f nodes=%-8lld time=%.3fs\n",
+                             r.instance.c_str(), threads, r.status.c_str(), r.objective, r.gap, r.nodes, r.solve_time);
+            } catch (const std::exception& e) {
+                std::fprintf(stderr, "%-24s threads=%d failed: %s\n", file.filename().string().c_str(), threads, e.what());
+            }
+        }
+    }
+
+    std::ofstream output_file;
+    if (!options.output.empty()) {
+        output_file.open(options.output);
+        if (!output_file) {
+            std::cerr << "mps_benchmark: cannot write " << options.output << "\n";
+            return 2;
+        }
+    }
+    std::ostream& out = options.output.empty() ? std::cout : output_file;
+    if (options.format == "csv") {
+        writeCSV(out, results);
+    } else {
+        writeJSON(out, results, options, rss_per_instance);
+    }
+    out.flush();
+
+    if (!options.compare.empty()) {
+        try {
+            return compareWithBaseline(results, options) > 0 ? 1 : 0;
+        } catch (const std::exception& e) {
+            std::cerr << "mps_benchmark: " << e.what() << "\n";
+            return 2;
+        }
+    }
+    return 0;
+}
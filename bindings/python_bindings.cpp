@@ -1,8 +1,22 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h> // Needed for automatic conversion of std::vector, etc.
+#include <pybind11/numpy.h>
+#include <limits>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <exception>
+#include <cmath>
+#include <unordered_map>
 #include "../src/core.h"
 #include "../src/solution.h"
 #include "../src/branch_bound_solver.h"
+#include "../src/batch_solver.h"
+#include "../src/portfolio_solver.h"
+#include "../src/parser.h"
+#include "../src/problem_snapshot.h"
 
 /*
  * Python绑定模块
@@ -23,14 +37,329 @@
  *    - 最小化Python/C++边界的数据拷贝
  *    - 利用pybind11的智能指针管理
  *    - 支持numpy数组的零拷贝访问
+ *    - MPSParser.parse_from_file(..., keep_names=False) 或 Problem.keep_names = False 不保存名字，
+ *      大模型可以省下大部分内存；名字用get_variable_name / get_constraint_name查询
  * 
  * 4. 错误处理：
  *    - C++异常自动转换为Python异常
  *    - 保持错误信息的完整性和可读性
+ * 
+ * 5. 并发：
+ *    - Solver.solve在求解期间释放GIL，其他Python线程（例如Web服务的请求处理）照常运行
+ *    - Solver.solve_async在后台线程上求解，立即返回SolveHandle（轮询、等待、取消、取结果）
+ *    - Solver.set_incumbent_callback注册的回调只在找到更好的整数解时获取GIL，
+ *      set_progress_callback注册的进度回调只在新最优解和定时报告时获取GIL
+ *    - 同一个Solver同时只能运行一个求解，并发求解请使用多个Solver；求解期间修改Solver的设置或Problem抛出RuntimeError
+ *    - Solver.solve_batch把一批独立的问题交给模块内常驻的线程池（每个硬件线程一个工作线程），
+ *      每个问题都使用该Solver的设置，求解期间释放GIL
+ * 
+ * 6. 增量求解：
+ *    - Problem.set_variable_bounds / set_constraint_rhs / set_objective_coefficient / remove_constraints
+ *      以及带系数的add_constraint按种类记录修改
+ *    - Solver.set_warm_start(True)后，同一个Solver再次求解修改过的同一个Problem时从上一次的状态开始
+ *      （根LP基、伪成本、割、修复后的最优解），见BranchBoundSolver::setWarmStart
+ * 
+ * 7. 初始解与解池：
+ *    - Solver.add_mip_start提供（可以只给出部分变量的）初始解，可行的作为初始最优解
+ *    - Solution.get_solution_pool给出找到的最好的若干个不同的解（set_solution_pool_size）
+ * 
+ * 8. 批量评估：
+ *    - Problem.evaluate_solutions(X)接收形状为(候选解个数, 变量个数)的二维数组，
+ *      返回(目标值, 最大违反量)两个数组；计算期间释放GIL，使用向量化内核（见kernels.h）
  */
 
 namespace py = pybind11;
 
+/*
+ * NumPy批量接口的辅助函数
+ *
+ * 批量建模接口一次接收整个数组，只跨越一次Python/C++边界：
+ * - 数组以 c_style | forcecast 方式接收，类型和内存布局已经匹配时直接使用NumPy的缓冲区，不做拷贝
+ * - 类型整数取 int(VariableType.X) / int(ConstraintType.X) 的值
+ * - 长度不一致或枚举值越界抛出ValueError
+ */
+namespace {
+    using DoubleArray = py::array_t<double, py::array::c_style | py::array::forcecast>;
+    using IntArray = py::array_t<int, py::array::c_style | py::array::forcecast>;
+
+    py::ssize_t checkVector(const py::array& array, const char* name, py::ssize_t expected = -1) {
+        if (array.ndim() != 1) {
+            throw py::value_error(std::string(name) + " must be a one-dimensional array");
+        }
+        if (expected >= 0 && array.shape(0) != expected) {
+            throw py::value_error(std::string(name) + " must have length " + std::to_string(expected));
+        }
+        if (array.shape(0) > std::numeric_limits<int>::max()) {
+            throw py::value_error(std::string(name) + " is too long");
+        }
+        return array.shape(0);
+    }
+
+    void checkIndex(int index, int count, const char* what) {
+        if (index < 0 || index >= count) {
+            throw py::index_error(std::string(what) + " index " + std::to_string(index) + " out of range");
+        }
+    }
+
+    template <typename Enum>
+    std::vector<Enum> toEnumVector(const IntArray& codes, const char* name, int num_values) {
+        std::vector<Enum> result(codes.shape(0));
+        const int* data = codes.data();
+        for (size_t i = 0; i < result.size(); ++i) {
+            if (data[i] < 0 || data[i] >= num_values) {
+                throw py::value_error(std::string(name) + " contains an invalid value " + std::to_string(data[i]));
+            }
+            result[i] = static_cast<Enum>(data[i]);
+        }
+        return result;
+    }
+
+    std::vector<std::string> toNames(const py::object& names, py::ssize_t expected) {
+        std::vector<std::string> result;
+        if (!names.is_none()) {
+            result = names.cast<std::vector<std::string>>();
+            if (static_cast<py::ssize_t>(result.size()) != expected) {
+                throw py::value_error("names must have length " + std::to_string(expected));
+            }
+        }
+        return result;
+    }
+
+    /*
+     * 可以在不持有GIL时复制和销毁的Python可调用对象
+     *
+     * 求解器内部会复制回调（std::function），这些复制发生在释放了GIL的求解线程上；
+     * 可调用对象本身由shared_ptr持有，最后一个引用释放时才获取GIL减少Python引用计数
+     */
+    std::shared_ptr<py::function> holdCallable(py::function callable) {
+        return std::shared_ptr<py::function>(new py::function(std::move(callable)), [](py::function* ptr) {
+            py::gil_scoped_acquire gil;
+            delete ptr;
+        });
+    }
+
+    // Python侧的Solver：记录是否正在求解，以及用户注册的新最优解回调和进度回调
+    struct PySolver : MIPSolver::BranchBoundSolver {
+        std::atomic<bool> busy{false};
+        std::shared_ptr<py::function> incumbent_callback;
+        std::shared_ptr<py::function> progress_callback;
+    };
+
+    // 求解期间占用Solver；已被占用时抛出RuntimeError
+    class SolverLease {
+    public:
+        explicit SolverLease(PySolver& solver) : solver_(solver) {
+            if (solver_.busy.exchange(true)) {
+                throw std::runtime_error("Solver is already running a solve; use one Solver per concurrent solve");
+            }
+        }
+        ~SolverLease() { solver_.busy.store(false); }
+        SolverLease(const SolverLease&) = delete;
+        SolverLease& operator=(const SolverLease&) = delete;
+    private:
+        PySolver& solver_;
+    };
+
+    /*
+     * 求解期间把Problem标记为被读取；同一个Problem可以同时交给多个Solver，所以按地址计数。
+     * 修改Problem的绑定先调用checkNotSolving，正在求解时抛出RuntimeError。
+     * 租约在持有GIL时取得，检查与修改也都在持有GIL时进行，所以检查之后不会有新的求解插进来；
+     * 后台求解在求解线程上（不持有GIL）归还租约，计数表由互斥锁保护
+     */
+    class ProblemLease {
+    public:
+        explicit ProblemLease(const MIPSolver::Problem& problem) : problem_(problem) {
+            std::lock_guard<std::mutex> lock(mutex());
+            ++counts()[&problem_];
+        }
+        ~ProblemLease() {
+            std::lock_guard<std::mutex> lock(mutex());
+            auto it = counts().find(&problem_);
+            if (--it->second == 0) counts().erase(it);
+        }
+        ProblemLease(const ProblemLease&) = delete;
+        ProblemLease& operator=(const ProblemLease&) = delete;
+
+        static void checkNotSolving(const MIPSolver::Problem& problem) {
+            std::lock_guard<std::mutex> lock(mutex());
+            if (counts().count(&problem)) {
+                throw std::runtime_error("Problem is being solved; wait for the solve to finish before modifying it");
+            }
+        }
+
+    private:
+        static std::mutex& mutex() {
+            static std::mutex instance;
+            return instance;
+        }
+        static std::unordered_map<const MIPSolver::Problem*, int>& counts() {
+            static std::unordered_map<const MIPSolver::Problem*, int> instance;
+            return instance;
+        }
+
+        const MIPSolver::Problem& problem_;
+    };
+
+    // 修改Problem的成员函数：先确认没有正在进行的求解再调用
+    template <typename Result, typename... Args>
+    auto checkedMutator(Result (MIPSolver::Problem::*mutator)(Args...)) {
+        return [mutator](MIPSolver::Problem& problem, Args... args) -> Result {
+            ProblemLease::checkNotSolving(problem);
+            return (problem.*mutator)(args...);
+        };
+    }
+
+    // 把求解器的设置函数包装成先占用Solver的绑定：后台求解期间调用时抛出RuntimeError，而不是与求解线程竞争
+    template <typename Class, typename... Args>
+    auto leasedSetter(void (Class::*setter)(Args...)) {
+        return [setter](PySolver& solver, Args... args) {
+            SolverLease lease(solver);
+            (solver.*setter)(args...);
+        };
+    }
+
+    /*
+     * 新最优解回调
+     *
+     * 在求解线程上调用：获取GIL，把变量值拷贝成NumPy数组交给用户函数。
+     * 用户函数抛出的异常不会中断求解，作为unraisable异常报告
+     */
+    MIPSolver::BranchBoundSolver::IncumbentCallback wrapIncumbentCallback(std::shared_ptr<py::function> callable,
+                                                                           std::atomic<double>* best_objective) {
+        return [callable, best_objective](const std::vector<double>& values, double objective) {
+            if (best_objective) best_objective->store(objective);
+            if (!callable) return;
+            py::gil_scoped_acquire gil;
+            try {
+                (*callable)(py::array_t<double>(static_cast<py::ssize_t>(values.size()), values.data()), objective);
+            } catch (py::error_already_set& e) {
+                e.discard_as_unraisable("incumbent callback");
+            }
+        };
+    }
+
+    // 进度回调：获取GIL后把SolveProgress交给用户函数，用户函数的异常同样作为unraisable异常报告
+    MIPSolver::SolverInterface::ProgressCallback wrapProgressCallback(std::shared_ptr<py::function> callable) {
+        return [callable](const MIPSolver::SolveProgress& progress) {
+            py::gil_scoped_acquire gil;
+            try {
+                (*callable)(progress);
+            } catch (py::error_already_set& e) {
+                e.discard_as_unraisable("progress callback");
+            }
+        };
+    }
+
+    /*
+     * 异步求解句柄
+     *
+     * 构造时占用Solver和Problem并在后台线程上开始求解，求解结束时归还；Solver和Problem的Python对象随句柄保持存活。
+     * 求解期间Problem的修改函数抛出RuntimeError（见ProblemLease），求解读到的始终是开始时的模型。
+     * cancel()置位求解器的停止标志，分支定界在下一个节点处协作式结束，result()返回INTERRUPTED状态
+     * 和已找到的最好解。句柄被销毁时若求解仍在运行，先取消并等待线程结束。
+     */
+    class SolveHandle {
+    public:
+        SolveHandle(py::object solver_object, py::object problem_object)
+            : solver_object_(std::move(solver_object)), problem_object_(std::move(problem_object)),
+              solver_(solver_object_.cast<PySolver&>()), problem_(problem_object_.cast<const MIPSolver::Problem&>()),
+              lease_(std::make_unique<SolverLease>(solver_)), problem_lease_(std::make_unique<ProblemLease>(problem_)),
+              best_objective_(std::numeric_limits<double>::quiet_NaN()) {
+            solver_.setStopFlag(&stop_);
+            solver_.setIncumbentCallback(wrapIncumbentCallback(solver_.incumbent_callback, &best_objective_));
+            thread_ = std::thread([this] { run(); });
+        }
+
+        ~SolveHandle() {
+            stop_.store(true);
+            if (thread_.joinable()) {
+                // The solve thread may be waiting for the GIL inside a callback
+                py::gil_scoped_release release;
+                thread_.join();
+            }
+        }
+
+        SolveHandle(const SolveHandle&) = delete;
+        SolveHandle& operator=(const SolveHandle&) = delete;
+
+        void cancel() { stop_.store(true); }
+        bool cancelRequested() const { return stop_.load(); }
+
+        bool done() const {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return done_;
+        }
+
+        // 等待求解结束；timeout为None时一直等待。返回求解是否已结束
+        bool wait(const py::object& timeout) {
+            bool forever = timeout.is_none();
+            double seconds = forever ? 0.0 : std::max(0.0, timeout.cast<double>());
+            py::gil_scoped_release release;
+            std::unique_lock<std::mutex> lock(mutex_);
+            if (forever) {
+                finished_.wait(lock, [this] { return done_; });
+                return true;
+            }
+            return finished_.wait_for(lock, std::chrono::duration<double>(seconds), [this] { return done_; });
+        }
+
+        // 等待并返回求解结果；超时抛出TimeoutError，求解抛出的异常在这里重新抛出
+        MIPSolver::Solution result(const py::object& timeout) {
+            if (!wait(timeout)) {
+                PyErr_SetString(PyExc_TimeoutError, "solve has not finished");
+                throw py::error_already_set();
+            }
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (error_) std::rethrow_exception(error_);
+            return *solution_;
+        }
+
+        // 目前找到的最好目标值；还没有整数解时为None
+        py::object bestObjective() const {
+            double objective = best_objective_.load();
+            if (std::isnan(objective)) return py::none();
+            return py::float_(objective);
+        }
+
+    private:
+        void run() {
+            std::unique_ptr<MIPSolver::Solution> solution;
+            std::exception_ptr error;
+            try {
+                solution = std::make_unique<MIPSolver::Solution>(solver_.solve(problem_));
+            } catch (...) {
+                error = std::current_exception();
+            }
+            solver_.setStopFlag(nullptr);
+            solver_.setIncumbentCallback(wrapIncumbentCallback(solver_.incumbent_callback, nullptr));
+            lease_.reset();  // The Solver can be reused as soon as this solve has finished
+            problem_lease_.reset();
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                solution_ = std::move(solution);
+                error_ = error;
+                done_ = true;
+            }
+            finished_.notify_all();
+        }
+
+        py::object solver_object_;
+        py::object problem_object_;
+        PySolver& solver_;
+        const MIPSolver::Problem& problem_;
+        std::unique_ptr<SolverLease> lease_;
+        std::unique_ptr<ProblemLease> problem_lease_;
+        std::atomic<bool> stop_{false};
+        std::atomic<double> best_objective_;
+        mutable std::mutex mutex_;
+        std::condition_variable finished_;
+        bool done_ = false;
+        std::unique_ptr<MIPSolver::Solution> solution_;
+        std::exception_ptr error_;
+        std::thread thread_;
+    };
+}
+
 // PYBIND11_MODULE定义Python扩展模块的入口点
 /*
  * 模块定义宏
@@ -63,7 +392,32 @@ PYBIND11_MODULE(_solver, m) {
     py::enum_<MIPSolver::Solution::Status>(m, "SolutionStatus")
         .value("OPTIMAL", MIPSolver::Solution::Status::OPTIMAL)
         .value("INFEASIBLE", MIPSolver::Solution::Status::INFEASIBLE)
-        // ... add other statuses
+        .value("FEASIBLE", MIPSolver::Solution::Status::FEASIBLE)
+        .value("UNBOUNDED", MIPSolver::Solution::Status::UNBOUNDED)
+        .value("ITERATION_LIMIT", MIPSolver::Solution::Status::ITERATION_LIMIT)
+        .value("TIME_LIMIT", MIPSolver::Solution::Status::TIME_LIMIT)
+        .value("UNKNOWN", MIPSolver::Solution::Status::UNKNOWN)
+        .value("INTERRUPTED", MIPSolver::Solution::Status::INTERRUPTED)
+        .value("WORK_LIMIT", MIPSolver::Solution::Status::WORK_LIMIT)
+        .export_values();
+
+    py::enum_<MIPSolver::BranchingRule>(m, "BranchingRule")
+        .value("MOST_FRACTIONAL", MIPSolver::BranchingRule::MOST_FRACTIONAL)
+        .value("PSEUDOCOST", MIPSolver::BranchingRule::PSEUDOCOST)
+        .value("RELIABILITY", MIPSolver::BranchingRule::RELIABILITY)
+        .value("LEARNED", MIPSolver::BranchingRule::LEARNED)
+        .export_values();
+
+    py::enum_<MIPSolver::NodeSelectionRule>(m, "NodeSelectionRule")
+        .value("DEPTH_FIRST", MIPSolver::NodeSelectionRule::DEPTH_FIRST)
+        .value("BEST_BOUND", MIPSolver::NodeSelectionRule::BEST_BOUND)
+        .value("BEST_ESTIMATE", MIPSolver::NodeSelectionRule::BEST_ESTIMATE)
+        .value("HYBRID", MIPSolver::NodeSelectionRule::HYBRID)
+        .export_values();
+
+    py::enum_<MIPSolver::MPSFormat>(m, "MPSFormat")
+        .value("FREE", MIPSolver::MPSFormat::FREE)
+        .value("FIXED", MIPSolver::MPSFormat::FIXED)
         .export_values();
 
 
@@ -74,6 +428,63 @@ PYBIND11_MODULE(_solver, m) {
         .def("get_status", &MIPSolver::Solution::getStatus)
         .def("get_objective_value", &MIPSolver::Solution::getObjectiveValue)
         .def("get_values", &MIPSolver::Solution::getValues, "Returns the solution values as a list of floats.")
+        .def("get_values_array", [](py::object self) {
+            // Zero-copy view of the solution vector; the array keeps the Solution alive through its base
+            const std::vector<double>& values = self.cast<const MIPSolver::Solution&>().getValues();
+            py::array_t<double> view(static_cast<py::ssize_t>(values.size()), values.data(), self);
+            view.attr("setflags")(py::arg("write") = false);
+            return view;
+        }, "Returns the solution values as a read-only NumPy array that shares memory with the Solution.")
+        .def("get_dual_bound", &MIPSolver::Solution::getDualBound,
+             "Best proven bound on the objective; equals the objective value when solved to optimality.")
+        .def("get_gap", &MIPSolver::Solution::getGap,
+             "Relative gap |objective - dual bound| / |objective|; inf without a solution.")
+        .def("get_node_count", &MIPSolver::Solution::getNodeCount)
+        .def("get_open_nodes", &MIPSolver::Solution::getOpenNodes, "Nodes left unexplored when the solve stopped.")
+        .def("get_solve_time", &MIPSolver::Solution::getSolveTime)
+        .def("get_work_units", &MIPSolver::Solution::getWorkUnits,
+             "Deterministic work spent by the solve (millions of LP nonzeros touched).")
+        .def("get_incumbent_history", [](const MIPSolver::Solution &s) {
+            py::list history;
+            for (const auto& record : s.getIncumbentHistory()) {
+                history.append(py::make_tuple(record.time, record.nodes, record.objective));
+            }
+            return history;
+        }, "Returns the improving solutions as a list of (seconds, nodes, objective) tuples, oldest first.")
+        .def("get_solution_pool", [](const MIPSolver::Solution &s) {
+            py::list pool;
+            for (const auto& entry : s.getSolutionPool()) {
+                pool.append(py::make_tuple(entry.objective, entry.values));
+            }
+            return pool;
+        }, "Returns the best distinct solutions found as a list of (objective, values) tuples, best first.")
+        .def("get_profile", [](const MIPSolver::Solution &s) {
+            namespace Instr = MIPSolver::Instrumentation;
+            const Instr::Profile& profile = s.getProfile();
+            py::dict phases, counters;
+            for (int p = 0; p < Instr::kNumPhases; ++p) {
+                Instr::Phase phase = static_cast<Instr::Phase>(p);
+                phases[Instr::phaseName(phase)] = py::make_tuple(profile.calls(phase), profile.seconds(phase));
+            }
+            for (int c = 0; c < Instr::kNumCounters; ++c) {
+                Instr::Counter counter = static_cast<Instr::Counter>(c);
+                counters[Instr::counterName(counter)] = profile.count(counter);
+            }
+            py::dict result;
+            result["enabled"] = profile.enabled();
+            result["threads"] = profile.numThreads();
+            result["phases"] = phases;
+            result["counters"] = counters;
+            return result;
+        }, "Phase timings {name: (calls, seconds)} and counters of the solve; empty unless built with MIPSOLVER_ENABLE_INSTRUMENTATION.")
+        .def("write_trace", [](const MIPSolver::Solution &s, const std::string &filename) {
+            if (!s.getProfile().enabled()) {
+                throw std::runtime_error("write_trace requires a build with MIPSOLVER_ENABLE_INSTRUMENTATION");
+            }
+            if (!s.getProfile().writeChromeTrace(filename)) {
+                throw std::runtime_error("cannot write trace file: " + filename);
+            }
+        }, py::arg("filename"), "Writes the solve's phase timings as a Chrome/Perfetto trace (JSON).")
         .def("__repr__", [](const MIPSolver::Solution &s) {
             return "<mipsolver.Solution objective=" + std::to_string(s.getObjectiveValue()) + ">";
         });
@@ -82,19 +493,314 @@ PYBIND11_MODULE(_solver, m) {
     // Bind the Problem class
     py::class_<MIPSolver::Problem>(m, "Problem")
         .def(py::init<const std::string&, MIPSolver::ObjectiveType>(), py::arg("name"), py::arg("objective_type"))
-        .def("add_variable", &MIPSolver::Problem::addVariable, py::arg("name"), py::arg("type") = MIPSolver::VariableType::CONTINUOUS)
-        .def("set_objective_coefficient", &MIPSolver::Problem::setObjectiveCoefficient, py::arg("var_index"), py::arg("coeff"))
-        .def("add_constraint", &MIPSolver::Problem::addConstraint, py::arg("name"), py::arg("type"), py::arg("rhs"))
+        .def("add_variable", checkedMutator(&MIPSolver::Problem::addVariable), py::arg("name"), py::arg("type") = MIPSolver::VariableType::CONTINUOUS)
+        .def("set_objective_coefficient", checkedMutator(&MIPSolver::Problem::setObjectiveCoefficient), py::arg("var_index"), py::arg("coeff"))
+        .def("add_constraint", [](MIPSolver::Problem &p, const std::string& name, MIPSolver::ConstraintType type, double rhs,
+                                  const py::object& indices, const py::object& values) {
+            ProblemLease::checkNotSolving(p);
+            if (indices.is_none() != values.is_none()) {
+                throw py::value_error("indices and values must be given together");
+            }
+            if (indices.is_none()) return p.addConstraint(name, type, rhs);
+            return p.addConstraint(name, type, rhs, indices.cast<std::vector<int>>(), values.cast<std::vector<double>>());
+        }, py::arg("name"), py::arg("type"), py::arg("rhs"), py::arg("indices") = py::none(), py::arg("values") = py::none(),
+           "Adds a constraint and returns its index. Passing the coefficients here (rather than through "
+           "add_constraint_coefficient) records the change as a new row only, so a warm-started Solver keeps its cuts.")
         .def("add_constraint_coefficient", [](MIPSolver::Problem &p, int c_idx, int v_idx, double coeff) {
-            p.getConstraint(c_idx).addVariable(v_idx, coeff);
+            ProblemLease::checkNotSolving(p);
+            p.addConstraintCoefficient(c_idx, v_idx, coeff);
         }, py::arg("constraint_index"), py::arg("var_index"), py::arg("coeff"))
-        .def("set_variable_bounds", [](MIPSolver::Problem &p, int v_idx, double lower, double upper) {
-            p.getVariable(v_idx).setBounds(lower, upper);
-        }, py::arg("var_index"), py::arg("lower"), py::arg("upper"));
+        .def("set_variable_bounds", checkedMutator(&MIPSolver::Problem::setVariableBounds), py::arg("var_index"), py::arg("lower"), py::arg("upper"))
+        .def("set_constraint_rhs", checkedMutator(&MIPSolver::Problem::setConstraintRHS), py::arg("constraint_index"), py::arg("rhs"))
+        .def("set_variable_type", checkedMutator(&MIPSolver::Problem::setVariableType), py::arg("var_index"), py::arg("type"))
+        .def("remove_constraints", checkedMutator(&MIPSolver::Problem::removeConstraints), py::arg("indices"),
+             "Removes the given constraints; the remaining ones keep their order and move up.")
+        .def_property("keep_names", &MIPSolver::Problem::getKeepNames, checkedMutator(&MIPSolver::Problem::setKeepNames),
+                      "When False, variable and constraint names are dropped and reported as x<index> / c<index>.")
+        .def("get_variable_name", [](const MIPSolver::Problem &p, int index) {
+            checkIndex(index, p.getNumVariables(), "variable");
+            return p.getVariableName(index);
+        }, py::arg("index"))
+        .def("get_constraint_name", [](const MIPSolver::Problem &p, int index) {
+            checkIndex(index, p.getNumConstraints(), "constraint");
+            return p.getConstraintName(index);
+        }, py::arg("index"))
+        .def_property_readonly("revision", &MIPSolver::Problem::getRevision,
+                               "Increases with every change made through the Problem methods.")
+        .def("add_variables", [](MIPSolver::Problem &p, const DoubleArray& lower, const DoubleArray& upper,
+                                 const DoubleArray& objective, const IntArray& types, const py::object& names) {
+            ProblemLease::checkNotSolving(p);
+            py::ssize_t count = checkVector(lower, "lower");
+            checkVector(upper, "upper", count);
+            checkVector(objective, "objective", count);
+            checkVector(types, "types", count);
+            std::vector<MIPSolver::VariableType> var_types = toEnumVector<MIPSolver::VariableType>(types, "types", 3);
+            std::vector<std::string> var_names = toNames(names, count);
+            return p.addVariables(static_cast<int>(count), lower.data(), upper.data(), objective.data(),
+                                  var_types.data(), var_names.empty() ? nullptr : var_names.data());
+        }, py::arg("lower"), py::arg("upper"), py::arg("objective"), py::arg("types"), py::arg("names") = py::none(),
+           "Adds one variable per array entry and returns the index of the first one.")
+        .def("add_constraints_csr", [](MIPSolver::Problem &p, const IntArray& indptr, const IntArray& indices,
+                                       const DoubleArray& data, const IntArray& types, const DoubleArray& rhs,
+                                       const py::object& names) {
+            ProblemLease::checkNotSolving(p);
+            py::ssize_t rows_plus_one = checkVector(indptr, "indptr");
+            if (rows_plus_one == 0) {
+                throw py::value_error("indptr must have at least one entry");
+            }
+            py::ssize_t count = rows_plus_one - 1;
+            py::ssize_t nnz = checkVector(indices, "indices");
+            checkVector(data, "data", nnz);
+            checkVector(types, "types", count);
+            checkVector(rhs, "rhs", count);
+            if (indptr.data()[count] > nnz) {
+                throw py::value_error("indptr[-1] exceeds the length of indices");
+            }
+            std::vector<MIPSolver::ConstraintType> row_types = toEnumVector<MIPSolver::ConstraintType>(types, "types", 3);
+            std::vector<std::string> row_names = toNames(names, count);
+            return p.addConstraintsCSR(static_cast<int>(count), row_types.data(), rhs.data(), indptr.data(),
+                                       indices.data(), data.data(), row_names.empty() ? nullptr : row_names.data());
+        }, py::arg("indptr"), py::arg("indices"), py::arg("data"), py::arg("types"), py::arg("rhs"),
+           py::arg("names") = py::none(),
+           "Adds constraints whose coefficients are given as CSR arrays (scipy.sparse.csr_matrix indptr/indices/data) "
+           "and returns the index of the first one.")
+        .def("evaluate_solutions", [](const MIPSolver::Problem &p, const DoubleArray& solutions) {
+            if (solutions.ndim() != 2 || solutions.shape(1) != p.getNumVariables()) {
+                throw py::value_error("solutions must have shape (count, " + std::to_string(p.getNumVariables()) + ")");
+            }
+            const py::ssize_t count = solutions.shape(0);
+            const py::ssize_t n = solutions.shape(1);
+            const double* rows = solutions.data();
+            std::vector<std::vector<double>> candidates(count);
+            for (py::ssize_t s = 0; s < count; ++s) {
+                candidates[s].assign(rows + s * n, rows + (s + 1) * n);
+            }
+            std::vector<double> objectives, max_violations;
+            {
+                py::gil_scoped_release release;
+                p.evaluateSolutions(candidates, objectives, max_violations);
+            }
+            return py::make_tuple(py::array_t<double>(count, objectives.data()),
+                                  py::array_t<double>(count, max_violations.data()));
+        }, py::arg("solutions"),
+           "Evaluates each row of a (count, num_variables) array and returns (objectives, max_violations); "
+           "a row is feasible within tol when its max violation is <= tol.")
+        .def("save_binary", [](const MIPSolver::Problem &p, const std::string& filename, bool include_names) {
+            MIPSolver::ProblemSnapshot::save(p, filename, include_names);
+        }, py::arg("filename"), py::arg("include_names") = true,
+           "Writes a binary snapshot that load_binary reloads without parsing.")
+        .def_static("load_binary", &MIPSolver::ProblemSnapshot::load, py::arg("filename"),
+                    "Loads a Problem from a binary snapshot file.");
+
+    // Bind the MPS parser
+    py::class_<MIPSolver::MPSParser>(m, "MPSParser")
+        .def_static("parse_from_file", &MIPSolver::MPSParser::parseFromFile, py::arg("filename"),
+                    py::arg("format") = MIPSolver::MPSFormat::FREE, py::arg("num_threads") = 1,
+                    py::arg("keep_names") = true,
+                    "Reads a plain, gzip or zstd MPS file into a Problem; num_threads > 1 parses COLUMNS in parallel. "
+                    "keep_names=False drops row and column names to save memory.")
+        .def_static("parse_from_string", [](const std::string& content, const std::string& name,
+                                            MIPSolver::MPSFormat format, int num_threads, bool keep_names) {
+            return MIPSolver::MPSParser::parseFromString(content, name, format, num_threads, keep_names);
+        }, py::arg("content"), py::arg("name") = "MIP", py::arg("format") = MIPSolver::MPSFormat::FREE,
+           py::arg("num_threads") = 1, py::arg("keep_names") = true);
+
+    // Snapshot passed to progress callbacks
+    py::class_<MIPSolver::SolveProgress> progress(m, "SolveProgress");
+    py::enum_<MIPSolver::SolveProgress::Event>(progress, "Event")
+        .value("INCUMBENT", MIPSolver::SolveProgress::Event::INCUMBENT)
+        .value("INTERVAL", MIPSolver::SolveProgress::Event::INTERVAL)
+        .export_values();
+    progress
+        .def_readonly("event", &MIPSolver::SolveProgress::event)
+        .def_readonly("time", &MIPSolver::SolveProgress::time)
+        .def_readonly("nodes", &MIPSolver::SolveProgress::nodes)
+        .def_readonly("open_nodes", &MIPSolver::SolveProgress::open_nodes)
+        .def_readonly("objective", &MIPSolver::SolveProgress::objective)
+        .def_readonly("dual_bound", &MIPSolver::SolveProgress::dual_bound)
+        .def_readonly("gap", &MIPSolver::SolveProgress::gap)
+        .def("__repr__", [](const MIPSolver::SolveProgress &p) {
+            return "<mipsolver.SolveProgress nodes=" + std::to_string(p.nodes) + " objective=" +
+                   std::to_string(p.objective) + " bound=" + std::to_string(p.dual_bound) +
+                   " gap=" + std::to_string(p.gap) + ">";
+        });
+
+    // Handle of a solve running on a background thread
+    py::class_<SolveHandle>(m, "SolveHandle")
+        .def("done", &SolveHandle::done, "True once the solve has finished (normally, cancelled or with an error).")
+        .def("cancel", &SolveHandle::cancel,
+             "Requests cooperative cancellation; the solve stops at the next branch-and-bound node.")
+        .def("cancel_requested", &SolveHandle::cancelRequested)
+        .def("wait", &SolveHandle::wait, py::arg("timeout") = py::none(),
+             "Blocks without holding the GIL until the solve finishes or timeout seconds pass; returns done().")
+        .def("result", &SolveHandle::result, py::arg("timeout") = py::none(),
+             "Waits for and returns the Solution; raises TimeoutError if it is not ready in time.")
+        .def("best_objective", &SolveHandle::bestObjective,
+             "Objective of the best integer solution found so far, or None.");
 
     // Bind the Solver class
-    py::class_<MIPSolver::BranchBoundSolver>(m, "Solver")
+    py::class_<PySolver>(m, "Solver")
         .def(py::init<>())
-        .def("set_verbose", &MIPSolver::BranchBoundSolver::setVerbose, py::arg("verbose"))
-        .def("solve", &MIPSolver::BranchBoundSolver::solve, py::arg("problem"), "Solves the given optimization problem.");
+        .def("set_verbose", leasedSetter(&MIPSolver::BranchBoundSolver::setVerbose), py::arg("verbose"))
+        .def("set_num_threads", leasedSetter(&MIPSolver::BranchBoundSolver::setNumThreads), py::arg("num_threads"),
+             "Sets the number of branch-and-bound worker threads (0 = all hardware threads).")
+        .def("set_branching_rule", leasedSetter(&MIPSolver::BranchBoundSolver::setBranchingRule), py::arg("rule"))
+        .def("set_node_selection", leasedSetter(&MIPSolver::BranchBoundSolver::setNodeSelection), py::arg("rule"))
+        .def("set_presolve", leasedSetter(&MIPSolver::BranchBoundSolver::setPresolve), py::arg("enable"))
+        .def("set_cutting_planes", leasedSetter(&MIPSolver::BranchBoundSolver::setCuttingPlanes), py::arg("enable"),
+             "Enables root-node Gomory and knapsack cover cuts with a cut pool.")
+        .def("set_max_cut_rounds", leasedSetter(&MIPSolver::BranchBoundSolver::setMaxCutRounds), py::arg("max_rounds"))
+        .def("set_alns", leasedSetter(&MIPSolver::BranchBoundSolver::setALNS), py::arg("enable"),
+             "Runs the adaptive large neighborhood search heuristic on its own thread during tree search.")
+        .def("set_domain_propagation", leasedSetter(&MIPSolver::BranchBoundSolver::setDomainPropagation), py::arg("enable"),
+             "Enables bound propagation at every branch-and-bound node before its LP is solved.")
+        .def("set_binary_specialization", leasedSetter(&MIPSolver::BranchBoundSolver::setBinarySpecialization), py::arg("enable"),
+             "Uses bitset domains and the 0-1 node routines when every column is binary (on by default).")
+        .def("set_deterministic", leasedSetter(&MIPSolver::BranchBoundSolver::setDeterministic), py::arg("deterministic"),
+             "Uses the reproducible synchronized-round parallel search.")
+        .def("set_time_limit", leasedSetter(&MIPSolver::BranchBoundSolver::setTimeLimit), py::arg("seconds"),
+             "Wall-clock limit for a solve, including presolve and long LPs; 0 disables it.")
+        .def("set_work_limit", leasedSetter(&MIPSolver::BranchBoundSolver::setWorkLimit), py::arg("work_units"),
+             "Deterministic work budget in millions of LP nonzeros touched; 0 disables it. "
+             "Unlike the time limit it stops at the same node on every machine.")
+        .def("set_node_limit", leasedSetter(&MIPSolver::BranchBoundSolver::setIterationLimit), py::arg("max_nodes"))
+        .def("set_random_seed", leasedSetter(&MIPSolver::BranchBoundSolver::setRandomSeed), py::arg("seed"),
+             "Seed of the concurrent ALNS heuristic (default 42).")
+        .def("set_objective_cutoff", [](PySolver &s, const py::object& cutoff) {
+            SolverLease lease(s);
+            s.setObjectiveCutoff(cutoff.is_none() ? std::numeric_limits<double>::quiet_NaN() : cutoff.cast<double>());
+        }, py::arg("cutoff"),
+           "Only accepts solutions strictly better than cutoff and prunes nodes that cannot beat it (None removes it). "
+           "A complete search without such a solution reports INFEASIBLE.")
+        .def("set_relative_gap", leasedSetter(&MIPSolver::BranchBoundSolver::setRelativeGap), py::arg("gap"),
+             "Stops proving optimality once the gap to the best bound is within gap * |objective|.")
+        .def("set_absolute_gap", leasedSetter(&MIPSolver::BranchBoundSolver::setAbsoluteGap), py::arg("gap"))
+        .def("set_warm_start", [](PySolver &s, bool enable) {
+            SolverLease lease(s);
+            s.setWarmStart(enable);
+        }, py::arg("enable"),
+           "Keep the root basis, pseudocosts, root cuts and best solution between solves of the same Problem. "
+           "The next solve after small changes (bounds, right-hand sides, objective, added or removed rows) "
+           "starts from them; the previous solution is repaired against the new data.")
+        .def("clear_warm_start", [](PySolver &s) {
+            SolverLease lease(s);
+            s.clearWarmStart();
+        }, "Drops the state kept by set_warm_start; the next solve starts from scratch.")
+        .def("add_mip_start", [](PySolver &s, const DoubleArray& values, const py::object& indices) {
+            py::ssize_t count = checkVector(values, "values");
+            const double* data = values.data();
+            SolverLease lease(s);
+            if (indices.is_none()) {
+                s.addMIPStart(std::vector<double>(data, data + count));
+                return;
+            }
+            IntArray index_array = indices.cast<IntArray>();
+            checkVector(index_array, "indices", count);
+            s.addMIPStart(std::vector<int>(index_array.data(), index_array.data() + count),
+                          std::vector<double>(data, data + count));
+        }, py::arg("values"), py::arg("indices") = py::none(),
+           "Adds a starting solution. Without indices, values[j] is the value of variable j and NaN leaves it "
+           "unspecified; with indices, values[k] is the value of variable indices[k]. Partial starts are "
+           "completed by a node-limited sub-MIP; feasible starts become the initial incumbent.")
+        .def("clear_mip_starts", [](PySolver &s) {
+            SolverLease lease(s);
+            s.clearMIPStarts();
+        })
+        .def("set_solution_pool_size", [](PySolver &s, int size) {
+            SolverLease lease(s);
+            s.setSolutionPoolSize(size);
+        }, py::arg("size"), "Number of best distinct solutions kept in Solution.get_solution_pool() (default 10).")
+        .def("set_incumbent_callback", [](PySolver &s, const py::object& callback) {
+            SolverLease lease(s);
+            s.incumbent_callback = callback.is_none() ? nullptr : holdCallable(callback.cast<py::function>());
+            s.setIncumbentCallback(s.incumbent_callback ? wrapIncumbentCallback(s.incumbent_callback, nullptr)
+                                                        : MIPSolver::BranchBoundSolver::IncumbentCallback());
+        }, py::arg("callback"),
+           "Calls callback(values, objective) whenever a better integer solution is found (None to remove). "
+           "It runs on a solver thread and holds the GIL only while it executes.")
+        .def("set_progress_callback", [](PySolver &s, const py::object& callback, double interval) {
+            SolverLease lease(s);
+            s.progress_callback = callback.is_none() ? nullptr : holdCallable(callback.cast<py::function>());
+            s.setProgressCallback(s.progress_callback ? wrapProgressCallback(s.progress_callback)
+                                                      : MIPSolver::SolverInterface::ProgressCallback(), interval);
+        }, py::arg("callback"), py::arg("interval") = 1.0,
+           "Calls callback(SolveProgress) on every new incumbent and every interval seconds (0 = incumbents only); "
+           "None removes it. It runs on a solver thread and holds the GIL only while it executes.")
+        .def("solve", [](PySolver &s, const MIPSolver::Problem& problem) {
+            SolverLease lease(s);
+            ProblemLease problem_lease(problem);
+            py::gil_scoped_release release;
+            return s.solve(problem);
+        }, py::arg("problem"), "Solves the given optimization problem; the GIL is released while it runs.")
+        .def("solve_batch", [](PySolver &s, const std::vector<const MIPSolver::Problem*>& problems, const py::object& callback) {
+            for (const MIPSolver::Problem* problem : problems) {
+                if (!problem) throw py::value_error("problems must not contain None");
+            }
+            SolverLease lease(s);
+            std::vector<std::unique_ptr<ProblemLease>> problem_leases;
+            for (const MIPSolver::Problem* problem : problems) {
+                problem_leases.push_back(std::make_unique<ProblemLease>(*problem));
+            }
+            std::shared_ptr<py::function> on_done = callback.is_none() ? nullptr : holdCallable(callback.cast<py::function>());
+            static MIPSolver::BatchSolver pool;
+
+            std::vector<std::unique_ptr<MIPSolver::Solution>> solutions(problems.size());
+            std::vector<std::exception_ptr> errors(problems.size());
+            {
+                py::gil_scoped_release release;
+                pool.solve(problems,
+                    [&s](MIPSolver::BranchBoundSolver& solver, size_t) { solver.copySettings(s); },
+                    [&](size_t index, std::unique_ptr<MIPSolver::Solution> solution, std::exception_ptr error) {
+                        if (on_done && solution) {
+                            py::gil_scoped_acquire gil;
+                            try {
+                                (*on_done)(index, *solution);
+                            } catch (py::error_already_set& e) {
+                                e.discard_as_unraisable("batch callback");
+                            }
+                        }
+                        solutions[index] = std::move(solution);
+                        errors[index] = error;
+                    });
+            }
+            py::list result;
+            for (size_t i = 0; i < problems.size(); ++i) {
+                if (errors[i]) std::rethrow_exception(errors[i]);
+                result.append(std::move(*solutions[i]));
+            }
+            return result;
+        }, py::arg("problems"), py::arg("callback") = py::none(),
+           "Solves independent problems on a persistent internal thread pool with this solver's settings and "
+           "returns the solutions in input order. callback(index, solution), if given, runs on a pool thread "
+           "(holding the GIL) as each problem finishes. The GIL is released while the batch runs; the problems "
+           "cannot be modified until it returns.")
+        .def("solve_race", [](PySolver &s, const MIPSolver::Problem& problem) {
+            SolverLease lease(s);
+            ProblemLease problem_lease(problem);
+            MIPSolver::PortfolioSolver portfolio;
+            portfolio.setSolutionPoolSize(s.getSolutionPoolSize());
+            for (const MIPSolver::SolverInterface::MIPStart& start : s.getMIPStarts()) {
+                portfolio.addMIPStart(start.indices, start.values);
+            }
+            // Every racer takes this solver's settings and keeps only its own strategies and seed
+            const std::vector<MIPSolver::PortfolioSolver::Racer> racers = portfolio.getRacers();
+            portfolio.setConfigure([&s, &racers](MIPSolver::BranchBoundSolver& solver, size_t index) {
+                solver.copySettings(s);  // limits and threads included; the callbacks are replaced by the portfolio's
+                solver.setNodeSelection(racers[index].node_selection);
+                solver.setBranchingRule(racers[index].branching_rule);
+                solver.setRandomSeed(racers[index].seed);
+            });
+            if (s.incumbent_callback) portfolio.setIncumbentCallback(wrapIncumbentCallback(s.incumbent_callback, nullptr));
+            if (s.progress_callback) portfolio.setProgressCallback(wrapProgressCallback(s.progress_callback), s.getProgressInterval());
+            py::gil_scoped_release release;
+            return portfolio.solve(problem);
+        }, py::arg("problem"),
+           "Races differently configured copies of this solver (node selection, branching rule, ALNS seed) on one "
+           "thread each; they share incumbents, the first to finish its proof wins and the others are stopped. "
+           "Limits apply to every racer. The GIL is released while it runs.")
+        .def("solve_async", [](py::object self, py::object problem) {
+            return std::make_unique<SolveHandle>(std::move(self), std::move(problem));
+        }, py::arg("problem"),
+           "Starts solving on a background thread and returns a SolveHandle. "
+           "Modifying the problem raises RuntimeError until the solve has finished.");
 }
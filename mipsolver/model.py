@@ -34,7 +34,8 @@ model.optimize()
 ```
 """
 
-from typing import Optional, Union, List, Dict, Any
+import math
+from typing import Optional, Union, List, Dict, Any, Callable
 from .constants import *
 from .expressions import LinExpr
 from .exceptions import MIPSolverError, OptimizationError
@@ -266,6 +267,10 @@ class Model:
         self._obj_val = 0.0
         self._iterations = 0
         self._solve_log = []
+        self._gap = float('inf')
+        self._obj_bound = None
+        self._progress_callback = None
+        self._progress_interval = 1.0
         
         # 尝试导入C++求解器后端
         # 这将由编译的扩展模块提供
@@ -325,6 +330,34 @@ class Model:
         """
         return self._solve_log.copy()
     
+    @property
+    def mip_gap(self) -> float:
+        """
+        最终的相对最优性间隙 |目标值 - 对偶界| / |目标值|
+        仅在调用optimize()后有效；没有可行解时为inf
+        """
+        return self._gap
+    
+    @property
+    def obj_bound(self) -> Optional[float]:
+        """
+        求解证明的目标值界（最小化为下界，最大化为上界）
+        仅在使用C++后端调用optimize()后有效
+        """
+        return self._obj_bound
+    
+    def set_progress_callback(self, callback: Optional[Callable], interval: float = 1.0):
+        """
+        注册求解进度回调
+        
+        Args:
+            callback: callback(progress)，progress带有event、time、nodes、open_nodes、
+                      objective、dual_bound、gap属性；在每个新最优解和每隔interval秒时调用，None取消
+            interval: 定时报告的间隔（秒），0表示只在新最优解时报告
+        """
+        self._progress_callback = callback
+        self._progress_interval = interval
+    
     def add_var(self, 
                 lb: float = 0.0, 
                 ub: float = float('inf'), 
@@ -426,7 +459,7 @@ class Model:
         from .solver_monitor import SolverMonitor
         
         # 初始化监控器
-        monitor = SolverMonitor()
+        monitor = SolverMonitor(self._progress_callback)
         monitor.start_solve(self._name, len(self._variables), len(self._constraints))
         
         try:
@@ -438,21 +471,27 @@ class Model:
                 monitor.log("构建C++求解器问题...")
                 cpp_problem = self._build_cpp_problem()
                 
-                # 模拟求解过程（因为C++后端不提供详细信息）
-                problem_size = monitor.get_problem_size(len(self._variables), len(self._constraints))
-                monitor.simulate_solve_process(problem_size)
-                
-                # 使用C++后端求解
+                # 使用C++后端求解；监控器通过进度回调记录节点数、对偶界和间隙
                 monitor.log("调用C++求解器...")
-                solution = self._solver.solve(cpp_problem)
+                self._solver.set_progress_callback(monitor.on_progress, self._progress_interval)
+                try:
+                    solution = self._solver.solve(cpp_problem)
+                finally:
+                    self._solver.set_progress_callback(None)
                 
                 # 提取结果
                 self._status = solution.get_status()
                 self._solved = True
+                self._gap = solution.get_gap()
+                self._obj_bound = solution.get_dual_bound()
+                monitor.iterations = solution.get_node_count()
+                gap_text = f"{self._gap * 100:.4f}%" if math.isfinite(self._gap) else "-"
+                monitor.log(f"节点数: {monitor.iterations}, 对偶界: {self._obj_bound:.6g}, 间隙: {gap_text}")
                 
                 if self._status.value == OPTIMAL:
                     self._obj_val = solution.get_objective_value()
-                    solution_values = solution.get_values()
+                    # 零拷贝的NumPy视图，tolist()一次性转换为Python浮点数
+                    solution_values = solution.get_values_array().tolist()
                     
                     # 更新变量值
                     for i, var in enumerate(self._variables):
@@ -522,47 +561,64 @@ class Model:
         
         这是我们从Python表示转换到C++求解器内部格式的地方。
         此方法在用户友好的Python API和高性能C++求解器核心之间架起桥梁。
+        
+        变量的边界、类型、目标系数和约束矩阵先在Python端收集成NumPy数组（约束为CSR格式），
+        再通过add_variables / add_constraints_csr一次性传给C++，而不是每个系数调用一次绑定函数。
         """
-        # C++ problem is built using the _solver module
+        import numpy as np
         
         # 创建C++问题对象
         obj_type = mipsolver._solver.ObjectiveType.MAXIMIZE if self._objective_sense == MAXIMIZE else mipsolver._solver.ObjectiveType.MINIMIZE
         problem = mipsolver._solver.Problem(self._name, obj_type)
         
         # 向C++问题添加变量
-        for var in self._variables:
-            vtype_map = {
-                CONTINUOUS: mipsolver._solver.VariableType.CONTINUOUS,
-                BINARY: mipsolver._solver.VariableType.BINARY,
-                INTEGER: mipsolver._solver.VariableType.INTEGER
-            }
-            cpp_vtype = vtype_map[var.vtype]
-            
-            var_index = problem.add_variable(var.name, cpp_vtype)
-            problem.set_variable_bounds(var_index, var.lb, var.ub)
+        vtype_map = {
+            CONTINUOUS: int(mipsolver._solver.VariableType.CONTINUOUS),
+            BINARY: int(mipsolver._solver.VariableType.BINARY),
+            INTEGER: int(mipsolver._solver.VariableType.INTEGER)
+        }
+        num_vars = len(self._variables)
+        lower = np.fromiter((var.lb for var in self._variables), dtype=np.float64, count=num_vars)
+        upper = np.fromiter((var.ub for var in self._variables), dtype=np.float64, count=num_vars)
+        types = np.fromiter((vtype_map[var.vtype] for var in self._variables), dtype=np.intc, count=num_vars)
         
         # 设置目标系数
+        objective = np.zeros(num_vars, dtype=np.float64)
         if self._objective_expr:
             for var, coeff in self._objective_expr.get_terms():
-                problem.set_objective_coefficient(var._index, coeff)
+                objective[var._index] = coeff
+        
+        problem.add_variables(lower, upper, objective, types, [var.name for var in self._variables])
         
         # 添加约束
+        sense_map = {
+            LESS_EQUAL: int(mipsolver._solver.ConstraintType.LESS_EQUAL),
+            GREATER_EQUAL: int(mipsolver._solver.ConstraintType.GREATER_EQUAL),
+            EQUAL: int(mipsolver._solver.ConstraintType.EQUAL)
+        }
+        indptr = [0]
+        indices = []
+        data = []
         for constraint in self._constraints:
-            sense_map = {
-                LESS_EQUAL: mipsolver._solver.ConstraintType.LESS_EQUAL,
-                GREATER_EQUAL: mipsolver._solver.ConstraintType.GREATER_EQUAL,
-                EQUAL: mipsolver._solver.ConstraintType.EQUAL
-            }
-            cpp_sense = sense_map[constraint.sense]
-            
-            constr_index = problem.add_constraint(constraint.name, cpp_sense, float(constraint.rhs))
-            
-            # 添加约束系数
+            # 约束系数
             if isinstance(constraint.lhs, Var):
-                problem.add_constraint_coefficient(constr_index, constraint.lhs._index, 1.0)
+                indices.append(constraint.lhs._index)
+                data.append(1.0)
             elif isinstance(constraint.lhs, LinExpr):
                 for var, coeff in constraint.lhs.get_terms():
-                    problem.add_constraint_coefficient(constr_index, var._index, coeff)
+                    indices.append(var._index)
+                    data.append(coeff)
+            indptr.append(len(indices))
+        
+        num_constrs = len(self._constraints)
+        problem.add_constraints_csr(
+            np.asarray(indptr, dtype=np.intc),
+            np.asarray(indices, dtype=np.intc),
+            np.asarray(data, dtype=np.float64),
+            np.fromiter((sense_map[c.sense] for c in self._constraints), dtype=np.intc, count=num_constrs),
+            np.fromiter((float(c.rhs) for c in self._constraints), dtype=np.float64, count=num_constrs),
+            [c.name for c in self._constraints]
+        )
         
         return problem
     
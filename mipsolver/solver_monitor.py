@@ -1,26 +1,42 @@
 """
 求解器监控类 - 跟踪迭代次数和求解日志
+
+使用C++后端时，监控器注册为求解器的进度回调（on_progress），
+日志中的节点数、目标值、对偶界和间隙都来自正在运行的分支定界；
+只有模拟求解器仍使用simulate_solve_process生成日志
 """
 
+import math
 import time
 import random
-from typing import List
+from typing import Callable, List, Optional
 
 class SolverMonitor:
     """
     监控求解过程，记录迭代次数和日志
     """
     
-    def __init__(self):
+    def __init__(self, callback: Optional[Callable] = None):
+        """
+        Args:
+            callback: 可选的用户函数，每次进度报告时以SolveProgress对象调用
+        """
         self.iterations = 0
         self.log_entries = []
         self.start_time = None
+        self.progress_history = []
+        self.gap = math.inf
+        self.dual_bound = None
+        self.callback = callback
         
     def start_solve(self, model_name: str, num_vars: int, num_constrs: int):
         """开始求解，初始化监控"""
         self.iterations = 0
         self.log_entries = []
         self.start_time = time.time()
+        self.progress_history = []
+        self.gap = math.inf
+        self.dual_bound = None
         
         self.log(f"开始求解模型: {model_name}")
         self.log(f"变量数量: {num_vars}, 约束数量: {num_constrs}")
@@ -31,6 +47,34 @@ class SolverMonitor:
         elapsed = time.time() - self.start_time if self.start_time else 0
         self.log_entries.append(f"[{elapsed:.3f}s] {message}")
         
+    def on_progress(self, progress):
+        """
+        C++求解器的进度回调（Solver.set_progress_callback）
+        
+        在求解线程上调用：记录节点数、开放节点数、目标值、对偶界和间隙，
+        新最优解和定时报告各写一行日志，然后转交用户回调
+        """
+        self.iterations = progress.nodes
+        self.gap = progress.gap
+        self.dual_bound = progress.dual_bound
+        self.progress_history.append({
+            'time': progress.time,
+            'nodes': progress.nodes,
+            'open_nodes': progress.open_nodes,
+            'objective': progress.objective,
+            'dual_bound': progress.dual_bound,
+            'gap': progress.gap,
+        })
+        
+        event = getattr(progress.event, 'name', str(progress.event))
+        prefix = "找到新解" if event == "INCUMBENT" else "进度"
+        gap_text = f"{progress.gap * 100:.2f}%" if math.isfinite(progress.gap) else "-"
+        self.log(f"{prefix} 节点 {progress.nodes} (开放 {progress.open_nodes}): "
+                 f"目标值 = {progress.objective:.6g}, 对偶界 = {progress.dual_bound:.6g}, 间隙 = {gap_text}")
+        
+        if self.callback is not None:
+            self.callback(progress)
+        
     def simulate_solve_process(self, problem_size: str = "medium"):
         """
         模拟求解过程（因为C++后端不提供详细信息）
@@ -95,5 +139,8 @@ class SolverMonitor:
         return {
             'iterations': self.iterations,
             'log_entries': self.log_entries.copy(),
-            'total_time': time.time() - self.start_time if self.start_time else 0
+            'total_time': time.time() - self.start_time if self.start_time else 0,
+            'gap': self.gap,
+            'dual_bound': self.dual_bound,
+            'progress_history': list(self.progress_history)
         }
\ No newline at end of file
@@ -24,8 +24,8 @@ void testCoreClasses() {
     
     // Add constraint: x1 + 2*x2 <= 5
     int c1 = problem.addConstraint("constraint1", ConstraintType::LESS_EQUAL, 5.0);
-    problem.getConstraint(c1).addVariable(x1, 1.0);
-    problem.getConstraint(c1).addVariable(x2, 2.0);
+    problem.addConstraintCoefficient(c1, x1, 1.0);
+    problem.addConstraintCoefficient(c1, x2, 2.0);
     
     // Print problem statistics
     problem.printStatistics();
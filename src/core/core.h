@@ -23,33 +23,45 @@
  *    - 类型安全的枚举，避免魔术数字
  * 
  * 4. 性能考虑：
- *    - 使用unordered_map实现O(1)系数查找
+ *    - 约束系数由Problem统一保存为连续的CSR稀疏矩阵（按需生成CSC列视图）
+ *    - 变量的边界、类型、目标系数和约束的类型、右端项按结构数组保存，扫描边界的循环只读取需要的数组；
+ *      Variable / Constraint只是指向其中一个下标的句柄
+ *    - 名字集中存放在NameTable中，也可以完全不保存（Problem::setKeepNames）
  *    - 避免不必要的数据拷贝
  *    - 内联小函数提高执行效率
  */
 
+#include "sparse_matrix.h"
+#include "kernels.h"
+#include "name_table.h"
 #include <vector>
 #include <string>
-#include <unordered_map>
+#include <string_view>
 #include <limits>
 #include <iostream>
+#include <cmath>
+#include <stdexcept>
+#include <atomic>
+#include <algorithm>
 
 namespace MIPSolver {
 
 // 前向声明 - 避免循环依赖
+class ConstVariable;
 class Variable;
+class ConstConstraint;
 class Constraint;
 class Problem;
 
 // 变量类型枚举 - 定义决策变量的数学性质
-enum class VariableType {
+enum class VariableType : unsigned char {
     CONTINUOUS,  // 连续变量：可以取任意实数值
     INTEGER,     // 整数变量：只能取整数值
     BINARY       // 二进制变量：只能取0或1
 };
 
 // 约束类型枚举 - 定义约束条件的数学关系
-enum class ConstraintType {
+enum class ConstraintType : unsigned char {
     LESS_EQUAL,     // 小于等于约束：左边 <= 右边
     GREATER_EQUAL,  // 大于等于约束：左边 >= 右边
     EQUAL           // 等式约束：左边 = 右边
@@ -61,171 +73,667 @@ enum class ObjectiveType {
     MINIMIZE    // 最小化：寻找使目标函数最小的解
 };
 
-// Variable类 - 表示优化问题中的决策变量
-class Variable {
+/*
+ * Variable / Constraint —— 问题中一个变量或约束的访问句柄
+ *
+ * 数据由Problem按列（结构数组）保存：边界、类型、目标系数各占一个连续数组，名字在NameTable中。
+ * 句柄只记录所属问题和下标，按值传递；问题增加变量或约束后仍然有效，删除约束后下标按新的顺序解释。
+ * ConstVariable / ConstConstraint是只读句柄，由const Problem得到；Variable / Constraint由可修改的Problem得到，
+ * 在只读句柄之上增加设置函数，可以在需要只读句柄的地方使用
+ */
+
+// 变量的只读句柄
+//
+// 新变量的边界为(-inf, +inf)，目标函数系数为0
+class ConstVariable {
     public:
-        /*
-         * 构造函数
-         * 
-         * 参数说明：
-         * @param name: 变量名称，用于标识和调试
-         * @param type: 变量类型，默认为连续变量
-         * 
-         * 初始化：
-         * - 边界默认为负无穷到正无穷（无约束）
-         * - 目标函数系数默认为0（不影响目标函数）
-         */
-        Variable (const std::string& name, VariableType type = VariableType::CONTINUOUS)
-            : name_(name), type_(type), lower_bound_(-std::numeric_limits<double>::infinity()),
-              upper_bound_(std::numeric_limits<double>::infinity()),
-              coefficient_(0.0) {}
+        int getIndex() const { return index_; }
 
-        // 获取器函数 - 提供只读访问私有成员
-        const std::string& getName() const { return name_; }
-        VariableType getType() const { return type_; }
-        double getLowerBound() const { return lower_bound_; }
-        double getUpperBound() const { return upper_bound_; }
-        double getCoefficient() const { return coefficient_; }
+        // 获取器函数
+        inline std::string getName() const;
+        inline VariableType getType() const;
+        inline double getLowerBound() const;
+        inline double getUpperBound() const;
+        inline double getCoefficient() const;
+
+    protected:
+        friend class Problem;
+        ConstVariable(const Problem* problem, int index) : problem_(problem), index_(index) {}
 
+        const Problem* problem_;
+        int index_;
+};
+
+// Variable类 - 表示优化问题中的决策变量
+class Variable : public ConstVariable {
+    public:
         // Setters
-        void setType(VariableType type) { type_ = type; }
-        void setBounds(double lower, double upper) {
-            lower_bound_ = lower;
-            upper_bound_ = upper;
-        }
-        void setCoefficient(double coeff) { coefficient_ = coeff; }
+        inline void setName(const std::string& name);
+        inline void setType(VariableType type);
+        inline void setBounds(double lower, double upper);
+        inline void setCoefficient(double coeff);
 
     private:
-        std::string name_;
-        VariableType type_;
-        double lower_bound_;
-        double upper_bound_;
-        double coefficient_; // Coefficient in objective function   
+        friend class Problem;
+        Variable(Problem* problem, int index) : ConstVariable(problem, index), owner_(problem) {}
+
+        Problem* owner_;  // the same problem, reachable for writing
 };
 
-// Constraint class --> represent linear constraints in MIP problems
-class Constraint {
+// Constraint class --> represent linear constraints in MIP problems (read-only handle: ConstConstraint)
+// The coefficients themselves live in the owning Problem's sparse matrix (row = constraint index)
+//
+// A constraint may carry a range R (MPS RANGES semantics) that turns it into a two-sided row:
+//   <= : [rhs - |R|, rhs]    >= : [rhs, rhs + |R|]    = : [rhs, rhs + R] for R >= 0, [rhs + R, rhs] for R < 0
+class ConstConstraint {
     public:
-        Constraint(const std::string& name, ConstraintType type, double rhs)
-            : name_(name), type_(type), rhs_(rhs) {}
-
-        // Add a variable to the constraint with its coefficient
-        void addVariable(int var_index, double coeff) {
-            coefficients_[var_index] = coeff;
-        }
+        int getIndex() const { return index_; }
 
         // Getters
-        const std::string& getName() const { return name_; }
-        ConstraintType getType() const { return type_; }
-        double getRHS() const { return rhs_; }
-        const std::unordered_map<int, double>& getCoefficients() const { return coefficients_; }
-        
-        // Check if constraint is satisfied by a given solution
-        bool isSatisfied (const std::vector<double>& solution) const {
-            double lhs = 0.0;
-            for (const auto& [var_index, coeff] : coefficients_) {
-                if (var_index < solution.size()) {  // Add bounds check
-                    lhs += coeff * solution[var_index];
+        inline std::string getName() const;
+        inline ConstraintType getType() const;
+        inline double getRHS() const;
+        inline bool hasRange() const;
+        inline double getRange() const;
+
+        // Row activity limits implied by the constraint sense and range: lower <= a^T x <= upper
+        inline double getLowerLimit() const;
+        inline double getUpperLimit() const;
+
+        // Check if constraint is satisfied by a given row activity (lhs value), within an absolute tolerance
+        inline bool isSatisfied(double lhs, double tolerance = 1e-9) const;
+
+        static double lowerLimit(ConstraintType type, double rhs, bool has_range, double range) {
+            if (has_range) {
+                switch (type) {
+                    case ConstraintType::LESS_EQUAL: return rhs - std::abs(range);
+                    case ConstraintType::EQUAL: return range < 0.0 ? rhs + range : rhs;
+                    default: return rhs;
                 }
             }
-            // 浮点计算， 比较精度
-            switch (type_) {
-                case ConstraintType::LESS_EQUAL: return lhs <= rhs_ + 1e-9;
-                case ConstraintType::GREATER_EQUAL: return lhs >= rhs_ - 1e-9;
-                case ConstraintType::EQUAL: return std::abs(lhs - rhs_) < 1e-9;
-                default: return false;
+            return type == ConstraintType::LESS_EQUAL ? -std::numeric_limits<double>::infinity() : rhs;
+        }
+        static double upperLimit(ConstraintType type, double rhs, bool has_range, double range) {
+            if (has_range) {
+                switch (type) {
+                    case ConstraintType::GREATER_EQUAL: return rhs + std::abs(range);
+                    case ConstraintType::EQUAL: return range > 0.0 ? rhs + range : rhs;
+                    default: return rhs;
+                }
             }
+            return type == ConstraintType::GREATER_EQUAL ? std::numeric_limits<double>::infinity() : rhs;
         }
-        
+
+    protected:
+        friend class Problem;
+        ConstConstraint(const Problem* problem, int index) : problem_(problem), index_(index) {}
+
+        const Problem* problem_;
+        int index_;
+};
+
+class Constraint : public ConstConstraint {
+    public:
         // Setters
-        void setName(const std::string& name) { name_ = name; }
-        void setType(ConstraintType type) { type_ = type; }
-        void setRHS(double rhs) { rhs_ = rhs; }
+        inline void setName(const std::string& name);
+        inline void setType(ConstraintType type);
+        inline void setRHS(double rhs);
+        inline void setRange(double range);
 
     private:
-        std::string name_;
-        ConstraintType type_;
-        double rhs_; // Right-hand side value
-        std::unordered_map<int, double> coefficients_; // Map of variable index to coefficient
+        friend class Problem;
+        Constraint(Problem* problem, int index) : ConstConstraint(problem, index), owner_(problem) {}
+
+        Problem* owner_;  // the same problem, reachable for writing
+};
+
+/*
+ * 自某个修订号以来对问题的修改（见Problem::changesSince）
+ *
+ * relaxed表示其中至少有一项修改可能扩大了可行域（放松边界或约束、删除约束、修改已有约束的系数、
+ * 放松整数性），在此之前由问题推出的割平面不再保证有效；其余修改只缩小可行域或只改变目标
+ */
+struct ProblemChanges {
+    bool bounds = false;         // 变量边界
+    bool rhs = false;            // 约束右端项
+    bool objective = false;      // 目标系数或优化方向
+    bool types = false;          // 变量类型
+    bool rows_added = false;
+    bool rows_removed = false;
+    bool columns_added = false;
+    bool coefficients = false;   // 已有约束的系数
+    bool relaxed = false;
+
+    bool any() const {
+        return bounds || rhs || objective || types || rows_added || rows_removed || columns_added || coefficients;
+    }
 };
 
 // Problem class --> main container for the optimization problem
+//
+// Every modification made through the Problem methods bumps a revision number and is recorded by kind,
+// so a solver that remembers the revision it last saw can tell what changed since (changesSince).
+// Copies get a new model id: state kept for one model is never applied to another.
 class Problem {
     public:
         // default minimization problem
         Problem(const std::string& name = "MIP", ObjectiveType objective_type = ObjectiveType::MINIMIZE)
             : name_(name), objective_type_(objective_type) {}
     
+        const std::string& getName() const { return name_; }
+
         // Add a variable to the problem
         int addVariable(const std::string& name, VariableType type = VariableType::CONTINUOUS) {
-            variables_.emplace_back(name, type);
-            return variables_.size() - 1;  // Return variable index
+            int index = getNumVariables();
+            col_lower_.push_back(-std::numeric_limits<double>::infinity());
+            col_upper_.push_back(std::numeric_limits<double>::infinity());
+            col_cost_.push_back(0.0);
+            col_type_.push_back(type);
+            if (keep_names_) col_names_.set(index, name);
+            touch(stamps_.columns_added, false);
+            return index;  // Return variable index
         }
 
-        Variable& getVariable(int index) { return variables_[index]; }
-        const Variable& getVariable(int index) const { return variables_[index]; }
-        int getNumVariables() const { return variables_.size(); }
+        // Taking a handle is not a change; its setters record what they modify
+        Variable getVariable(int index) { return Variable(this, index); }
+        const ConstVariable getVariable(int index) const { return ConstVariable(this, index); }
+        int getNumVariables() const { return static_cast<int>(col_type_.size()); }
+
+        // Column data as contiguous arrays indexed by variable
+        const std::vector<double>& getLowerBounds() const { return col_lower_; }
+        const std::vector<double>& getUpperBounds() const { return col_upper_; }
+        const std::vector<double>& getObjectiveCoefficients() const { return col_cost_; }
+        const std::vector<VariableType>& getVariableTypes() const { return col_type_; }
 
         // Add a constraint to the problem
         int addConstraint(const std::string& name, ConstraintType type, double rhs) {
-            constraints_.emplace_back(name, type, rhs);
-            return constraints_.size() - 1;  // Return constraint index
+            int index = getNumConstraints();
+            appendRow(type, rhs);
+            if (keep_names_) row_names_.set(index, name);
+            touch(stamps_.rows_added, false);
+            return index;  // Return constraint index
+        }
+
+        /*
+         * 添加一个约束及其系数
+         *
+         * 与addConstraint + addConstraintCoefficient结果相同，但只记为新增约束：
+         * 向已求解过的问题追加约束时用它（或addConstraintsCSR），先前的割平面仍然有效
+         */
+        int addConstraint(const std::string& name, ConstraintType type, double rhs,
+                          const std::vector<int>& indices, const std::vector<double>& values) {
+            if (indices.size() != values.size()) {
+                throw std::runtime_error("addConstraint: indices and values differ in length");
+            }
+            int row_start[2] = {0, static_cast<int>(indices.size())};
+            return addConstraintsCSR(1, &type, &rhs, row_start, indices.data(), values.data(), &name);
+        }
+
+        Constraint getConstraint(int index) { return Constraint(this, index); }
+        const ConstConstraint getConstraint(int index) const { return ConstConstraint(this, index); }
+        int getNumConstraints() const { return static_cast<int>(row_type_.size()); }
+
+        /*
+         * 名字
+         *
+         * 名字只用于输入输出和报告。setKeepNames(false)丢弃已有的名字，之后添加的变量和约束也不保存名字，
+         * 百万列以上的模型可以省下大部分内存；没有保存名字的变量和约束按 x<下标> / c<下标> 命名
+         * （删除约束后按新的下标），addVariables / addConstraintsCSR不给名字时同样不保存
+         */
+        void setKeepNames(bool keep) {
+            keep_names_ = keep;
+            if (!keep) {
+                col_names_.clear();
+                row_names_.clear();
+            }
+        }
+        bool getKeepNames() const { return keep_names_; }
+        bool hasNames() const { return !col_names_.empty() || !row_names_.empty(); }
+
+        std::string getVariableName(int index) const {
+            if (col_names_.has(index)) return std::string(col_names_.get(index));
+            return "x" + std::to_string(index);
+        }
+        std::string getConstraintName(int index) const {
+            if (row_names_.has(index)) return std::string(row_names_.get(index));
+            return "c" + std::to_string(index);
+        }
+        void setVariableName(int index, std::string_view name) {
+            checkVariableIndex(index, "setVariableName");
+            if (keep_names_) col_names_.set(index, name);
+        }
+        void setConstraintName(int index, std::string_view name) {
+            checkConstraintIndex(index, "setConstraintName");
+            if (keep_names_) row_names_.set(index, name);
+        }
+
+        // Heap bytes held by variable and constraint names
+        size_t getNameMemory() const { return col_names_.memoryBytes() + row_names_.memoryBytes(); }
+
+        // Identifier of a constraint that stays the same when other constraints are removed
+        long long getConstraintId(int index) const { return row_ids_[index]; }
+
+        /*
+         * 批量添加变量
+         *
+         * @param count: 变量个数
+         * @param lower/upper/objective/types: 长度为count的数组，依次给出每个变量的边界、目标系数和类型
+         * @param names: 长度为count的名字数组；为nullptr时不保存名字（按 x<序号> 命名）
+         * @return: 第一个新变量的索引
+         */
+        int addVariables(int count, const double* lower, const double* upper, const double* objective,
+                         const VariableType* types, const std::string* names = nullptr) {
+            int first = getNumVariables();
+            col_lower_.insert(col_lower_.end(), lower, lower + count);
+            col_upper_.insert(col_upper_.end(), upper, upper + count);
+            col_cost_.insert(col_cost_.end(), objective, objective + count);
+            col_type_.insert(col_type_.end(), types, types + count);
+            if (names && keep_names_) {
+                col_names_.reserve(first + count);
+                for (int i = 0; i < count; ++i) col_names_.set(first + i, names[i]);
+            }
+            touch(stamps_.columns_added, false);
+            return first;
+        }
+
+        /*
+         * 批量添加约束（不带系数，系数另用addConstraintCoefficients或setMatrix给出）
+         *
+         * @param count: 约束个数
+         * @param types/rhs: 长度为count的约束类型和右端项
+         * @param names: 长度为count的名字数组；为nullptr时不保存名字（按 c<序号> 命名）
+         * @return: 第一个新约束的索引
+         */
+        int addConstraints(int count, const ConstraintType* types, const double* rhs, const std::string* names = nullptr) {
+            int first = getNumConstraints();
+            reserveRows(first + count);
+            for (int r = 0; r < count; ++r) appendRow(types[r], rhs[r]);
+            if (names && keep_names_) {
+                row_names_.reserve(first + count);
+                for (int r = 0; r < count; ++r) row_names_.set(first + r, names[r]);
+            }
+            touch(stamps_.rows_added, false);
+            return first;
         }
 
-        Constraint& getConstraint(int index) { return constraints_[index]; }
-        const Constraint& getConstraint(int index) const { return constraints_[index]; }
-        int getNumConstraints() const { return constraints_.size(); }
+        /*
+         * 批量添加约束，系数以CSR数组给出
+         *
+         * @param count: 约束个数
+         * @param types/rhs: 长度为count的约束类型和右端项
+         * @param row_start: 长度为count+1，第 r 个约束的系数位于 [row_start[r], row_start[r+1])
+         * @param col_index/values: 系数的变量索引和数值（必须指向已有变量）
+         * @param names: 长度为count的名字数组；为nullptr时不保存名字（按 c<序号> 命名）
+         * @return: 第一个新约束的索引
+         *
+         * 系数直接追加到CSR矩阵的末尾，不经过三元组构建器；下标无效时抛出std::runtime_error，问题保持不变
+         */
+        int addConstraintsCSR(int count, const ConstraintType* types, const double* rhs,
+                              const int* row_start, const int* col_index, const double* values,
+                              const std::string* names = nullptr) {
+            if (count < 0 || row_start[0] < 0) {
+                throw std::runtime_error("addConstraintsCSR: invalid row_start");
+            }
+            for (int r = 0; r < count; ++r) {
+                if (row_start[r + 1] < row_start[r]) {
+                    throw std::runtime_error("addConstraintsCSR: row_start must be non-decreasing");
+                }
+            }
+            int num_vars = getNumVariables();
+            for (int k = row_start[0]; k < row_start[count]; ++k) {
+                if (col_index[k] < 0 || col_index[k] >= num_vars) {
+                    throw std::runtime_error("addConstraintsCSR: variable index " + std::to_string(col_index[k]) +
+                                             " out of range");
+                }
+            }
+
+            // Bring the CSR matrix up to date so the new rows can be appended directly
+            if (!matrix_builder_.empty() || matrix_.getNumRows() != getNumConstraints()) {
+                finalize();
+            }
+
+            int first = getNumConstraints();
+            reserveRows(first + count);
+            for (int r = 0; r < count; ++r) appendRow(types[r], rhs[r]);
+            if (names && keep_names_) {
+                row_names_.reserve(first + count);
+                for (int r = 0; r < count; ++r) row_names_.set(first + r, names[r]);
+            }
+            matrix_.appendRows(num_vars, count, row_start, col_index, values);
+            touch(stamps_.rows_added, false);
+            return first;
+        }
+
+        /*
+         * 批量添加变量及其在已有约束中的系数（CSC数组）
+         *
+         * @param col_start: 长度为count+1，第 j 个新变量的系数位于 [col_start[j], col_start[j+1])
+         * @param row_index/values: 系数所在的约束索引和数值（必须指向已有约束）
+         * 其余参数同addVariables；下标无效时抛出std::runtime_error，问题保持不变
+         * @return: 第一个新变量的索引
+         */
+        int addColumnsCSC(int count, const int* col_start, const int* row_index, const double* values,
+                          const double* lower, const double* upper, const double* objective,
+                          const VariableType* types, const std::string* names = nullptr) {
+            if (count < 0 || col_start[0] < 0) {
+                throw std::runtime_error("addColumnsCSC: invalid col_start");
+            }
+            for (int j = 0; j < count; ++j) {
+                if (col_start[j + 1] < col_start[j]) {
+                    throw std::runtime_error("addColumnsCSC: col_start must be non-decreasing");
+                }
+            }
+            int num_rows = getNumConstraints();
+            for (int k = col_start[0]; k < col_start[count]; ++k) {
+                if (row_index[k] < 0 || row_index[k] >= num_rows) {
+                    throw std::runtime_error("addColumnsCSC: constraint index " + std::to_string(row_index[k]) +
+                                             " out of range");
+                }
+            }
+
+            int first = addVariables(count, lower, upper, objective, types, names);
+            matrix_builder_.reserve(matrix_builder_.size() + (col_start[count] - col_start[0]));
+            for (int j = 0; j < count; ++j) {
+                for (int k = col_start[j]; k < col_start[j + 1]; ++k) {
+                    matrix_builder_.add(row_index[k], first + j, values[k]);
+                }
+            }
+            if (col_start[count] > col_start[0]) touch(stamps_.coefficients, true);
+            return first;
+        }
+
+        // Set the coefficient of a variable in a constraint (a later call for the same pair overwrites)
+        void addConstraintCoefficient(int constraint_index, int var_index, double coeff) {
+            matrix_builder_.add(constraint_index, var_index, coeff);
+            touch(stamps_.coefficients, true);
+        }
+
+        // Bulk form of addConstraintCoefficient; entries are applied in order
+        void addConstraintCoefficients(const std::vector<SparseMatrixBuilder::Triplet>& entries) {
+            matrix_builder_.append(entries);
+            touch(stamps_.coefficients, true);
+        }
+
+        // Replace all constraint coefficients by a finalized matrix of matching dimensions
+        void setMatrix(SparseMatrix matrix) {
+            matrix_builder_.clear();
+            matrix_ = std::move(matrix);
+            touch(stamps_.coefficients, true);
+        }
+
+        /*
+         * 增量修改：变量边界、约束右端项、类型和范围、变量类型
+         *
+         * 这些方法按种类记录修改，并区分收紧与放松，使保持热启动状态的求解器（BranchBoundSolver::setWarmStart）
+         * 能保留更多状态；Variable / Constraint的设置函数调用它们。约束类型和范围的修改记为右端项的修改。
+         * 下标无效时抛出std::runtime_error
+         */
+        void setVariableBounds(int var_index, double lower, double upper) {
+            checkVariableIndex(var_index, "setVariableBounds");
+            if (lower == col_lower_[var_index] && upper == col_upper_[var_index]) return;
+            bool relaxing = lower < col_lower_[var_index] || upper > col_upper_[var_index];
+            col_lower_[var_index] = lower;
+            col_upper_[var_index] = upper;
+            touch(stamps_.bounds, relaxing);
+        }
+
+        void setConstraintRHS(int constraint_index, double rhs) {
+            checkConstraintIndex(constraint_index, "setConstraintRHS");
+            if (rhs == row_rhs_[constraint_index]) return;
+            double old_lower = getRowLowerLimit(constraint_index);
+            double old_upper = getRowUpperLimit(constraint_index);
+            row_rhs_[constraint_index] = rhs;
+            touch(stamps_.rhs, getRowLowerLimit(constraint_index) < old_lower ||
+                               getRowUpperLimit(constraint_index) > old_upper);
+        }
+
+        void setConstraintType(int constraint_index, ConstraintType type) {
+            checkConstraintIndex(constraint_index, "setConstraintType");
+            if (type == row_type_[constraint_index]) return;
+            double old_lower = getRowLowerLimit(constraint_index);
+            double old_upper = getRowUpperLimit(constraint_index);
+            row_type_[constraint_index] = type;
+            touch(stamps_.rhs, getRowLowerLimit(constraint_index) < old_lower ||
+                               getRowUpperLimit(constraint_index) > old_upper);
+        }
+
+        void setConstraintRange(int constraint_index, double range) {
+            checkConstraintIndex(constraint_index, "setConstraintRange");
+            if (row_has_range_[constraint_index] && range == row_range_[constraint_index]) return;
+            double old_lower = getRowLowerLimit(constraint_index);
+            double old_upper = getRowUpperLimit(constraint_index);
+            row_range_[constraint_index] = range;
+            row_has_range_[constraint_index] = 1;
+            touch(stamps_.rhs, getRowLowerLimit(constraint_index) < old_lower ||
+                               getRowUpperLimit(constraint_index) > old_upper);
+        }
+
+        void setVariableType(int var_index, VariableType type) {
+            checkVariableIndex(var_index, "setVariableType");
+            VariableType old = col_type_[var_index];
+            if (type == old) return;
+            // Dropping integrality, or BINARY -> INTEGER, may admit new solutions
+            bool relaxing = type == VariableType::CONTINUOUS || old == VariableType::BINARY;
+            col_type_[var_index] = type;
+            touch(stamps_.types, relaxing);
+        }
+
+        /*
+         * 删除若干约束（下标可以重复、无序），其余约束按原顺序前移
+         *
+         * getConstraintId不受影响，可以用它跟踪删除前后同一个约束
+         */
+        void removeConstraints(const std::vector<int>& indices) {
+            if (indices.empty()) return;
+            std::vector<bool> remove(getNumConstraints(), false);
+            for (int index : indices) {
+                checkConstraintIndex(index, "removeConstraints");
+                remove[index] = true;
+            }
+            getMatrix();
+            matrix_.removeRows(remove);
+            size_t kept = 0;
+            for (size_t i = 0; i < row_type_.size(); ++i) {
+                if (remove[i]) continue;
+                row_type_[kept] = row_type_[i];
+                row_rhs_[kept] = row_rhs_[i];
+                row_range_[kept] = row_range_[i];
+                row_has_range_[kept] = row_has_range_[i];
+                row_ids_[kept] = row_ids_[i];
+                kept++;
+            }
+            row_type_.resize(kept);
+            row_rhs_.resize(kept);
+            row_range_.resize(kept);
+            row_has_range_.resize(kept);
+            row_ids_.resize(kept);
+            row_names_.erase(remove);
+            touch(stamps_.rows_removed, true);
+        }
+
+        /*
+         * 修改跟踪
+         *
+         * getRevision在每次修改后增大；changesSince(r)给出修订号r之后的全部修改种类。
+         * getModelId在问题的生命周期内不变，复制得到的问题有新的编号
+         */
+        long long getRevision() const { return revision_; }
+        unsigned long long getModelId() const { return model_id_.value; }
+
+        ProblemChanges changesSince(long long revision) const {
+            ProblemChanges changes;
+            changes.bounds = stamps_.bounds > revision;
+            changes.rhs = stamps_.rhs > revision;
+            changes.objective = stamps_.objective > revision;
+            changes.types = stamps_.types > revision;
+            changes.rows_added = stamps_.rows_added > revision;
+            changes.rows_removed = stamps_.rows_removed > revision;
+            changes.columns_added = stamps_.columns_added > revision;
+            changes.coefficients = stamps_.coefficients > revision;
+            changes.relaxed = stamps_.relaxed > revision;
+            return changes;
+        }
+
+        void reserve(int num_variables, int num_constraints) {
+            col_lower_.reserve(num_variables);
+            col_upper_.reserve(num_variables);
+            col_cost_.reserve(num_variables);
+            col_type_.reserve(num_variables);
+            if (keep_names_) {
+                col_names_.reserve(num_variables);
+                row_names_.reserve(num_constraints);
+            }
+            reserveRows(num_constraints);
+        }
+
+        // Constraint matrix in CSR form; pending coefficients are merged in on first access
+        const SparseMatrix& getMatrix() const {
+            if (!matrix_builder_.empty() || matrix_.getNumRows() != getNumConstraints() ||
+                matrix_.getNumCols() != getNumVariables()) {
+                finalize();
+            }
+            return matrix_;
+        }
+
+        // Merge all pending coefficients into the CSR matrix
+        void finalize() const {
+            matrix_ = matrix_builder_.build(getNumConstraints(), getNumVariables(), &matrix_);
+            matrix_builder_.clear();
+        }
+
+        // Row activity limits of a constraint (see Constraint::getLowerLimit)
+        double getRowLowerLimit(int constraint_index) const {
+            return Constraint::lowerLimit(row_type_[constraint_index], row_rhs_[constraint_index],
+                                          row_has_range_[constraint_index] != 0, row_range_[constraint_index]);
+        }
+        double getRowUpperLimit(int constraint_index) const {
+            return Constraint::upperLimit(row_type_[constraint_index], row_rhs_[constraint_index],
+                                          row_has_range_[constraint_index] != 0, row_range_[constraint_index]);
+        }
+
+        // Row activity a_i^T x of a constraint
+        double getRowActivity(int constraint_index, const std::vector<double>& solution) const {
+            SparseMatrix::VectorView row = getMatrix().row(constraint_index);
+            return Kernels::sparseDot(row.indices, row.values, row.size, solution.data());
+        }
+
+        bool isConstraintSatisfied(int constraint_index, const std::vector<double>& solution, double tolerance = 1e-9) const {
+            return getConstraint(constraint_index).isSatisfied(getRowActivity(constraint_index, solution), tolerance);
+        }
 
         // Objective function management
-        void setObjectiveType(ObjectiveType type) { objective_type_ = type; }
+        void setObjectiveType(ObjectiveType type) {
+            if (type == objective_type_) return;
+            objective_type_ = type;
+            touch(stamps_.objective, false);
+        }
         ObjectiveType getObjectiveType() const { return objective_type_; }
 
         void setObjectiveCoefficient(int var_index, double coeff) {
-            if (var_index >= 0 && var_index < variables_.size()) {
-                variables_[var_index].setCoefficient(coeff);
+            if (var_index >= 0 && var_index < getNumVariables() && col_cost_[var_index] != coeff) {
+                col_cost_[var_index] = coeff;
+                touch(stamps_.objective, false);
             }
         }
 
-        // Problem validation
-        bool isValidSolution(const std::vector<double>& solution) const {
-            if (solution.size() != variables_.size()) {
+        // Problem validation; bounds and constraints may be violated by at most `tolerance` (absolute)
+        bool isValidSolution(const std::vector<double>& solution, double tolerance = 1e-9) const {
+            if (solution.size() != col_type_.size()) {
                 return false; // Solution size must match number of variables
             }
 
             // Check variable bounds
-            for (int i = 0; i < variables_.size(); ++i) {
-                const auto& var = variables_[i];
-                if (solution[i] < var.getLowerBound() - 1e-9 || solution[i] > var.getUpperBound() + 1e-9) {
+            for (size_t i = 0; i < solution.size(); ++i) {
+                if (solution[i] < col_lower_[i] - tolerance || solution[i] > col_upper_[i] + tolerance) {
                     return false; // Variable out of bounds
                 }
-            }   
-            for (const auto& constraint : constraints_) {
-                if (!constraint.isSatisfied(solution)) {
+            }
+            for (int c = 0; c < getNumConstraints(); ++c) {
+                if (!isConstraintSatisfied(c, solution, tolerance)) {
                     return false; // At least one constraint is not satisfied
                 }
             }
             return true; // All constraints are satisfied
         }
 
+        /*
+         * 批量评估候选解
+         *
+         * 对每个候选解给出目标值（原始值，不因最大化而取反）和最大违反量：
+         * 变量越界量与约束违反量中的最大者，可行时为0，长度不符或含NaN时为无穷大。
+         * max_violation <= tolerance 与 isValidSolution(solution, tolerance) 一致，
+         * 只有恰好偏离tolerance的等式约束例外（后者对等式使用严格小于）。
+         * 候选解分成小组交错存放后用Kernels中的批量内核计算，结果与逐个计算逐位相同
+         */
+        void evaluateSolutions(const std::vector<std::vector<double>>& solutions, std::vector<double>& objectives,
+                               std::vector<double>& max_violations) const {
+            constexpr int kGroup = 16;
+            const SparseMatrix& matrix = getMatrix();
+            const int n = getNumVariables();
+            const int m = getNumConstraints();
+            const int count = static_cast<int>(solutions.size());
+            objectives.assign(count, 0.0);
+            max_violations.assign(count, 0.0);
+
+            std::vector<double> row_lower(m), row_upper(m);
+            for (int i = 0; i < m; ++i) {
+                row_lower[i] = getRowLowerLimit(i);
+                row_upper[i] = getRowUpperLimit(i);
+            }
+
+            std::vector<int> group;
+            std::vector<double> packed, activity, lanes(8 * kGroup);
+            group.reserve(kGroup);
+            for (int first = 0; first < count; first += kGroup) {
+                group.clear();
+                for (int s = first; s < std::min(count, first + kGroup); ++s) {
+                    if (static_cast<int>(solutions[s].size()) == n) {
+                        group.push_back(s);
+                    } else {
+                        objectives[s] = std::numeric_limits<double>::quiet_NaN();
+                        max_violations[s] = std::numeric_limits<double>::infinity();
+                    }
+                }
+                const int width = static_cast<int>(group.size());
+                if (width == 0) continue;
+
+                packed.resize(static_cast<size_t>(n) * width);
+                activity.resize(static_cast<size_t>(m) * width);
+                for (int s = 0; s < width; ++s) {
+                    const double* x = solutions[group[s]].data();
+                    for (int j = 0; j < n; ++j) packed[static_cast<size_t>(j) * width + s] = x[j];
+                }
+
+                double objective[kGroup];
+                double violation[kGroup] = {};
+                Kernels::dotBatch(col_cost_.data(), n, packed.data(), width, objective, lanes.data());
+                Kernels::maxViolationBatch(packed.data(), col_lower_.data(), col_upper_.data(), n, width, violation);
+                Kernels::rowActivitiesBatch(matrix, packed.data(), width, activity.data(), lanes.data());
+                Kernels::maxViolationBatch(activity.data(), row_lower.data(), row_upper.data(), m, width, violation);
+                for (int s = 0; s < width; ++s) {
+                    objectives[group[s]] = objective[s];
+                    max_violations[group[s]] = violation[s];
+                }
+            }
+        }
+
         // Calculate the objective value for a given solution
         double calculateObjectiveValue(const std::vector<double>& solution) const {
-            double value = 0.0;
-            for (int i = 0; i < variables_.size() && i < solution.size(); ++i) {
-                value += variables_[i].getCoefficient() * solution[i];
-            }
-            return value;  // Return raw value - don't flip for maximize
-        }   
+            int size = static_cast<int>(std::min(col_cost_.size(), solution.size()));
+            return Kernels::dot(col_cost_.data(), solution.data(), size);  // Return raw value - don't flip for maximize
+        }
 
         // Problem statistics
         void printStatistics() const {
             std::cout << "Problem Name: " << name_ << "\n";
             std::cout << "Objective Type: " << (objective_type_ == ObjectiveType::MAXIMIZE ? "Maximize" : "Minimize") << "\n";
-            std::cout << "Number of Variables: " << variables_.size() << "\n";
-            std::cout << "Number of Constraints: " << constraints_.size() << "\n";
+            std::cout << "Number of Variables: " << getNumVariables() << "\n";
+            std::cout << "Number of Constraints: " << getNumConstraints() << "\n";
+            std::cout << "Number of Nonzeros: " << getMatrix().getNumNonzeros() << "\n";
 
             int continuous_count = 0, integer_count = 0, binary_count = 0;
-            for (const auto& var : variables_) {
-                switch (var.getType()) {
+            for (VariableType type : col_type_) {
+                switch (type) {
                     case VariableType::CONTINUOUS: continuous_count++; break;
                     case VariableType::INTEGER: integer_count++; break;
                     case VariableType::BINARY: binary_count++; break;
@@ -240,11 +748,131 @@ class Problem {
     private:
         std::string name_;
         ObjectiveType objective_type_;
-        std::vector<Variable> variables_; // List of decision variables
-        std::vector<Constraint> constraints_; // List of constraints
+        friend class ConstVariable;
+        friend class ConstConstraint;
+
+        // Variables, one entry per column
+        std::vector<double> col_lower_;
+        std::vector<double> col_upper_;
+        std::vector<double> col_cost_;  // Objective coefficients
+        std::vector<VariableType> col_type_;
+        NameTable col_names_;
+
+        // Constraints, one entry per row
+        std::vector<ConstraintType> row_type_;
+        std::vector<double> row_rhs_;
+        std::vector<double> row_range_;           // Only meaningful where row_has_range_ is set
+        std::vector<unsigned char> row_has_range_;
+        NameTable row_names_;
+
+        bool keep_names_ = true;
+        mutable SparseMatrix matrix_; // Finalized constraint coefficients (CSR + lazy CSC)
+        mutable SparseMatrixBuilder matrix_builder_; // Coefficients added since the last finalize
         // REMOVED: objective_value_ - this should be in Solution class, not Problem class
+
+        // Process-wide unique id; copying or assigning a Problem draws a fresh one
+        struct ModelId {
+            unsigned long long value;
+            ModelId() : value(next()) {}
+            ModelId(const ModelId&) : value(next()) {}
+            ModelId& operator=(const ModelId&) { value = next(); return *this; }
+            static unsigned long long next() {
+                static std::atomic<unsigned long long> counter{0};
+                return ++counter;
+            }
+        };
+
+        // Revision of the latest change of each kind (0 = never changed)
+        struct ChangeStamps {
+            long long bounds = 0;
+            long long rhs = 0;
+            long long objective = 0;
+            long long types = 0;
+            long long rows_added = 0;
+            long long rows_removed = 0;
+            long long columns_added = 0;
+            long long coefficients = 0;
+            long long relaxed = 0;
+        };
+
+        ModelId model_id_;
+        long long revision_ = 0;
+        ChangeStamps stamps_;
+        std::vector<long long> row_ids_;  // getConstraintId, one entry per row
+        long long next_row_id_ = 0;
+
+        void appendRow(ConstraintType type, double rhs) {
+            row_type_.push_back(type);
+            row_rhs_.push_back(rhs);
+            row_range_.push_back(0.0);
+            row_has_range_.push_back(0);
+            row_ids_.push_back(next_row_id_++);
+        }
+
+        void reserveRows(int count) {
+            row_type_.reserve(count);
+            row_rhs_.reserve(count);
+            row_range_.reserve(count);
+            row_has_range_.reserve(count);
+            row_ids_.reserve(count);
+        }
+
+        void touch(long long& stamp, bool relaxing) {
+            stamp = ++revision_;
+            if (relaxing) stamps_.relaxed = revision_;
+        }
+
+        void checkVariableIndex(int index, const char* caller) const {
+            if (index < 0 || index >= getNumVariables()) {
+                throw std::runtime_error(std::string(caller) + ": variable index " + std::to_string(index) + " out of range");
+            }
+        }
+
+        void checkConstraintIndex(int index, const char* caller) const {
+            if (index < 0 || index >= getNumConstraints()) {
+                throw std::runtime_error(std::string(caller) + ": constraint index " + std::to_string(index) + " out of range");
+            }
+        }
 };
 
+inline std::string ConstVariable::getName() const { return problem_->getVariableName(index_); }
+inline VariableType ConstVariable::getType() const { return problem_->col_type_[index_]; }
+inline double ConstVariable::getLowerBound() const { return problem_->col_lower_[index_]; }
+inline double ConstVariable::getUpperBound() const { return problem_->col_upper_[index_]; }
+inline double ConstVariable::getCoefficient() const { return problem_->col_cost_[index_]; }
+
+inline void Variable::setName(const std::string& name) { owner_->setVariableName(index_, name); }
+inline void Variable::setType(VariableType type) { owner_->setVariableType(index_, type); }
+inline void Variable::setBounds(double lower, double upper) { owner_->setVariableBounds(index_, lower, upper); }
+inline void Variable::setCoefficient(double coeff) { owner_->setObjectiveCoefficient(index_, coeff); }
+
+inline std::string ConstConstraint::getName() const { return problem_->getConstraintName(index_); }
+inline ConstraintType ConstConstraint::getType() const { return problem_->row_type_[index_]; }
+inline double ConstConstraint::getRHS() const { return problem_->row_rhs_[index_]; }
+inline bool ConstConstraint::hasRange() const { return problem_->row_has_range_[index_] != 0; }
+inline double ConstConstraint::getRange() const { return problem_->row_range_[index_]; }
+inline double ConstConstraint::getLowerLimit() const { return problem_->getRowLowerLimit(index_); }
+inline double ConstConstraint::getUpperLimit() const { return problem_->getRowUpperLimit(index_); }
+
+inline bool ConstConstraint::isSatisfied(double lhs, double tolerance) const {
+    // 浮点计算， 比较精度
+    if (hasRange()) {
+        return lhs >= getLowerLimit() - tolerance && lhs <= getUpperLimit() + tolerance;
+    }
+    double rhs = getRHS();
+    switch (getType()) {
+        case ConstraintType::LESS_EQUAL: return lhs <= rhs + tolerance;
+        case ConstraintType::GREATER_EQUAL: return lhs >= rhs - tolerance;
+        case ConstraintType::EQUAL: return std::abs(lhs - rhs) < tolerance;
+        default: return false;
+    }
+}
+
+inline void Constraint::setName(const std::string& name) { owner_->setConstraintName(index_, name); }
+inline void Constraint::setType(ConstraintType type) { owner_->setConstraintType(index_, type); }
+inline void Constraint::setRHS(double rhs) { owner_->setConstraintRHS(index_, rhs); }
+inline void Constraint::setRange(double range) { owner_->setConstraintRange(index_, range); }
+
 // Forward declarations for classes that should be in separate headers
 class Solution;
 class SolverInterface;
@@ -0,0 +1,345 @@
+#ifndef INSTRUMENTATION_H
+#define INSTRUMENTATION_H
+
+/*
+ * 热路径计时与计数
+ *
+ * 定位慢求解的时间花在哪里（解析、LP、分支、节点复制、启发式……）：
+ *
+ * 1. 编译开关：定义 MIPSOLVER_ENABLE_INSTRUMENTATION 时才记录。
+ *    未定义时 MIPSOLVER_TRACE_SCOPE / MIPSOLVER_COUNT / MIPSOLVER_TRACE_THREAD 展开为空语句，
+ *    参数不会被求值，求解器代码中的插桩点不产生任何开销，可以保留在发布版本中
+ *
+ * 2. 记录：
+ *    - Session：一次记录会话，拥有各线程的缓冲区；BranchBoundSolver::solve 每次求解创建一个
+ *    - ThreadScope：把调用线程绑定到会话，此后该线程上的记录写入它独占的缓冲区（无锁）；
+ *      线程已经绑定到同一会话时什么也不做，析构时恢复之前的绑定
+ *    - MIPSOLVER_TRACE_SCOPE(PHASE)：作用域计时，累计阶段的总时间和次数，并记录一条轨迹事件；
+ *      阶段可以嵌套（例如NODE内的LP_SOLVE），总时间是包含子阶段的
+ *    - MIPSOLVER_COUNT(COUNTER, n)：计数器加n
+ *    - 当前线程没有绑定会话时记录被忽略，因此单独使用SimplexSolver等组件时也没有副作用
+ *
+ * 3. 结果：Session::collect 在所有记录线程结束后合并为 Profile，
+ *    求解器把它放进 Solution（Solution::getProfile），可以查询各阶段时间、计数器，
+ *    或用 writeChromeTrace 导出 Chrome / Perfetto 的 JSON 轨迹（chrome://tracing、ui.perfetto.dev）
+ *
+ * 解析等求解之外的阶段需要调用者自己建立会话：
+ *   Instrumentation::Session session;
+ *   { Instrumentation::ThreadScope bind(&session, "main"); problem = MPSParser::parseFromFile(path); }
+ *   session.collect().writeChromeTrace("parse.json");
+ */
+
+#include <array>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+namespace MIPSolver {
+namespace Instrumentation {
+
+// Whether the instrumentation points are compiled in
+#ifdef MIPSOLVER_ENABLE_INSTRUMENTATION
+constexpr bool kEnabled = true;
+#else
+constexpr bool kEnabled = false;
+#endif
+
+enum class Phase {
+    PARSE,        // MPS parsing
+    PRESOLVE,
+    ROOT_CUTS,    // root LP and cutting plane rounds
+    SEARCH,       // tree search loop of one thread
+    NODE,         // processing one node (LP, propagation, branching, children)
+    PROPAGATION,  // domain propagation at a node
+    LP_SOLVE,     // one simplex solve (node LPs, strong branching, heuristics)
+    BRANCHING,    // branching variable selection, including strong branching
+    NODE_COPY,    // saving the basis and building the child nodes
+    HEURISTIC,    // one ALNS run
+    POSTSOLVE
+};
+constexpr int kNumPhases = static_cast<int>(Phase::POSTSOLVE) + 1;
+
+enum class Counter {
+    LP_CALLS,
+    LP_PIVOTS,
+    REFACTORIZATIONS,
+    NODES_PROCESSED,
+    NODES_CREATED,
+    NODES_PRUNED_BOUND,        // LP bound (or the parent's bound) no better than the incumbent
+    NODES_PRUNED_INFEASIBLE,   // LP infeasible
+    NODES_PRUNED_PROPAGATION,  // infeasible by domain propagation, no LP solved
+    NODES_PRUNED_BRANCHING,    // infeasible in every strong branching direction
+    NODES_INTEGER,             // LP solution integer feasible
+    NODE_BYTES,                // bytes of child node records (bound changes and bases)
+    POOL_BYTES                 // heap bytes requested by the node memory pools (flat once they are warm)
+};
+constexpr int kNumCounters = static_cast<int>(Counter::POOL_BYTES) + 1;
+
+inline const char* phaseName(Phase phase) {
+    static const char* const names[kNumPhases] = {
+        "parse", "presolve", "root_cuts", "search", "node", "propagation",
+        "lp_solve", "branching", "node_copy", "heuristic", "postsolve"
+    };
+    return names[static_cast<int>(phase)];
+}
+
+inline const char* counterName(Counter counter) {
+    static const char* const names[kNumCounters] = {
+        "lp_calls", "lp_pivots", "refactorizations", "nodes_processed", "nodes_created",
+        "nodes_pruned_bound", "nodes_pruned_infeasible", "nodes_pruned_propagation",
+        "nodes_pruned_branching", "nodes_integer", "node_bytes", "pool_bytes"
+    };
+    return names[static_cast<int>(counter)];
+}
+
+// One completed phase scope; times are microseconds since the start of the session
+struct TraceEvent {
+    Phase phase;
+    int thread;
+    double start_us;
+    double duration_us;
+};
+
+class Session;
+
+// Per-thread buffer; only the owning thread writes to it while the session is recording
+struct ThreadBuffer {
+    const Session* session = nullptr;
+    int thread = 0;
+    std::string name;
+    std::chrono::steady_clock::time_point origin;
+    std::array<double, kNumPhases> seconds{};
+    std::array<long long, kNumPhases> calls{};
+    std::array<long long, kNumCounters> counters{};
+    std::vector<TraceEvent> events;
+    long long dropped_events = 0;
+
+    static constexpr size_t kMaxEvents = 1 << 20;  // Per thread; totals keep counting past it
+
+    void record(Phase phase, std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end) {
+        int p = static_cast<int>(phase);
+        double duration = std::chrono::duration<double>(end - start).count();
+        seconds[p] += duration;
+        calls[p]++;
+        if (events.size() >= kMaxEvents) {
+            dropped_events++;
+            return;
+        }
+        events.push_back({phase, thread, std::chrono::duration<double, std::micro>(start - origin).count(), duration * 1e6});
+    }
+};
+
+inline ThreadBuffer*& currentBuffer() {
+    thread_local ThreadBuffer* buffer = nullptr;
+    return buffer;
+}
+
+/*
+ * 合并后的记录结果
+ *
+ * 没有编译插桩的版本中enabled()为false，所有查询返回0
+ */
+class Profile {
+    public:
+        bool enabled() const { return enabled_; }
+        int numThreads() const { return static_cast<int>(thread_names_.size()); }
+
+        // Total seconds inside the phase over all threads (nested phases included)
+        double seconds(Phase phase) const { return seconds_[static_cast<int>(phase)]; }
+        long long calls(Phase phase) const { return calls_[static_cast<int>(phase)]; }
+        long long count(Counter counter) const { return counters_[static_cast<int>(counter)]; }
+
+        // Average heap bytes allocated per child node
+        double bytesPerNode() const {
+            long long created = count(Counter::NODES_CREATED);
+            return created > 0 ? static_cast<double>(count(Counter::NODE_BYTES)) / created : 0.0;
+        }
+
+        // Trace events ordered by start time; droppedEvents() were not kept once a thread's buffer was full
+        const std::vector<TraceEvent>& events() const { return events_; }
+        long long droppedEvents() const { return dropped_events_; }
+
+        /*
+         * 导出Chrome轨迹（JSON Object Format）
+         *
+         * 每个阶段作用域是一条"X"（完整）事件，线程名以"M"元数据事件给出，
+         * 计数器和各阶段总时间放在otherData中
+         */
+        void writeChromeTrace(std::ostream& out) const {
+            out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+            bool first = true;
+            auto separator = [&]() -> std::ostream& {
+                if (!first) out << ",";
+                first = false;
+                return out << "\n";
+            };
+            for (size_t t = 0; t < thread_names_.size(); ++t) {
+                separator() << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << t
+                            << ",\"args\":{\"name\":\"" << thread_names_[t] << "\"}}";
+            }
+            std::streamsize precision = out.precision();
+            out << std::fixed << std::setprecision(3);
+            for (const TraceEvent& event : events_) {
+                separator() << "{\"name\":\"" << phaseName(event.phase) << "\",\"cat\":\"mipsolver\",\"ph\":\"X\",\"pid\":1,\"tid\":"
+                            << event.thread << ",\"ts\":" << event.start_us << ",\"dur\":" << event.duration_us << "}";
+            }
+            out << "\n],\"otherData\":{";
+            for (int c = 0; c < kNumCounters; ++c) {
+                out << "\"" << counterName(static_cast<Counter>(c)) << "\":" << counters_[c] << ",";
+            }
+            for (int p = 0; p < kNumPhases; ++p) {
+                out << "\"" << phaseName(static_cast<Phase>(p)) << "_seconds\":" << std::setprecision(6) << seconds_[p] << ",";
+            }
+            out << "\"dropped_events\":" << dropped_events_ << "}}\n";
+            out.unsetf(std::ios::floatfield);
+            out.precision(precision);
+        }
+
+        bool writeChromeTrace(const std::string& filename) const {
+            std::ofstream file(filename);
+            if (!file) return false;
+            writeChromeTrace(file);
+            return static_cast<bool>(file.flush());
+        }
+
+        void print(std::ostream& out) const {
+            if (!enabled_) {
+                out << "Instrumentation: not compiled in (define MIPSOLVER_ENABLE_INSTRUMENTATION)\n";
+                return;
+            }
+            out << "Phase times (" << numThreads() << " threads, nested phases included):\n";
+            for (int p = 0; p < kNumPhases; ++p) {
+                if (calls_[p] == 0) continue;
+                out << "  " << std::left << std::setw(12) << phaseName(static_cast<Phase>(p)) << std::right
+                    << std::setw(12) << calls_[p] << " calls  " << seconds_[p] << " s\n";
+            }
+            out << "Counters:\n";
+            for (int c = 0; c < kNumCounters; ++c) {
+                out << "  " << std::left << std::setw(26) << counterName(static_cast<Counter>(c)) << std::right
+                    << counters_[c] << "\n";
+            }
+        }
+
+    private:
+        friend class Session;
+
+        bool enabled_ = false;
+        std::array<double, kNumPhases> seconds_{};
+        std::array<long long, kNumPhases> calls_{};
+        std::array<long long, kNumCounters> counters_{};
+        std::vector<TraceEvent> events_;
+        std::vector<std::string> thread_names_;
+        long long dropped_events_ = 0;
+};
+
+class Session {
+    public:
+        Session() : origin_(std::chrono::steady_clock::now()) {}
+        Session(const Session&) = delete;
+        Session& operator=(const Session&) = delete;
+
+        // A new buffer for the calling thread; thread ids follow registration order
+        ThreadBuffer* registerThread(const std::string& name) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            buffers_.push_back(std::make_unique<ThreadBuffer>());
+            ThreadBuffer* buffer = buffers_.back().get();
+            buffer->session = this;
+            buffer->thread = static_cast<int>(buffers_.size()) - 1;
+            buffer->name = name;
+            buffer->origin = origin_;
+            return buffer;
+        }
+
+        // Merge all thread buffers; no thread may still be recording into this session
+        Profile collect() const {
+            std::lock_guard<std::mutex> lock(mutex_);
+            Profile profile;
+            profile.enabled_ = kEnabled;
+            for (const auto& buffer : buffers_) {
+                for (int p = 0; p < kNumPhases; ++p) {
+                    profile.seconds_[p] += buffer->seconds[p];
+                    profile.calls_[p] += buffer->calls[p];
+                }
+                for (int c = 0; c < kNumCounters; ++c) {
+                    profile.counters_[c] += buffer->counters[c];
+                }
+                profile.events_.insert(profile.events_.end(), buffer->events.begin(), buffer->events.end());
+                profile.dropped_events_ += buffer->dropped_events;
+                profile.thread_names_.push_back(buffer->name);
+            }
+            std::stable_sort(profile.events_.begin(), profile.events_.end(),
+                             [](const TraceEvent& a, const TraceEvent& b) { return a.start_us < b.start_us; });
+            return profile;
+        }
+
+    private:
+        std::chrono::steady_clock::time_point origin_;
+        mutable std::mutex mutex_;
+        std::vector<std::unique_ptr<ThreadBuffer>> buffers_;
+};
+
+// Binds the calling thread to a session for the lifetime of the object (no-op for nullptr)
+class ThreadScope {
+    public:
+        ThreadScope(Session* session, const std::string& name) : previous_(currentBuffer()) {
+            if (session && !(previous_ && previous_->session == session)) {
+                currentBuffer() = session->registerThread(name);
+            }
+        }
+        ~ThreadScope() { currentBuffer() = previous_; }
+        ThreadScope(const ThreadScope&) = delete;
+        ThreadScope& operator=(const ThreadScope&) = delete;
+
+    private:
+        ThreadBuffer* previous_;
+};
+
+class ScopedTimer {
+    public:
+        explicit ScopedTimer(Phase phase) : buffer_(currentBuffer()), phase_(phase) {
+            if (buffer_) start_ = std::chrono::steady_clock::now();
+        }
+        ~ScopedTimer() {
+            if (buffer_) buffer_->record(phase_, start_, std::chrono::steady_clock::now());
+        }
+        ScopedTimer(const ScopedTimer&) = delete;
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+    private:
+        ThreadBuffer* buffer_;
+        Phase phase_;
+        std::chrono::steady_clock::time_point start_;
+};
+
+inline void count(Counter counter, long long amount) {
+    if (ThreadBuffer* buffer = currentBuffer()) buffer->counters[static_cast<int>(counter)] += amount;
+}
+
+} // namespace Instrumentation
+} // namespace MIPSolver
+
+#define MIPSOLVER_INSTRUMENTATION_CONCAT_(a, b) a##b
+#define MIPSOLVER_INSTRUMENTATION_CONCAT(a, b) MIPSOLVER_INSTRUMENTATION_CONCAT_(a, b)
+
+#ifdef MIPSOLVER_ENABLE_INSTRUMENTATION
+#define MIPSOLVER_TRACE_SCOPE(phase) \
+    ::MIPSolver::Instrumentation::ScopedTimer MIPSOLVER_INSTRUMENTATION_CONCAT(mipsolver_trace_scope_, __LINE__)( \
+        ::MIPSolver::Instrumentation::Phase::phase)
+#define MIPSOLVER_COUNT(counter, amount) \
+    ::MIPSolver::Instrumentation::count(::MIPSolver::Instrumentation::Counter::counter, (amount))
+#define MIPSOLVER_TRACE_THREAD(session, name) \
+    ::MIPSolver::Instrumentation::ThreadScope MIPSOLVER_INSTRUMENTATION_CONCAT(mipsolver_trace_thread_, __LINE__)( \
+        (session), (name))
+#else
+#define MIPSOLVER_TRACE_SCOPE(phase) ((void)0)
+#define MIPSOLVER_COUNT(counter, amount) ((void)0)
+#define MIPSOLVER_TRACE_THREAD(session, name) ((void)0)
+#endif
+
+#endif
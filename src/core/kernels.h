@@ -0,0 +1,665 @@
+#ifndef MIP_SOLVER_KERNELS_H
+#define MIP_SOLVER_KERNELS_H
+
+/*
+ * 可行性检查与目标值的向量化内核
+ *
+ * 启发式对每个候选解都要计算行活动度、违反量和目标值，这里给出这些循环的SIMD实现：
+ *
+ * 1. 指令集：x86-64上的AVX2与AVX-512F（GCC/Clang的target属性编译，首次使用时按CPU选择），
+ *    AArch64上的NEON（基线指令集，总是可用），其余平台和编译器使用标量实现。
+ *    定义MIPSOLVER_DISABLE_SIMD编译时只保留标量实现；setInstructionSet可以临时降级（测试、基准）
+ *
+ * 2. 可复现：所有实现使用同一个求和顺序——第k项计入第k%8路部分和，八路部分和按
+ *    ((s0+s4)+(s2+s6)) + ((s1+s5)+(s3+s7)) 合并——并且不使用FMA，
+ *    因此同一输入在任何指令集上得到逐位相同的结果，确定性求解不受运行机器的影响
+ *
+ * 3. 批量：rowActivitiesBatch等一次处理count个候选解。候选解按变量交错存放
+ *    （第s个解的第j个分量在X[j * count + s]），每个非零元对全部候选解做一次连续的向量乘加，
+ *    不需要gather；结果与逐个计算逐位相同
+ *
+ * 违反量：值v相对区间[lower, upper]的违反量为max(lower - v, v - upper, 0)，
+ * 出现NaN时为无穷大。
+ */
+
+#include "sparse_matrix.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#if !defined(MIPSOLVER_DISABLE_SIMD)
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#define MIPSOLVER_KERNELS_X86 1
+#include <immintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#define MIPSOLVER_KERNELS_NEON 1
+#include <arm_neon.h>
+#endif
+#endif
+
+// Products and sums must round separately in every variant
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC push_options
+#pragma GCC optimize("fp-contract=off")
+#endif
+
+namespace MIPSolver {
+namespace Kernels {
+
+enum class InstructionSet {
+    SCALAR,
+    AVX2,
+    AVX512,
+    NEON
+};
+
+inline const char* instructionSetName(InstructionSet set) {
+    switch (set) {
+        case InstructionSet::AVX2: return "avx2";
+        case InstructionSet::AVX512: return "avx512";
+        case InstructionSet::NEON: return "neon";
+        default: return "scalar";
+    }
+}
+
+namespace detail {
+
+constexpr int kLanes = 8;  // partial sums of the canonical summation order
+
+inline double combineLanes(const double* s) {
+    return ((s[0] + s[4]) + (s[2] + s[6])) + ((s[1] + s[5]) + (s[3] + s[7]));
+}
+
+inline double violation(double value, double lower, double upper) {
+    double below = lower - value;
+    double above = value - upper;
+    if (std::isnan(below) || std::isnan(above)) return std::numeric_limits<double>::infinity();
+    double v = below > above ? below : above;
+    return v > 0.0 ? v : 0.0;
+}
+
+// ---- Scalar reference implementations ----
+
+inline double sparseDotScalar(const int* index, const double* value, int size, const double* x) {
+    double s[kLanes] = {};
+    for (int k = 0; k < size; ++k) {
+        double product = value[k] * x[index[k]];
+        s[k % kLanes] += product;
+    }
+    return combineLanes(s);
+}
+
+inline double dotScalar(const double* a, const double* x, int size) {
+    double s[kLanes] = {};
+    for (int k = 0; k < size; ++k) {
+        double product = a[k] * x[k];
+        s[k % kLanes] += product;
+    }
+    return combineLanes(s);
+}
+
+inline double maxViolationScalar(const double* values, const double* lower, const double* upper, int size) {
+    double result = 0.0;
+    for (int i = 0; i < size; ++i) {
+        double v = violation(values[i], lower[i], upper[i]);
+        if (v > result) result = v;
+    }
+    return result;
+}
+
+inline double sumViolationScalar(const double* values, const double* lower, const double* upper, int size) {
+    double s[kLanes] = {};
+    for (int i = 0; i < size; ++i) {
+        s[i % kLanes] += violation(values[i], lower[i], upper[i]);
+    }
+    return combineLanes(s);
+}
+
+// acc[s] += a * x[s]
+inline void scaleAddScalar(double a, const double* x, double* acc, int count) {
+    for (int s = 0; s < count; ++s) {
+        double product = a * x[s];
+        acc[s] += product;
+    }
+}
+
+// out[s] = canonical combination of lanes[l * count + s]
+inline void combineLanesBatchScalar(const double* lanes, int count, double* out) {
+    for (int s = 0; s < count; ++s) {
+        double l[kLanes];
+        for (int k = 0; k < kLanes; ++k) l[k] = lanes[k * count + s];
+        out[s] = combineLanes(l);
+    }
+}
+
+// result[s] = max(result[s], violation of values[i * count + s] against [lower[i], upper[i]])
+inline void maxViolationBatchScalar(const double* values, const double* lower, const double* upper, int size,
+                                    int count, double* result) {
+    for (int i = 0; i < size; ++i) {
+        for (int s = 0; s < count; ++s) {
+            double v = violation(values[i * count + s], lower[i], upper[i]);
+            if (v > result[s]) result[s] = v;
+        }
+    }
+}
+
+#if defined(MIPSOLVER_KERNELS_X86)
+
+// GCC's intrinsic headers start some operations from an "undefined" register and warn about it
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+// ---- AVX2: two 4-wide accumulators hold the eight lanes ----
+
+__attribute__((target("avx2"))) inline double finishAvx2(__m256d lo, __m256d hi, int done, int size,
+                                                         const int* index, const double* value, const double* x) {
+    alignas(32) double s[kLanes];
+    _mm256_store_pd(s, lo);
+    _mm256_store_pd(s + 4, hi);
+    for (int k = done; k < size; ++k) {
+        double product = value[k] * (index ? x[index[k]] : x[k]);
+        s[k % kLanes] += product;
+    }
+    return combineLanes(s);
+}
+
+__attribute__((target("avx2"))) inline double sparseDotAvx2(const int* index, const double* value, int size,
+                                                            const double* x) {
+    __m256d lo = _mm256_setzero_pd();
+    __m256d hi = _mm256_setzero_pd();
+    int k = 0;
+    for (; k + kLanes <= size; k += kLanes) {
+        __m128i i0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(index + k));
+        __m128i i1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(index + k + 4));
+        lo = _mm256_add_pd(lo, _mm256_mul_pd(_mm256_loadu_pd(value + k), _mm256_i32gather_pd(x, i0, 8)));
+        hi = _mm256_add_pd(hi, _mm256_mul_pd(_mm256_loadu_pd(value + k + 4), _mm256_i32gather_pd(x, i1, 8)));
+    }
+    return finishAvx2(lo, hi, k, size, index, value, x);
+}
+
+__attribute__((target("avx2"))) inline double dotAvx2(const double* a, const double* x, int size) {
+    __m256d lo = _mm256_setzero_pd();
+    __m256d hi = _mm256_setzero_pd();
+    int k = 0;
+    for (; k + kLanes <= size; k += kLanes) {
+        lo = _mm256_add_pd(lo, _mm256_mul_pd(_mm256_loadu_pd(a + k), _mm256_loadu_pd(x + k)));
+        hi = _mm256_add_pd(hi, _mm256_mul_pd(_mm256_loadu_pd(a + k + 4), _mm256_loadu_pd(x + k + 4)));
+    }
+    return finishAvx2(lo, hi, k, size, nullptr, a, x);
+}
+
+__attribute__((target("avx2"))) inline __m256d violationAvx2(__m256d v, __m256d lower, __m256d upper) {
+    __m256d below = _mm256_sub_pd(lower, v);
+    __m256d above = _mm256_sub_pd(v, upper);
+    __m256d worst = _mm256_max_pd(_mm256_max_pd(below, above), _mm256_setzero_pd());
+    __m256d nan = _mm256_cmp_pd(below, above, _CMP_UNORD_Q);
+    return _mm256_blendv_pd(worst, _mm256_set1_pd(std::numeric_limits<double>::infinity()), nan);
+}
+
+__attribute__((target("avx2"))) inline double maxViolationAvx2(const double* values, const double* lower,
+                                                               const double* upper, int size) {
+    __m256d acc = _mm256_setzero_pd();
+    int i = 0;
+    for (; i + 4 <= size; i += 4) {
+        acc = _mm256_max_pd(acc, violationAvx2(_mm256_loadu_pd(values + i), _mm256_loadu_pd(lower + i),
+                                               _mm256_loadu_pd(upper + i)));
+    }
+    alignas(32) double lanes[4];
+    _mm256_store_pd(lanes, acc);
+    double result = std::max(std::max(lanes[0], lanes[1]), std::max(lanes[2], lanes[3]));
+    for (; i < size; ++i) result = std::max(result, violation(values[i], lower[i], upper[i]));
+    return result;
+}
+
+__attribute__((target("avx2"))) inline double sumViolationAvx2(const double* values, const double* lower,
+                                                               const double* upper, int size) {
+    __m256d lo = _mm256_setzero_pd();
+    __m256d hi = _mm256_setzero_pd();
+    int i = 0;
+    for (; i + kLanes <= size; i += kLanes) {
+        lo = _mm256_add_pd(lo, violationAvx2(_mm256_loadu_pd(values + i), _mm256_loadu_pd(lower + i),
+                                             _mm256_loadu_pd(upper + i)));
+        hi = _mm256_add_pd(hi, violationAvx2(_mm256_loadu_pd(values + i + 4), _mm256_loadu_pd(lower + i + 4),
+                                             _mm256_loadu_pd(upper + i + 4)));
+    }
+    alignas(32) double s[kLanes];
+    _mm256_store_pd(s, lo);
+    _mm256_store_pd(s + 4, hi);
+    for (; i < size; ++i) s[i % kLanes] += violation(values[i], lower[i], upper[i]);
+    return combineLanes(s);
+}
+
+__attribute__((target("avx2"))) inline void scaleAddAvx2(double a, const double* x, double* acc, int count) {
+    __m256d factor = _mm256_set1_pd(a);
+    int s = 0;
+    for (; s + 4 <= count; s += 4) {
+        _mm256_storeu_pd(acc + s, _mm256_add_pd(_mm256_loadu_pd(acc + s), _mm256_mul_pd(factor, _mm256_loadu_pd(x + s))));
+    }
+    scaleAddScalar(a, x + s, acc + s, count - s);
+}
+
+__attribute__((target("avx2"))) inline void combineLanesBatchAvx2(const double* lanes, int count, double* out) {
+    int s = 0;
+    for (; s + 4 <= count; s += 4) {
+        __m256d l[kLanes];
+        for (int k = 0; k < kLanes; ++k) l[k] = _mm256_loadu_pd(lanes + k * count + s);
+        __m256d even = _mm256_add_pd(_mm256_add_pd(l[0], l[4]), _mm256_add_pd(l[2], l[6]));
+        __m256d odd = _mm256_add_pd(_mm256_add_pd(l[1], l[5]), _mm256_add_pd(l[3], l[7]));
+        _mm256_storeu_pd(out + s, _mm256_add_pd(even, odd));
+    }
+    for (; s < count; ++s) {
+        double l[kLanes];
+        for (int k = 0; k < kLanes; ++k) l[k] = lanes[k * count + s];
+        out[s] = combineLanes(l);
+    }
+}
+
+__attribute__((target("avx2"))) inline void maxViolationBatchAvx2(const double* values, const double* lower,
+                                                                  const double* upper, int size, int count,
+                                                                  double* result) {
+    for (int i = 0; i < size; ++i) {
+        __m256d lo = _mm256_set1_pd(lower[i]);
+        __m256d up = _mm256_set1_pd(upper[i]);
+        const double* row = values + static_cast<size_t>(i) * count;
+        int s = 0;
+        for (; s + 4 <= count; s += 4) {
+            _mm256_storeu_pd(result + s, _mm256_max_pd(_mm256_loadu_pd(result + s),
+                                                       violationAvx2(_mm256_loadu_pd(row + s), lo, up)));
+        }
+        for (; s < count; ++s) result[s] = std::max(result[s], violation(row[s], lower[i], upper[i]));
+    }
+}
+
+// ---- AVX-512F: one 8-wide accumulator holds the eight lanes ----
+
+__attribute__((target("avx512f"))) inline double finishAvx512(__m512d acc, int done, int size, const int* index,
+                                                              const double* value, const double* x) {
+    alignas(64) double s[kLanes];
+    _mm512_store_pd(s, acc);
+    for (int k = done; k < size; ++k) {
+        double product = value[k] * (index ? x[index[k]] : x[k]);
+        s[k % kLanes] += product;
+    }
+    return combineLanes(s);
+}
+
+__attribute__((target("avx512f"))) inline double sparseDotAvx512(const int* index, const double* value, int size,
+                                                                 const double* x) {
+    __m512d acc = _mm512_setzero_pd();
+    int k = 0;
+    for (; k + kLanes <= size; k += kLanes) {
+        __m256i i8 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(index + k));
+        acc = _mm512_add_pd(acc, _mm512_mul_pd(_mm512_loadu_pd(value + k), _mm512_i32gather_pd(i8, x, 8)));
+    }
+    return finishAvx512(acc, k, size, index, value, x);
+}
+
+__attribute__((target("avx512f"))) inline double dotAvx512(const double* a, const double* x, int size) {
+    __m512d acc = _mm512_setzero_pd();
+    int k = 0;
+    for (; k + kLanes <= size; k += kLanes) {
+        acc = _mm512_add_pd(acc, _mm512_mul_pd(_mm512_loadu_pd(a + k), _mm512_loadu_pd(x + k)));
+    }
+    return finishAvx512(acc, k, size, nullptr, a, x);
+}
+
+__attribute__((target("avx512f"))) inline __m512d violationAvx512(__m512d v, __m512d lower, __m512d upper) {
+    __m512d below = _mm512_sub_pd(lower, v);
+    __m512d above = _mm512_sub_pd(v, upper);
+    __m512d worst = _mm512_max_pd(_mm512_max_pd(below, above), _mm512_setzero_pd());
+    __mmask8 nan = _mm512_cmp_pd_mask(below, above, _CMP_UNORD_Q);
+    return _mm512_mask_blend_pd(nan, worst, _mm512_set1_pd(std::numeric_limits<double>::infinity()));
+}
+
+__attribute__((target("avx512f"))) inline double maxViolationAvx512(const double* values, const double* lower,
+                                                                    const double* upper, int size) {
+    __m512d acc = _mm512_setzero_pd();
+    int i = 0;
+    for (; i + kLanes <= size; i += kLanes) {
+        acc = _mm512_max_pd(acc, violationAvx512(_mm512_loadu_pd(values + i), _mm512_loadu_pd(lower + i),
+                                                 _mm512_loadu_pd(upper + i)));
+    }
+    double result = _mm512_reduce_max_pd(acc);
+    for (; i < size; ++i) result = std::max(result, violation(values[i], lower[i], upper[i]));
+    return result;
+}
+
+__attribute__((target("avx512f"))) inline double sumViolationAvx512(const double* values, const double* lower,
+                                                                    const double* upper, int size) {
+    __m512d acc = _mm512_setzero_pd();
+    int i = 0;
+    for (; i + kLanes <= size; i += kLanes) {
+        acc = _mm512_add_pd(acc, violationAvx512(_mm512_loadu_pd(values + i), _mm512_loadu_pd(lower + i),
+                                                 _mm512_loadu_pd(upper + i)));
+    }
+    alignas(64) double s[kLanes];
+    _mm512_store_pd(s, acc);
+    for (; i < size; ++i) s[i % kLanes] += violation(values[i], lower[i], upper[i]);
+    return combineLanes(s);
+}
+
+__attribute__((target("avx512f"))) inline void scaleAddAvx512(double a, const double* x, double* acc, int count) {
+    __m512d factor = _mm512_set1_pd(a);
+    int s = 0;
+    for (; s + 8 <= count; s += 8) {
+        _mm512_storeu_pd(acc + s, _mm512_add_pd(_mm512_loadu_pd(acc + s), _mm512_mul_pd(factor, _mm512_loadu_pd(x + s))));
+    }
+    scaleAddScalar(a, x + s, acc + s, count - s);
+}
+
+__attribute__((target("avx512f"))) inline void combineLanesBatchAvx512(const double* lanes, int count, double* out) {
+    int s = 0;
+    for (; s + 8 <= count; s += 8) {
+        __m512d l[kLanes];
+        for (int k = 0; k < kLanes; ++k) l[k] = _mm512_loadu_pd(lanes + k * count + s);
+        __m512d even = _mm512_add_pd(_mm512_add_pd(l[0], l[4]), _mm512_add_pd(l[2], l[6]));
+        __m512d odd = _mm512_add_pd(_mm512_add_pd(l[1], l[5]), _mm512_add_pd(l[3], l[7]));
+        _mm512_storeu_pd(out + s, _mm512_add_pd(even, odd));
+    }
+    for (; s < count; ++s) {
+        double l[kLanes];
+        for (int k = 0; k < kLanes; ++k) l[k] = lanes[k * count + s];
+        out[s] = combineLanes(l);
+    }
+}
+
+__attribute__((target("avx512f"))) inline void maxViolationBatchAvx512(const double* values, const double* lower,
+                                                                      const double* upper, int size, int count,
+                                                                      double* result) {
+    for (int i = 0; i < size; ++i) {
+        __m512d lo = _mm512_set1_pd(lower[i]);
+        __m512d up = _mm512_set1_pd(upper[i]);
+        const double* row = values + static_cast<size_t>(i) * count;
+        int s = 0;
+        for (; s + 8 <= count; s += 8) {
+            _mm512_storeu_pd(result + s, _mm512_max_pd(_mm512_loadu_pd(result + s),
+                                                       violationAvx512(_mm512_loadu_pd(row + s), lo, up)));
+        }
+        for (; s < count; ++s) result[s] = std::max(result[s], violation(row[s], lower[i], upper[i]));
+    }
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#endif  // MIPSOLVER_KERNELS_X86
+
+#if defined(MIPSOLVER_KERNELS_NEON)
+
+// ---- NEON: four 2-wide accumulators hold the eight lanes ----
+
+inline double finishNeon(const float64x2_t* acc, int done, int size, const int* index, const double* value,
+                         const double* x) {
+    double s[kLanes];
+    for (int q = 0; q < 4; ++q) vst1q_f64(s + 2 * q, acc[q]);
+    for (int k = done; k < size; ++k) {
+        double product = value[k] * (index ? x[index[k]] : x[k]);
+        s[k % kLanes] += product;
+    }
+    return combineLanes(s);
+}
+
+inline double sparseDotNeon(const int* index, const double* value, int size, const double* x) {
+    float64x2_t acc[4] = {vdupq_n_f64(0.0), vdupq_n_f64(0.0), vdupq_n_f64(0.0), vdupq_n_f64(0.0)};
+    int k = 0;
+    for (; k + kLanes <= size; k += kLanes) {
+        for (int q = 0; q < 4; ++q) {
+            float64x2_t xv = vsetq_lane_f64(x[index[k + 2 * q + 1]], vdupq_n_f64(x[index[k + 2 * q]]), 1);
+            acc[q] = vaddq_f64(acc[q], vmulq_f64(vld1q_f64(value + k + 2 * q), xv));
+        }
+    }
+    return finishNeon(acc, k, size, index, value, x);
+}
+
+inline double dotNeon(const double* a, const double* x, int size) {
+    float64x2_t acc[4] = {vdupq_n_f64(0.0), vdupq_n_f64(0.0), vdupq_n_f64(0.0), vdupq_n_f64(0.0)};
+    int k = 0;
+    for (; k + kLanes <= size; k += kLanes) {
+        for (int q = 0; q < 4; ++q) {
+            acc[q] = vaddq_f64(acc[q], vmulq_f64(vld1q_f64(a + k + 2 * q), vld1q_f64(x + k + 2 * q)));
+        }
+    }
+    return finishNeon(acc, k, size, nullptr, a, x);
+}
+
+inline float64x2_t violationNeon(float64x2_t v, float64x2_t lower, float64x2_t upper) {
+    float64x2_t below = vsubq_f64(lower, v);
+    float64x2_t above = vsubq_f64(v, upper);
+    float64x2_t worst = vmaxq_f64(vmaxq_f64(below, above), vdupq_n_f64(0.0));
+    uint64x2_t ordered = vandq_u64(vceqq_f64(below, below), vceqq_f64(above, above));
+    return vbslq_f64(ordered, worst, vdupq_n_f64(std::numeric_limits<double>::infinity()));
+}
+
+inline double maxViolationNeon(const double* values, const double* lower, const double* upper, int size) {
+    float64x2_t acc = vdupq_n_f64(0.0);
+    int i = 0;
+    for (; i + 2 <= size; i += 2) {
+        acc = vmaxq_f64(acc, violationNeon(vld1q_f64(values + i), vld1q_f64(lower + i), vld1q_f64(upper + i)));
+    }
+    double result = vmaxvq_f64(acc);
+    for (; i < size; ++i) result = std::max(result, violation(values[i], lower[i], upper[i]));
+    return result;
+}
+
+inline double sumViolationNeon(const double* values, const double* lower, const double* upper, int size) {
+    float64x2_t acc[4] = {vdupq_n_f64(0.0), vdupq_n_f64(0.0), vdupq_n_f64(0.0), vdupq_n_f64(0.0)};
+    int i = 0;
+    for (; i + kLanes <= size; i += kLanes) {
+        for (int q = 0; q < 4; ++q) {
+            int o = i + 2 * q;
+            acc[q] = vaddq_f64(acc[q], violationNeon(vld1q_f64(values + o), vld1q_f64(lower + o), vld1q_f64(upper + o)));
+        }
+    }
+    double s[kLanes];
+    for (int q = 0; q < 4; ++q) vst1q_f64(s + 2 * q, acc[q]);
+    for (; i < size; ++i) s[i % kLanes] += violation(values[i], lower[i], upper[i]);
+    return combineLanes(s);
+}
+
+inline void scaleAddNeon(double a, const double* x, double* acc, int count) {
+    float64x2_t factor = vdupq_n_f64(a);
+    int s = 0;
+    for (; s + 2 <= count; s += 2) {
+        vst1q_f64(acc + s, vaddq_f64(vld1q_f64(acc + s), vmulq_f64(factor, vld1q_f64(x + s))));
+    }
+    scaleAddScalar(a, x + s, acc + s, count - s);
+}
+
+inline void combineLanesBatchNeon(const double* lanes, int count, double* out) {
+    int s = 0;
+    for (; s + 2 <= count; s += 2) {
+        float64x2_t l[kLanes];
+        for (int k = 0; k < kLanes; ++k) l[k] = vld1q_f64(lanes + k * count + s);
+        float64x2_t even = vaddq_f64(vaddq_f64(l[0], l[4]), vaddq_f64(l[2], l[6]));
+        float64x2_t odd = vaddq_f64(vaddq_f64(l[1], l[5]), vaddq_f64(l[3], l[7]));
+        vst1q_f64(out + s, vaddq_f64(even, odd));
+    }
+    combineLanesBatchScalar(lanes + s, count - s, out + s);
+}
+
+inline void maxViolationBatchNeon(const double* values, const double* lower, const double* upper, int size,
+                                  int count, double* result) {
+    for (int i = 0; i < size; ++i) {
+        float64x2_t lo = vdupq_n_f64(lower[i]);
+        float64x2_t up = vdupq_n_f64(upper[i]);
+        const double* row = values + static_cast<size_t>(i) * count;
+        int s = 0;
+        for (; s + 2 <= count; s += 2) {
+            vst1q_f64(result + s, vmaxq_f64(vld1q_f64(result + s), violationNeon(vld1q_f64(row + s), lo, up)));
+        }
+        for (; s < count; ++s) result[s] = std::max(result[s], violation(row[s], lower[i], upper[i]));
+    }
+}
+
+#endif  // MIPSOLVER_KERNELS_NEON
+
+struct KernelTable {
+    InstructionSet set;
+    double (*sparse_dot)(const int*, const double*, int, const double*);
+    double (*dot)(const double*, const double*, int);
+    double (*max_violation)(const double*, const double*, const double*, int);
+    double (*sum_violation)(const double*, const double*, const double*, int);
+    void (*scale_add)(double, const double*, double*, int);
+    void (*combine_lanes_batch)(const double*, int, double*);
+    void (*max_violation_batch)(const double*, const double*, const double*, int, int, double*);
+};
+
+inline const KernelTable* kernelTable(InstructionSet set) {
+    static const KernelTable scalar = {InstructionSet::SCALAR, sparseDotScalar, dotScalar, maxViolationScalar,
+                                       sumViolationScalar, scaleAddScalar, combineLanesBatchScalar,
+                                       maxViolationBatchScalar};
+#if defined(MIPSOLVER_KERNELS_X86)
+    static const KernelTable avx2 = {InstructionSet::AVX2, sparseDotAvx2, dotAvx2, maxViolationAvx2,
+                                     sumViolationAvx2, scaleAddAvx2, combineLanesBatchAvx2, maxViolationBatchAvx2};
+    static const KernelTable avx512 = {InstructionSet::AVX512, sparseDotAvx512, dotAvx512, maxViolationAvx512,
+                                       sumViolationAvx512, scaleAddAvx512, combineLanesBatchAvx512,
+                                       maxViolationBatchAvx512};
+    if (set == InstructionSet::AVX512) return &avx512;
+    if (set == InstructionSet::AVX2) return &avx2;
+#endif
+#if defined(MIPSOLVER_KERNELS_NEON)
+    static const KernelTable neon = {InstructionSet::NEON, sparseDotNeon, dotNeon, maxViolationNeon,
+                                     sumViolationNeon, scaleAddNeon, combineLanesBatchNeon, maxViolationBatchNeon};
+    if (set == InstructionSet::NEON) return &neon;
+#endif
+    return &scalar;
+}
+
+inline std::atomic<const KernelTable*>& activeTable() {
+    static std::atomic<const KernelTable*> table{nullptr};
+    return table;
+}
+
+}  // namespace detail
+
+// 本机（CPU与编译选项）支持的最好指令集
+inline InstructionSet supportedInstructionSet() {
+#if defined(MIPSOLVER_KERNELS_X86)
+    static const InstructionSet best = [] {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f")) return InstructionSet::AVX512;
+        if (__builtin_cpu_supports("avx2")) return InstructionSet::AVX2;
+        return InstructionSet::SCALAR;
+    }();
+    return best;
+#elif defined(MIPSOLVER_KERNELS_NEON)
+    return InstructionSet::NEON;
+#else
+    return InstructionSet::SCALAR;
+#endif
+}
+
+namespace detail {
+
+inline const KernelTable& table() {
+    const KernelTable* current = activeTable().load(std::memory_order_acquire);
+    if (!current) {
+        current = kernelTable(supportedInstructionSet());
+        activeTable().store(current, std::memory_order_release);
+    }
+    return *current;
+}
+
+inline bool isSupported(InstructionSet set) {
+    if (set == InstructionSet::SCALAR) return true;
+    InstructionSet best = supportedInstructionSet();
+    if (set == InstructionSet::NEON) return best == InstructionSet::NEON;
+    if (set == InstructionSet::AVX2) return best == InstructionSet::AVX2 || best == InstructionSet::AVX512;
+    return set == best;
+}
+
+}  // namespace detail
+
+inline InstructionSet activeInstructionSet() { return detail::table().set; }
+
+/*
+ * 选择内核使用的指令集（默认为supportedInstructionSet()）
+ *
+ * 本机不支持的指令集不会被选中。结果与指令集无关，这里只用于测试和基准对比。
+ * 不应在其他线程正在求解时调用
+ *
+ * @return: 是否切换到了set
+ */
+inline bool setInstructionSet(InstructionSet set) {
+    if (!detail::isSupported(set)) return false;
+    detail::activeTable().store(detail::kernelTable(set), std::memory_order_release);
+    return true;
+}
+
+// 稀疏向量与稠密向量的点积 sum_k value[k] * x[index[k]]
+inline double sparseDot(const int* index, const double* value, int size, const double* x) {
+    return detail::table().sparse_dot(index, value, size, x);
+}
+
+inline double dot(const double* a, const double* x, int size) {
+    return detail::table().dot(a, x, size);
+}
+
+// 最大违反量（全部满足时为0）与违反量之和
+inline double maxViolation(const double* values, const double* lower, const double* upper, int size) {
+    return detail::table().max_violation(values, lower, upper, size);
+}
+
+inline double sumViolation(const double* values, const double* lower, const double* upper, int size) {
+    return detail::table().sum_violation(values, lower, upper, size);
+}
+
+// 全部行活动度 activity[i] = a_i^T x
+inline void rowActivities(const SparseMatrix& matrix, const double* x, double* activity) {
+    const detail::KernelTable& kernels = detail::table();
+    for (int i = 0; i < matrix.getNumRows(); ++i) {
+        SparseMatrix::VectorView row = matrix.row(i);
+        activity[i] = kernels.sparse_dot(row.indices, row.values, row.size, x);
+    }
+}
+
+/*
+ * 批量行活动度：activity[i * count + s] = a_i^T x_s
+ *
+ * @param x: 交错存放的count个候选解，x[j * count + s]
+ * @param lanes: 工作区，至少8 * count个元素
+ */
+inline void rowActivitiesBatch(const SparseMatrix& matrix, const double* x, int count, double* activity,
+                               double* lanes) {
+    const detail::KernelTable& kernels = detail::table();
+    for (int i = 0; i < matrix.getNumRows(); ++i) {
+        SparseMatrix::VectorView row = matrix.row(i);
+        std::fill(lanes, lanes + detail::kLanes * count, 0.0);
+        for (int k = 0; k < row.size; ++k) {
+            kernels.scale_add(row.values[k], x + static_cast<size_t>(row.indices[k]) * count,
+                              lanes + (k % detail::kLanes) * count, count);
+        }
+        kernels.combine_lanes_batch(lanes, count, activity + static_cast<size_t>(i) * count);
+    }
+}
+
+// 批量稠密点积：result[s] = a^T x_s，x交错存放；lanes同上
+inline void dotBatch(const double* a, int size, const double* x, int count, double* result, double* lanes) {
+    const detail::KernelTable& kernels = detail::table();
+    std::fill(lanes, lanes + detail::kLanes * count, 0.0);
+    for (int j = 0; j < size; ++j) {
+        kernels.scale_add(a[j], x + static_cast<size_t>(j) * count, lanes + (j % detail::kLanes) * count, count);
+    }
+    kernels.combine_lanes_batch(lanes, count, result);
+}
+
+// 批量最大违反量：result[s] = max(result[s], 第s个解在size个区间上的最大违反量)，values交错存放
+inline void maxViolationBatch(const double* values, const double* lower, const double* upper, int size, int count,
+                              double* result) {
+    detail::table().max_violation_batch(values, lower, upper, size, count, result);
+}
+
+}  // namespace Kernels
+}  // namespace MIPSolver
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC pop_options
+#endif
+
+#endif
@@ -0,0 +1,121 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+/*
+ * 只读文件映射
+ *
+ * MPS解析器和二进制问题快照都把整个文件映射进内存后直接在映射上读取：
+ * - POSIX 使用 mmap，并提示内核按顺序预读
+ * - Windows 使用 CreateFileMapping / MapViewOfFile
+ * - 空文件或无法映射的文件（管道、特殊文件）退回到一次性读入内存
+ *
+ * 映射在对象析构时解除，从data()得到的视图不能比对象活得更久。
+ */
+
+#include <string>
+#include <string_view>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace MIPSolver {
+
+class MappedFile {
+    public:
+        explicit MappedFile(const std::string& filename) {
+#if defined(_WIN32)
+            file_ = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+            if (file_ == INVALID_HANDLE_VALUE) {
+                throw std::runtime_error("Could not open file: " + filename);
+            }
+            LARGE_INTEGER size;
+            if (GetFileSizeEx(file_, &size) && size.QuadPart > 0) {
+                mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+                if (mapping_) {
+                    view_ = MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0);
+                    if (view_) {
+                        data_ = static_cast<const char*>(view_);
+                        size_ = static_cast<size_t>(size.QuadPart);
+                        return;
+                    }
+                }
+            }
+#else
+            int fd = open(filename.c_str(), O_RDONLY);
+            if (fd < 0) {
+                throw std::runtime_error("Could not open file: " + filename);
+            }
+            struct stat info;
+            if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0) {
+                void* view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+                if (view != MAP_FAILED) {
+                    madvise(view, static_cast<size_t>(info.st_size), MADV_SEQUENTIAL);
+                    view_ = view;
+                    data_ = static_cast<const char*>(view);
+                    size_ = static_cast<size_t>(info.st_size);
+                    close(fd);
+                    return;
+                }
+            }
+            close(fd);
+#endif
+            readWhole(filename);
+        }
+
+        ~MappedFile() {
+#if defined(_WIN32)
+            if (view_) UnmapViewOfFile(view_);
+            if (mapping_) CloseHandle(mapping_);
+            if (file_ != INVALID_HANDLE_VALUE) CloseHandle(file_);
+#else
+            if (view_) munmap(view_, size_);
+#endif
+        }
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        std::string_view data() const { return std::string_view(data_, size_); }
+
+    private:
+        const char* data_ = nullptr;
+        size_t size_ = 0;
+        std::string contents_;  // used when the file could not be mapped
+#if defined(_WIN32)
+        HANDLE file_ = INVALID_HANDLE_VALUE;
+        HANDLE mapping_ = nullptr;
+        LPVOID view_ = nullptr;
+#else
+        void* view_ = nullptr;
+#endif
+
+        void readWhole(const std::string& filename) {
+            std::ifstream file(filename, std::ios::binary);
+            if (!file.is_open()) {
+                throw std::runtime_error("Could not open file: " + filename);
+            }
+            contents_.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+            data_ = contents_.data();
+            size_ = contents_.size();
+        }
+};
+
+} // namespace MIPSolver
+
+#endif
@@ -0,0 +1,111 @@
+#ifndef MIP_SOLVER_NAME_TABLE_H
+#define MIP_SOLVER_NAME_TABLE_H
+
+/*
+ * 变量名和约束名的紧凑存储
+ *
+ * 所有名字首尾相接地存放在一个字符缓冲区里，每个条目只占一个偏移和一个长度，
+ * 没有逐个名字的堆分配和std::string对象。名字只在输入输出和报告时查找，求解过程从不访问。
+ *
+ * 条目可以缺失（从未设置，或中间的条目被跳过），由调用者决定缺失时使用的名字。
+ * 改名时新名字不长于旧名字就原地覆盖，否则追加到缓冲区末尾；作废的字节超过一半时整理缓冲区
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace MIPSolver {
+
+class NameTable {
+public:
+    size_t size() const { return lengths_.size(); }
+    bool empty() const { return lengths_.empty(); }
+
+    void reserve(size_t entries) {
+        offsets_.reserve(entries);
+        lengths_.reserve(entries);
+    }
+
+    void clear() {
+        chars_.clear();
+        chars_.shrink_to_fit();
+        offsets_.clear();
+        offsets_.shrink_to_fit();
+        lengths_.clear();
+        lengths_.shrink_to_fit();
+        garbage_ = 0;
+    }
+
+    bool has(size_t index) const { return index < lengths_.size() && lengths_[index] != kMissing; }
+
+    // Empty view for missing entries
+    std::string_view get(size_t index) const {
+        if (!has(index)) return std::string_view();
+        return std::string_view(chars_.data() + offsets_[index], lengths_[index]);
+    }
+
+    // Sets entry index; entries between the current end and index become missing
+    void set(size_t index, std::string_view name) {
+        if (!chars_.empty() && name.data() >= chars_.data() && name.data() < chars_.data() + chars_.size()) {
+            set(index, std::string(name));  // the view would dangle once chars_ grows
+            return;
+        }
+        if (index >= lengths_.size()) {
+            offsets_.resize(index + 1, 0);
+            lengths_.resize(index + 1, kMissing);
+        }
+        uint32_t old_length = lengths_[index];
+        if (old_length != kMissing && name.size() <= old_length) {
+            std::copy(name.begin(), name.end(), chars_.begin() + offsets_[index]);
+            garbage_ += old_length - name.size();
+        } else {
+            if (old_length != kMissing) garbage_ += old_length;
+            offsets_[index] = chars_.size();
+            chars_.insert(chars_.end(), name.begin(), name.end());
+        }
+        lengths_[index] = static_cast<uint32_t>(name.size());
+        if (garbage_ > chars_.size() / 2) compact(nullptr);
+    }
+
+    // Drops the entries with remove[i] set; the others keep their order
+    void erase(const std::vector<bool>& remove) { compact(&remove); }
+
+    // Heap bytes held by the table
+    size_t memoryBytes() const {
+        return chars_.capacity() + offsets_.capacity() * sizeof(uint64_t) + lengths_.capacity() * sizeof(uint32_t);
+    }
+
+private:
+    static constexpr uint32_t kMissing = UINT32_MAX;
+
+    std::vector<char> chars_;
+    std::vector<uint64_t> offsets_;
+    std::vector<uint32_t> lengths_;
+    size_t garbage_ = 0;  // bytes of chars_ no entry refers to
+
+    void compact(const std::vector<bool>* remove) {
+        std::vector<char> chars;
+        chars.reserve(chars_.size() - garbage_);
+        size_t kept = 0;
+        for (size_t i = 0; i < lengths_.size(); ++i) {
+            if (remove && i < remove->size() && (*remove)[i]) continue;
+            uint64_t offset = offsets_[i];
+            uint32_t length = lengths_[i];
+            offsets_[kept] = chars.size();
+            lengths_[kept] = length;
+            if (length != kMissing) chars.insert(chars.end(), chars_.begin() + offset, chars_.begin() + offset + length);
+            kept++;
+        }
+        offsets_.resize(kept);
+        lengths_.resize(kept);
+        chars_.swap(chars);
+        garbage_ = 0;
+    }
+};
+
+} // namespace MIPSolver
+
+#endif
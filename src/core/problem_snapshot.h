@@ -0,0 +1,309 @@
+#ifndef PROBLEM_SNAPSHOT_H
+#define PROBLEM_SNAPSHOT_H
+
+/*
+ * Problem的二进制快照
+ *
+ * 反复求解同一批基础模型时，用快照代替MPS文本可以跳过解析：
+ *
+ * 1. 文件布局（本机字节序，载入时检查）：
+ *    - 64字节文件头：魔数、版本、字节序标记、标志位（是否含名字表、是否最大化）、维度和各段大小
+ *    - 8字节数组：矩阵值、变量下界、变量上界、目标系数、约束右端项、约束区间
+ *    - 4字节数组：CSR行起点（m+1个）、列索引
+ *    - 1字节数组：变量类型、约束类型（最高位标记约束带区间）
+ *    - 名字表：偏移数组（uint64）加连续的字符数据；第一个名字是问题名，
+ *      之后按需依次是全部变量名和约束名
+ *    - 每段按8字节对齐
+ *
+ * 2. 载入：
+ *    - 文件整体映射进内存（MappedFile），校验文件头、总长度和CSR结构
+ *    - 每个数组整块复制到Problem的存储中，矩阵直接作为规范化的CSR装入，不经过三元组排序
+ *    - 不写名字表时（或问题没有保存名字时）载入的问题不保存名字，按 x<下标> / c<下标> 命名，
+ *      载入时没有逐元素的内存分配
+ *
+ * 3. 内存缓冲区：serialize / deserialize 使用同样的布局，用于在进程之间传送问题（见DistributedSolver）
+ *
+ * 快照与具体的平台字节序绑定，不适合作为长期归档格式；格式不符时抛出std::runtime_error。
+ */
+
+#include "core.h"
+#include "mapped_file.h"
+#include <cstdint>
+#include <limits>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <stdexcept>
+
+namespace MIPSolver {
+
+class ProblemSnapshot {
+public:
+    /*
+     * 把问题写入快照文件
+     *
+     * @param include_names: 是否写入变量名和约束名（问题名总是写入；问题没有保存名字时不写）
+     */
+    static void save(const Problem& problem, const std::string& filename, bool include_names = true) {
+        std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            throw std::runtime_error("Could not open file for writing: " + filename);
+        }
+        write(problem, file, include_names);
+        if (!file) {
+            throw std::runtime_error("Could not write problem snapshot: " + filename);
+        }
+    }
+
+    // 从快照文件载入问题
+    static Problem load(const std::string& filename) {
+        MappedFile file(filename);
+        return parse(file.data(), filename);
+    }
+
+    // 把问题写成内存中的快照，布局与save相同
+    static std::string serialize(const Problem& problem, bool include_names = true) {
+        std::ostringstream buffer(std::ios::binary);
+        write(problem, buffer, include_names);
+        return buffer.str();
+    }
+
+    // 从内存中的快照载入问题
+    static Problem deserialize(std::string_view data) {
+        return parse(data, "<buffer>");
+    }
+
+private:
+    static void write(const Problem& problem, std::ostream& file, bool include_names) {
+        const SparseMatrix& matrix = problem.getMatrix();
+        const int n = problem.getNumVariables();
+        const int m = problem.getNumConstraints();
+
+        std::vector<double> lower(n), upper(n), objective(n), rhs(m), range(m);
+        std::vector<uint8_t> var_type(n), row_type(m);
+        for (int j = 0; j < n; ++j) {
+            ConstVariable var = problem.getVariable(j);
+            lower[j] = var.getLowerBound();
+            upper[j] = var.getUpperBound();
+            objective[j] = var.getCoefficient();
+            var_type[j] = static_cast<uint8_t>(var.getType());
+        }
+        for (int i = 0; i < m; ++i) {
+            ConstConstraint constraint = problem.getConstraint(i);
+            rhs[i] = constraint.getRHS();
+            range[i] = constraint.getRange();
+            row_type[i] = static_cast<uint8_t>(constraint.getType()) | (constraint.hasRange() ? kRangeFlag : 0);
+        }
+
+        std::vector<uint64_t> name_offsets(1, 0);
+        std::string names;
+        auto add_name = [&](const std::string& name) {
+            names += name;
+            name_offsets.push_back(names.size());
+        };
+        add_name(problem.getName());
+        const bool with_names = include_names && problem.hasNames();
+        if (with_names) {
+            for (int j = 0; j < n; ++j) add_name(problem.getVariable(j).getName());
+            for (int i = 0; i < m; ++i) add_name(problem.getConstraint(i).getName());
+        }
+
+        Header header = {};
+        std::memcpy(header.magic, kMagic, sizeof(header.magic));
+        header.version = kVersion;
+        header.endian = kEndianMark;
+        header.flags = (with_names ? kHasNames : 0u) |
+                       (problem.getObjectiveType() == ObjectiveType::MAXIMIZE ? kMaximize : 0u);
+        header.num_variables = n;
+        header.num_constraints = m;
+        header.num_nonzeros = matrix.getNumNonzeros();
+        header.names_bytes = names.size();
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        writeSection(file, matrix.getValues().data(), matrix.getValues().size());
+        writeSection(file, lower.data(), lower.size());
+        writeSection(file, upper.data(), upper.size());
+        writeSection(file, objective.data(), objective.size());
+        writeSection(file, rhs.data(), rhs.size());
+        writeSection(file, range.data(), range.size());
+        writeSection(file, matrix.getRowStarts().data(), matrix.getRowStarts().size());
+        writeSection(file, matrix.getColumnIndices().data(), matrix.getColumnIndices().size());
+        writeSection(file, var_type.data(), var_type.size());
+        writeSection(file, row_type.data(), row_type.size());
+        writeSection(file, name_offsets.data(), name_offsets.size());
+        writeSection(file, names.data(), names.size());
+    }
+
+    // Parses a snapshot held in memory; filename only names the source in error messages
+    static Problem parse(std::string_view data, const std::string& filename) {
+        if (data.size() < sizeof(Header)) invalid(filename, "file too short");
+
+        Header header;
+        std::memcpy(&header, data.data(), sizeof(header));
+        if (std::memcmp(header.magic, kMagic, sizeof(header.magic)) != 0) invalid(filename, "bad magic");
+        if (header.endian != kEndianMark) invalid(filename, "byte order mismatch");
+        if (header.version != kVersion) invalid(filename, "unsupported version");
+        if (header.num_variables < 0 || header.num_constraints < 0 ||
+            header.num_nonzeros > static_cast<uint64_t>(std::numeric_limits<int>::max())) {
+            invalid(filename, "bad dimensions");
+        }
+
+        const size_t n = static_cast<size_t>(header.num_variables);
+        const size_t m = static_cast<size_t>(header.num_constraints);
+        const size_t nnz = static_cast<size_t>(header.num_nonzeros);
+        const bool has_names = (header.flags & kHasNames) != 0;
+        const size_t num_names = 1 + (has_names ? n + m : 0);
+
+        // Section offsets follow the order written by save()
+        Reader reader{data, sizeof(Header)};
+        size_t values_at = reader.take<double>(nnz);
+        size_t lower_at = reader.take<double>(n);
+        size_t upper_at = reader.take<double>(n);
+        size_t objective_at = reader.take<double>(n);
+        size_t rhs_at = reader.take<double>(m);
+        size_t range_at = reader.take<double>(m);
+        size_t row_start_at = reader.take<int32_t>(m + 1);
+        size_t col_index_at = reader.take<int32_t>(nnz);
+        size_t var_type_at = reader.take<uint8_t>(n);
+        size_t row_type_at = reader.take<uint8_t>(m);
+        size_t offsets_at = reader.take<uint64_t>(num_names + 1);
+        size_t names_at = reader.take<char>(header.names_bytes);
+        if (reader.overflow || reader.offset != data.size()) invalid(filename, "size mismatch");
+
+        std::vector<int> row_start = reader.array<int>(row_start_at, m + 1);
+        std::vector<int> col_index = reader.array<int>(col_index_at, nnz);
+        std::vector<double> values = reader.array<double>(values_at, nnz);
+        if (row_start[0] != 0 || static_cast<size_t>(row_start[m]) != nnz) invalid(filename, "bad row starts");
+        for (size_t i = 0; i < m; ++i) {
+            if (row_start[i + 1] < row_start[i] || static_cast<size_t>(row_start[i + 1]) > nnz) {
+                invalid(filename, "bad row starts");
+            }
+            for (int k = row_start[i]; k < row_start[i + 1]; ++k) {
+                if (col_index[k] < 0 || static_cast<size_t>(col_index[k]) >= n ||
+                    (k > row_start[i] && col_index[k] <= col_index[k - 1])) {
+                    invalid(filename, "bad column index");
+                }
+            }
+        }
+
+        std::vector<uint64_t> offsets = reader.array<uint64_t>(offsets_at, num_names + 1);
+        for (size_t k = 0; k < num_names; ++k) {
+            if (offsets[k + 1] < offsets[k] || offsets[k + 1] > header.names_bytes) invalid(filename, "bad name table");
+        }
+        auto name = [&](size_t k) {
+            return std::string_view(data.data() + names_at + offsets[k], offsets[k + 1] - offsets[k]);
+        };
+
+        Problem problem(std::string(name(0)), (header.flags & kMaximize) ? ObjectiveType::MAXIMIZE : ObjectiveType::MINIMIZE);
+        problem.setKeepNames(has_names);  // without names there is nothing to store
+
+        std::vector<VariableType> var_types(n);
+        const uint8_t* var_type = reinterpret_cast<const uint8_t*>(data.data() + var_type_at);
+        for (size_t j = 0; j < n; ++j) {
+            if (var_type[j] > static_cast<uint8_t>(VariableType::BINARY)) invalid(filename, "bad variable type");
+            var_types[j] = static_cast<VariableType>(var_type[j]);
+        }
+        std::vector<ConstraintType> row_types(m);
+        const uint8_t* row_type = reinterpret_cast<const uint8_t*>(data.data() + row_type_at);
+        for (size_t i = 0; i < m; ++i) {
+            uint8_t type = row_type[i] & static_cast<uint8_t>(~kRangeFlag);
+            if (type > static_cast<uint8_t>(ConstraintType::EQUAL)) invalid(filename, "bad constraint type");
+            row_types[i] = static_cast<ConstraintType>(type);
+        }
+        // Columns and rows each in one bulk call; the validated CSR arrays become the matrix as they are
+        problem.reserve(static_cast<int>(n), static_cast<int>(m));
+        problem.addVariables(static_cast<int>(n), reader.array<double>(lower_at, n).data(),
+                             reader.array<double>(upper_at, n).data(), reader.array<double>(objective_at, n).data(),
+                             var_types.data());
+        problem.addConstraints(static_cast<int>(m), row_types.data(), reader.array<double>(rhs_at, m).data());
+        if (has_names) {
+            for (size_t j = 0; j < n; ++j) problem.setVariableName(static_cast<int>(j), name(1 + j));
+            for (size_t i = 0; i < m; ++i) problem.setConstraintName(static_cast<int>(i), name(1 + n + i));
+        }
+        const double* range = reinterpret_cast<const double*>(data.data() + range_at);
+        for (size_t i = 0; i < m; ++i) {
+            if (row_type[i] & kRangeFlag) problem.setConstraintRange(static_cast<int>(i), loadDouble(range + i));
+        }
+
+        problem.setKeepNames(true);
+        problem.setMatrix(SparseMatrix::fromCSR(static_cast<int>(m), static_cast<int>(n), std::move(row_start),
+                                                std::move(col_index), std::move(values)));
+        return problem;
+    }
+
+    static constexpr char kMagic[8] = {'M', 'I', 'P', 'S', 'N', 'A', 'P', '\0'};
+    static constexpr uint32_t kVersion = 1;
+    static constexpr uint32_t kEndianMark = 0x01020304;
+    static constexpr uint32_t kHasNames = 1u << 0;
+    static constexpr uint32_t kMaximize = 1u << 1;
+    static constexpr uint8_t kRangeFlag = 0x80;
+
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t endian;
+        uint32_t flags;
+        int32_t num_variables;
+        int32_t num_constraints;
+        uint32_t reserved0;
+        uint64_t num_nonzeros;
+        uint64_t names_bytes;   // size of the name character data
+        uint64_t reserved[2];
+    };
+    static_assert(sizeof(Header) == 64, "snapshot header must be 64 bytes");
+
+    // Walks the section layout of a mapped snapshot
+    struct Reader {
+        std::string_view data;
+        size_t offset;
+        bool overflow = false;
+
+        // Reserves an 8-byte aligned section of count elements and returns its offset
+        template <typename T>
+        size_t take(uint64_t count) {
+            size_t at = offset;
+            if (count > (data.size() - std::min(data.size(), at)) / sizeof(T)) {
+                overflow = true;
+                return at;
+            }
+            offset = alignUp(at + static_cast<size_t>(count) * sizeof(T));
+            return at;
+        }
+
+        template <typename T>
+        std::vector<T> array(size_t at, size_t count) const {
+            std::vector<T> result(count);
+            if (count > 0) std::memcpy(result.data(), data.data() + at, count * sizeof(T));
+            return result;
+        }
+    };
+
+    static size_t alignUp(size_t offset) { return (offset + 7) & ~static_cast<size_t>(7); }
+
+    // The fallback read buffer is not guaranteed to be 8-byte aligned
+    static double loadDouble(const double* address) {
+        double value;
+        std::memcpy(&value, address, sizeof(value));
+        return value;
+    }
+
+    template <typename T>
+    static void writeSection(std::ostream& file, const T* values, size_t count) {
+        static const char padding[8] = {};
+        size_t bytes = count * sizeof(T);
+        if (bytes > 0) file.write(reinterpret_cast<const char*>(values), static_cast<std::streamsize>(bytes));
+        file.write(padding, static_cast<std::streamsize>(alignUp(bytes) - bytes));
+    }
+
+    [[noreturn]] static void invalid(const std::string& filename, const char* reason) {
+        throw std::runtime_error("Invalid problem snapshot (" + std::string(reason) + "): " + filename);
+    }
+};
+
+} // namespace MIPSolver
+
+#endif
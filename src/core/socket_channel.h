@@ -0,0 +1,311 @@
+#ifndef SOCKET_CHANNEL_H
+#define SOCKET_CHANNEL_H
+
+/*
+ * TCP消息通道
+ *
+ * 分布式树搜索（DistributedSolver）的协调进程和工作进程之间交换的是整条消息，
+ * 这里把字节流切分成带类型的帧：
+ * - 帧头12字节：消息类型（uint32）和负载长度（uint64），小端序
+ * - 负载原样传送，内容的编码由使用者决定
+ * - POSIX 使用BSD套接字，Windows 使用Winsock（进程内首次使用时初始化）
+ *
+ * 同一个通道上send可以被多个线程并发调用（内部加锁），receive只能由一个线程调用；
+ * shutdown可以从任何线程调用，让阻塞中的receive返回。连接、收发失败时抛出std::runtime_error
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <mutex>
+#include <stdexcept>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "ws2_32.lib")
+#else
+#include <cerrno>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <unistd.h>
+#endif
+
+namespace MIPSolver {
+
+namespace SocketDetail {
+
+#if defined(_WIN32)
+using Handle = SOCKET;
+constexpr Handle kInvalid = INVALID_SOCKET;
+
+inline void initialize() {
+    static const bool started = [] {
+        WSADATA data;
+        if (WSAStartup(MAKEWORD(2, 2), &data) != 0) throw std::runtime_error("WSAStartup failed");
+        return true;
+    }();
+    (void)started;
+}
+
+inline void closeHandle(Handle handle) { closesocket(handle); }
+inline void shutdownHandle(Handle handle) { ::shutdown(handle, SD_BOTH); }
+inline int pollHandle(Handle handle, int timeout_ms) {
+    WSAPOLLFD entry = {handle, POLLRDNORM, 0};
+    return WSAPoll(&entry, 1, timeout_ms);
+}
+inline bool interrupted() { return false; }
+#else
+using Handle = int;
+constexpr Handle kInvalid = -1;
+
+inline void initialize() {}
+inline void closeHandle(Handle handle) { ::close(handle); }
+inline void shutdownHandle(Handle handle) { ::shutdown(handle, SHUT_RDWR); }
+inline int pollHandle(Handle handle, int timeout_ms) {
+    pollfd entry = {handle, POLLIN, 0};
+    return ::poll(&entry, 1, timeout_ms);
+}
+inline bool interrupted() { return errno == EINTR; }
+#endif
+
+#if defined(MSG_NOSIGNAL)
+constexpr int kSendFlags = MSG_NOSIGNAL;  // a closed peer must not raise SIGPIPE
+#else
+constexpr int kSendFlags = 0;
+#endif
+
+inline void setOptions(Handle handle) {
+    int one = 1;
+    setsockopt(handle, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&one), sizeof(one));
+    setsockopt(handle, SOL_SOCKET, SO_KEEPALIVE, reinterpret_cast<const char*>(&one), sizeof(one));
+#if defined(SO_NOSIGPIPE)
+    setsockopt(handle, SOL_SOCKET, SO_NOSIGPIPE, reinterpret_cast<const char*>(&one), sizeof(one));
+#endif
+}
+
+} // namespace SocketDetail
+
+class SocketChannel {
+public:
+    SocketChannel() = default;
+    // Takes ownership of a connected socket
+    explicit SocketChannel(SocketDetail::Handle handle) : handle_(handle) {}
+
+    ~SocketChannel() { close(); }
+
+    SocketChannel(SocketChannel&& other) noexcept : handle_(other.handle_) { other.handle_ = SocketDetail::kInvalid; }
+    SocketChannel& operator=(SocketChannel&& other) noexcept {
+        if (this != &other) {
+            close();
+            handle_ = other.handle_;
+            other.handle_ = SocketDetail::kInvalid;
+        }
+        return *this;
+    }
+    SocketChannel(const SocketChannel&) = delete;
+    SocketChannel& operator=(const SocketChannel&) = delete;
+
+    // 连接host:port（主机名或数字地址），依次尝试解析出的每个地址
+    static SocketChannel connect(const std::string& host, int port) {
+        SocketDetail::initialize();
+        addrinfo hints = {};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        addrinfo* addresses = nullptr;
+        std::string service = std::to_string(port);
+        if (getaddrinfo(host.c_str(), service.c_str(), &hints, &addresses) != 0) {
+            throw std::runtime_error("Could not resolve host: " + host);
+        }
+        SocketDetail::Handle handle = SocketDetail::kInvalid;
+        for (addrinfo* address = addresses; address; address = address->ai_next) {
+            handle = socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+            if (handle == SocketDetail::kInvalid) continue;
+            if (::connect(handle, address->ai_addr, static_cast<int>(address->ai_addrlen)) == 0) break;
+            SocketDetail::closeHandle(handle);
+            handle = SocketDetail::kInvalid;
+        }
+        freeaddrinfo(addresses);
+        if (handle == SocketDetail::kInvalid) {
+            throw std::runtime_error("Could not connect to " + host + ":" + service);
+        }
+        SocketDetail::setOptions(handle);
+        return SocketChannel(handle);
+    }
+
+    bool isOpen() const { return handle_ != SocketDetail::kInvalid; }
+
+    // 发送一条消息
+    void send(uint32_t type, std::string_view payload) {
+        unsigned char header[kHeaderBytes];
+        encode(header, type, 4);
+        encode(header + 4, payload.size(), 8);
+        std::lock_guard<std::mutex> lock(send_mutex_);
+        sendAll(reinterpret_cast<const char*>(header), sizeof(header));
+        sendAll(payload.data(), payload.size());
+    }
+
+    /*
+     * 接收一条消息（阻塞）
+     *
+     * 负载长度来自对方，超过max_payload时抛出异常；缓冲区随实际收到的字节增长，
+     * 帧头声明的长度不会被直接用来分配内存
+     *
+     * @param max_payload: 本次接受的最大负载字节数，由调用者按预期的消息内容给出
+     * @return: false表示对方在消息边界处关闭了连接（或本端调用了shutdown）；消息中途断开时抛出异常
+     */
+    bool receive(uint32_t& type, std::string& payload, uint64_t max_payload) {
+        unsigned char header[kHeaderBytes];
+        if (!receiveAll(reinterpret_cast<char*>(header), sizeof(header), true)) return false;
+        type = static_cast<uint32_t>(decode(header, 4));
+        uint64_t length = decode(header + 4, 8);
+        if (length > max_payload) throw std::runtime_error("Socket message too large");
+        payload.clear();
+        while (payload.size() < length) {
+            size_t done = payload.size();
+            payload.resize(done + static_cast<size_t>(std::min<uint64_t>(length - done, kReceiveChunk)));
+            receiveAll(&payload[done], payload.size() - done, false);
+        }
+        return true;
+    }
+
+    // 等待至多timeout_ms毫秒：有数据可读（或连接已关闭）时返回true
+    bool poll(int timeout_ms) const {
+        int ready = SocketDetail::pollHandle(handle_, timeout_ms);
+        if (ready < 0 && !SocketDetail::interrupted()) throw std::runtime_error("Socket poll failed");
+        return ready > 0;
+    }
+
+    // 关闭两个方向的传输（不释放套接字），阻塞中的receive随即返回
+    void shutdown() {
+        if (isOpen()) SocketDetail::shutdownHandle(handle_);
+    }
+
+    void close() {
+        if (!isOpen()) return;
+        SocketDetail::closeHandle(handle_);
+        handle_ = SocketDetail::kInvalid;
+    }
+
+private:
+    static constexpr size_t kHeaderBytes = 12;
+    static constexpr uint64_t kReceiveChunk = uint64_t(1) << 20;  // buffer growth per read while a payload arrives
+
+    SocketDetail::Handle handle_ = SocketDetail::kInvalid;
+    std::mutex send_mutex_;
+
+    static void encode(unsigned char* out, uint64_t value, int bytes) {
+        for (int k = 0; k < bytes; ++k) out[k] = static_cast<unsigned char>(value >> (8 * k));
+    }
+
+    static uint64_t decode(const unsigned char* in, int bytes) {
+        uint64_t value = 0;
+        for (int k = 0; k < bytes; ++k) value |= static_cast<uint64_t>(in[k]) << (8 * k);
+        return value;
+    }
+
+    void sendAll(const char* data, size_t size) {
+        while (size > 0) {
+            int chunk = static_cast<int>(std::min<size_t>(size, 1 << 30));
+            auto sent = ::send(handle_, data, chunk, SocketDetail::kSendFlags);
+            if (sent < 0 && SocketDetail::interrupted()) continue;
+            if (sent <= 0) throw std::runtime_error("Socket send failed");
+            data += sent;
+            size -= static_cast<size_t>(sent);
+        }
+    }
+
+    // allow_eof: a close before the first byte is an orderly end rather than an error
+    bool receiveAll(char* data, size_t size, bool allow_eof) {
+        size_t done = 0;
+        while (done < size) {
+            int chunk = static_cast<int>(std::min<size_t>(size - done, 1 << 30));
+            auto got = ::recv(handle_, data + done, chunk, 0);
+            if (got < 0 && SocketDetail::interrupted()) continue;
+            if (got == 0 && done == 0 && allow_eof) return false;
+            if (got <= 0) throw std::runtime_error("Socket connection lost");
+            done += static_cast<size_t>(got);
+        }
+        return true;
+    }
+};
+
+class SocketListener {
+public:
+    /*
+     * 在host的port端口上监听
+     *
+     * @param host: 本机地址（主机名或数字地址），"127.0.0.1"只接受本机连接，""或"0.0.0.0"表示所有IPv4地址
+     * @param port: 0表示由系统选择空闲端口（用getPort取得）
+     */
+    SocketListener(const std::string& host, int port) {
+        SocketDetail::initialize();
+        addrinfo hints = {};
+        hints.ai_family = host.empty() ? AF_INET : AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        hints.ai_flags = AI_PASSIVE;
+        addrinfo* addresses = nullptr;
+        std::string service = std::to_string(port);
+        if (getaddrinfo(host.empty() ? nullptr : host.c_str(), service.c_str(), &hints, &addresses) != 0) {
+            throw std::runtime_error("Could not resolve listen address: " + host);
+        }
+        for (addrinfo* address = addresses; address && handle_ == SocketDetail::kInvalid; address = address->ai_next) {
+            handle_ = socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+            if (handle_ == SocketDetail::kInvalid) continue;
+            int one = 1;
+            setsockopt(handle_, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&one), sizeof(one));
+            if (bind(handle_, address->ai_addr, static_cast<int>(address->ai_addrlen)) != 0 || listen(handle_, 16) != 0) {
+                SocketDetail::closeHandle(handle_);
+                handle_ = SocketDetail::kInvalid;
+            }
+        }
+        freeaddrinfo(addresses);
+        sockaddr_storage bound = {};
+        socklen_t length = sizeof(bound);
+        if (handle_ == SocketDetail::kInvalid ||
+            getsockname(handle_, reinterpret_cast<sockaddr*>(&bound), &length) != 0) {
+            if (handle_ != SocketDetail::kInvalid) SocketDetail::closeHandle(handle_);
+            throw std::runtime_error("Could not listen on " + host + ":" + service);
+        }
+        port_ = bound.ss_family == AF_INET6 ? ntohs(reinterpret_cast<const sockaddr_in6&>(bound).sin6_port)
+                                            : ntohs(reinterpret_cast<const sockaddr_in&>(bound).sin_port);
+    }
+
+    ~SocketListener() { SocketDetail::closeHandle(handle_); }
+
+    SocketListener(const SocketListener&) = delete;
+    SocketListener& operator=(const SocketListener&) = delete;
+
+    int getPort() const { return port_; }
+
+    // 等待至多timeout_ms毫秒接受一个连接；超时返回未打开的通道
+    SocketChannel accept(int timeout_ms) {
+        int ready = SocketDetail::pollHandle(handle_, timeout_ms);
+        if (ready < 0 && !SocketDetail::interrupted()) throw std::runtime_error("Socket poll failed");
+        if (ready <= 0) return SocketChannel();
+        SocketDetail::Handle client = ::accept(handle_, nullptr, nullptr);
+        if (client == SocketDetail::kInvalid) return SocketChannel();
+        SocketDetail::setOptions(client);
+        return SocketChannel(client);
+    }
+
+private:
+    SocketDetail::Handle handle_ = SocketDetail::kInvalid;
+    int port_ = 0;
+};
+
+} // namespace MIPSolver
+
+#endif
@@ -2,8 +2,15 @@
 #define SOLUTION_H
 
 #include "core.h"
+#include "instrumentation.h"
 #include <vector>
+#include <memory>
 #include <iostream>
+#include <functional>
+#include <limits>
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
 
 namespace MIPSolver {
 
@@ -16,7 +23,22 @@ class Solution {
             UNBOUNDED,
             ITERATION_LIMIT,
             TIME_LIMIT,
-            UNKNOWN
+            UNKNOWN,
+            INTERRUPTED, // stopped by an external request; values hold the best solution found (if any)
+            WORK_LIMIT   // the deterministic work budget (SolverInterface::setWorkLimit) ran out
+        };
+
+        // One improvement of the incumbent during the solve
+        struct IncumbentRecord {
+            double time;       // seconds since the start of the solve
+            long long nodes;   // nodes processed when it was found
+            double objective;
+        };
+
+        // One feasible solution kept in the solution pool
+        struct PoolEntry {
+            double objective;
+            std::vector<double> values;
         };
 
         Solution(int num_variables)
@@ -24,7 +46,11 @@ class Solution {
              objective_value_(0.0),
              status_(Status::UNKNOWN),
              solve_time_(0.0),
-             iterations_(0) {}
+             iterations_(0),
+             lp_iterations_(0),
+             dual_bound_(0.0),
+             open_nodes_(0),
+             work_units_(0.0) {}
 
         // Getters/Setters
         void setValue(int var_index, double value) {
@@ -54,6 +80,59 @@ class Solution {
 
         void setIterations(int iterations) { iterations_ = iterations; }
         int getIterations() const { return iterations_; }
+        // Branch-and-bound nodes processed (same as getIterations)
+        int getNodeCount() const { return iterations_; }
+
+        // Best bound proven by the search (lower bound for minimization, upper bound for maximization)
+        void setDualBound(double bound) { dual_bound_ = bound; }
+        double getDualBound() const { return dual_bound_; }
+
+        // Relative gap |objective - dual bound| / |objective|; infinite without a finite objective
+        double getGap() const { return relativeGap(objective_value_, dual_bound_); }
+
+        static double relativeGap(double objective, double bound) {
+            if (!std::isfinite(objective)) return std::numeric_limits<double>::infinity();
+            double difference = std::abs(objective - bound);
+            if (difference == 0.0) return 0.0;
+            return difference / std::max(std::abs(objective), 1e-10);
+        }
+
+        // Nodes still open when the search stopped (0 after a complete search)
+        void setOpenNodes(long long open_nodes) { open_nodes_ = open_nodes; }
+        long long getOpenNodes() const { return open_nodes_; }
+
+        // Every improvement of the incumbent, in the order found
+        void setIncumbentHistory(std::vector<IncumbentRecord> history) { incumbent_history_ = std::move(history); }
+        const std::vector<IncumbentRecord>& getIncumbentHistory() const { return incumbent_history_; }
+
+        /*
+         * 解池：求解过程中找到的（以及初始解中可行的）互不相同的解，按目标值从好到坏排列，
+         * 至多SolverInterface::setSolutionPoolSize个；有可行解时第一个与getValues相同
+         */
+        void setSolutionPool(std::vector<PoolEntry> pool) { solution_pool_ = std::move(pool); }
+        const std::vector<PoolEntry>& getSolutionPool() const { return solution_pool_; }
+
+        // Total simplex iterations over all node LPs
+        void setLPIterations(long long iterations) { lp_iterations_ = iterations; }
+        long long getLPIterations() const { return lp_iterations_; }
+        double getLPIterationsPerNode() const {
+            return iterations_ > 0 ? static_cast<double>(lp_iterations_) / iterations_ : 0.0;
+        }
+
+        // Deterministic work spent by the search, in the units of SolverInterface::setWorkLimit
+        void setWorkUnits(double work_units) { work_units_ = work_units; }
+        double getWorkUnits() const { return work_units_; }
+
+        /*
+         * 求解过程的阶段计时和计数器（见instrumentation.h）
+         *
+         * 没有定义MIPSOLVER_ENABLE_INSTRUMENTATION时返回的Profile为空（enabled()为false）
+         */
+        void setProfile(std::shared_ptr<const Instrumentation::Profile> profile) { profile_ = std::move(profile); }
+        const Instrumentation::Profile& getProfile() const {
+            static const Instrumentation::Profile empty;
+            return profile_ ? *profile_ : empty;
+        }
 
         const std::vector<double>& getValues() const { return values_; }
 
@@ -67,10 +146,15 @@ class Solution {
                 case Status::ITERATION_LIMIT: std::cout << "Iteration Limit Reached"; break;
                 case Status::TIME_LIMIT: std::cout << "Time Limit Reached"; break;
                 case Status::UNKNOWN: std::cout << "Unknown"; break;
+                case Status::INTERRUPTED: std::cout << "Interrupted"; break;
+                case Status::WORK_LIMIT: std::cout << "Work Limit Reached"; break;
             }
             std::cout << "\nObjective Value: " << objective_value_ << "\n";
+            std::cout << "Dual Bound: " << dual_bound_ << " (gap " << getGap() * 100.0 << "%)\n";
             std::cout << "Solve Time: " << solve_time_ << " seconds\n";
             std::cout << "Iterations: " << iterations_ << "\n";
+            std::cout << "LP Iterations: " << lp_iterations_ << " (" << getLPIterationsPerNode() << " per node)\n";
+            std::cout << "Work Units: " << work_units_ << "\n";
             std::cout << "Variable Values:\n";
             for (int i = 0; i < values_.size(); ++i) {
                 if (std::abs(values_[i]) > 1e-6) { // Only print non-zero values
@@ -85,6 +169,84 @@ class Solution {
         Status status_;
         double solve_time_;
         int iterations_;
+        long long lp_iterations_;
+        double dual_bound_;
+        long long open_nodes_;
+        double work_units_;
+        std::vector<IncumbentRecord> incumbent_history_;
+        std::vector<PoolEntry> solution_pool_;
+        std::shared_ptr<const Instrumentation::Profile> profile_;  // shared between copies
+};
+
+/*
+ * 有界解池
+ *
+ * 按目标值保留最好的capacity个互不相同的解：两个解的每个分量之差都不超过
+ * kTolerance * max(1, |x|)时视为同一个解，只保留目标值较好的一个。不加锁，由调用者同步
+ */
+class SolutionPool {
+    public:
+        SolutionPool(ObjectiveType obj_type, int capacity) : obj_type_(obj_type), capacity_(std::max(capacity, 0)) {}
+
+        // @return: 解是否进入了解池
+        bool add(double objective, const std::vector<double>& values) {
+            if (capacity_ == 0 || !std::isfinite(objective)) return false;
+            if (static_cast<int>(entries_.size()) == capacity_ && !better(objective, entries_.back().objective)) return false;
+            for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+                if (!same(it->values, values)) continue;
+                if (!better(objective, it->objective)) return false;
+                entries_.erase(it);
+                break;
+            }
+            // Equal objectives keep arrival order
+            auto position = std::find_if(entries_.begin(), entries_.end(),
+                                         [&](const Solution::PoolEntry& entry) { return better(objective, entry.objective); });
+            entries_.insert(position, Solution::PoolEntry{objective, values});
+            if (static_cast<int>(entries_.size()) > capacity_) entries_.pop_back();
+            return true;
+        }
+
+        const std::vector<Solution::PoolEntry>& entries() const { return entries_; }
+
+    private:
+        static constexpr double kTolerance = 1e-6;
+
+        bool better(double a, double b) const {
+            return obj_type_ == ObjectiveType::MINIMIZE ? a < b : a > b;
+        }
+
+        static bool same(const std::vector<double>& a, const std::vector<double>& b) {
+            if (a.size() != b.size()) return false;
+            for (size_t j = 0; j < a.size(); ++j) {
+                if (std::abs(a[j] - b[j]) > kTolerance * std::max(1.0, std::abs(a[j]))) return false;
+            }
+            return true;
+        }
+
+        ObjectiveType obj_type_;
+        int capacity_;
+        std::vector<Solution::PoolEntry> entries_;
+};
+
+/*
+ * 求解进度快照
+ *
+ * 由SolverInterface的进度回调在找到新的最优解（INCUMBENT）和每隔固定时间（INTERVAL）时给出。
+ * 目标值和对偶界都在原问题的目标意义下；还没有可行解时objective为"最差"的无穷值、gap为正无穷
+ */
+struct SolveProgress {
+    enum class Event {
+        INCUMBENT,
+        INTERVAL
+    };
+
+    Event event;
+    double time;          // seconds since the start of the solve
+    long long nodes;      // nodes processed so far
+    long long open_nodes; // open nodes, including those being processed
+    double objective;     // incumbent objective
+    double dual_bound;    // best bound over the open nodes
+    double gap;           // Solution::relativeGap(objective, dual_bound)
 };
 
 class SolverInterface {
@@ -97,12 +259,80 @@ class SolverInterface {
         // Set parameters for the solver
         virtual void setTimeLimit(double seconds) { time_limit_ = seconds; };
         virtual void setIterationLimit(int iterations) { iteration_limit_ = iterations; };
+        /*
+         * 确定性工作量上限（非正表示不限）
+         *
+         * 工作量按LP中实际扫描的非零元计数（一个单位为一百万次），与机器速度无关；
+         * 同样的输入和设置下在同一处停止，因此比时间上限更适合需要复现的场景
+         */
+        virtual void setWorkLimit(double work_units) { work_limit_ = work_units; };
         virtual void setVerbose(bool verbose) { verbose_ = verbose; };
+        // Number of worker threads; 0 means one per hardware thread
+        virtual void setNumThreads(int num_threads) { num_threads_ = num_threads; };
+
+        using ProgressCallback = std::function<void(const SolveProgress& progress)>;
+
+        /*
+         * 进度回调（为空时不回调）
+         *
+         * 在找到新的最优解时、以及每隔interval_seconds秒调用一次；回调在求解线程上运行，
+         * 调用之间互斥。回调中不能修改求解器，需要提前结束时使用求解器的停止机制
+         */
+        virtual void setProgressCallback(ProgressCallback callback, double interval_seconds = 1.0) {
+            progress_callback_ = std::move(callback);
+            progress_interval_ = interval_seconds;
+        }
+        double getProgressInterval() const { return progress_interval_; }
+
+        /*
+         * 初始解（MIP start），可以提供多个
+         *
+         * values[k]是变量indices[k]的取值（同一变量出现多次时以最后一次为准），可以只给出部分变量。
+         * 求解开始时逐个检查：给出全部变量的直接用Problem::isValidSolution检查（容差1e-6，整数变量须取整数值），
+         * 只给出部分变量的先固定这些变量、求解一个受节点数限制的子MIP补全其余变量。
+         * 可行的初始解中最好的一个作为初始最优解用于剪枝，全部进入解池；不可行的被丢弃
+         * （详细模式下说明原因）。初始解在多次solve之间保留，直到clearMIPStarts
+         *
+         * 下标越界时solve抛出std::runtime_error。由BranchBoundSolver实现，其他求解器忽略初始解
+         */
+        struct MIPStart {
+            std::vector<int> indices;
+            std::vector<double> values;
+        };
+
+        virtual void addMIPStart(const std::vector<int>& indices, const std::vector<double>& values) {
+            if (indices.size() != values.size()) {
+                throw std::runtime_error("addMIPStart: indices and values differ in length");
+            }
+            mip_starts_.push_back({indices, values});
+        }
+        // Dense form: values[j] is the value of variable j; NaN leaves a variable unspecified
+        virtual void addMIPStart(const std::vector<double>& values) {
+            MIPStart start;
+            for (size_t j = 0; j < values.size(); ++j) {
+                if (std::isnan(values[j])) continue;
+                start.indices.push_back(static_cast<int>(j));
+                start.values.push_back(values[j]);
+            }
+            mip_starts_.push_back(std::move(start));
+        }
+        virtual void clearMIPStarts() { mip_starts_.clear(); }
+        const std::vector<MIPStart>& getMIPStarts() const { return mip_starts_; }
+
+        // Capacity of the solution pool (Solution::getSolutionPool); 0 keeps no pool
+        virtual void setSolutionPoolSize(int size) { solution_pool_size_ = std::max(size, 0); }
+        int getSolutionPoolSize() const { return solution_pool_size_; }
     
     protected:
         double time_limit_ = 3600.0; // Default time limit in seconds ( 1 hour)
         int iteration_limit_ = 100000; // Default iteration limit
+        double work_limit_ = 0.0; // Work budget in work units; <= 0 means unlimited
         bool verbose_ = false; // Verbose output flag
+        int num_threads_ = 1; // Worker threads used by the solve
+        ProgressCallback progress_callback_; // Progress reports (may be empty)
+        double progress_interval_ = 1.0; // Seconds between INTERVAL reports
+        std::vector<MIPStart> mip_starts_; // Starting solutions checked at the start of every solve
+        int solution_pool_size_ = 10; // Best distinct solutions kept in the Solution
 };
 
 } // namespace MIPSolver
@@ -39,6 +39,13 @@
 #include <random>
 #include <algorithm>
 #include <cmath>
+#include <functional>
+#include <memory>
+#include <limits>
+#include <unordered_map>
+#include <unordered_set>
+#include <mutex>
+#include <atomic>
 
 namespace MIPSolver {
 
@@ -70,6 +77,22 @@ namespace MIPSolver {
  *    - 使用模拟退火策略接受劣解
  *    - 避免陷入局部最优，增强全局搜索能力
  * 
+ * 4. 在本实现中：
+ *    - 破坏算子：随机、目标贡献最差、按约束关联的簇
+ *    - 修复算子：被移除的变量先移到LP提示值（没有提示时为目标最优的边界），
+ *      再按随机顺序（贪心）或按后悔值顺序重新赋值，候选值包括边界、原值、
+ *      LP提示值的取整以及使违反约束恰好满足的"跳跃"值；
+ *      之后对剩余的违反约束做局部跳跃修复
+ *    - 含连续变量时可以注入连续部分补全函数（固定整数变量求解LP）
+ *    - 还没有可行解时以总违反量为准则搜索，优先尽快得到第一个可行解
+ * 
+ * 与分支定界并发运行：
+ *    - setSolutionSource：每次迭代检查外部（分支定界）的最优解，更好时以它为新的起点
+ *    - setSolutionCallback：找到更好的可行解时回调，用于更新共享最优解
+ *    - setHint：其他线程随时提交LP解作为修复算子的提示
+ *    - setStopFlag：外部停止标志，每次迭代检查
+ * setHint可以在solve运行期间从任意线程调用，其余设置须在solve之前完成。
+ * 
  * 适用场景：
  * - 大规模混合整数规划问题
  * - 需要快速获得高质量可行解的情况
@@ -83,7 +106,8 @@ public:
      * 包含算法运行所需的所有可调参数：
      * - max_iterations: 最大迭代次数，控制算法运行时间
      * - alpha: 权重衰减因子，控制历史信息的重要性
-     * - temperature_start/end: 模拟退火的初始和终止温度
+     * - temperature_start/end: 模拟退火的初始和终止温度，
+     *   以当前目标值绝对值的百分比计（温度100表示恶化1%时接受概率为e^-0.01）
      * - segment_size: 权重更新的周期长度
      * - 奖励参数: 不同质量解的奖励分值
      */
@@ -96,7 +120,16 @@ public:
         double best_reward = 30.0;         // 找到新最优解的奖励
         double better_reward = 15.0;       // 找到更好解的奖励
         double accepted_reward = 5.0;      // 解被接受的基础奖励
+        double min_destroy_fraction = 0.05;  // 每次破坏的变量比例下限
+        double max_destroy_fraction = 0.3;   // 每次破坏的变量比例上限
     };
+    
+    // 找到更好的可行解时调用：(变量取值, 目标值)
+    using SolutionCallback = std::function<void(const std::vector<double>&, double)>;
+    // 外部有优于给定目标值的可行解时写入values并返回true
+    using SolutionSource = std::function<bool(double, std::vector<double>&)>;
+    // 整数变量固定为当前取值，重新计算连续变量；不可行时返回false
+    using ContinuousCompletion = std::function<bool(std::vector<double>&)>;
 
 private:
     ALNSParameters params_;
@@ -111,9 +144,67 @@ private:
     std::vector<double> destroy_weights_;
     std::vector<double> repair_weights_;
     
+    SolutionCallback on_solution_;
+    SolutionSource solution_source_;
+    ContinuousCompletion completion_;
+    const std::atomic<bool>* stop_ = nullptr;
+    
+    // LP hint shared with other threads
+    std::mutex hint_mutex_;
+    std::vector<double> shared_hint_;
+    std::atomic<unsigned> hint_version_{0};
+    std::atomic<int> improvements_{0};
+    
+    // Per-solve model data
+    const Problem* problem_ = nullptr;
+    double sense_ = 1.0;
+    std::vector<double> lower_;
+    std::vector<double> upper_;
+    std::vector<double> cost_;
+    std::vector<bool> is_integer_;
+    std::vector<double> row_lower_;
+    std::vector<double> row_upper_;
+    std::vector<int> free_vars_;       // variables with lower < upper
+    bool has_continuous_ = false;
+    double penalty_ = 1.0;             // objective units per unit of violation (regret ranking)
+    
+    // Search state: current solution and the trial built by the repair operators
+    std::vector<double> current_;
+    std::vector<double> current_activity_;
+    std::vector<double> trial_;
+    std::vector<double> trial_activity_;
+    std::vector<double> hint_;         // local copy of the latest LP hint (empty if none)
+    unsigned seen_hint_version_ = 0;
+    std::vector<int> violated_;        // violated rows of the trial
+    std::vector<int> violated_pos_;
+    std::vector<unsigned> stamp_;
+    unsigned stamp_value_ = 0;
+    
+    static constexpr double kFeasibilityTolerance = 1e-6;
+    static constexpr double kInfinity = 1e20;
+    
 public:
     AdaptiveLargeNeighborhoodSearch(unsigned seed = 42);
     
+    void setParameters(const ALNSParameters& params) { params_ = params; }
+    const ALNSParameters& getParameters() const { return params_; }
+    void setSolutionCallback(SolutionCallback callback) { on_solution_ = std::move(callback); }
+    void setSolutionSource(SolutionSource source) { solution_source_ = std::move(source); }
+    void setContinuousCompletion(ContinuousCompletion completion) { completion_ = std::move(completion); }
+    void setStopFlag(const std::atomic<bool>* stop) { stop_ = stop; }
+    
+    // 提交LP解作为修复提示（线程安全）
+    void setHint(const std::vector<double>& lp_solution);
+    
+    // 各次solve累计找到的更好可行解个数
+    int getNumImprovements() const { return improvements_.load(); }
+    
+    /*
+     * 从initial_solution（状态为OPTIMAL或FEASIBLE时）或外部来源的解出发搜索，
+     * 没有起点时由LP提示或变量边界构造
+     * 
+     * @return: 找到的最好可行解，状态为FEASIBLE；没有找到时状态为UNKNOWN
+     */
     Solution solve(const Problem& problem, const Solution& initial_solution);
     
 private:
@@ -129,9 +220,61 @@ private:
     // 修复算子实现
     std::vector<double> greedyRepair(const Problem& problem, const std::vector<int>& removed_vars);
     std::vector<double> regretRepair(const Problem& problem, const std::vector<int>& removed_vars);
+    
+    // Candidate value for one variable, ranked by (violation change, objective change, hint distance)
+    struct Move {
+        double value;
+        double violation_delta;
+        double objective_delta;
+        double hint_distance;
+        bool operator<(const Move& other) const {
+            if (std::abs(violation_delta - other.violation_delta) > 1e-9) return violation_delta < other.violation_delta;
+            if (std::abs(objective_delta - other.objective_delta) > 1e-12) return objective_delta < other.objective_delta;
+            return hint_distance < other.hint_distance;
+        }
+    };
+    
+    void setupModel(const Problem& problem);
+    void refreshHint();
+    bool stopRequested() const { return stop_ && stop_->load(std::memory_order_relaxed); }
+    double rowViolation(int row, double activity) const;
+    double objectiveOf(const std::vector<double>& x) const;
+    double totalViolation(const std::vector<double>& activity) const;
+    void computeActivity(const std::vector<double>& x, std::vector<double>& activity) const;
+    double clampValue(int j, double value) const;
+    double hintValue(int j) const;
+    double moveViolationDelta(int j, double to) const;
+    void applyMove(int j, double value);
+    void candidateMoves(int j, double base_value, std::vector<Move>& moves);
+    Move bestMove(int j, double base_value);
+    void ruin(const std::vector<int>& removed_vars);
+    void rebuildViolated();
+    void updateViolated(int row);
+    void repairViolations(int max_steps);
+    void completeContinuous();
+    void loadTrial(const std::vector<double>& x);
 };
 
 // 机器学习驱动的分支选择
+/*
+ * 学习型分支打分
+ * 
+ * 每个候选变量用一组特征描述，打分最高者被选为分支变量：
+ * - pseudocost_up/down: 向上/向下分支的预计目标恶化量（伪成本 × 分数距离）
+ * - infeasibility: 到最近整数的距离
+ * - obj_coefficient: 目标系数绝对值
+ * - constraint_density: 该变量出现的约束比例
+ * - variable_age: 该变量已有的伪成本观测次数
+ * 
+ * 打分来源（按优先级）：
+ * 1. setScorer 注入的外部模型（例如离线训练的神经网络）
+ * 2. updateModel 在线拟合的线性模型
+ * 3. 未训练时退化为伪成本乘积规则
+ * 
+ * BranchBoundSolver 在 BranchingRule::LEARNED 下调用 selectBranchingVariable，
+ * 特征中的伪成本来自求解过程中观测到的子节点恶化量。
+ * 并行搜索时多个线程会同时调用打分函数，注入的模型需要支持并发调用
+ */
 class MLBranchingStrategy {
 public:
     struct BranchingFeatures {
@@ -143,58 +286,200 @@ public:
         double variable_age;
     };
     
+    using Scorer = std::function<double(const BranchingFeatures&)>;
+    
 private:
     // 简化的线性模型权重 (在实际SOTA实现中会使用神经网络)
     std::vector<double> feature_weights_;
     bool is_trained_;
+    Scorer scorer_;
     
 public:
     MLBranchingStrategy();
     
-    // 选择最佳分支变量
+    // 选择最佳分支变量；features按变量索引，为空时由问题数据提取
     int selectBranchingVariable(const Problem& problem, 
                                const std::vector<double>& lp_solution,
                                const std::vector<BranchingFeatures>& features);
     
-    // 更新模型 (简化版本)
+    // 更新模型 (简化版本)：以outcomes为目标做线性回归
     void updateModel(const std::vector<BranchingFeatures>& features, 
                      const std::vector<double>& outcomes);
     
+    // 注入外部打分模型，替代内置线性模型
+    void setScorer(Scorer scorer) { scorer_ = std::move(scorer); }
+    
+    bool isTrained() const { return is_trained_ || static_cast<bool>(scorer_); }
+    
+    // 对单个候选打分（越大越好）
+    double score(const BranchingFeatures& features) { return predictScore(features); }
+    
 private:
     BranchingFeatures extractFeatures(const Problem& problem, int var_index, 
                                      const std::vector<double>& lp_solution);
     double predictScore(const BranchingFeatures& features);
 };
 
+// 预处理的逆操作记录
+/*
+ * 后处理栈
+ * 
+ * 预处理每删除一个变量就压入一条记录，后处理时按逆序弹出，
+ * 把缩减问题的解还原为原问题的解。目前的归约只会把变量固定在某个值上
+ * 再删除，因此记录只有FIX_VARIABLE一种；需要代入消元的归约可以在此扩展。
+ */
+class PostsolveStack {
+public:
+    struct Step {
+        enum class Kind { FIX_VARIABLE };
+        Kind kind;
+        int var_index;   // 原问题中的变量索引
+        double value;
+    };
+    
+    void fixVariable(int var_index, double value) {
+        steps_.push_back({Step::Kind::FIX_VARIABLE, var_index, value});
+    }
+    
+    size_t size() const { return steps_.size(); }
+    bool empty() const { return steps_.empty(); }
+    
+    /*
+     * 还原原问题的解
+     * 
+     * @param reduced_values: 缩减问题的解
+     * @param variable_mapping: 缩减问题变量 -> 原问题变量
+     * @param num_original: 原问题变量数
+     */
+    std::vector<double> undo(const std::vector<double>& reduced_values,
+                             const std::vector<int>& variable_mapping, int num_original) const {
+        std::vector<double> values(num_original, 0.0);
+        for (size_t k = 0; k < variable_mapping.size() && k < reduced_values.size(); ++k) {
+            values[variable_mapping[k]] = reduced_values[k];
+        }
+        for (auto it = steps_.rbegin(); it != steps_.rend(); ++it) {
+            switch (it->kind) {
+                case Step::Kind::FIX_VARIABLE:
+                    values[it->var_index] = it->value;
+                    break;
+            }
+        }
+        return values;
+    }
+    
+private:
+    std::vector<Step> steps_;
+};
+
 // 启发式预处理器
+/*
+ * 预处理（presolve）
+ * 
+ * 在分支定界之前缩减问题规模，所有归约都保持最优解不变：
+ * 1. 单元素行：a*x_j 在 [lo, up] 内，转化为x_j的边界后删除该行
+ * 2. 固定变量消去：上下界相等的变量代入各行的左右端后删除；
+ *    不出现在任何约束中的变量按目标系数固定在有利的边界上
+ * 3. 隐含边界：由行活动度的最小/最大值推出变量更紧的边界（整数变量取整），
+ *    并删除在当前边界下恒成立的冗余行；活动度区间与行界不相交时判定不可行
+ * 4. 平行行聚合：系数成比例的行合并为一行（取行界的交集）
+ * 5. 系数强化：对单侧约束中的二进制变量缩小系数和右端，收紧LP松弛
+ * 
+ * 结果中variable_mapping / constraint_mapping 给出缩减问题索引到原问题索引的映射，
+ * postsolve 记录被删除变量的取值，用于把缩减问题的解还原为原问题的解
+ */
 class HeuristicPreprocessor {
 public:
     struct PreprocessingResult {
         Problem processed_problem;
-        std::vector<int> variable_mapping;
-        std::vector<int> constraint_mapping;
+        std::vector<int> variable_mapping;    // 缩减问题变量 -> 原问题变量
+        std::vector<int> constraint_mapping;  // 缩减问题约束 -> 原问题约束
         bool problem_reduced;
         int variables_eliminated;
         int constraints_eliminated;
+        bool infeasible = false;              // 预处理已证明原问题不可行
+        double objective_offset = 0.0;        // 被删除变量对目标函数的贡献
+        int bounds_tightened = 0;
+        int coefficients_strengthened = 0;
+        PostsolveStack postsolve;
     };
     
     PreprocessingResult preprocess(const Problem& original_problem);
     
+    /*
+     * 后处理：把缩减问题的求解结果映射回原问题
+     * 
+     * 变量值按variable_mapping和后处理栈还原；目标值在原问题上重新计算，
+     * 对偶界加上被删除变量的目标贡献；状态与统计量保持不变
+     */
+    Solution postsolve(const PreprocessingResult& result, const Problem& original_problem,
+                       const Solution& reduced_solution) const;
+    
+    // 最大预处理轮数
+    void setMaxRounds(int rounds) { max_rounds_ = rounds; }
+    
 private:
+    // 预处理过程中的工作模型：行以稀疏向量保存，删除的行/列只做标记
+    struct WorkingModel {
+        std::vector<double> lower;
+        std::vector<double> upper;
+        std::vector<double> cost;
+        std::vector<bool> is_integer;
+        std::vector<bool> col_active;
+        std::vector<std::vector<int>> col_rows;  // 列 -> 包含它的行（可能含已删除或已消去的行）
+        
+        std::vector<double> row_lower;
+        std::vector<double> row_upper;
+        std::vector<bool> row_active;
+        std::vector<std::vector<std::pair<int, double>>> rows;  // 行 -> (列, 系数)
+        
+        double sense = 1.0;  // +1 最小化，-1 最大化
+        bool infeasible = false;
+    };
+    
+    int max_rounds_ = 20;
+    int bounds_tightened_ = 0;
+    int coefficients_strengthened_ = 0;
+    
+    // 单元素行转化为变量边界
+    bool removeSingletonRows(WorkingModel& model);
+    
     // 变量固定
-    void fixVariables(Problem& problem, std::vector<int>& eliminated_vars);
+    bool fixVariables(WorkingModel& model, PostsolveStack& postsolve, double& objective_offset);
     
     // 约束聚合
-    void aggregateConstraints(Problem& problem, std::vector<int>& eliminated_constraints);
+    bool aggregateConstraints(WorkingModel& model);
     
     // 系数强化
-    void strengthenCoefficients(Problem& problem);
+    void strengthenCoefficients(WorkingModel& model);
     
     // 隐含边界检测
-    void detectImpliedBounds(Problem& problem);
+    bool detectImpliedBounds(WorkingModel& model);
+    
+    // 收紧变量j的边界，返回是否有实质改变
+    bool tightenLower(WorkingModel& model, int j, double bound);
+    bool tightenUpper(WorkingModel& model, int j, double bound);
 };
 
-// 动态割平面生成器
+/*
+ * 动态割平面生成器
+ * 
+ * 割平面统一表示为 sum_j a_j x_j <= rhs（稀疏存储），已实现的分离器：
+ * 1. GOMORY（Gomory混合整数割）：
+ *    - 取LP最优单纯形表中基变量为分数整数变量的行，把非基变量平移到其所在边界，
+ *      对整数非基变量按分数部分、对连续非基变量按系数符号构造GMI不等式
+ *    - 逻辑变量（行活动度）按连续变量处理，最后用行表达式代回结构变量
+ * 2. KNAPSACK_COVER（背包覆盖割）：
+ *    - 对每个单侧行（等式和区间行取两侧），把非二进制变量放到其最有利的边界、
+ *      负系数的二进制变量取补，得到背包约束
+ *    - 按LP解贪心构造覆盖C，得到 sum_{C} x_j <= |C|-1，再用系数不小于C中最大系数
+ *      的变量扩展
+ * 
+ * Gomory割依赖单纯形表，由调用者（分支定界求解器）从LP求解器取出TableauRow传入；
+ * problem须是LP当前的全部行（原始约束加上已加入LP的割），边界为全局边界，
+ * 这样得到的割在整棵搜索树上都有效。
+ * 有效度 efficacy = 违反量 / ||a||，即LP解到割平面的欧氏距离。
+ * 系数动态范围过大或过密（非零数超过变量数的1/4加10）的割被丢弃。
+ */
 class DynamicCuttingPlanes {
 public:
     enum class CutType {
@@ -206,13 +491,28 @@ public:
     };
     
     struct Cut {
-        std::vector<double> coefficients;
+        std::vector<int> indices;          // 非零系数的变量，升序
+        std::vector<double> coefficients;  // 与indices对应的系数
         double rhs;
         CutType type;
         double efficacy;
         double violation;
     };
     
+    /*
+     * 单纯形表的一行：x_B + sum_k alpha_k x_{indices_k} = 0
+     * 
+     * 列索引小于变量数的是结构变量，其余为逻辑变量 n+i（第i行的活动度），
+     * at_upper标记该非基列位于上界（否则位于下界）
+     */
+    struct TableauRow {
+        int basic_var;
+        double value;                  // 基变量的LP取值
+        std::vector<int> indices;
+        std::vector<double> alpha;
+        std::vector<bool> at_upper;
+    };
+    
 private:
     double min_efficacy_;
     double min_violation_;
@@ -223,21 +523,97 @@ public:
                         double min_violation = 1e-6,
                         int max_cuts = 50);
     
+    /*
+     * 分离一轮割平面
+     * 
+     * @param problem: LP的全部行与全局边界
+     * @param lp_solution: LP最优解（结构变量）
+     * @param tableau_rows: 用于Gomory割的单纯形表行，可为空
+     * @return: 满足违反量和有效度门限的割，按有效度降序，至多max_cuts个
+     */
     std::vector<Cut> generateCuts(const Problem& problem, 
-                                 const std::vector<double>& lp_solution);
+                                 const std::vector<double>& lp_solution,
+                                 const std::vector<TableauRow>& tableau_rows = {});
+    
+    double calculateEfficacy(const Cut& cut, const std::vector<double>& lp_solution) const;
+    double calculateViolation(const Cut& cut, const std::vector<double>& lp_solution) const;
     
 private:
     std::vector<Cut> generateGomoryCuts(const Problem& problem, 
-                                       const std::vector<double>& lp_solution);
+                                       const std::vector<double>& lp_solution,
+                                       const std::vector<TableauRow>& tableau_rows);
     
     std::vector<Cut> generateKnapsackCoverCuts(const Problem& problem, 
                                               const std::vector<double>& lp_solution);
     
-    std::vector<Cut> generateMIRCuts(const Problem& problem, 
-                                    const std::vector<double>& lp_solution);
+    // 稠密系数清理后转为稀疏割；数值上不可靠时返回false
+    bool finishCut(const Problem& problem, std::vector<double>& dense, const std::vector<int>& support,
+                   double rhs, CutType type, const std::vector<double>& lp_solution, Cut& cut) const;
+};
+
+/*
+ * 割池
+ * 
+ * 保存分离得到的全部割（按系数哈希去重），分支定界的所有线程共享，内部加锁：
+ * - 活跃割：已加入LP的割，按加入顺序编号；列表只增不减，
+ *   各线程的LP按同一顺序追加这些行，因此任意线程保存的基都能在其他线程上热启动
+ * - 候选割：留在池中的割，每次检查时没有被违反则年龄加一，超过上限后删除；
+ *   被选中加入LP时转为活跃
+ * - 选择：只考虑有效度不低于门限的违反割，按有效度降序贪心选取，
+ *   与已选割夹角余弦超过max_parallelism的割被跳过
+ */
+class CutPool {
+public:
+    using Cut = DynamicCuttingPlanes::Cut;
+    
+    explicit CutPool(int max_age = 100, double max_parallelism = 0.9)
+        : max_age_(max_age), max_parallelism_(max_parallelism) {}
     
-    double calculateEfficacy(const Cut& cut, const std::vector<double>& lp_solution);
-    double calculateViolation(const Cut& cut, const std::vector<double>& lp_solution);
+    void clear();
+    
+    // 加入一个候选割，重复的割被忽略；返回是否加入
+    bool add(const Cut& cut);
+    
+    /*
+     * 检查候选割并把选中的割转为活跃
+     * 
+     * @param lp_solution: 当前LP解
+     * @param max_cuts: 本次最多选出的割数
+     * @param min_efficacy: 有效度门限
+     * @return: 新增活跃割的个数
+     */
+    int separate(const std::vector<double>& lp_solution, int max_cuts, double min_efficacy);
+    
+    // 活跃割的数量及第from个之后的全部活跃割
+    int numActive() const { return num_active_.load(std::memory_order_acquire); }
+    std::vector<Cut> getActive(int from) const;
+    
+    // 只保留keep[k]为true的活跃割，其余退回候选（年龄清零）；只能在搜索开始前调用
+    void retainActive(const std::vector<bool>& keep);
+    
+    size_t size() const;
+    
+private:
+    struct Entry {
+        Cut cut;
+        double norm;
+        int age;
+    };
+    
+    int max_age_;
+    double max_parallelism_;
+    mutable std::mutex mutex_;
+    std::vector<Entry> entries_;  // 候选割
+    std::vector<Cut> active_;     // 活跃割，按加入LP的顺序
+    std::atomic<int> num_active_{0};
+    std::unordered_set<size_t> hashes_;  // 全部割（包括活跃割）的系数哈希
+    // separate的工作区（受mutex_保护），保留容量，节点循环中检查割池不分配内存
+    std::vector<std::pair<double, size_t>> violated_;
+    std::vector<size_t> chosen_;
+    std::vector<bool> remove_;
+    
+    static size_t hashCut(const Cut& cut);
+    static double parallelism(const Cut& a, double norm_a, const Cut& b, double norm_b);
 };
 
 // SOTA求解器集成器
@@ -270,6 +646,1588 @@ private:
     Solution hybridSearch(const Problem& problem, const Solution& initial_solution);
 };
 
+// ---------------------------------------------------------------------------
+// AdaptiveLargeNeighborhoodSearch
+// ---------------------------------------------------------------------------
+
+inline AdaptiveLargeNeighborhoodSearch::AdaptiveLargeNeighborhoodSearch(unsigned seed) : rng_(seed) {
+    initializeOperators();
+}
+
+inline void AdaptiveLargeNeighborhoodSearch::initializeOperators() {
+    destroy_operators_ = {
+        [this](const std::vector<double>& x, int k) { return randomDestroy(x, k); },
+        [this](const std::vector<double>& x, int k) { return worstDestroy(x, k); },
+        [this](const std::vector<double>& x, int k) { return clusterDestroy(x, k); }
+    };
+    repair_operators_ = {
+        [this](const Problem& p, const std::vector<int>& removed) { return greedyRepair(p, removed); },
+        [this](const Problem& p, const std::vector<int>& removed) { return regretRepair(p, removed); }
+    };
+    destroy_weights_.assign(destroy_operators_.size(), 1.0);
+    repair_weights_.assign(repair_operators_.size(), 1.0);
+}
+
+inline void AdaptiveLargeNeighborhoodSearch::setHint(const std::vector<double>& lp_solution) {
+    std::lock_guard<std::mutex> lock(hint_mutex_);
+    shared_hint_ = lp_solution;
+    hint_version_.fetch_add(1, std::memory_order_release);
+}
+
+inline void AdaptiveLargeNeighborhoodSearch::refreshHint() {
+    unsigned version = hint_version_.load(std::memory_order_acquire);
+    if (version == seen_hint_version_) return;
+    std::lock_guard<std::mutex> lock(hint_mutex_);
+    hint_ = shared_hint_;
+    seen_hint_version_ = version;
+    if (hint_.size() != lower_.size()) hint_.clear();
+}
+
+inline Solution AdaptiveLargeNeighborhoodSearch::solve(const Problem& problem, const Solution& initial_solution) {
+    setupModel(problem);
+    const int n = problem.getNumVariables();
+    const int m = problem.getNumConstraints();
+    const double no_solution = sense_ * std::numeric_limits<double>::infinity();
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    refreshHint();
+    
+    std::vector<double> best;
+    double best_objective = no_solution;
+    bool has_best = false;
+    auto better = [&](double a, double b) { return sense_ * (a - b) < -1e-9 * std::max(1.0, std::abs(b)); };
+    
+    // Starting point: the given solution or the external incumbent; otherwise built from the hint
+    std::vector<double> start;
+    std::vector<double> external;
+    Solution::Status status = initial_solution.getStatus();
+    if ((status == Solution::Status::OPTIMAL || status == Solution::Status::FEASIBLE) &&
+        static_cast<int>(initial_solution.getValues().size()) == n) {
+        start = initial_solution.getValues();
+    }
+    if (solution_source_ && solution_source_(no_solution, external)) {
+        start = external;
+    }
+    bool constructed = start.empty();
+    auto construct = [&]() {
+        start.resize(n);
+        for (int j = 0; j < n; ++j) {
+            start[j] = hint_.empty() ? clampValue(j, 0.0) : hintValue(j);
+        }
+        loadTrial(start);
+        repairViolations(20 * (n + m) + 100);
+        completeContinuous();
+    };
+    if (constructed) {
+        construct();
+    } else {
+        loadTrial(start);
+    }
+    
+    current_ = trial_;
+    current_activity_ = trial_activity_;
+    bool current_feasible = violated_.empty();
+    double current_objective = objectiveOf(current_);
+    double current_violation = totalViolation(current_activity_);
+    if (current_feasible) {
+        best = current_;
+        best_objective = current_objective;
+        has_best = true;
+        if (constructed) {
+            improvements_++;
+            if (on_solution_) on_solution_(best, best_objective);
+        }
+    }
+    
+    std::vector<double> destroy_scores(destroy_operators_.size(), 0.0);
+    std::vector<double> repair_scores(repair_operators_.size(), 0.0);
+    std::vector<int> destroy_uses(destroy_operators_.size(), 0);
+    std::vector<int> repair_uses(repair_operators_.size(), 0);
+    const int max_iterations = params_.max_iterations;
+    const int segment_size = std::max(1, params_.segment_size);
+    int iteration = 0;
+    
+    for (; iteration < max_iterations && !stopRequested() && !free_vars_.empty(); ++iteration) {
+        // A new LP hint gives a fresh construction while no feasible solution is known
+        unsigned hint_version = seen_hint_version_;
+        refreshHint();
+        if (!current_feasible && seen_hint_version_ != hint_version && !hint_.empty()) {
+            construct();
+            if (violated_.empty() || totalViolation(trial_activity_) < current_violation) {
+                current_ = trial_;
+                current_activity_ = trial_activity_;
+                current_feasible = violated_.empty();
+                current_objective = objectiveOf(current_);
+                current_violation = totalViolation(current_activity_);
+                if (current_feasible && (!has_best || better(current_objective, best_objective))) {
+                    best = current_;
+                    best_objective = current_objective;
+                    has_best = true;
+                    improvements_++;
+                    if (on_solution_) on_solution_(best, best_objective);
+                }
+            }
+        }
+        
+        // Restart from the external incumbent when it is better than anything found here
+        if (solution_source_ && solution_source_(has_best ? best_objective : no_solution, external)) {
+            best = external;
+            best_objective = objectiveOf(best);
+            has_best = true;
+            current_ = best;
+            computeActivity(current_, current_activity_);
+            current_feasible = true;
+            current_objective = best_objective;
+            current_violation = 0.0;
+        }
+        
+        double progress = max_iterations > 1 ? static_cast<double>(iteration) / (max_iterations - 1) : 1.0;
+        double temperature = params_.temperature_start *
+                             std::pow(params_.temperature_end / params_.temperature_start, progress);
+        double fraction = params_.min_destroy_fraction +
+                          (params_.max_destroy_fraction - params_.min_destroy_fraction) * uniform(rng_);
+        int num_free = static_cast<int>(free_vars_.size());
+        int remove_count = std::min(num_free, std::max(1, static_cast<int>(std::round(fraction * num_free))));
+        
+        int d = selectOperator(destroy_weights_);
+        int r = selectOperator(repair_weights_);
+        std::vector<int> removed = destroy_operators_[d](current_, remove_count);
+        std::vector<double> candidate = repair_operators_[r](problem, removed);
+        
+        // The LP completion is far more expensive than the repair: it only polishes candidates
+        // that improve on the best solution, or repairs them while none is known
+        double objective = objectiveOf(candidate);
+        if (completion_ && has_continuous_ &&
+            (violated_.empty() ? !has_best || better(objective, best_objective) : !has_best)) {
+            completeContinuous();
+            candidate = trial_;
+            objective = objectiveOf(candidate);
+        }
+        bool feasible = violated_.empty();
+        double violation = feasible ? 0.0 : totalViolation(trial_activity_);
+        double reward = 0.0;
+        bool accept = false;
+        if (feasible) {
+            if (!has_best || better(objective, best_objective)) {
+                best = candidate;
+                best_objective = objective;
+                has_best = true;
+                improvements_++;
+                if (on_solution_) on_solution_(best, best_objective);
+                reward = params_.best_reward;
+                accept = true;
+            } else if (!current_feasible || better(objective, current_objective)) {
+                reward = params_.better_reward;
+                accept = true;
+            } else {
+                // Simulated annealing on the relative worsening, in percent
+                double worsening = 100.0 * sense_ * (objective - current_objective) /
+                                   std::max(1.0, std::abs(current_objective));
+                accept = uniform(rng_) < std::exp(-worsening / std::max(temperature, 1e-12));
+                if (accept) reward = params_.accepted_reward;
+            }
+        } else if (!current_feasible && violation < current_violation - 1e-9) {
+            reward = params_.better_reward;
+            accept = true;
+        }
+        if (accept) {
+            current_.swap(candidate);
+            current_activity_ = trial_activity_;
+            current_feasible = feasible;
+            current_objective = objective;
+            current_violation = violation;
+        }
+        
+        destroy_scores[d] += reward;
+        destroy_uses[d]++;
+        repair_scores[r] += reward;
+        repair_uses[r]++;
+        if ((iteration + 1) % segment_size == 0) {
+            for (size_t k = 0; k < destroy_scores.size(); ++k) {
+                if (destroy_uses[k] > 0) updateWeights(static_cast<int>(k), destroy_scores[k] / destroy_uses[k], destroy_weights_);
+                destroy_scores[k] = 0.0;
+                destroy_uses[k] = 0;
+            }
+            for (size_t k = 0; k < repair_scores.size(); ++k) {
+                if (repair_uses[k] > 0) updateWeights(static_cast<int>(k), repair_scores[k] / repair_uses[k], repair_weights_);
+                repair_scores[k] = 0.0;
+                repair_uses[k] = 0;
+            }
+        }
+    }
+    
+    Solution result(n);
+    result.setIterations(iteration);
+    if (has_best) {
+        for (int j = 0; j < n; ++j) {
+            result.setValue(j, best[j]);
+        }
+        result.setObjectiveValue(best_objective);
+        result.setStatus(Solution::Status::FEASIBLE);
+    } else {
+        result.setObjectiveValue(no_solution);
+    }
+    return result;
+}
+
+inline int AdaptiveLargeNeighborhoodSearch::selectOperator(const std::vector<double>& weights) {
+    double total = 0.0;
+    for (double w : weights) total += w;
+    double pick = std::uniform_real_distribution<double>(0.0, total)(rng_);
+    for (size_t k = 0; k < weights.size(); ++k) {
+        pick -= weights[k];
+        if (pick <= 0.0) return static_cast<int>(k);
+    }
+    return static_cast<int>(weights.size()) - 1;
+}
+
+inline void AdaptiveLargeNeighborhoodSearch::updateWeights(int operator_idx, double reward, std::vector<double>& weights) {
+    // Keep a floor so that no operator is starved for good
+    weights[operator_idx] = std::max(0.1, (1.0 - params_.alpha) * weights[operator_idx] + params_.alpha * reward);
+}
+
+inline std::vector<int> AdaptiveLargeNeighborhoodSearch::randomDestroy(const std::vector<double>& /*solution*/, int remove_count) {
+    std::vector<int> pool = free_vars_;
+    int count = std::min(remove_count, static_cast<int>(pool.size()));
+    for (int k = 0; k < count; ++k) {
+        int pick = k + static_cast<int>(rng_() % (pool.size() - k));
+        std::swap(pool[k], pool[pick]);
+    }
+    pool.resize(count);
+    return pool;
+}
+
+inline std::vector<int> AdaptiveLargeNeighborhoodSearch::worstDestroy(const std::vector<double>& solution, int remove_count) {
+    // Objective loss of each variable against its best bound, randomized to vary the choice
+    std::uniform_real_distribution<double> noise(0.5, 1.5);
+    std::vector<std::pair<double, int>> scored;
+    scored.reserve(free_vars_.size());
+    for (int j : free_vars_) {
+        double c = sense_ * cost_[j];
+        double bound = c > 0.0 ? lower_[j] : upper_[j];
+        double loss = std::abs(bound) < kInfinity ? c * (solution[j] - bound) : 0.0;
+        scored.push_back({-loss * noise(rng_), j});
+    }
+    int count = std::min(remove_count, static_cast<int>(scored.size()));
+    std::partial_sort(scored.begin(), scored.begin() + count, scored.end());
+    std::vector<int> removed(count);
+    for (int k = 0; k < count; ++k) {
+        removed[k] = scored[k].second;
+    }
+    return removed;
+}
+
+inline std::vector<int> AdaptiveLargeNeighborhoodSearch::clusterDestroy(const std::vector<double>& /*solution*/, int remove_count) {
+    // Breadth-first over variables that share rows, starting from random seeds
+    const SparseMatrix& matrix = problem_->getMatrix();
+    int count = std::min(remove_count, static_cast<int>(free_vars_.size()));
+    std::vector<int> removed;
+    removed.reserve(count);
+    stamp_value_++;
+    size_t head = 0;
+    while (static_cast<int>(removed.size()) < count) {
+        if (head == removed.size()) {
+            int seed = free_vars_[rng_() % free_vars_.size()];
+            if (stamp_[seed] == stamp_value_) continue;
+            stamp_[seed] = stamp_value_;
+            removed.push_back(seed);
+        }
+        SparseMatrix::VectorView column = matrix.column(removed[head++]);
+        for (int k = 0; k < column.size && static_cast<int>(removed.size()) < count; ++k) {
+            SparseMatrix::VectorView row = matrix.row(column.indices[k]);
+            for (int t = 0; t < row.size && static_cast<int>(removed.size()) < count; ++t) {
+                int j = row.indices[t];
+                if (stamp_[j] == stamp_value_ || lower_[j] >= upper_[j]) continue;
+                stamp_[j] = stamp_value_;
+                removed.push_back(j);
+            }
+        }
+    }
+    return removed;
+}
+
+inline std::vector<double> AdaptiveLargeNeighborhoodSearch::greedyRepair(const Problem& /*problem*/,
+                                                                         const std::vector<int>& removed_vars) {
+    loadTrial(current_);
+    ruin(removed_vars);
+    std::vector<int> order = removed_vars;
+    std::shuffle(order.begin(), order.end(), rng_);
+    for (int j : order) {
+        Move move = bestMove(j, current_[j]);
+        if (move.value != trial_[j]) applyMove(j, move.value);
+    }
+    repairViolations(10 * static_cast<int>(removed_vars.size() + violated_.size()) + 100);
+    return trial_;
+}
+
+inline std::vector<double> AdaptiveLargeNeighborhoodSearch::regretRepair(const Problem& /*problem*/,
+                                                                         const std::vector<int>& removed_vars) {
+    const size_t max_evaluated = 30;  // regret is recomputed for at most this many pending variables
+    loadTrial(current_);
+    ruin(removed_vars);
+    std::vector<int> pending = removed_vars;
+    std::vector<Move> moves;
+    while (!pending.empty()) {
+        if (pending.size() > max_evaluated) {
+            for (size_t k = 0; k < max_evaluated; ++k) {
+                std::swap(pending[k], pending[k + rng_() % (pending.size() - k)]);
+            }
+        }
+        size_t evaluated = std::min(pending.size(), max_evaluated);
+        size_t chosen = 0;
+        double chosen_regret = -1.0;
+        Move chosen_move{0.0, 0.0, 0.0, 0.0};
+        for (size_t k = 0; k < evaluated; ++k) {
+            int j = pending[k];
+            candidateMoves(j, current_[j], moves);
+            std::partial_sort(moves.begin(), moves.begin() + std::min<size_t>(2, moves.size()), moves.end());
+            double regret = 0.0;
+            if (moves.size() > 1) {
+                regret = penalty_ * (moves[1].violation_delta - moves[0].violation_delta) +
+                         (moves[1].objective_delta - moves[0].objective_delta);
+            }
+            if (regret > chosen_regret) {
+                chosen_regret = regret;
+                chosen = k;
+                chosen_move = moves[0];
+            }
+        }
+        int j = pending[chosen];
+        if (chosen_move.value != trial_[j]) applyMove(j, chosen_move.value);
+        pending[chosen] = pending.back();
+        pending.pop_back();
+    }
+    repairViolations(10 * static_cast<int>(removed_vars.size() + violated_.size()) + 100);
+    return trial_;
+}
+
+inline void AdaptiveLargeNeighborhoodSearch::setupModel(const Problem& problem) {
+    problem_ = &problem;
+    sense_ = problem.getObjectiveType() == ObjectiveType::MAXIMIZE ? -1.0 : 1.0;
+    const int n = problem.getNumVariables();
+    const int m = problem.getNumConstraints();
+    problem.getMatrix().buildColumnView();
+    
+    lower_.resize(n);
+    upper_.resize(n);
+    cost_.resize(n);
+    is_integer_.resize(n);
+    free_vars_.clear();
+    has_continuous_ = false;
+    double max_cost = 0.0;
+    for (int j = 0; j < n; ++j) {
+        ConstVariable var = problem.getVariable(j);
+        is_integer_[j] = var.getType() != VariableType::CONTINUOUS;
+        lower_[j] = is_integer_[j] ? std::ceil(var.getLowerBound() - kFeasibilityTolerance) : var.getLowerBound();
+        upper_[j] = is_integer_[j] ? std::floor(var.getUpperBound() + kFeasibilityTolerance) : var.getUpperBound();
+        cost_[j] = var.getCoefficient();
+        max_cost = std::max(max_cost, std::abs(cost_[j]));
+        if (lower_[j] < upper_[j]) {
+            free_vars_.push_back(j);
+            if (!is_integer_[j]) has_continuous_ = true;
+        }
+    }
+    penalty_ = 1e3 * (1.0 + max_cost);
+    row_lower_.resize(m);
+    row_upper_.resize(m);
+    for (int i = 0; i < m; ++i) {
+        row_lower_[i] = problem.getConstraint(i).getLowerLimit();
+        row_upper_[i] = problem.getConstraint(i).getUpperLimit();
+    }
+    violated_pos_.assign(m, -1);
+    violated_.clear();
+    stamp_.assign(n, 0);
+    stamp_value_ = 0;
+    if (hint_.size() != static_cast<size_t>(n)) hint_.clear();
+}
+
+inline double AdaptiveLargeNeighborhoodSearch::rowViolation(int row, double activity) const {
+    if (activity < row_lower_[row]) return row_lower_[row] - activity;
+    if (activity > row_upper_[row]) return activity - row_upper_[row];
+    return 0.0;
+}
+
+inline double AdaptiveLargeNeighborhoodSearch::objectiveOf(const std::vector<double>& x) const {
+    return Kernels::dot(cost_.data(), x.data(), static_cast<int>(x.size()));
+}
+
+inline double AdaptiveLargeNeighborhoodSearch::totalViolation(const std::vector<double>& activity) const {
+    return Kernels::sumViolation(activity.data(), row_lower_.data(), row_upper_.data(),
+                                 static_cast<int>(activity.size()));
+}
+
+inline void AdaptiveLargeNeighborhoodSearch::computeActivity(const std::vector<double>& x,
+                                                              std::vector<double>& activity) const {
+    const SparseMatrix& matrix = problem_->getMatrix();
+    activity.resize(row_lower_.size());
+    Kernels::rowActivities(matrix, x.data(), activity.data());
+}
+
+inline double AdaptiveLargeNeighborhoodSearch::clampValue(int j, double value) const {
+    if (is_integer_[j]) value = std::round(value);
+    return std::min(std::max(value, lower_[j]), upper_[j]);
+}
+
+inline double AdaptiveLargeNeighborhoodSearch::hintValue(int j) const {
+    return clampValue(j, hint_[j]);
+}
+
+inline double AdaptiveLargeNeighborhoodSearch::moveViolationDelta(int j, double to) const {
+    double step = to - trial_[j];
+    if (step == 0.0) return 0.0;
+    SparseMatrix::VectorView column = problem_->getMatrix().column(j);
+    double delta = 0.0;
+    for (int k = 0; k < column.size; ++k) {
+        int i = column.indices[k];
+        double activity = trial_activity_[i];
+        delta += rowViolation(i, activity + column.values[k] * step) - rowViolation(i, activity);
+    }
+    return delta;
+}
+
+inline void AdaptiveLargeNeighborhoodSearch::applyMove(int j, double value) {
+    double step = value - trial_[j];
+    trial_[j] = value;
+    SparseMatrix::VectorView column = problem_->getMatrix().column(j);
+    for (int k = 0; k < column.size; ++k) {
+        int i = column.indices[k];
+        trial_activity_[i] += column.values[k] * step;
+        updateViolated(i);
+    }
+}
+
+inline void AdaptiveLargeNeighborhoodSearch::candidateMoves(int j, double base_value, std::vector<Move>& moves) {
+    const int max_jumps = 8;
+    double values[max_jumps + 4];
+    int count = 0;
+    values[count++] = trial_[j];
+    values[count++] = clampValue(j, base_value);
+    if (lower_[j] > -kInfinity) values[count++] = lower_[j];
+    if (upper_[j] < kInfinity) values[count++] = upper_[j];
+    if (!hint_.empty()) values[count++] = hintValue(j);
+    
+    // Values that make a violated row through j exactly satisfied
+    SparseMatrix::VectorView column = problem_->getMatrix().column(j);
+    for (int k = 0; k < column.size && count < max_jumps + 4; ++k) {
+        int i = column.indices[k];
+        if (violated_pos_[i] < 0) continue;
+        double activity = trial_activity_[i];
+        double shift = (activity < row_lower_[i] ? row_lower_[i] - activity : row_upper_[i] - activity) / column.values[k];
+        double value = trial_[j] + shift;
+        if (is_integer_[j]) value = shift > 0.0 ? std::ceil(value - 1e-9) : std::floor(value + 1e-9);
+        values[count++] = std::min(std::max(value, lower_[j]), upper_[j]);
+    }
+    
+    moves.clear();
+    for (int k = 0; k < count; ++k) {
+        double value = values[k];
+        moves.push_back({value, moveViolationDelta(j, value), sense_ * cost_[j] * (value - trial_[j]),
+                         hint_.empty() ? 0.0 : std::abs(value - hint_[j])});
+    }
+}
+
+inline AdaptiveLargeNeighborhoodSearch::Move AdaptiveLargeNeighborhoodSearch::bestMove(int j, double base_value) {
+    std::vector<Move> moves;
+    candidateMoves(j, base_value, moves);
+    return *std::min_element(moves.begin(), moves.end());
+}
+
+inline void AdaptiveLargeNeighborhoodSearch::ruin(const std::vector<int>& removed_vars) {
+    // Removed variables move to the LP hint, or to their objective-preferred bound without one
+    for (int j : removed_vars) {
+        double value = trial_[j];
+        if (!hint_.empty()) {
+            value = hintValue(j);
+        } else if (sense_ * cost_[j] > 0.0 && lower_[j] > -kInfinity) {
+            value = lower_[j];
+        } else if (sense_ * cost_[j] < 0.0 && upper_[j] < kInfinity) {
+            value = upper_[j];
+        }
+        if (value != trial_[j]) applyMove(j, value);
+    }
+}
+
+inline void AdaptiveLargeNeighborhoodSearch::rebuildViolated() {
+    for (int i : violated_) {
+        violated_pos_[i] = -1;
+    }
+    violated_.clear();
+    for (size_t i = 0; i < row_lower_.size(); ++i) {
+        updateViolated(static_cast<int>(i));
+    }
+}
+
+inline void AdaptiveLargeNeighborhoodSearch::updateViolated(int row) {
+    double activity = trial_activity_[row];
+    double violation = rowViolation(row, activity);
+    double bound = activity < row_lower_[row] ? row_lower_[row] : row_upper_[row];
+    bool violated = violation > kFeasibilityTolerance * std::max(1.0, std::abs(bound));
+    int pos = violated_pos_[row];
+    if (violated && pos < 0) {
+        violated_pos_[row] = static_cast<int>(violated_.size());
+        violated_.push_back(row);
+    } else if (!violated && pos >= 0) {
+        int last = violated_.back();
+        violated_[pos] = last;
+        violated_pos_[last] = pos;
+        violated_.pop_back();
+        violated_pos_[row] = -1;
+    }
+}
+
+/*
+ * 局部跳跃修复：随机取一行违反的约束，在该行的变量中选择使它恰好满足的取值，
+ * 选择总违反量下降最多的一步；没有下降的一步时以小概率仍然执行以跳出平台
+ */
+inline void AdaptiveLargeNeighborhoodSearch::repairViolations(int max_steps) {
+    const int max_entries = 32;       // row entries examined per step
+    const int max_failures = 50;
+    const SparseMatrix& matrix = problem_->getMatrix();
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    int failures = 0;
+    for (int step = 0; step < max_steps && !violated_.empty() && failures < max_failures; ++step) {
+        int i = violated_[rng_() % violated_.size()];
+        SparseMatrix::VectorView row = matrix.row(i);
+        if (row.size == 0) break;
+        double activity = trial_activity_[i];
+        double needed = activity < row_lower_[i] ? row_lower_[i] - activity : row_upper_[i] - activity;
+        
+        bool found = false;
+        Move best{0.0, 0.0, 0.0, 0.0};
+        int best_var = -1;
+        int examined = std::min(row.size, max_entries);
+        int offset = static_cast<int>(rng_() % row.size);
+        for (int t = 0; t < examined; ++t) {
+            int k = (offset + t) % row.size;
+            int j = row.indices[k];
+            if (lower_[j] >= upper_[j] || row.values[k] == 0.0) continue;
+            double shift = needed / row.values[k];
+            double value = trial_[j] + shift;
+            if (is_integer_[j]) value = shift > 0.0 ? std::ceil(value - 1e-9) : std::floor(value + 1e-9);
+            value = std::min(std::max(value, lower_[j]), upper_[j]);
+            if (value == trial_[j]) continue;
+            Move move{value, moveViolationDelta(j, value), sense_ * cost_[j] * (value - trial_[j]), 0.0};
+            if (!found || move < best) {
+                best = move;
+                best_var = j;
+                found = true;
+            }
+        }
+        if (!found) {
+            failures++;
+            continue;
+        }
+        if (best.violation_delta < -1e-12) {
+            applyMove(best_var, best.value);
+            failures = 0;
+        } else {
+            failures++;
+            if (uniform(rng_) < 0.1) applyMove(best_var, best.value);
+        }
+    }
+}
+
+inline void AdaptiveLargeNeighborhoodSearch::completeContinuous() {
+    if (!completion_ || !has_continuous_) return;
+    std::vector<double> x = trial_;
+    if (completion_(x)) {
+        loadTrial(x);
+    }
+}
+
+inline void AdaptiveLargeNeighborhoodSearch::loadTrial(const std::vector<double>& x) {
+    trial_ = x;
+    computeActivity(trial_, trial_activity_);
+    rebuildViolated();
+}
+
+// ---------------------------------------------------------------------------
+// MLBranchingStrategy
+// ---------------------------------------------------------------------------
+
+inline MLBranchingStrategy::MLBranchingStrategy()
+    : feature_weights_(7, 0.0), is_trained_(false) {}
+
+inline int MLBranchingStrategy::selectBranchingVariable(const Problem& problem,
+                                                        const std::vector<double>& lp_solution,
+                                                        const std::vector<BranchingFeatures>& features) {
+    const double tolerance = 1e-6;
+    bool have_features = static_cast<int>(features.size()) == problem.getNumVariables();
+    int best_var = -1;
+    double best_score = -std::numeric_limits<double>::infinity();
+    
+    for (int j = 0; j < problem.getNumVariables(); ++j) {
+        if (problem.getVariable(j).getType() == VariableType::CONTINUOUS) continue;
+        double val = lp_solution[j];
+        if (std::abs(val - std::round(val)) <= tolerance) continue;
+        
+        double s = have_features ? predictScore(features[j])
+                                 : predictScore(extractFeatures(problem, j, lp_solution));
+        if (s > best_score) {
+            best_score = s;
+            best_var = j;
+        }
+    }
+    return best_var;
+}
+
+inline void MLBranchingStrategy::updateModel(const std::vector<BranchingFeatures>& features,
+                                             const std::vector<double>& outcomes) {
+    size_t count = std::min(features.size(), outcomes.size());
+    if (count == 0) return;
+    
+    // Normalized least-mean-squares passes over the samples
+    const int epochs = 10;
+    const double learning_rate = 0.1;
+    for (int epoch = 0; epoch < epochs; ++epoch) {
+        for (size_t k = 0; k < count; ++k) {
+            const BranchingFeatures& f = features[k];
+            double x[7] = {1.0, f.pseudocost_up, f.pseudocost_down, f.infeasibility,
+                           f.obj_coefficient, f.constraint_density, f.variable_age};
+            double prediction = 0.0;
+            double norm = 0.0;
+            for (int i = 0; i < 7; ++i) {
+                prediction += feature_weights_[i] * x[i];
+                norm += x[i] * x[i];
+            }
+            double step = learning_rate * (outcomes[k] - prediction) / norm;
+            for (int i = 0; i < 7; ++i) {
+                feature_weights_[i] += step * x[i];
+            }
+        }
+    }
+    is_trained_ = true;
+}
+
+inline MLBranchingStrategy::BranchingFeatures MLBranchingStrategy::extractFeatures(
+        const Problem& problem, int var_index, const std::vector<double>& lp_solution) {
+    ConstVariable var = problem.getVariable(var_index);
+    double val = lp_solution[var_index];
+    double down = val - std::floor(val);
+    double up = 1.0 - down;
+    double obj = std::abs(var.getCoefficient());
+    
+    BranchingFeatures features;
+    // Without observed pseudocosts, use the objective coefficient as the per-unit degradation
+    features.pseudocost_down = obj * down;
+    features.pseudocost_up = obj * up;
+    features.infeasibility = std::min(down, up);
+    features.obj_coefficient = obj;
+    int num_rows = problem.getNumConstraints();
+    features.constraint_density = num_rows > 0
+        ? static_cast<double>(problem.getMatrix().column(var_index).size) / num_rows : 0.0;
+    features.variable_age = 0.0;
+    return features;
+}
+
+inline double MLBranchingStrategy::predictScore(const BranchingFeatures& features) {
+    if (scorer_) {
+        return scorer_(features);
+    }
+    if (!is_trained_) {
+        const double epsilon = 1e-6;
+        return std::max(features.pseudocost_down, epsilon) * std::max(features.pseudocost_up, epsilon);
+    }
+    double x[7] = {1.0, features.pseudocost_up, features.pseudocost_down, features.infeasibility,
+                   features.obj_coefficient, features.constraint_density, features.variable_age};
+    double prediction = 0.0;
+    for (int i = 0; i < 7; ++i) {
+        prediction += feature_weights_[i] * x[i];
+    }
+    return prediction;
+}
+
+// ---------------------------------------------------------------------------
+// HeuristicPreprocessor
+// ---------------------------------------------------------------------------
+
+inline HeuristicPreprocessor::PreprocessingResult HeuristicPreprocessor::preprocess(const Problem& original_problem) {
+    const double inf = std::numeric_limits<double>::infinity();
+    const int n = original_problem.getNumVariables();
+    const int m = original_problem.getNumConstraints();
+    const SparseMatrix& matrix = original_problem.getMatrix();
+    bounds_tightened_ = 0;
+    coefficients_strengthened_ = 0;
+    
+    WorkingModel model;
+    model.sense = original_problem.getObjectiveType() == ObjectiveType::MAXIMIZE ? -1.0 : 1.0;
+    model.lower.resize(n);
+    model.upper.resize(n);
+    model.cost.resize(n);
+    model.is_integer.resize(n);
+    model.col_active.assign(n, true);
+    model.col_rows.resize(n);
+    for (int j = 0; j < n; ++j) {
+        ConstVariable var = original_problem.getVariable(j);
+        double lower = var.getLowerBound();
+        double upper = var.getUpperBound();
+        bool is_integer = var.getType() != VariableType::CONTINUOUS;
+        if (is_integer) {
+            lower = std::ceil(lower - 1e-9);
+            upper = std::floor(upper + 1e-9);
+        }
+        model.lower[j] = lower;
+        model.upper[j] = upper;
+        model.cost[j] = var.getCoefficient();
+        model.is_integer[j] = is_integer;
+        if (lower > upper) model.infeasible = true;
+        
+        SparseMatrix::VectorView column = matrix.column(j);
+        model.col_rows[j].assign(column.indices, column.indices + column.size);
+    }
+    
+    model.row_lower.resize(m);
+    model.row_upper.resize(m);
+    model.row_active.assign(m, true);
+    model.rows.resize(m);
+    for (int i = 0; i < m; ++i) {
+        ConstConstraint constraint = original_problem.getConstraint(i);
+        model.row_lower[i] = constraint.getLowerLimit();
+        model.row_upper[i] = constraint.getUpperLimit();
+        SparseMatrix::VectorView row = matrix.row(i);
+        model.rows[i].reserve(row.size);
+        for (int k = 0; k < row.size; ++k) {
+            model.rows[i].emplace_back(row.indices[k], row.values[k]);
+        }
+    }
+    
+    PreprocessingResult result;
+    result.problem_reduced = false;
+    result.variables_eliminated = 0;
+    result.constraints_eliminated = 0;
+    
+    for (int round = 0; round < max_rounds_ && !model.infeasible; ++round) {
+        bool changed = false;
+        changed |= removeSingletonRows(model);
+        changed |= fixVariables(model, result.postsolve, result.objective_offset);
+        changed |= detectImpliedBounds(model);
+        if (!changed && !model.infeasible) {
+            changed |= aggregateConstraints(model);
+        }
+        if (!changed) break;
+    }
+    if (!model.infeasible) {
+        fixVariables(model, result.postsolve, result.objective_offset);
+        strengthenCoefficients(model);
+    }
+    
+    result.bounds_tightened = bounds_tightened_;
+    result.coefficients_strengthened = coefficients_strengthened_;
+    if (model.infeasible) {
+        result.infeasible = true;
+        return result;
+    }
+    
+    // Build the reduced problem from the surviving rows and columns
+    Problem reduced(original_problem.getName(), original_problem.getObjectiveType());
+    std::vector<int> new_index(n, -1);
+    for (int j = 0; j < n; ++j) {
+        if (!model.col_active[j]) continue;
+        ConstVariable var = original_problem.getVariable(j);
+        int index = reduced.addVariable(var.getName(), var.getType());
+        reduced.getVariable(index).setBounds(model.lower[j], model.upper[j]);
+        reduced.setObjectiveCoefficient(index, model.cost[j]);
+        result.variable_mapping.push_back(j);
+        new_index[j] = index;
+    }
+    
+    auto add_row = [&](int i, ConstraintType type, double rhs) {
+        int index = reduced.addConstraint(original_problem.getConstraint(i).getName(), type, rhs);
+        for (const auto& entry : model.rows[i]) {
+            reduced.addConstraintCoefficient(index, new_index[entry.first], entry.second);
+        }
+        result.constraint_mapping.push_back(i);
+    };
+    for (int i = 0; i < m; ++i) {
+        if (!model.row_active[i]) continue;
+        double lower = model.row_lower[i];
+        double upper = model.row_upper[i];
+        if (lower == upper) {
+            add_row(i, ConstraintType::EQUAL, lower);
+        } else if (lower == -inf && upper != inf) {
+            add_row(i, ConstraintType::LESS_EQUAL, upper);
+        } else if (upper == inf && lower != -inf) {
+            add_row(i, ConstraintType::GREATER_EQUAL, lower);
+        } else if (lower != -inf && upper != inf) {
+            add_row(i, ConstraintType::GREATER_EQUAL, lower);
+            reduced.getConstraint(reduced.getNumConstraints() - 1).setRange(upper - lower);
+        }
+    }
+    reduced.finalize();
+    
+    result.variables_eliminated = n - reduced.getNumVariables();
+    result.constraints_eliminated = m - static_cast<int>(std::count(model.row_active.begin(), model.row_active.end(), true));
+    result.problem_reduced = result.variables_eliminated > 0 || result.constraints_eliminated > 0 ||
+                             result.bounds_tightened > 0 || result.coefficients_strengthened > 0;
+    result.processed_problem = std::move(reduced);
+    return result;
+}
+
+inline Solution HeuristicPreprocessor::postsolve(const PreprocessingResult& result, const Problem& original_problem,
+                                                 const Solution& reduced_solution) const {
+    int n = original_problem.getNumVariables();
+    Solution solution(n);
+    std::vector<double> values = result.postsolve.undo(reduced_solution.getValues(), result.variable_mapping, n);
+    for (int j = 0; j < n; ++j) {
+        solution.setValue(j, values[j]);
+    }
+    
+    double objective = reduced_solution.getObjectiveValue();
+    solution.setObjectiveValue(std::isfinite(objective) ? original_problem.calculateObjectiveValue(values) : objective);
+    solution.setDualBound(reduced_solution.getDualBound() + result.objective_offset);
+    solution.setStatus(reduced_solution.getStatus());
+    solution.setSolveTime(reduced_solution.getSolveTime());
+    solution.setIterations(reduced_solution.getIterations());
+    solution.setLPIterations(reduced_solution.getLPIterations());
+    solution.setOpenNodes(reduced_solution.getOpenNodes());
+    solution.setWorkUnits(reduced_solution.getWorkUnits());
+    std::vector<Solution::IncumbentRecord> history = reduced_solution.getIncumbentHistory();
+    for (Solution::IncumbentRecord& record : history) {
+        record.objective += result.objective_offset;
+    }
+    solution.setIncumbentHistory(std::move(history));
+    return solution;
+}
+
+inline bool HeuristicPreprocessor::tightenLower(WorkingModel& model, int j, double bound) {
+    if (model.is_integer[j]) bound = std::ceil(bound - 1e-6);
+    if (bound <= model.lower[j]) return false;
+    if (bound > model.upper[j]) {
+        if (bound > model.upper[j] + 1e-6 * std::max(1.0, std::abs(model.upper[j]))) {
+            model.infeasible = true;
+            return false;
+        }
+        bound = model.upper[j];
+    }
+    double old = model.lower[j];
+    model.lower[j] = bound;
+    // Tiny improvements are applied but do not trigger another round
+    bool substantial = std::isinf(old) || bound - old > 1e-3 * std::max(1.0, std::abs(bound));
+    if (substantial) bounds_tightened_++;
+    return substantial;
+}
+
+inline bool HeuristicPreprocessor::tightenUpper(WorkingModel& model, int j, double bound) {
+    if (model.is_integer[j]) bound = std::floor(bound + 1e-6);
+    if (bound >= model.upper[j]) return false;
+    if (bound < model.lower[j]) {
+        if (bound < model.lower[j] - 1e-6 * std::max(1.0, std::abs(model.lower[j]))) {
+            model.infeasible = true;
+            return false;
+        }
+        bound = model.lower[j];
+    }
+    double old = model.upper[j];
+    model.upper[j] = bound;
+    bool substantial = std::isinf(old) || old - bound > 1e-3 * std::max(1.0, std::abs(bound));
+    if (substantial) bounds_tightened_++;
+    return substantial;
+}
+
+inline bool HeuristicPreprocessor::removeSingletonRows(WorkingModel& model) {
+    bool changed = false;
+    for (size_t i = 0; i < model.rows.size() && !model.infeasible; ++i) {
+        if (!model.row_active[i]) continue;
+        const auto& row = model.rows[i];
+        double lower = model.row_lower[i];
+        double upper = model.row_upper[i];
+        
+        if (row.empty()) {
+            if (lower > 1e-6 * std::max(1.0, std::abs(lower)) || upper < -1e-6 * std::max(1.0, std::abs(upper))) {
+                model.infeasible = true;
+                return false;
+            }
+            model.row_active[i] = false;
+            changed = true;
+        } else if (row.size() == 1) {
+            int j = row[0].first;
+            double a = row[0].second;
+            // a * x_j in [lower, upper]; dividing by a negative coefficient swaps the limits
+            double var_lower = a > 0 ? lower / a : upper / a;
+            double var_upper = a > 0 ? upper / a : lower / a;
+            tightenLower(model, j, var_lower);
+            tightenUpper(model, j, var_upper);
+            model.row_active[i] = false;
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+inline bool HeuristicPreprocessor::fixVariables(WorkingModel& model, PostsolveStack& postsolve, double& objective_offset) {
+    bool changed = false;
+    for (size_t j = 0; j < model.lower.size(); ++j) {
+        if (!model.col_active[j]) continue;
+        double lower = model.lower[j];
+        double upper = model.upper[j];
+        double value;
+        
+        if (upper - lower <= 1e-9) {
+            value = model.is_integer[j] ? std::round(lower) : lower;
+        } else {
+            bool in_active_row = false;
+            for (int r : model.col_rows[j]) {
+                if (!model.row_active[r]) continue;
+                const auto& row = model.rows[r];
+                if (std::any_of(row.begin(), row.end(), [&](const std::pair<int, double>& e) { return e.first == static_cast<int>(j); })) {
+                    in_active_row = true;
+                    break;
+                }
+            }
+            if (in_active_row) continue;
+            
+            // Empty column: the objective alone decides its value
+            double cost = model.sense * model.cost[j];
+            if (cost > 0.0) {
+                if (std::isinf(lower)) continue;  // Unbounded; left for the LP to report
+                value = lower;
+            } else if (cost < 0.0) {
+                if (std::isinf(upper)) continue;
+                value = upper;
+            } else {
+                value = std::min(std::max(0.0, lower), upper);
+            }
+        }
+        
+        model.col_active[j] = false;
+        postsolve.fixVariable(static_cast<int>(j), value);
+        objective_offset += model.cost[j] * value;
+        for (int r : model.col_rows[j]) {
+            if (!model.row_active[r]) continue;
+            auto& row = model.rows[r];
+            for (auto it = row.begin(); it != row.end(); ++it) {
+                if (it->first != static_cast<int>(j)) continue;
+                double shift = it->second * value;
+                model.row_lower[r] -= shift;
+                model.row_upper[r] -= shift;
+                row.erase(it);
+                break;
+            }
+        }
+        changed = true;
+    }
+    return changed;
+}
+
+inline bool HeuristicPreprocessor::detectImpliedBounds(WorkingModel& model) {
+    const double inf = std::numeric_limits<double>::infinity();
+    bool changed = false;
+    
+    for (size_t i = 0; i < model.rows.size(); ++i) {
+        if (!model.row_active[i]) continue;
+        const auto& row = model.rows[i];
+        double lower = model.row_lower[i];
+        double upper = model.row_upper[i];
+        
+        // Activity range split into a finite part and a count of infinite contributions
+        double min_finite = 0.0, max_finite = 0.0;
+        int min_infinite = 0, max_infinite = 0;
+        for (const auto& entry : row) {
+            double a = entry.second;
+            double lo = model.lower[entry.first];
+            double up = model.upper[entry.first];
+            double min_term = a > 0 ? a * lo : a * up;
+            double max_term = a > 0 ? a * up : a * lo;
+            if (std::isinf(min_term)) min_infinite++; else min_finite += min_term;
+            if (std::isinf(max_term)) max_infinite++; else max_finite += max_term;
+        }
+        
+        if ((min_infinite == 0 && min_finite > upper + 1e-6 * std::max(1.0, std::abs(upper))) ||
+            (max_infinite == 0 && max_finite < lower - 1e-6 * std::max(1.0, std::abs(lower)))) {
+            model.infeasible = true;
+            return false;
+        }
+        
+        bool lower_implied = lower == -inf || (min_infinite == 0 && min_finite >= lower - 1e-9 * std::max(1.0, std::abs(lower)));
+        bool upper_implied = upper == inf || (max_infinite == 0 && max_finite <= upper + 1e-9 * std::max(1.0, std::abs(upper)));
+        if (lower_implied && upper_implied) {
+            model.row_active[i] = false;
+            changed = true;
+            continue;
+        }
+        
+        for (const auto& entry : row) {
+            int j = entry.first;
+            double a = entry.second;
+            if (std::abs(a) < 1e-9) continue;
+            double min_term = a > 0 ? a * model.lower[j] : a * model.upper[j];
+            double max_term = a > 0 ? a * model.upper[j] : a * model.lower[j];
+            
+            // Activity of the rest of the row, excluding this entry
+            double rest_min = std::isinf(min_term) ? (min_infinite == 1 ? min_finite : -inf)
+                                                   : (min_infinite == 0 ? min_finite - min_term : -inf);
+            double rest_max = std::isinf(max_term) ? (max_infinite == 1 ? max_finite : inf)
+                                                   : (max_infinite == 0 ? max_finite - max_term : inf);
+            
+            if (upper != inf && rest_min != -inf) {
+                double bound = (upper - rest_min) / a;
+                if (model.is_integer[j] || std::abs(bound) < 1e9) {
+                    changed |= a > 0 ? tightenUpper(model, j, bound) : tightenLower(model, j, bound);
+                }
+            }
+            if (lower != -inf && rest_max != inf) {
+                double bound = (lower - rest_max) / a;
+                if (model.is_integer[j] || std::abs(bound) < 1e9) {
+                    changed |= a > 0 ? tightenLower(model, j, bound) : tightenUpper(model, j, bound);
+                }
+            }
+            if (model.infeasible) return false;
+        }
+    }
+    return changed;
+}
+
+inline bool HeuristicPreprocessor::aggregateConstraints(WorkingModel& model) {
+    const double inf = std::numeric_limits<double>::infinity();
+    const double tolerance = 1e-9;
+    bool changed = false;
+    
+    // Bucket rows by their sparsity pattern and coefficients scaled by the first entry
+    std::unordered_map<size_t, std::vector<int>> buckets;
+    for (size_t i = 0; i < model.rows.size(); ++i) {
+        if (!model.row_active[i] || model.rows[i].empty()) continue;
+        const auto& row = model.rows[i];
+        size_t hash = row.size();
+        double scale = row[0].second;
+        for (const auto& entry : row) {
+            long long ratio = std::llround(entry.second / scale * 1e6);
+            hash ^= std::hash<long long>()(entry.first * 1000003LL + ratio) + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+        }
+        buckets[hash].push_back(static_cast<int>(i));
+    }
+    
+    for (auto& bucket : buckets) {
+        std::vector<int>& rows = bucket.second;
+        for (size_t p = 0; p < rows.size(); ++p) {
+            int r1 = rows[p];
+            if (!model.row_active[r1]) continue;
+            for (size_t q = p + 1; q < rows.size(); ++q) {
+                int r2 = rows[q];
+                if (!model.row_active[r2]) continue;
+                const auto& a = model.rows[r1];
+                const auto& b = model.rows[r2];
+                if (a.size() != b.size()) continue;
+                
+                // row2 = lambda * row1 ?
+                double lambda = b[0].second / a[0].second;
+                bool parallel = true;
+                for (size_t k = 0; k < a.size() && parallel; ++k) {
+                    parallel = a[k].first == b[k].first &&
+                               std::abs(b[k].second - lambda * a[k].second) <= tolerance * std::max(1.0, std::abs(b[k].second));
+                }
+                if (!parallel) continue;
+                
+                double lower2 = lambda > 0 ? model.row_lower[r2] / lambda : model.row_upper[r2] / lambda;
+                double upper2 = lambda > 0 ? model.row_upper[r2] / lambda : model.row_lower[r2] / lambda;
+                double lower = std::max(model.row_lower[r1], lower2);
+                double upper = std::min(model.row_upper[r1], upper2);
+                if (lower > upper + 1e-6 * std::max(1.0, std::abs(upper))) {
+                    model.infeasible = true;
+                    return false;
+                }
+                bool finite = lower != -inf && upper != inf;
+                if (finite && std::abs(upper - lower) <= tolerance * std::max(1.0, std::abs(upper))) {
+                    upper = lower;
+                } else if (finite) {
+                    continue;  // The intersection would be a ranged row; keep both rows
+                }
+                model.row_lower[r1] = lower;
+                model.row_upper[r1] = upper;
+                model.row_active[r2] = false;
+                changed = true;
+            }
+        }
+    }
+    return changed;
+}
+
+inline void HeuristicPreprocessor::strengthenCoefficients(WorkingModel& model) {
+    const double inf = std::numeric_limits<double>::infinity();
+    for (size_t i = 0; i < model.rows.size(); ++i) {
+        if (!model.row_active[i]) continue;
+        bool has_upper = model.row_upper[i] != inf;
+        bool has_lower = model.row_lower[i] != -inf;
+        if (has_upper == has_lower) continue;  // Only one-sided rows
+        
+        // Work on the <= form: sign * a^T x <= rhs
+        double sign = has_upper ? 1.0 : -1.0;
+        double rhs = has_upper ? model.row_upper[i] : -model.row_lower[i];
+        auto& row = model.rows[i];
+        
+        double max_activity = 0.0;
+        bool finite = true;
+        for (const auto& entry : row) {
+            double a = sign * entry.second;
+            double term = a > 0 ? a * model.upper[entry.first] : a * model.lower[entry.first];
+            if (std::isinf(term)) { finite = false; break; }
+            max_activity += term;
+        }
+        if (!finite) continue;
+        
+        for (auto& entry : row) {
+            int j = entry.first;
+            if (!model.is_integer[j] || model.lower[j] != 0.0 || model.upper[j] != 1.0) continue;
+            double a = sign * entry.second;
+            if (a > 0) {
+                // With x_j = 0 the row can never be tight: shift the slack into the coefficient
+                double d = rhs - (max_activity - a);
+                if (d <= 1e-6 * std::max(1.0, std::abs(rhs))) continue;
+                a -= d;
+                rhs -= d;
+                max_activity -= d;
+            } else {
+                // With x_j = 1 the row can never be tight
+                double d = rhs - (max_activity + a);
+                if (d <= 1e-6 * std::max(1.0, std::abs(rhs))) continue;
+                a += d;
+            }
+            entry.second = sign * a;
+            coefficients_strengthened_++;
+        }
+        
+        if (has_upper) {
+            model.row_upper[i] = rhs;
+        } else {
+            model.row_lower[i] = -rhs;
+        }
+        row.erase(std::remove_if(row.begin(), row.end(),
+                                 [](const std::pair<int, double>& e) { return std::abs(e.second) < 1e-12; }),
+                  row.end());
+    }
+}
+
+// ---------------------------------------------------------------------------
+// DynamicCuttingPlanes
+// ---------------------------------------------------------------------------
+
+inline DynamicCuttingPlanes::DynamicCuttingPlanes(double min_efficacy, double min_violation, int max_cuts)
+    : min_efficacy_(min_efficacy), min_violation_(min_violation), max_cuts_per_round_(max_cuts) {}
+
+inline std::vector<DynamicCuttingPlanes::Cut> DynamicCuttingPlanes::generateCuts(
+        const Problem& problem, const std::vector<double>& lp_solution,
+        const std::vector<TableauRow>& tableau_rows) {
+    std::vector<Cut> cuts = generateGomoryCuts(problem, lp_solution, tableau_rows);
+    std::vector<Cut> covers = generateKnapsackCoverCuts(problem, lp_solution);
+    cuts.insert(cuts.end(), std::make_move_iterator(covers.begin()), std::make_move_iterator(covers.end()));
+    
+    cuts.erase(std::remove_if(cuts.begin(), cuts.end(), [this](const Cut& cut) {
+                   return cut.violation < min_violation_ || cut.efficacy < min_efficacy_;
+               }),
+               cuts.end());
+    std::stable_sort(cuts.begin(), cuts.end(), [](const Cut& a, const Cut& b) { return a.efficacy > b.efficacy; });
+    if (static_cast<int>(cuts.size()) > max_cuts_per_round_) {
+        cuts.resize(max_cuts_per_round_);
+    }
+    return cuts;
+}
+
+inline double DynamicCuttingPlanes::calculateViolation(const Cut& cut, const std::vector<double>& lp_solution) const {
+    double activity = 0.0;
+    for (size_t k = 0; k < cut.indices.size(); ++k) {
+        activity += cut.coefficients[k] * lp_solution[cut.indices[k]];
+    }
+    return activity - cut.rhs;
+}
+
+inline double DynamicCuttingPlanes::calculateEfficacy(const Cut& cut, const std::vector<double>& lp_solution) const {
+    double norm = 0.0;
+    for (double a : cut.coefficients) norm += a * a;
+    if (norm <= 0.0) return 0.0;
+    return calculateViolation(cut, lp_solution) / std::sqrt(norm);
+}
+
+inline bool DynamicCuttingPlanes::finishCut(const Problem& problem, std::vector<double>& dense,
+                                            const std::vector<int>& support, double rhs, CutType type,
+                                            const std::vector<double>& lp_solution, Cut& cut) const {
+    std::vector<int> columns(support);
+    std::sort(columns.begin(), columns.end());
+    columns.erase(std::unique(columns.begin(), columns.end()), columns.end());
+    
+    double max_abs = 0.0;
+    for (int j : columns) max_abs = std::max(max_abs, std::abs(dense[j]));
+    
+    // Tiny coefficients are dropped by moving their worst case onto the right-hand side
+    bool usable = max_abs > 1e-9;
+    double min_abs = std::numeric_limits<double>::infinity();
+    cut.indices.clear();
+    cut.coefficients.clear();
+    for (int j : columns) {
+        double a = dense[j];
+        dense[j] = 0.0;
+        if (!usable || a == 0.0) continue;
+        if (std::abs(a) < 1e-9 * max_abs) {
+            ConstVariable var = problem.getVariable(j);
+            double bound = (a > 0.0) ? var.getLowerBound() : var.getUpperBound();
+            if (std::abs(bound) >= 1e20 || std::isinf(bound)) {
+                usable = false;
+            } else {
+                rhs -= a * bound;
+            }
+            continue;
+        }
+        cut.indices.push_back(j);
+        cut.coefficients.push_back(a);
+        min_abs = std::min(min_abs, std::abs(a));
+    }
+    if (!usable || cut.indices.empty() || max_abs / min_abs > 1e6) return false;
+    // Dense cuts make every later factorization of the LP basis more expensive
+    if (static_cast<int>(cut.indices.size()) > 10 + problem.getNumVariables() / 4) return false;
+    
+    // Normalize to max |a| = 1 and leave a small safety margin for round-off in the derivation
+    for (double& a : cut.coefficients) a /= max_abs;
+    rhs /= max_abs;
+    rhs += 1e-9 * std::max(1.0, std::abs(rhs));
+    
+    cut.rhs = rhs;
+    cut.type = type;
+    cut.violation = calculateViolation(cut, lp_solution);
+    cut.efficacy = calculateEfficacy(cut, lp_solution);
+    return true;
+}
+
+inline std::vector<DynamicCuttingPlanes::Cut> DynamicCuttingPlanes::generateGomoryCuts(
+        const Problem& problem, const std::vector<double>& lp_solution,
+        const std::vector<TableauRow>& tableau_rows) {
+    const double min_fraction = 0.01;
+    const int n = problem.getNumVariables();
+    const SparseMatrix& matrix = problem.getMatrix();
+    std::vector<Cut> cuts;
+    std::vector<double> dense(n, 0.0);
+    std::vector<bool> touched(n, false);
+    std::vector<int> support;
+    
+    auto add = [&](int j, double value) {
+        if (!touched[j]) {
+            touched[j] = true;
+            support.push_back(j);
+        }
+        dense[j] += value;
+    };
+    
+    for (const TableauRow& row : tableau_rows) {
+        double f0 = row.value - std::floor(row.value);
+        if (f0 < min_fraction || f0 > 1.0 - min_fraction) continue;
+        
+        // With y_k >= 0 the distance of nonbasic k from its bound, x_B + sum a_k y_k = x_B*;
+        // the GMI cut sum pi_k y_k >= 1 is accumulated directly in x-space as sum c_j x_j >= rhs
+        double rhs = 1.0;
+        bool usable = true;
+        support.clear();
+        for (size_t k = 0; k < row.indices.size(); ++k) {
+            int j = row.indices[k];
+            bool upper = row.at_upper[k];
+            double lb, ub;
+            bool integer = false;
+            if (j < n) {
+                ConstVariable var = problem.getVariable(j);
+                lb = var.getLowerBound();
+                ub = var.getUpperBound();
+                integer = var.getType() != VariableType::CONTINUOUS;
+            } else {
+                ConstConstraint constraint = problem.getConstraint(j - n);
+                lb = constraint.getLowerLimit();
+                ub = constraint.getUpperLimit();
+            }
+            if (lb == ub) continue;  // y_k is identically zero
+            double bound = upper ? ub : lb;
+            if (std::isinf(bound) || std::abs(bound) >= 1e20) {
+                usable = false;
+                break;
+            }
+            integer = integer && bound == std::floor(bound);
+            
+            double a = upper ? -row.alpha[k] : row.alpha[k];
+            double pi;
+            if (integer) {
+                double f = a - std::floor(a);
+                pi = (f <= f0) ? f / f0 : (1.0 - f) / (1.0 - f0);
+            } else {
+                pi = (a >= 0.0) ? a / f0 : -a / (1.0 - f0);
+            }
+            if (pi <= 1e-12) continue;
+            
+            // y = x - lb at the lower bound, ub - x at the upper bound
+            double c = upper ? -pi : pi;
+            rhs += c * bound;
+            if (j < n) {
+                add(j, c);
+            } else {
+                SparseMatrix::VectorView logical = matrix.row(j - n);
+                for (int t = 0; t < logical.size; ++t) {
+                    add(logical.indices[t], c * logical.values[t]);
+                }
+            }
+        }
+        
+        for (int j : support) {
+            touched[j] = false;
+            dense[j] = -dense[j];  // sum c x >= rhs  ->  sum -c x <= -rhs
+        }
+        if (!usable) {
+            for (int j : support) dense[j] = 0.0;
+            continue;
+        }
+        Cut cut;
+        if (finishCut(problem, dense, support, -rhs, CutType::GOMORY, lp_solution, cut)) {
+            cuts.push_back(std::move(cut));
+        }
+    }
+    return cuts;
+}
+
+inline std::vector<DynamicCuttingPlanes::Cut> DynamicCuttingPlanes::generateKnapsackCoverCuts(
+        const Problem& problem, const std::vector<double>& lp_solution) {
+    struct Item {
+        int var;
+        double weight;
+        double value;       // LP value of the (possibly complemented) binary
+        bool complemented;  // item stands for 1 - x
+    };
+    
+    const int n = problem.getNumVariables();
+    const SparseMatrix& matrix = problem.getMatrix();
+    std::vector<Cut> cuts;
+    std::vector<double> dense(n, 0.0);
+    std::vector<int> support;
+    std::vector<Item> items;
+    std::vector<bool> in_cover;
+    
+    for (int i = 0; i < problem.getNumConstraints(); ++i) {
+        ConstConstraint constraint = problem.getConstraint(i);
+        SparseMatrix::VectorView row = matrix.row(i);
+        for (int side = 0; side < 2; ++side) {
+            // side 0: a^T x <= upper, side 1: -a^T x <= -lower
+            double sign = (side == 0) ? 1.0 : -1.0;
+            double capacity = (side == 0) ? constraint.getUpperLimit() : -constraint.getLowerLimit();
+            if (std::isinf(capacity) || std::abs(capacity) >= 1e20) continue;
+            
+            // Relax to a knapsack over binaries: other variables sit at their most favourable bound
+            items.clear();
+            bool usable = true;
+            for (int k = 0; k < row.size && usable; ++k) {
+                int j = row.indices[k];
+                double a = sign * row.values[k];
+                ConstVariable var = problem.getVariable(j);
+                double lb = var.getLowerBound();
+                double ub = var.getUpperBound();
+                if (var.getType() != VariableType::CONTINUOUS && lb == 0.0 && ub == 1.0) {
+                    if (a > 0.0) {
+                        items.push_back({j, a, lp_solution[j], false});
+                    } else {
+                        items.push_back({j, -a, 1.0 - lp_solution[j], true});
+                        capacity -= a;
+                    }
+                } else {
+                    double bound = (a > 0.0) ? lb : ub;
+                    if (std::isinf(bound) || std::abs(bound) >= 1e20) {
+                        usable = false;
+                    } else {
+                        capacity -= a * bound;
+                    }
+                }
+            }
+            if (!usable || items.size() < 2 || capacity < 0.0) continue;
+            
+            double total = 0.0;
+            for (const Item& item : items) total += item.weight;
+            double threshold = capacity + 1e-9 * std::max(1.0, std::abs(capacity));
+            if (total <= threshold) continue;
+            
+            // Greedy cover: items whose LP value is close to 1 cost the least slack
+            std::stable_sort(items.begin(), items.end(), [](const Item& a, const Item& b) {
+                if (a.value != b.value) return a.value > b.value;
+                return a.weight > b.weight;
+            });
+            in_cover.assign(items.size(), false);
+            double weight = 0.0;
+            for (size_t k = 0; k < items.size() && weight <= threshold; ++k) {
+                in_cover[k] = true;
+                weight += items[k].weight;
+            }
+            
+            // Make the cover minimal, dropping the items with the smallest LP value first
+            for (size_t k = items.size(); k-- > 0;) {
+                if (in_cover[k] && weight - items[k].weight > threshold) {
+                    in_cover[k] = false;
+                    weight -= items[k].weight;
+                }
+            }
+            
+            int cover_size = 0;
+            double lhs = 0.0;
+            double max_weight = 0.0;
+            for (size_t k = 0; k < items.size(); ++k) {
+                if (!in_cover[k]) continue;
+                cover_size++;
+                lhs += items[k].value;
+                max_weight = std::max(max_weight, items[k].weight);
+            }
+            if (lhs <= cover_size - 1 + min_violation_) continue;
+            
+            // Extended cover: any item at least as heavy as the heaviest cover item joins with coefficient 1
+            double rhs = cover_size - 1;
+            support.clear();
+            for (size_t k = 0; k < items.size(); ++k) {
+                if (!in_cover[k] && items[k].weight < max_weight) continue;
+                const Item& item = items[k];
+                if (item.complemented) {
+                    dense[item.var] -= 1.0;
+                    rhs -= 1.0;
+                } else {
+                    dense[item.var] += 1.0;
+                }
+                support.push_back(item.var);
+            }
+            Cut cut;
+            if (finishCut(problem, dense, support, rhs, CutType::KNAPSACK_COVER, lp_solution, cut)) {
+                cuts.push_back(std::move(cut));
+            }
+        }
+    }
+    return cuts;
+}
+
+// ---------------------------------------------------------------------------
+// CutPool
+// ---------------------------------------------------------------------------
+
+inline void CutPool::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.clear();
+    active_.clear();
+    hashes_.clear();
+    num_active_.store(0, std::memory_order_release);
+}
+
+inline size_t CutPool::hashCut(const Cut& cut) {
+    // Rounded coefficients so that cuts equal up to round-off collide
+    size_t h = cut.indices.size();
+    auto mix = [&h](size_t v) { h ^= v + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2); };
+    for (size_t k = 0; k < cut.indices.size(); ++k) {
+        mix(std::hash<int>()(cut.indices[k]));
+        mix(std::hash<long long>()(std::llround(cut.coefficients[k] * 1e6)));
+    }
+    mix(std::hash<long long>()(std::llround(cut.rhs * 1e6)));
+    return h;
+}
+
+inline double CutPool::parallelism(const Cut& a, double norm_a, const Cut& b, double norm_b) {
+    double dot = 0.0;
+    size_t p = 0, q = 0;
+    while (p < a.indices.size() && q < b.indices.size()) {
+        if (a.indices[p] < b.indices[q]) {
+            ++p;
+        } else if (a.indices[p] > b.indices[q]) {
+            ++q;
+        } else {
+            dot += a.coefficients[p++] * b.coefficients[q++];
+        }
+    }
+    return std::abs(dot) / (norm_a * norm_b);
+}
+
+inline bool CutPool::add(const Cut& cut) {
+    double norm = 0.0;
+    for (double a : cut.coefficients) norm += a * a;
+    if (norm <= 0.0) return false;
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!hashes_.insert(hashCut(cut)).second) return false;
+    entries_.push_back({cut, std::sqrt(norm), 0});
+    return true;
+}
+
+inline int CutPool::separate(const std::vector<double>& lp_solution, int max_cuts, double min_efficacy) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    std::vector<std::pair<double, size_t>>& violated = violated_;  // (efficacy, entry)
+    violated.clear();
+    for (size_t e = 0; e < entries_.size(); ++e) {
+        Entry& entry = entries_[e];
+        double activity = 0.0;
+        for (size_t k = 0; k < entry.cut.indices.size(); ++k) {
+            activity += entry.cut.coefficients[k] * lp_solution[entry.cut.indices[k]];
+        }
+        double efficacy = (activity - entry.cut.rhs) / entry.norm;
+        if (efficacy > 0.0 && efficacy >= min_efficacy) {
+            violated.push_back({efficacy, e});
+            entry.age = 0;
+        } else {
+            entry.age++;
+        }
+    }
+    // Ties keep pool order; std::sort needs no temporary buffer, unlike std::stable_sort
+    std::sort(violated.begin(), violated.end(),
+              [](const std::pair<double, size_t>& a, const std::pair<double, size_t>& b) {
+                  return a.first > b.first || (a.first == b.first && a.second < b.second);
+              });
+    
+    // Greedy selection by efficacy, skipping cuts nearly parallel to one already chosen
+    std::vector<size_t>& chosen = chosen_;
+    chosen.clear();
+    for (const auto& candidate : violated) {
+        if (static_cast<int>(chosen.size()) >= max_cuts) break;
+        const Entry& entry = entries_[candidate.second];
+        bool parallel = false;
+        for (size_t c : chosen) {
+            if (parallelism(entry.cut, entry.norm, entries_[c].cut, entries_[c].norm) > max_parallelism_) {
+                parallel = true;
+                break;
+            }
+        }
+        if (!parallel) chosen.push_back(candidate.second);
+    }
+    
+    std::vector<bool>& remove = remove_;
+    remove.assign(entries_.size(), false);
+    for (size_t c : chosen) {
+        active_.push_back(entries_[c].cut);
+        remove[c] = true;
+    }
+    for (size_t e = 0; e < entries_.size(); ++e) {
+        if (!remove[e] && entries_[e].age > max_age_) {
+            hashes_.erase(hashCut(entries_[e].cut));
+            remove[e] = true;
+        }
+    }
+    size_t kept = 0;
+    for (size_t e = 0; e < entries_.size(); ++e) {
+        if (remove[e]) continue;
+        if (kept != e) entries_[kept] = std::move(entries_[e]);
+        kept++;
+    }
+    entries_.resize(kept);
+    
+    num_active_.store(static_cast<int>(active_.size()), std::memory_order_release);
+    return static_cast<int>(chosen.size());
+}
+
+inline std::vector<CutPool::Cut> CutPool::getActive(int from) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (from >= static_cast<int>(active_.size())) return {};
+    return std::vector<Cut>(active_.begin() + from, active_.end());
+}
+
+inline void CutPool::retainActive(const std::vector<bool>& keep) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<Cut> retained;
+    for (size_t k = 0; k < active_.size(); ++k) {
+        if (k < keep.size() && keep[k]) {
+            retained.push_back(std::move(active_[k]));
+            continue;
+        }
+        double norm = 0.0;
+        for (double a : active_[k].coefficients) norm += a * a;
+        entries_.push_back({std::move(active_[k]), std::sqrt(norm), 0});
+    }
+    active_.swap(retained);
+    num_active_.store(static_cast<int>(active_.size()), std::memory_order_release);
+}
+
+inline size_t CutPool::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size() + active_.size();
+}
+
 } // namespace MIPSolver
 
 #endif // SOTA_ALGORITHMS_H
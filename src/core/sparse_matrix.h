@@ -0,0 +1,301 @@
+#ifndef MIP_SOLVER_SPARSE_MATRIX_H
+#define MIP_SOLVER_SPARSE_MATRIX_H
+
+/*
+ * 稀疏约束矩阵
+ *
+ * Problem 的约束系数矩阵采用连续内存的压缩存储：
+ *
+ * 1. 行存储 (CSR)：
+ *    - row_start_[i] .. row_start_[i+1] 给出第 i 行在 col_index_/values_ 中的区间
+ *    - 行内按列索引升序排列，无重复、无显式零
+ *    - 约束检查、行活动度计算等按行扫描的操作直接顺序访问
+ *
+ * 2. 列存储 (CSC)：
+ *    - 首次按列访问时由 CSR 转置生成，之后缓存
+ *    - 供单纯形法的基矩阵列、边界传播等需要列视图的算法使用
+ *
+ * 3. 构建器 (SparseMatrixBuilder)：
+ *    - addConstraintCoefficient 等增量接口只追加三元组 (row, col, value)
+ *    - finalize 时一次性排序合并为 CSR，同一位置重复写入以最后一次为准
+ *
+ * 注意：列视图在 const 对象上惰性生成。多线程共享同一个矩阵前，
+ *       应先在单线程中调用 buildColumnView()。
+ */
+
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+#include <utility>
+
+namespace MIPSolver {
+
+class SparseMatrix {
+    public:
+        // 一行（或一列）非零元素的只读视图，指向矩阵内部的连续存储
+        struct VectorView {
+            const int* indices;
+            const double* values;
+            int size;
+
+            double dot(const std::vector<double>& x) const {
+                double sum = 0.0;
+                for (int k = 0; k < size; ++k) {
+                    sum += values[k] * x[indices[k]];
+                }
+                return sum;
+            }
+        };
+
+        SparseMatrix() : num_rows_(0), num_cols_(0), row_start_(1, 0), columns_valid_(false) {}
+
+        /*
+         * 直接由CSR数组构造
+         *
+         * 调用者保证数组满足CSR的约定（行内列索引严格升序、无显式零），这里不做排序；
+         * 用于从已经规范化的外部数据（例如二进制快照）整块载入
+         */
+        static SparseMatrix fromCSR(int num_rows, int num_cols, std::vector<int> row_start,
+                                    std::vector<int> col_index, std::vector<double> values) {
+            SparseMatrix matrix;
+            matrix.num_rows_ = num_rows;
+            matrix.num_cols_ = num_cols;
+            matrix.row_start_ = std::move(row_start);
+            matrix.col_index_ = std::move(col_index);
+            matrix.values_ = std::move(values);
+            return matrix;
+        }
+
+        /*
+         * 在矩阵末尾追加若干行（CSR输入）
+         *
+         * @param num_cols: 追加后的列数（不小于当前列数）
+         * @param count: 追加的行数
+         * @param row_start/col_index/values: 第 r 个新行的元素为 [row_start[r], row_start[r+1]) 区间，
+         *        与 scipy.sparse.csr_matrix 的 indptr/indices/data 相同；调用者保证下标有效
+         *
+         * 已经规范化的行（列索引严格升序、无零元素）直接整段拷贝；
+         * 其余的行在行内排序，与构建器相同：同一列重复写入以最后一次为准，零元素被去除
+         */
+        void appendRows(int num_cols, int count, const int* row_start, const int* col_index, const double* values) {
+            size_t added = static_cast<size_t>(row_start[count] - row_start[0]);
+            row_start_.reserve(row_start_.size() + count);
+            col_index_.reserve(col_index_.size() + added);
+            values_.reserve(values_.size() + added);
+
+            std::vector<std::pair<int, double>> scratch;
+            for (int r = 0; r < count; ++r) {
+                int begin = row_start[r];
+                int end = row_start[r + 1];
+                bool canonical = true;
+                for (int k = begin; k < end && canonical; ++k) {
+                    canonical = values[k] != 0.0 && (k == begin || col_index[k - 1] < col_index[k]);
+                }
+
+                if (canonical) {
+                    col_index_.insert(col_index_.end(), col_index + begin, col_index + end);
+                    values_.insert(values_.end(), values + begin, values + end);
+                } else {
+                    scratch.clear();
+                    for (int k = begin; k < end; ++k) {
+                        scratch.emplace_back(col_index[k], values[k]);
+                    }
+                    std::stable_sort(scratch.begin(), scratch.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+                    for (auto it = scratch.begin(); it != scratch.end(); ++it) {
+                        if (it + 1 != scratch.end() && (it + 1)->first == it->first) continue;
+                        if (it->second != 0.0) {
+                            col_index_.push_back(it->first);
+                            values_.push_back(it->second);
+                        }
+                    }
+                }
+                row_start_.push_back(static_cast<int>(col_index_.size()));
+            }
+
+            num_rows_ += count;
+            num_cols_ = num_cols;
+            columns_valid_ = false;
+        }
+
+        /*
+         * 删除若干行，其余行按原顺序前移
+         *
+         * @param remove: 长度为行数，remove[r]为true的行被删除
+         */
+        void removeRows(const std::vector<bool>& remove) {
+            int kept = 0;
+            int write = 0;
+            for (int r = 0; r < num_rows_; ++r) {
+                if (remove[r]) continue;
+                for (int k = row_start_[r]; k < row_start_[r + 1]; ++k, ++write) {
+                    col_index_[write] = col_index_[k];
+                    values_[write] = values_[k];
+                }
+                row_start_[++kept] = write;
+            }
+            row_start_.resize(kept + 1);
+            col_index_.resize(write);
+            values_.resize(write);
+            num_rows_ = kept;
+            columns_valid_ = false;
+        }
+
+        int getNumRows() const { return num_rows_; }
+        int getNumCols() const { return num_cols_; }
+        size_t getNumNonzeros() const { return values_.size(); }
+
+        VectorView row(int r) const {
+            int begin = row_start_[r];
+            return {col_index_.data() + begin, values_.data() + begin, row_start_[r + 1] - begin};
+        }
+
+        VectorView column(int c) const {
+            buildColumnView();
+            int begin = col_start_[c];
+            return {row_index_.data() + begin, col_values_.data() + begin, col_start_[c + 1] - begin};
+        }
+
+        // Raw CSR arrays
+        const std::vector<int>& getRowStarts() const { return row_start_; }
+        const std::vector<int>& getColumnIndices() const { return col_index_; }
+        const std::vector<double>& getValues() const { return values_; }
+
+        // Coefficient lookup by binary search within the row; 0 if absent
+        double getCoefficient(int r, int c) const {
+            auto first = col_index_.begin() + row_start_[r];
+            auto last = col_index_.begin() + row_start_[r + 1];
+            auto it = std::lower_bound(first, last, c);
+            if (it == last || *it != c) return 0.0;
+            return values_[it - col_index_.begin()];
+        }
+
+        // Build (or rebuild) the cached column-major copy
+        void buildColumnView() const {
+            if (columns_valid_) return;
+
+            col_start_.assign(num_cols_ + 1, 0);
+            for (int c : col_index_) {
+                col_start_[c + 1]++;
+            }
+            for (int c = 0; c < num_cols_; ++c) {
+                col_start_[c + 1] += col_start_[c];
+            }
+
+            row_index_.resize(values_.size());
+            col_values_.resize(values_.size());
+            std::vector<int> next(col_start_.begin(), col_start_.end() - 1);
+            // Rows are visited in order, so each column comes out sorted by row
+            for (int r = 0; r < num_rows_; ++r) {
+                for (int k = row_start_[r]; k < row_start_[r + 1]; ++k) {
+                    int pos = next[col_index_[k]]++;
+                    row_index_[pos] = r;
+                    col_values_[pos] = values_[k];
+                }
+            }
+            columns_valid_ = true;
+        }
+
+    private:
+        friend class SparseMatrixBuilder;
+
+        int num_rows_;
+        int num_cols_;
+        std::vector<int> row_start_;     // size num_rows_ + 1
+        std::vector<int> col_index_;     // size nnz
+        std::vector<double> values_;     // size nnz
+
+        // Column-major copy, built on demand
+        mutable bool columns_valid_;
+        mutable std::vector<int> col_start_;
+        mutable std::vector<int> row_index_;
+        mutable std::vector<double> col_values_;
+};
+
+// Collects (row, col, value) triplets and finalizes them into a SparseMatrix
+class SparseMatrixBuilder {
+    public:
+        struct Triplet {
+            int row;
+            int col;
+            double value;
+        };
+
+        void reserve(size_t num_entries) { triplets_.reserve(num_entries); }
+        void add(int row, int col, double value) { triplets_.push_back({row, col, value}); }
+        void append(const std::vector<Triplet>& entries) { triplets_.insert(triplets_.end(), entries.begin(), entries.end()); }
+        bool empty() const { return triplets_.empty(); }
+        size_t size() const { return triplets_.size(); }
+        void clear() { triplets_.clear(); }
+
+        /*
+         * 生成 CSR 矩阵
+         *
+         * @param num_rows/num_cols: 结果矩阵的维度
+         * @param base: 已有矩阵（可为空），其元素先于待处理三元组参与合并，
+         *              因此同一位置的新写入会覆盖旧值
+         * @return: 排序、去重并去除零元素后的矩阵
+         */
+        SparseMatrix build(int num_rows, int num_cols, const SparseMatrix* base = nullptr) const {
+            SparseMatrix matrix;
+            matrix.num_rows_ = num_rows;
+            matrix.num_cols_ = num_cols;
+
+            // Count entries per row (base entries first, then pending triplets)
+            std::vector<int> count(num_rows + 1, 0);
+            if (base) {
+                for (int r = 0; r < base->num_rows_ && r < num_rows; ++r) {
+                    count[r + 1] += base->row_start_[r + 1] - base->row_start_[r];
+                }
+            }
+            for (const auto& t : triplets_) {
+                if (t.row >= 0 && t.row < num_rows && t.col >= 0 && t.col < num_cols) {
+                    count[t.row + 1]++;
+                }
+            }
+            for (int r = 0; r < num_rows; ++r) {
+                count[r + 1] += count[r];
+            }
+
+            // Bucket by row, keeping arrival order within each row
+            std::vector<std::pair<int, double>> entries(count[num_rows]);
+            std::vector<int> next(count.begin(), count.end() - 1);
+            if (base) {
+                for (int r = 0; r < base->num_rows_ && r < num_rows; ++r) {
+                    for (int k = base->row_start_[r]; k < base->row_start_[r + 1]; ++k) {
+                        entries[next[r]++] = {base->col_index_[k], base->values_[k]};
+                    }
+                }
+            }
+            for (const auto& t : triplets_) {
+                if (t.row >= 0 && t.row < num_rows && t.col >= 0 && t.col < num_cols) {
+                    entries[next[t.row]++] = {t.col, t.value};
+                }
+            }
+
+            // Sort each row by column; for duplicates the last write wins
+            matrix.row_start_.assign(num_rows + 1, 0);
+            matrix.col_index_.reserve(entries.size());
+            matrix.values_.reserve(entries.size());
+            for (int r = 0; r < num_rows; ++r) {
+                auto first = entries.begin() + count[r];
+                auto last = entries.begin() + count[r + 1];
+                std::stable_sort(first, last, [](const auto& a, const auto& b) { return a.first < b.first; });
+                for (auto it = first; it != last; ++it) {
+                    if (it + 1 != last && (it + 1)->first == it->first) continue;
+                    if (it->second != 0.0) {
+                        matrix.col_index_.push_back(it->first);
+                        matrix.values_.push_back(it->second);
+                    }
+                }
+                matrix.row_start_[r + 1] = static_cast<int>(matrix.col_index_.size());
+            }
+            return matrix;
+        }
+
+    private:
+        std::vector<Triplet> triplets_;
+};
+
+} // namespace MIPSolver
+
+#endif
@@ -0,0 +1,406 @@
+#ifndef BASIS_FACTORIZATION_H
+#define BASIS_FACTORIZATION_H
+
+/*
+ * 基矩阵稀疏LU分解
+ *
+ * 修正单纯形法每次迭代都需要求解 B x = a（FTRAN）和 B^T y = c（BTRAN），
+ * 这里用稀疏LU分解表示 B^{-1}，主要内容：
+ *
+ * 1. 分解：
+ *    - 右视（right-looking）高斯消元，按行存储活动子矩阵
+ *    - 优先选取列单元素（松弛列）和行单元素，不产生填充
+ *    - 其余部分使用带阈值的Markowitz准则选主元，兼顾稀疏性与数值稳定性
+ *    - 检测到奇异时返回未覆盖的基位置和行，由调用者用松弛列替换
+ *
+ * 2. 更新：
+ *    - 换基后以乘积形式（product form）追加一个eta向量，不重新分解
+ *    - eta数量达到上限后由调用者重新分解
+ *
+ * 索引约定：FTRAN的输入按行编号、输出按基位置编号；BTRAN相反。
+ *
+ * 分解的工作区和eta向量在多次分解之间保留容量，维数不变时重复分解不再访问堆。
+ */
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+namespace MIPSolver {
+
+class BasisFactorization {
+public:
+    BasisFactorization() : m_(0) {}
+
+    /*
+     * 分解基矩阵
+     *
+     * @param m: 基矩阵维数
+     * @param col_start/row_index/values: 按基位置排列的列压缩存储（m+1个起点）
+     * @return: 奇异位置数，0表示分解成功；奇异时可通过
+     *          getSingularPositions()/getSingularRows()取得需要替换的位置和对应行
+     */
+    int factorize(int m, const std::vector<int>& col_start,
+                  const std::vector<int>& row_index, const std::vector<double>& values) {
+        m_ = m;
+        clearFactors();
+        singular_positions_.clear();
+        singular_rows_.clear();
+
+        // Active submatrix: row-wise entries plus a (possibly stale) column pattern
+        resetLists(active_rows_, m);
+        resetLists(col_pattern_, m);
+        col_count_.assign(m, 0);
+        row_done_.assign(m, false);
+        col_done_.assign(m, false);
+        for (int j = 0; j < m; ++j) {
+            for (int k = col_start[j]; k < col_start[j + 1]; ++k) {
+                if (values[k] == 0.0) continue;
+                active_rows_[row_index[k]].push_back({j, values[k]});
+                col_pattern_[j].push_back(row_index[k]);
+                col_count_[j]++;
+            }
+        }
+
+        std::vector<int>& col_singletons = col_singletons_;
+        std::vector<int>& row_singletons = row_singletons_;
+        col_singletons.clear();
+        row_singletons.clear();
+        for (int j = 0; j < m; ++j) {
+            if (col_count_[j] == 1) col_singletons.push_back(j);
+        }
+        for (int i = 0; i < m; ++i) {
+            if (active_rows_[i].size() == 1) row_singletons.push_back(i);
+        }
+
+        marker_.assign(m, -1);
+        for (int step = 0; step < m; ++step) {
+            int pivot_row = -1;
+            int pivot_col = -1;
+
+            // 1. Column singleton: no elimination needed
+            while (!col_singletons.empty() && pivot_row < 0) {
+                int j = col_singletons.back();
+                col_singletons.pop_back();
+                if (col_done_[j] || col_count_[j] != 1) continue;
+                for (int i : col_pattern_[j]) {
+                    if (!row_done_[i] && std::abs(entryValue(i, j)) > kPivotZero) {
+                        pivot_row = i;
+                        pivot_col = j;
+                        break;
+                    }
+                }
+            }
+
+            // 2. Row singleton: eliminates only the pivot column entry of other rows
+            while (pivot_row < 0 && !row_singletons.empty()) {
+                int i = row_singletons.back();
+                row_singletons.pop_back();
+                if (row_done_[i] || active_rows_[i].size() != 1) continue;
+                if (std::abs(active_rows_[i][0].second) > kPivotZero) {
+                    pivot_row = i;
+                    pivot_col = active_rows_[i][0].first;
+                }
+            }
+
+            // 3. Markowitz search over the shortest columns
+            if (pivot_row < 0) {
+                selectMarkowitzPivot(pivot_row, pivot_col);
+            }
+
+            if (pivot_row < 0) {
+                // Remaining columns are (numerically) dependent
+                for (int j = 0; j < m; ++j) {
+                    if (!col_done_[j]) singular_positions_.push_back(j);
+                }
+                for (int i = 0; i < m; ++i) {
+                    if (!row_done_[i]) singular_rows_.push_back(i);
+                }
+                return static_cast<int>(singular_positions_.size());
+            }
+
+            eliminate(pivot_row, pivot_col, col_singletons, row_singletons);
+        }
+        return 0;
+    }
+
+    /*
+     * 前向求解 B x = rhs
+     * 输入按行编号，结果按基位置编号（原地覆盖rhs）
+     */
+    void ftran(std::vector<double>& rhs) const {
+        // Apply L etas in elimination order
+        for (size_t k = 0; k < l_start_.size() - 1; ++k) {
+            double pivot_value = rhs[l_pivot_row_[k]];
+            if (pivot_value == 0.0) continue;
+            for (int e = l_start_[k]; e < l_start_[k + 1]; ++e) {
+                rhs[l_index_[e]] -= l_value_[e] * pivot_value;
+            }
+        }
+
+        // Back substitution through U (row p_k solves for position q_k)
+        work_.assign(m_, 0.0);
+        for (int k = m_ - 1; k >= 0; --k) {
+            double value = rhs[u_pivot_row_[k]];
+            for (int e = u_start_[k]; e < u_start_[k + 1]; ++e) {
+                value -= u_value_[e] * work_[u_index_[e]];
+            }
+            work_[u_pivot_col_[k]] = value / u_diag_[k];
+        }
+        rhs.swap(work_);
+
+        // Product-form updates
+        for (size_t k = 0; k < num_etas_; ++k) {
+            const Eta& eta = etas_[k];
+            double pivot_value = rhs[eta.position];
+            if (pivot_value == 0.0) continue;
+            pivot_value /= eta.pivot;
+            rhs[eta.position] = pivot_value;
+            for (size_t e = 0; e < eta.index.size(); ++e) {
+                rhs[eta.index[e]] -= eta.value[e] * pivot_value;
+            }
+        }
+    }
+
+    /*
+     * 后向求解 B^T y = rhs
+     * 输入按基位置编号，结果按行编号（原地覆盖rhs）
+     */
+    void btran(std::vector<double>& rhs) const {
+        for (size_t k = num_etas_; k-- > 0;) {
+            const Eta& eta = etas_[k];
+            double value = rhs[eta.position];
+            for (size_t e = 0; e < eta.index.size(); ++e) {
+                value -= eta.value[e] * rhs[eta.index[e]];
+            }
+            rhs[eta.position] = value / eta.pivot;
+        }
+
+        // Solve U^T z = rhs, producing row-indexed z
+        work_.assign(m_, 0.0);
+        for (int k = 0; k < m_; ++k) {
+            double value = rhs[u_pivot_col_[k]] / u_diag_[k];
+            work_[u_pivot_row_[k]] = value;
+            if (value == 0.0) continue;
+            for (int e = u_start_[k]; e < u_start_[k + 1]; ++e) {
+                rhs[u_index_[e]] -= u_value_[e] * value;
+            }
+        }
+
+        // Apply L^T etas in reverse order
+        for (int k = static_cast<int>(l_start_.size()) - 2; k >= 0; --k) {
+            double value = 0.0;
+            for (int e = l_start_[k]; e < l_start_[k + 1]; ++e) {
+                value += l_value_[e] * work_[l_index_[e]];
+            }
+            work_[l_pivot_row_[k]] -= value;
+        }
+        rhs.swap(work_);
+    }
+
+    /*
+     * 乘积形式更新：基位置position换入新列，alpha = B^{-1} a_q（按基位置编号）
+     */
+    void update(int position, const std::vector<double>& alpha) {
+        // Reuse the storage of an eta discarded by the last refactorization
+        if (num_etas_ == etas_.size()) etas_.emplace_back();
+        Eta& eta = etas_[num_etas_++];
+        eta.position = position;
+        eta.pivot = alpha[position];
+        eta.index.clear();
+        eta.value.clear();
+        for (int i = 0; i < m_; ++i) {
+            if (i != position && std::abs(alpha[i]) > kDropTolerance) {
+                eta.index.push_back(i);
+                eta.value.push_back(alpha[i]);
+            }
+        }
+        eta_nonzeros_ += eta.index.size();
+    }
+
+    int getNumUpdates() const { return static_cast<int>(num_etas_); }
+    size_t getEtaNonzeros() const { return eta_nonzeros_; }
+    size_t getFactorNonzeros() const { return l_index_.size() + u_index_.size() + u_diag_.size(); }
+    const std::vector<int>& getSingularPositions() const { return singular_positions_; }
+    const std::vector<int>& getSingularRows() const { return singular_rows_; }
+
+private:
+    static constexpr double kPivotZero = 1e-11;      // 视为零的主元
+    static constexpr double kPivotThreshold = 0.01;  // 阈值选主元的相对门限
+    static constexpr double kDropTolerance = 1e-14;  // 丢弃eta中的极小元素
+    static constexpr int kMarkowitzColumns = 4;      // Markowitz搜索的候选列数
+
+    struct Eta {
+        int position;
+        double pivot;
+        std::vector<int> index;
+        std::vector<double> value;
+    };
+
+    int m_;
+
+    // L factor: one eta column per elimination step
+    std::vector<int> l_pivot_row_;
+    std::vector<int> l_start_;
+    std::vector<int> l_index_;
+    std::vector<double> l_value_;
+
+    // U factor: pivot row k covers position u_pivot_col_[k] plus off-diagonal positions
+    std::vector<int> u_pivot_row_;
+    std::vector<int> u_pivot_col_;
+    std::vector<double> u_diag_;
+    std::vector<int> u_start_;
+    std::vector<int> u_index_;
+    std::vector<double> u_value_;
+
+    std::vector<Eta> etas_;   // the first num_etas_ are in use
+    size_t num_etas_ = 0;
+    size_t eta_nonzeros_ = 0;
+
+    // Factorization workspace
+    std::vector<std::vector<std::pair<int, double>>> active_rows_;
+    std::vector<std::vector<int>> col_pattern_;
+    std::vector<int> col_count_;
+    std::vector<bool> row_done_;
+    std::vector<bool> col_done_;
+    std::vector<int> marker_;
+    std::vector<int> candidate_cols_;
+    std::vector<int> col_singletons_;
+    std::vector<int> row_singletons_;
+    mutable std::vector<double> work_;
+
+    std::vector<int> singular_positions_;
+    std::vector<int> singular_rows_;
+
+    void clearFactors() {
+        l_pivot_row_.clear();
+        l_start_.assign(1, 0);
+        l_index_.clear();
+        l_value_.clear();
+        u_pivot_row_.clear();
+        u_pivot_col_.clear();
+        u_diag_.clear();
+        u_start_.assign(1, 0);
+        u_index_.clear();
+        u_value_.clear();
+        num_etas_ = 0;
+        eta_nonzeros_ = 0;
+    }
+
+    // Size to m empty lists, keeping the capacity of the inner vectors
+    template <typename List>
+    static void resetLists(std::vector<List>& lists, int m) {
+        if (static_cast<int>(lists.size()) > m) lists.resize(m);
+        for (List& list : lists) list.clear();
+        lists.resize(m);
+    }
+
+    double entryValue(int row, int col) const {
+        for (const auto& [j, v] : active_rows_[row]) {
+            if (j == col) return v;
+        }
+        return 0.0;
+    }
+
+    void selectMarkowitzPivot(int& pivot_row, int& pivot_col) {
+        // Collect the few active columns with the smallest counts
+        candidate_cols_.clear();
+        for (int j = 0; j < m_; ++j) {
+            if (col_done_[j] || col_count_[j] == 0) continue;
+            candidate_cols_.push_back(j);
+        }
+        if (candidate_cols_.empty()) return;
+        if (candidate_cols_.size() > static_cast<size_t>(kMarkowitzColumns)) {
+            std::nth_element(candidate_cols_.begin(), candidate_cols_.begin() + kMarkowitzColumns,
+                             candidate_cols_.end(),
+                             [this](int a, int b) { return col_count_[a] < col_count_[b]; });
+            candidate_cols_.resize(kMarkowitzColumns);
+        }
+
+        long best_cost = -1;
+        double best_value = 0.0;
+        for (int j : candidate_cols_) {
+            double col_max = 0.0;
+            for (int i : col_pattern_[j]) {
+                if (!row_done_[i]) col_max = std::max(col_max, std::abs(entryValue(i, j)));
+            }
+            if (col_max <= kPivotZero) continue;
+            for (int i : col_pattern_[j]) {
+                if (row_done_[i]) continue;
+                double v = std::abs(entryValue(i, j));
+                if (v < kPivotThreshold * col_max || v <= kPivotZero) continue;
+                long cost = static_cast<long>(active_rows_[i].size() - 1) * (col_count_[j] - 1);
+                if (best_cost < 0 || cost < best_cost || (cost == best_cost && v > best_value)) {
+                    best_cost = cost;
+                    best_value = v;
+                    pivot_row = i;
+                    pivot_col = j;
+                }
+            }
+        }
+    }
+
+    void eliminate(int p, int q, std::vector<int>& col_singletons, std::vector<int>& row_singletons) {
+        std::vector<std::pair<int, double>>& pivot_entries = active_rows_[p];
+        double pivot_value = 0.0;
+        for (const auto& [j, v] : pivot_entries) {
+            if (j == q) pivot_value = v;
+        }
+
+        row_done_[p] = true;
+        col_done_[q] = true;
+
+        // U row
+        u_pivot_row_.push_back(p);
+        u_pivot_col_.push_back(q);
+        u_diag_.push_back(pivot_value);
+        for (const auto& [j, v] : pivot_entries) {
+            if (j == q) continue;
+            u_index_.push_back(j);
+            u_value_.push_back(v);
+            if (--col_count_[j] == 1) col_singletons.push_back(j);
+        }
+        u_start_.push_back(static_cast<int>(u_index_.size()));
+
+        // L column: eliminate column q from the remaining active rows
+        l_pivot_row_.push_back(p);
+        for (int l : col_pattern_[q]) {
+            if (row_done_[l]) continue;
+            auto& row = active_rows_[l];
+            int pos = -1;
+            for (size_t e = 0; e < row.size(); ++e) {
+                if (row[e].first == q) { pos = static_cast<int>(e); break; }
+            }
+            if (pos < 0) continue;
+            double multiplier = row[pos].second / pivot_value;
+            row[pos] = row.back();
+            row.pop_back();
+            l_index_.push_back(l);
+            l_value_.push_back(multiplier);
+
+            if (pivot_entries.size() > 1) {
+                for (size_t e = 0; e < row.size(); ++e) marker_[row[e].first] = static_cast<int>(e);
+                for (const auto& [j, v] : pivot_entries) {
+                    if (j == q) continue;
+                    if (marker_[j] >= 0) {
+                        row[marker_[j]].second -= multiplier * v;
+                    } else {
+                        // Fill-in
+                        row.push_back({j, -multiplier * v});
+                        col_pattern_[j].push_back(l);
+                        col_count_[j]++;
+                    }
+                }
+                for (const auto& entry : row) marker_[entry.first] = -1;
+            }
+            if (row.size() == 1) row_singletons.push_back(l);
+        }
+        l_start_.push_back(static_cast<int>(l_index_.size()));
+
+        pivot_entries.clear();
+    }
+};
+
+} // namespace MIPSolver
+
+#endif
@@ -0,0 +1,202 @@
+#ifndef BATCH_SOLVER_H
+#define BATCH_SOLVER_H
+
+/*
+ * 批量求解线程池
+ *
+ * 大量相互独立的小模型（例如ran10x10规模）逐个求解时，每次新建求解器、在调用线程上串行运行，
+ * 无法用满机器。BatchSolver持有一组常驻工作线程：
+ *
+ * 1. 调度：
+ *    - solve接收一批问题，放入共享队列，由空闲的工作线程按提交顺序取走
+ *    - 多个线程可以同时调用solve，各批次的问题在同一个队列中交错执行
+ *    - 调用线程阻塞到本批次全部完成
+ *
+ * 2. 工作区：
+ *    - 每个工作线程独占一个BranchBoundSolver，在整个线程池的生命周期内反复使用
+ *    - 每次求解前先恢复默认设置，再调用configure按需设置（限制、线程数、回调等），
+ *      上一个问题的设置不会泄漏到下一个问题
+ *
+ * 3. 结果：
+ *    - completion在工作线程上、每个问题求解结束时调用（各问题之间可能并发），
+ *      求解抛出的异常以exception_ptr交给它
+ *    - 也可以直接取得按输入顺序排列的Solution
+ *
+ * 线程安全：
+ *    - 求解期间问题只被读取；同一个Problem可以在一批中出现多次，或被多个批次同时使用，
+ *      但在求解结束前不能修改它
+ *    - solve开始前在调用线程上合并每个问题待处理的系数并建立矩阵的列视图（各批次之间串行），
+ *      工作线程之间不会竞争这些惰性缓存
+ *    - configure和completion不能在工作线程上再调用同一个BatchSolver的solve（会等待自己而死锁）
+ *
+ * 每个求解仍可使用多个线程（setNumThreads）并运行ALNS线程；以吞吐量为目标时，
+ * 通常让每个问题单线程、工作线程数等于硬件线程数效果最好。
+ */
+
+#include "core.h"
+#include "solution.h"
+#include "branch_bound_solver.h"
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <exception>
+#include <algorithm>
+
+namespace MIPSolver {
+
+class BatchSolver {
+    public:
+        // Applied to the worker's solver (already reset to the defaults) before problem `index` is solved
+        using Configure = std::function<void(BranchBoundSolver& solver, size_t index)>;
+        // Receives either the solution or the exception thrown by the solve; runs on a worker thread
+        using Completion = std::function<void(size_t index, std::unique_ptr<Solution> solution, std::exception_ptr error)>;
+
+        /*
+         * @param num_workers: 工作线程数，0表示每个硬件线程一个
+         */
+        explicit BatchSolver(int num_workers = 0) {
+            if (num_workers <= 0) {
+                num_workers = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+            }
+            for (int w = 0; w < num_workers; ++w) {
+                solvers_.push_back(std::make_unique<BranchBoundSolver>());
+            }
+            for (int w = 0; w < num_workers; ++w) {
+                threads_.emplace_back([this, w] { workerLoop(*solvers_[w]); });
+            }
+        }
+
+        ~BatchSolver() {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                quit_ = true;
+            }
+            work_available_.notify_all();
+            for (auto& thread : threads_) {
+                thread.join();
+            }
+        }
+
+        BatchSolver(const BatchSolver&) = delete;
+        BatchSolver& operator=(const BatchSolver&) = delete;
+
+        int getNumWorkers() const { return static_cast<int>(threads_.size()); }
+
+        /*
+         * 求解一批问题，全部完成后返回
+         *
+         * @param problems: 待求解的问题（不能为nullptr），求解期间只读
+         * @param configure: 每个问题求解前的设置（可为空，即默认设置）
+         * @param completion: 每个问题结束时的回调（可为空）
+         */
+        void solve(const std::vector<const Problem*>& problems, const Configure& configure, const Completion& completion) {
+            if (problems.empty()) return;
+            {
+                // Serialized so that concurrent batches sharing a problem never build its caches twice at once
+                std::lock_guard<std::mutex> lock(prepare_mutex_);
+                for (const Problem* problem : problems) {
+                    problem->getMatrix().buildColumnView();
+                }
+            }
+
+            Batch batch;
+            batch.configure = &configure;
+            batch.completion = &completion;
+            batch.remaining = problems.size();
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                for (size_t i = 0; i < problems.size(); ++i) {
+                    queue_.push_back({problems[i], i, &batch});
+                }
+            }
+            work_available_.notify_all();
+
+            std::unique_lock<std::mutex> lock(batch.mutex);
+            batch.finished.wait(lock, [&] { return batch.remaining == 0; });
+        }
+
+        // Solutions in input order; rethrows the first exception (by input position) after the whole batch ran
+        std::vector<Solution> solve(const std::vector<const Problem*>& problems, const Configure& configure = Configure()) {
+            std::vector<std::unique_ptr<Solution>> solutions(problems.size());
+            std::vector<std::exception_ptr> errors(problems.size());
+            solve(problems, configure, [&](size_t index, std::unique_ptr<Solution> solution, std::exception_ptr error) {
+                solutions[index] = std::move(solution);
+                errors[index] = error;
+            });
+
+            std::vector<Solution> result;
+            result.reserve(problems.size());
+            for (size_t i = 0; i < problems.size(); ++i) {
+                if (errors[i]) std::rethrow_exception(errors[i]);
+                result.push_back(std::move(*solutions[i]));
+            }
+            return result;
+        }
+
+    private:
+        struct Batch {
+            const Configure* configure = nullptr;
+            const Completion* completion = nullptr;
+            size_t remaining = 0;
+            std::mutex mutex;
+            std::condition_variable finished;
+        };
+
+        struct Task {
+            const Problem* problem;
+            size_t index;
+            Batch* batch;
+        };
+
+        void workerLoop(BranchBoundSolver& solver) {
+            static const BranchBoundSolver defaults;
+            while (true) {
+                Task task;
+                {
+                    std::unique_lock<std::mutex> lock(mutex_);
+                    work_available_.wait(lock, [this] { return quit_ || !queue_.empty(); });
+                    if (quit_ && queue_.empty()) return;
+                    task = queue_.front();
+                    queue_.pop_front();
+                }
+
+                std::unique_ptr<Solution> solution;
+                std::exception_ptr error;
+                try {
+                    solver.copySettings(defaults);
+                    if (*task.batch->configure) (*task.batch->configure)(solver, task.index);
+                    solution = std::make_unique<Solution>(solver.solve(*task.problem));
+                } catch (...) {
+                    error = std::current_exception();
+                }
+                // Drop references held by the callbacks of this solve
+                solver.copySettings(defaults);
+                if (*task.batch->completion) {
+                    try {
+                        (*task.batch->completion)(task.index, std::move(solution), error);
+                    } catch (...) {
+                        // A throwing completion must not take the worker down or leave the batch waiting
+                    }
+                }
+
+                std::lock_guard<std::mutex> lock(task.batch->mutex);
+                if (--task.batch->remaining == 0) task.batch->finished.notify_all();
+            }
+        }
+
+        std::vector<std::unique_ptr<BranchBoundSolver>> solvers_;  // one per worker, reused across problems
+        std::vector<std::thread> threads_;
+        std::mutex prepare_mutex_;
+        std::mutex mutex_;
+        std::condition_variable work_available_;
+        std::deque<Task> queue_;
+        bool quit_ = false;
+};
+
+} // namespace MIPSolver
+
+#endif
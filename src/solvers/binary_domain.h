@@ -0,0 +1,320 @@
+#ifndef BINARY_DOMAIN_H
+#define BINARY_DOMAIN_H
+
+/*
+ * 纯0-1问题的域传播与变量类
+ *
+ * 每一列都是0-1变量时，变量的定义域只有三种状态（自由、固定为0、固定为1），
+ * 通用传播引擎中的无穷边界计数、除法与取整、连续变量的改进阈值都用不到：
+ *
+ * 1. 定义域：位集fixed_标记已固定的变量，固定值由同时维护的lower()/upper()给出（供节点LP使用）；
+ *    行扫描和候选遍历按位判断、按64位字跳过已固定的变量
+ * 2. 行活动度：只有有限部分。固定x_j为1时正系数加入min、负系数加入max，
+ *    固定为0时正系数移出max、负系数移出min
+ * 3. 传播：自由变量的系数|a_j|超过行的剩余松弛时(slack < |a_j|)，x_j只能取使该项不增加活动度的值，
+ *    与通用引擎对整数变量的取整规则给出相同的固定；已固定变量在行扫描中按位跳过
+ * 4. 回溯：trail只记录被固定的变量下标，undo清除位并从当前定义域重新计算受影响行的活动度
+ *
+ * 变量类（GeneralVariables / BinaryVariables）把分支定界中与变量类型有关的判断做成编译期的策略：
+ * 传播引擎的类型、整数性判断、分数度，以及按位跳过已固定变量的候选遍历。
+ * 节点处理函数以变量类为模板参数实例化两份，求解开始时按问题选择一次
+ */
+
+#include "core.h"
+#include "domain_propagation.h"
+#include <cstdint>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+namespace MIPSolver {
+
+class BinaryPropagator {
+public:
+    /*
+     * 每一列都是边界在[0,1]内的整数变量（BINARY或INTEGER）时返回true
+     */
+    static bool supports(const Problem& problem) {
+        if (problem.getNumVariables() == 0) return false;
+        const std::vector<VariableType>& types = problem.getVariableTypes();
+        const std::vector<double>& lower = problem.getLowerBounds();
+        const std::vector<double>& upper = problem.getUpperBounds();
+        for (int j = 0; j < problem.getNumVariables(); ++j) {
+            if (types[j] == VariableType::CONTINUOUS || lower[j] < 0.0 || upper[j] > 1.0) return false;
+        }
+        return true;
+    }
+
+    /*
+     * 载入问题（须满足supports）：边界为[0,0]或[1,1]的变量载入时即固定
+     */
+    void load(const Problem& problem) {
+        matrix_ = &problem.getMatrix();
+        matrix_->buildColumnView();
+        n_ = problem.getNumVariables();
+        int m = problem.getNumConstraints();
+
+        size_t words = (static_cast<size_t>(n_) + 63) / 64;
+        fixed_.assign(words, 0);
+        if (n_ % 64 != 0) fixed_.back() = ~uint64_t(0) << (n_ % 64);  // padding bits never come back as free
+        lower_.resize(n_);
+        upper_.resize(n_);
+        const std::vector<double>& lower = problem.getLowerBounds();
+        const std::vector<double>& upper = problem.getUpperBounds();
+        for (int j = 0; j < n_; ++j) {
+            lower_[j] = lower[j] > 0.0 ? 1.0 : 0.0;
+            upper_[j] = upper[j] < 1.0 ? 0.0 : 1.0;
+            if (lower_[j] >= upper_[j]) fixed_[j >> 6] |= bit(j);
+        }
+        row_lower_.resize(m);
+        row_upper_.resize(m);
+        activity_.resize(m);
+        for (int i = 0; i < m; ++i) {
+            row_lower_[i] = problem.getRowLowerLimit(i);
+            row_upper_[i] = problem.getRowUpperLimit(i);
+            computeActivity(i);
+        }
+
+        trail_.clear();
+        queue_.clear();
+        queued_.assign(m, false);
+        row_stamp_.assign(m, 0);
+        stamp_ = 0;
+        tightenings_ = 0;
+    }
+
+    const std::vector<double>& lower() const { return lower_; }
+    const std::vector<double>& upper() const { return upper_; }
+
+    bool isFixed(int j) const { return (fixed_[j >> 6] & bit(j)) != 0; }
+
+    // 不小于j的第一个自由变量，没有时返回变量数；按64位字跳过已固定的变量
+    int nextFree(int j) const {
+        if (j >= n_) return n_;
+        size_t w = static_cast<size_t>(j) >> 6;
+        uint64_t free = ~fixed_[w] & (~uint64_t(0) << (j & 63));
+        while (free == 0) {
+            if (++w == fixed_.size()) return n_;
+            free = ~fixed_[w];
+        }
+        return static_cast<int>(w * 64) + lowestBit(free);
+    }
+
+    /*
+     * 收紧单个变量的边界（与当前边界取交集）；0-1变量的边界只取0或1，
+     * 落在(0,1)内的值按整数变量取整
+     *
+     * @return: false表示收紧后定义域为空，此时边界不被修改
+     */
+    bool tightenLower(int j, double value) {
+        if (value <= lower_[j] + kFeasibilityTolerance) return true;
+        if (value > upper_[j] + kFeasibilityTolerance * std::max(1.0, std::abs(value))) return false;
+        if (upper_[j] == 0.0) return true;  // within tolerance of the fixed value
+        fix(j, true);
+        return true;
+    }
+
+    bool tightenUpper(int j, double value) {
+        if (value >= upper_[j] - kFeasibilityTolerance) return true;
+        if (value < lower_[j] - kFeasibilityTolerance * std::max(1.0, std::abs(value))) return false;
+        if (lower_[j] == 1.0) return true;
+        fix(j, false);
+        return true;
+    }
+
+    /*
+     * 从上次传播以来活动度发生变化的行开始传播
+     *
+     * @return: false表示证明了当前节点不可行
+     */
+    bool propagate() {
+        int work_limit = 2 * static_cast<int>(activity_.size()) + 1000;
+        bool feasible = true;
+        for (size_t head = 0; head < queue_.size(); ++head) {
+            int i = queue_[head];
+            queued_[i] = false;
+            if (!feasible || --work_limit < 0) continue;
+            feasible = propagateRow(i);
+        }
+        queue_.clear();
+        return feasible;
+    }
+
+    // trail的当前位置
+    size_t mark() const { return trail_.size(); }
+
+    // 撤销mark之后的全部固定
+    void undo(size_t mark) {
+        if (trail_.size() <= mark) return;
+        stamp_++;
+        std::vector<int>& dirty = dirty_rows_;
+        dirty.clear();
+        while (trail_.size() > mark) {
+            int j = trail_.back();
+            fixed_[j >> 6] &= ~bit(j);
+            lower_[j] = 0.0;
+            upper_[j] = 1.0;
+            SparseMatrix::VectorView column = matrix_->column(j);
+            for (int k = 0; k < column.size; ++k) {
+                int i = column.indices[k];
+                if (row_stamp_[i] != stamp_) {
+                    row_stamp_[i] = stamp_;
+                    dirty.push_back(i);
+                }
+            }
+            trail_.pop_back();
+        }
+        for (int i : dirty) {
+            computeActivity(i);
+        }
+        for (int i : queue_) {
+            queued_[i] = false;
+        }
+        queue_.clear();
+    }
+
+    // 传播推出的固定次数（不含tightenLower/tightenUpper的直接调用）
+    long long getNumTightenings() const { return tightenings_; }
+
+private:
+    static constexpr double kInfinity = 1e20;
+    static constexpr double kFeasibilityTolerance = 1e-6;
+
+    struct Activity {
+        double min;
+        double max;
+    };
+
+    const SparseMatrix* matrix_ = nullptr;
+    int n_ = 0;
+    std::vector<uint64_t> fixed_;
+    std::vector<double> lower_;
+    std::vector<double> upper_;
+    std::vector<double> row_lower_;
+    std::vector<double> row_upper_;
+    std::vector<Activity> activity_;
+
+    std::vector<int> trail_;  // fixed variables, in order
+    std::vector<int> queue_;
+    std::vector<bool> queued_;
+    std::vector<unsigned> row_stamp_;
+    std::vector<int> dirty_rows_;
+    unsigned stamp_ = 0;
+    long long tightenings_ = 0;
+
+    static uint64_t bit(int j) { return uint64_t(1) << (j & 63); }
+
+    static int lowestBit(uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_ctzll(word);
+#else
+        int k = 0;
+        while (!(word & 1)) {
+            word >>= 1;
+            k++;
+        }
+        return k;
+#endif
+    }
+
+    static bool isInfinite(double bound) { return std::abs(bound) >= kInfinity; }
+
+    void computeActivity(int i) {
+        Activity& act = activity_[i];
+        act = {0.0, 0.0};
+        SparseMatrix::VectorView row = matrix_->row(i);
+        for (int k = 0; k < row.size; ++k) {
+            int j = row.indices[k];
+            double a = row.values[k];
+            double lower = lower_[j];
+            double upper = upper_[j];
+            act.min += a * (a > 0.0 ? lower : upper);
+            act.max += a * (a > 0.0 ? upper : lower);
+        }
+    }
+
+    // Fixes the free variable j and moves its coefficient into or out of the row activities
+    void fix(int j, bool one) {
+        fixed_[j >> 6] |= bit(j);
+        (one ? lower_[j] : upper_[j]) = one ? 1.0 : 0.0;
+        trail_.push_back(j);
+        SparseMatrix::VectorView column = matrix_->column(j);
+        for (int k = 0; k < column.size; ++k) {
+            int i = column.indices[k];
+            double a = column.values[k];
+            Activity& act = activity_[i];
+            if (one) {
+                (a > 0.0 ? act.min : act.max) += a;
+            } else {
+                (a > 0.0 ? act.max : act.min) -= a;
+            }
+            if (!queued_[i]) {
+                queued_[i] = true;
+                queue_.push_back(i);
+            }
+        }
+    }
+
+    // Infeasibility check and fixings for one row
+    bool propagateRow(int i) {
+        const Activity& act = activity_[i];
+        double row_lower = row_lower_[i];
+        double row_upper = row_upper_[i];
+        bool has_upper = !isInfinite(row_upper);
+        bool has_lower = !isInfinite(row_lower);
+        if (has_upper && act.min > row_upper + kFeasibilityTolerance * std::max(1.0, std::abs(row_upper))) {
+            return false;
+        }
+        if (has_lower && act.max < row_lower - kFeasibilityTolerance * std::max(1.0, std::abs(row_lower))) {
+            return false;
+        }
+
+        // x_j at its activity-increasing value would overrun the slack: floor(slack / |a| + tol) == 0
+        SparseMatrix::VectorView row = matrix_->row(i);
+        for (int k = 0; k < row.size; ++k) {
+            int j = row.indices[k];
+            if (isFixed(j)) continue;
+            double a = row.values[k];
+            if (std::abs(a) < 1e-9) continue;
+            double size = std::abs(a) * (1.0 - kFeasibilityTolerance);
+            if (has_upper && row_upper - act.min < size) {
+                fix(j, a < 0.0);
+                tightenings_++;
+            } else if (has_lower && act.max - row_lower < size) {
+                fix(j, a > 0.0);
+                tightenings_++;
+            }
+        }
+        return true;
+    }
+};
+
+/*
+ * 变量类
+ *
+ * - GeneralVariables：任意变量类型与边界，使用通用传播引擎，候选遍历全部变量
+ * - BinaryVariables：每一列都是0-1变量，整数性判断恒为真，分数度是min(x, 1-x)，
+ *   候选遍历按位跳过已固定的变量（它们的LP值就是固定值）
+ */
+struct GeneralVariables {
+    using Propagator = DomainPropagator;
+
+    static bool isInteger(VariableType type) { return type != VariableType::CONTINUOUS; }
+    // Distance from the nearest integer
+    static double fractionality(double x) { return std::abs(x - std::round(x)); }
+    static int firstCandidate(const Propagator&) { return 0; }
+    static int nextCandidate(const Propagator&, int j) { return j + 1; }
+};
+
+struct BinaryVariables {
+    using Propagator = BinaryPropagator;
+
+    static constexpr bool isInteger(VariableType) { return true; }
+    static double fractionality(double x) { return std::min(x, 1.0 - x); }
+    static int firstCandidate(const Propagator& domain) { return domain.nextFree(0); }
+    static int nextCandidate(const Propagator& domain, int j) { return domain.nextFree(j + 1); }
+};
+
+} // namespace MIPSolver
+
+#endif
@@ -11,12 +11,65 @@
  * 1. 线性松弛：将整数约束松弛为连续约束，使用单纯形法求解
  * 2. 分支操作：对非整数解的整数变量进行分支，创建子问题
  * 3. 定界操作：利用线性松弛的最优值作为上界进行剪枝
- * 4. 搜索策略：采用深度优先搜索遍历分支树
+ * 4. 搜索策略：可配置的节点选择（深度优先、最优界、最优估计、混合潜水），见node_selection.h
+ * 5. 并行搜索：setNumThreads设置线程数，各线程拥有本地节点池并互相窃取节点，
+ *    共享原子更新的最优值用于剪枝；setDeterministic开启可复现的同步轮次模式
  * 
  * 性能优化：
- * - 智能分支变量选择：选择分数部分最大的变量进行分支
+ * - 预处理：求解前删除冗余行列、收紧边界与系数（见HeuristicPreprocessor）
+ * - 割平面：根节点多轮分离Gomory混合整数割与背包覆盖割，割池中的割在局部节点重新检查
+ *   （见DynamicCuttingPlanes、CutPool）
+ * - 域传播：激活节点后沿约束传播分支带来的边界改变，收紧其他变量的边界，
+ *   不求解LP即可剪除不可行节点（见DomainPropagator）
+ * - 纯0-1问题：每一列都是0-1变量时，节点使用位集定义域的传播引擎，整数性判断和分支候选遍历
+ *   按变量类在编译期特化，跳过已固定的变量（见binary_domain.h、setBinarySpecialization）
+ * - 并发启发式：树搜索期间在单独的线程上运行ALNS，以当前最优解为起点、以节点LP解为提示，
+ *   找到的更好可行解立即写入共享最优解用于剪枝（见AdaptiveLargeNeighborhoodSearch）
+ * - 智能分支变量选择：默认可靠性分支（伪成本 + 有限强分支），见branching.h
  * - 有效剪枝策略：及时剪除不可能包含最优解的子树
  * - 内存高效：使用栈结构管理分支节点，避免递归调用
+ * - 节点只保存相对根问题的边界改变链，激活节点时应用、离开时撤销，
+ *   所有节点共享同一个只读的根问题
+ * - 边界改变记录和热启动基从各线程的内存池分配（见memory_pool.h），LP结果、分支打分等
+ *   节点工作区由线程复用，池和工作区稳定后节点循环不再访问全局堆
+ * 
+ * 终止条件：
+ * - 节点数上限（setIterationLimit）与时间上限（setTimeLimit，从solve开始计时，包括预处理），
+ *   在每个节点（确定性模式下每一轮）之前检查，分别返回ITERATION_LIMIT和TIME_LIMIT；
+ *   截止时刻同时交给每个线程的单纯形求解器，单个LP耗时过长时也会及时停止，
+ *   该节点留在开放节点中，返回的对偶界仍然有效
+ * - 工作量上限（setWorkLimit）：按LP扫描的非零元计量（见SimplexSolver::getWork），
+ *   在每个节点（确定性模式下每一轮）之前检查，返回WORK_LIMIT。单线程且关闭ALNS，
+ *   或确定性模式下，相同输入和线程数在任何机器上都停在同一个节点
+ * - 最优性间隙（setRelativeGap / setAbsoluteGap）：LP界与当前最优值之差不超过
+ *   max(absolute_gap, relative_gap * |最优值|)的节点被剪除，报告的对偶界仍包含这些节点的界
+ * 
+ * 外部控制：
+ * - setStopFlag：外部停止标志，每个节点（确定性模式下每一轮）之前检查；置位后搜索尽快结束，
+ *   返回INTERRUPTED状态和已找到的最好解。求解运行期间可以从任意线程置位
+ * - setIncumbentCallback：找到更好的整数解时回调（原问题空间中的变量值和目标值）。
+ *   回调在找到解的线程上调用，调用之间互斥，且目标值严格单调改进
+ * - setProgressCallback（SolverInterface）：新最优解时以及每隔固定时间给出SolveProgress
+ *   （节点数、开放节点数、最优值、全局对偶界、间隙），与上面的回调共用同一把锁
+ * 
+ * 插桩：定义MIPSOLVER_ENABLE_INSTRUMENTATION编译时，每次solve记录各阶段计时（预处理、根割平面、
+ * 节点、LP、分支、节点复制、ALNS……）和计数器（LP调用、主元、按原因分类的剪枝、节点字节数），
+ * 每个线程写自己的缓冲区，结果由Solution::getProfile给出，可导出Chrome轨迹（见instrumentation.h）
+ * 
+ * 热启动：setWarmStart开启后，求解器在多次solve之间保留根LP基、伪成本、根割和最优解，
+ * 同一个Problem只改了边界、右端项、目标或增删了约束（见Problem::changesSince）时从这些状态开始，
+ * 上一次的最优解按新数据修复后作为初始最优解
+ * 
+ * 初始解与解池：addMIPStart（SolverInterface）给出的初始解在求解开始时检查，部分初始解由子MIP补全，
+ * 可行的作为初始最优解；求解中提交的可行解按目标值保留最好的若干个不同的解（Solution::getSolutionPool）
+ * 
+ * 与其他求解器协作：setObjectiveCutoff / setSharedCutoff给出外部已知的目标值界，用于剪枝；
+ * setOpenNodeOutput在提前停止时导出剩余的开放节点（原问题下标的边界收紧），
+ * 由其他求解器继续搜索（见PortfolioSolver、DistributedSolver）
+ * 
+ * 全局对偶界：开放节点（各线程的节点池）、正在处理的节点、仅因间隙容差被剪除的节点
+ * 三者LP界中最好的一个，再与当前最优值合并。求解中途的快照在并行搜索下是近似的
+ * （节点在线程间移动时可能漏算），求解结束时写入Solution的界是精确的
  * 
  * 算法特点：
  * - 保证找到全局最优解（如果存在且有限）
@@ -27,222 +80,2282 @@
 #include "core.h"
 #include "solution.h"
 #include "simplex_solver.h"
+#include "node_selection.h"
+#include "branching.h"
+#include "binary_domain.h"
+#include "memory_pool.h"
+#include "sota_algorithms.h"
 #include <queue>
 #include <chrono>
 #include <limits>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <sstream>
+#include <functional>
+#include <algorithm>
 
 namespace MIPSolver {
 
 class BranchBoundSolver : public SolverInterface {
 public:
+    using IncumbentCallback = std::function<void(const std::vector<double>& values, double objective)>;
+    
+    /*
+     * 构造函数
+     * 
+     * 初始化分支定界求解器，配置内部的单纯形求解器为非详细模式
+     * 这样可以避免在分支定界过程中产生过多的调试输出
+     */
+    BranchBoundSolver()
+        : node_selection_(NodeSelectionRule::HYBRID), deterministic_(false),
+          branching_rule_(BranchingRule::RELIABILITY), presolve_(true),
+          cutting_planes_(true), max_cut_rounds_(10), domain_propagation_(true), alns_enabled_(true) {}
+    
+    /*
+     * 设置节点选择策略
+     * 
+     * 默认使用HYBRID（潜水找可行解 + 跳回最优界节点）
+     */
+    void setNodeSelection(NodeSelectionRule rule) { node_selection_ = rule; }
+    NodeSelectionRule getNodeSelection() const { return node_selection_; }
+    
+    /*
+     * 设置确定性并行模式
+     * 
+     * 多线程时默认使用工作窃取，节点处理顺序随线程调度变化；
+     * 开启后改为同步轮次搜索，相同输入和线程数下结果可复现（用于调试）
+     */
+    void setDeterministic(bool deterministic) { deterministic_ = deterministic; }
+    bool isDeterministic() const { return deterministic_; }
+    
+    /*
+     * 设置分支变量选择规则
+     * 
+     * 默认使用RELIABILITY；LEARNED需要先通过setLearnedBranching提供打分模型，
+     * 否则按PSEUDOCOST处理
+     */
+    void setBranchingRule(BranchingRule rule) { branching_rule_ = rule; }
+    BranchingRule getBranchingRule() const { return branching_rule_; }
+    
+    void setBranchingParameters(const BranchingParameters& params) { branching_params_ = params; }
+    const BranchingParameters& getBranchingParameters() const { return branching_params_; }
+    
+    // 学习型分支打分模型（用于BranchingRule::LEARNED）
+    void setLearnedBranching(std::shared_ptr<MLBranchingStrategy> strategy) { ml_branching_ = std::move(strategy); }
+    
+    /*
+     * 预处理开关
+     * 
+     * 默认开启：求解前用HeuristicPreprocessor缩减问题，在缩减问题上做分支定界，
+     * 再把解映射回原问题
+     */
+    void setPresolve(bool enable) { presolve_ = enable; }
+    bool getPresolve() const { return presolve_; }
+    
+    /*
+     * 割平面开关
+     * 
+     * 默认开启：根节点做至多max_rounds轮Gomory混合整数割和背包覆盖割的分离，
+     * 割保存在割池中，搜索树的节点LP解为分数时重新检查池中的割
+     */
+    void setCuttingPlanes(bool enable) { cutting_planes_ = enable; }
+    bool getCuttingPlanes() const { return cutting_planes_; }
+    void setMaxCutRounds(int max_rounds) { max_cut_rounds_ = max_rounds; }
+    
+    /*
+     * 域传播开关
+     * 
+     * 默认开启：每个节点（以及强分支的每个子问题）在求解LP之前做边界传播，
+     * 传播证明不可行的节点直接剪除
+     */
+    void setDomainPropagation(bool enable) { domain_propagation_ = enable; }
+    bool getDomainPropagation() const { return domain_propagation_; }
+    
+    /*
+     * 单次节点LP的单纯形迭代上限
+     * 
+     * 默认-1，按LP的规模自动确定。因上限或数值问题没有解出的节点LP先从松弛基用原始单纯形重解一次；
+     * 仍然失败时放弃该节点，它的界计入对偶界，求解结束时状态不会是OPTIMAL或INFEASIBLE
+     */
+    void setLPIterationLimit(int limit) { lp_iteration_limit_ = limit; }
+    int getLPIterationLimit() const { return lp_iteration_limit_; }
+    
+    /*
+     * 纯0-1特化开关
+     * 
+     * 默认开启：预处理后每一列都是0-1变量时，节点处理改用BinaryPropagator和BinaryVariables
+     * 实例化的节点函数；关闭后所有问题都走通用路径（两者的搜索结果相同，只是速度不同）
+     */
+    void setBinarySpecialization(bool enable) { binary_specialization_ = enable; }
+    bool getBinarySpecialization() const { return binary_specialization_; }
+    
+    /*
+     * 并发ALNS启发式开关
+     * 
+     * 默认开启：树搜索期间额外运行一个ALNS线程寻找可行解；
+     * 确定性并行模式下不运行（它的结果依赖线程调度）
+     */
+    void setALNS(bool enable) { alns_enabled_ = enable; }
+    bool getALNS() const { return alns_enabled_; }
+    void setALNSParameters(const AdaptiveLargeNeighborhoodSearch::ALNSParameters& params) { alns_params_ = params; }
+    
+    /*
+     * 随机数种子（默认42）
+     * 
+     * 树搜索本身不使用随机数；种子交给并发ALNS，不同种子让它走不同的邻域序列
+     */
+    void setRandomSeed(unsigned seed) { random_seed_ = seed; }
+    unsigned getRandomSeed() const { return random_seed_; }
+    
+    /*
+     * 目标值截断（原问题的目标意义）
+     * 
+     * setObjectiveCutoff：只接受严格优于cutoff的解，LP界不能优于cutoff的节点被剪除；
+     * NaN表示不截断（默认）。搜索完成而没有更好的解时状态为INFEASIBLE（即"没有优于cutoff的解"），
+     * 对偶界不差于cutoff
+     * 
+     * setSharedCutoff：求解期间由外部更新的截断值（例如并发求解同一问题的其他求解器找到的最优值），
+     * 每个节点（确定性模式下每一轮）之前读取，只在它更紧时生效；可为nullptr。
+     * 变量由调用者持有，生命周期须覆盖整个求解过程
+     */
+    void setObjectiveCutoff(double cutoff) { objective_cutoff_ = cutoff; }
+    double getObjectiveCutoff() const { return objective_cutoff_; }
+    void setSharedCutoff(const std::atomic<double>* cutoff) { shared_cutoff_ = cutoff; }
+    
+    /*
+     * 开放节点（子树）
+     * 
+     * bound是子树的LP界（原问题的目标意义，根节点未处理时为无穷），
+     * indices/lower/upper是子树相对原问题的边界收紧（原问题变量下标，每个变量至多出现一次）。
+     * 已搜索的部分加上全部导出的子树覆盖了原问题的最优解
+     */
+    struct Subtree {
+        double bound = 0.0;
+        std::vector<int> indices;
+        std::vector<double> lower;
+        std::vector<double> upper;
+    };
+    
+    // 求解因限制或停止请求提前结束时把剩余的开放节点写入output（每次求解先清空）；nullptr表示不导出（默认）
+    void setOpenNodeOutput(std::vector<Subtree>* output) { open_node_output_ = output; }
+    
+    /*
+     * 外部停止标志（可为nullptr）
+     * 
+     * 由调用者持有，生命周期须覆盖整个求解过程；求解期间从其他线程置位即可请求协作式取消
+     */
+    void setStopFlag(const std::atomic<bool>* stop) { stop_flag_ = stop; }
+    
+    /*
+     * 最优性间隙容差（默认0，即证明最优）
+     * 
+     * 节点界不可能把当前最优值改进超过 max(absolute, relative * |最优值|) 时剪除该节点，
+     * 达到容差后状态仍为OPTIMAL，getDualBound给出证明的界
+     */
+    void setRelativeGap(double gap) { relative_gap_ = gap; }
+    void setAbsoluteGap(double gap) { absolute_gap_ = gap; }
+    double getRelativeGap() const { return relative_gap_; }
+    double getAbsoluteGap() const { return absolute_gap_; }
+    
+    // 新最优解回调（为空时不回调）；须在solve之前设置
+    void setIncumbentCallback(IncumbentCallback callback) { incumbent_callback_ = std::move(callback); }
+    
+    /*
+     * 热启动模式（默认关闭）
+     * 
+     * 开启后求解器在两次solve之间保留状态：根LP的最优基、伪成本、根节点留在LP中的割和最优解。
+     * 再次求解同一个Problem对象（按getModelId识别，通常只改了边界、右端项、目标或增删了约束）时：
+     * - 上一次的最优解按新数据修复：截断到边界、整数变量取整，含连续变量时固定整数部分重解LP；
+     *   修复后可行则作为初始最优解，否则作为ALNS的提示
+     * - 基和伪成本按变量和约束（getConstraintId）对应到新问题，预处理的结果不同时也适用
+     * - 割只在此后的修改没有放松可行域时保留（见ProblemChanges::relaxed），作为割池中的候选重新检查
+     * 
+     * 求解其他问题时状态被丢弃。割以外的状态只影响求解速度、不影响结果
+     */
+    void setWarmStart(bool enable) {
+        warm_start_ = enable;
+        if (!enable) clearWarmStart();
+    }
+    bool getWarmStart() const { return warm_start_; }
+    // 丢弃保留的状态，下一次求解从头开始
+    void clearWarmStart() { warm_state_ = WarmState(); }
+    
+    /*
+     * 复制另一个求解器的全部设置
+     * 
+     * 包括限制、策略开关（含热启动开关）、参数、随机数种子、目标值截断、解池容量、停止标志和回调，
+     * 不复制初始解（它们属于具体的问题）、开放节点的输出位置和伪成本、割池、热启动状态等求解状态；
+     * 用于让长期存在的求解器对象（例如BatchSolver的每个工作线程）按模板配置后反复使用
+     */
+    void copySettings(const BranchBoundSolver& other) {
+        time_limit_ = other.time_limit_;
+        iteration_limit_ = other.iteration_limit_;
+        work_limit_ = other.work_limit_;
+        verbose_ = other.verbose_;
+        num_threads_ = other.num_threads_;
+        progress_callback_ = other.progress_callback_;
+        progress_interval_ = other.progress_interval_;
+        node_selection_ = other.node_selection_;
+        deterministic_ = other.deterministic_;
+        branching_rule_ = other.branching_rule_;
+        branching_params_ = other.branching_params_;
+        ml_branching_ = other.ml_branching_;
+        presolve_ = other.presolve_;
+        cutting_planes_ = other.cutting_planes_;
+        max_cut_rounds_ = other.max_cut_rounds_;
+        domain_propagation_ = other.domain_propagation_;
+        binary_specialization_ = other.binary_specialization_;
+        alns_enabled_ = other.alns_enabled_;
+        alns_params_ = other.alns_params_;
+        random_seed_ = other.random_seed_;
+        objective_cutoff_ = other.objective_cutoff_;
+        shared_cutoff_ = other.shared_cutoff_;
+        stop_flag_ = other.stop_flag_;
+        relative_gap_ = other.relative_gap_;
+        absolute_gap_ = other.absolute_gap_;
+        incumbent_callback_ = other.incumbent_callback_;
+        warm_start_ = other.warm_start_;
+        solution_pool_size_ = other.solution_pool_size_;
+    }
+    
+    /*
+     * 核心求解方法
+     * 
+     * 实现完整的分支定界算法流程：
+     * 1. 初始化：设置根节点和最优值界限
+     * 2. 主循环：处理分支树中的每个节点
+     * 3. 线性松弛：使用单纯形法求解当前节点的LP松弛
+     * 4. 可行性检查：判断解是否满足整数约束
+     * 5. 分支操作：对非整数变量创建子问题
+     * 6. 剪枝判断：根据界限剪除不必要的分支
+     * 7. 结果返回：设置最终解的状态和数值
+     * 
+     * @param problem: 要求解的混合整数规划问题
+     * @return: 包含最优解信息的Solution对象
+     */
+    Solution solve(const Problem& problem) override {
+        solve_start_ = std::chrono::steady_clock::now();
+        deadline_ = computeDeadline();
+        work_budget_ = computeWorkBudget();
+        if (!warm_start_ || warm_state_.model_id != problem.getModelId()) {
+            warm_state_ = WarmState();
+        }
+        start_solutions_ = checkMIPStarts(problem);
+        if (open_node_output_) open_node_output_->clear();
+#ifdef MIPSOLVER_ENABLE_INSTRUMENTATION
+        // Every thread of this solve records into its own buffer of the session
+        Instrumentation::Session session;
+        trace_session_ = &session;
+        Solution solution = [&] {
+            Instrumentation::ThreadScope bind(&session, "solve");
+            return solvePresolved(problem);
+        }();
+        trace_session_ = nullptr;
+        auto profile = std::make_shared<const Instrumentation::Profile>(session.collect());
+        if (verbose_) profile->print(std::cout);
+        solution.setProfile(std::move(profile));
+#else
+        Solution solution = solvePresolved(problem);
+#endif
+        finishSolutionPool(problem, solution);
+        start_solutions_.clear();
+        if (warm_start_) {
+            // The other parts were saved by solveTree; this stamps them with the model they belong to
+            bool found = std::isfinite(solution.getObjectiveValue()) &&
+                         solution.getStatus() != Solution::Status::INFEASIBLE &&
+                         solution.getStatus() != Solution::Status::UNBOUNDED;
+            if (found) warm_state_.incumbent = solution.getValues();
+            warm_state_.model_id = problem.getModelId();
+            warm_state_.revision = problem.getRevision();
+        }
+        return solution;
+    }
+
+private:
+    /*
+     * 热启动状态（见setWarmStart）
+     * 
+     * 全部以原问题的下标保存，求解时再按预处理的结果换算到树搜索的问题上，
+     * 因此两次求解的预处理结果不同时仍然可用
+     */
+    struct WarmState {
+        unsigned long long model_id = 0;                 // 状态所属的问题（Problem::getModelId），0表示没有状态
+        long long revision = 0;                          // 保存状态时问题的修订号
+        std::vector<SimplexSolver::VarStatus> columns;   // 每个原问题变量在根LP最优基中的状态
+        std::vector<long long> row_ids;                  // 有记录的约束（Problem::getConstraintId，升序）
+        std::vector<SimplexSolver::VarStatus> rows;      // 对应约束的逻辑变量在根LP最优基中的状态
+        PseudocostTable::Snapshot pseudocosts;           // 按原问题变量下标
+        std::vector<CutPool::Cut> cuts;                  // 原问题变量空间中的割
+        std::vector<double> incumbent;                   // 原问题的最优解，没有时为空
+    };
+    
+    // 树搜索的问题（预处理后的问题）与原问题之间的下标对应
+    struct TreeMapping {
+        const Problem* original = nullptr;
+        const std::vector<int>* variables = nullptr;    // 树问题变量 -> 原问题变量，nullptr表示相同
+        const std::vector<int>* constraints = nullptr;  // 树问题约束 -> 原问题约束，nullptr表示相同
+        std::vector<double> fixed;                      // 预处理固定的原问题变量的取值；为空表示没有固定
+        
+        int variable(int k) const { return variables ? (*variables)[k] : k; }
+        int constraint(int i) const { return constraints ? (*constraints)[i] : i; }
+    };
+    
+    // 换算到树问题上的起始数据（热启动状态和初始解）
+    struct TreeStart {
+        std::shared_ptr<const SimplexSolver::Basis> basis;  // 根LP的初始基
+        std::vector<CutPool::Cut> cuts;                     // 根节点割池的初始候选
+        std::vector<std::vector<double>> solutions;         // 可行的起始解：修复后的上一次最优解、初始解
+        std::vector<double> hint;                           // 在树问题上不可行的起始点（交给ALNS）
+        bool pseudocosts = false;                           // 是否载入保留的伪成本
+    };
+    
+    // 预处理、在缩减问题上做分支定界、把解映射回原问题
+    Solution solvePresolved(const Problem& problem) {
+        TreeMapping identity;
+        identity.original = &problem;
+        if (!presolve_) {
+            return solveTree(problem, identity, incumbent_callback_);
+        }
+        
+        auto start_time = std::chrono::high_resolution_clock::now();
+        HeuristicPreprocessor presolver;
+        HeuristicPreprocessor::PreprocessingResult presolved = [&] {
+            MIPSOLVER_TRACE_SCOPE(PRESOLVE);
+            return presolver.preprocess(problem);
+        }();
+        
+        if (verbose_) {
+            std::cout << "Presolve: removed " << presolved.variables_eliminated << " variables, "
+                      << presolved.constraints_eliminated << " constraints; tightened "
+                      << presolved.bounds_tightened << " bounds, strengthened "
+                      << presolved.coefficients_strengthened << " coefficients"
+                      << (presolved.infeasible ? " (infeasible)" : "") << std::endl;
+        }
+        
+        Solution solution(problem.getNumVariables());
+        if (presolved.infeasible) {
+            solution.setStatus(Solution::Status::INFEASIBLE);
+            solution.setObjectiveValue(problem.getObjectiveType() == ObjectiveType::MINIMIZE
+                                       ? std::numeric_limits<double>::infinity()
+                                       : -std::numeric_limits<double>::infinity());
+            solution.setDualBound(solution.getObjectiveValue());
+        } else if (!presolved.problem_reduced) {
+            return solveTree(problem, identity, incumbent_callback_);
+        } else {
+            // Incumbents of the reduced problem are reported in the original variable space
+            IncumbentCallback report;
+            if (incumbent_callback_) {
+                report = [&](const std::vector<double>& values, double objective) {
+                    Solution reduced(static_cast<int>(values.size()));
+                    for (size_t j = 0; j < values.size(); ++j) {
+                        reduced.setValue(static_cast<int>(j), values[j]);
+                    }
+                    reduced.setObjectiveValue(objective);
+                    Solution original = presolver.postsolve(presolved, problem, reduced);
+                    incumbent_callback_(original.getValues(), original.getObjectiveValue());
+                };
+            }
+            TreeMapping mapping;
+            mapping.original = &problem;
+            mapping.variables = &presolved.variable_mapping;
+            mapping.constraints = &presolved.constraint_mapping;
+            if (warm_start_) {
+                std::vector<double> zero(presolved.variable_mapping.size(), 0.0);
+                mapping.fixed = presolved.postsolve.undo(zero, presolved.variable_mapping, problem.getNumVariables());
+            }
+            Solution reduced = solveTree(presolved.processed_problem, mapping, report, presolved.objective_offset);
+            MIPSOLVER_TRACE_SCOPE(POSTSOLVE);
+            solution = presolver.postsolve(presolved, problem, reduced);
+            std::vector<Solution::PoolEntry> pool;
+            for (const Solution::PoolEntry& entry : reduced.getSolutionPool()) {
+                std::vector<double> values = presolved.postsolve.undo(entry.values, presolved.variable_mapping,
+                                                                      problem.getNumVariables());
+                pool.push_back({problem.calculateObjectiveValue(values), std::move(values)});
+            }
+            solution.setSolutionPool(std::move(pool));
+        }
+        
+        auto end_time = std::chrono::high_resolution_clock::now();
+        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
+        solution.setSolveTime(duration.count() / 1000.0);
+        return solution;
+    }
+    
+    /*
+     * 分支定界主流程（在预处理之后的问题上运行）
+     * 
+     * @param mapping: problem与原问题之间的下标对应（用于换算热启动状态）
+     * @param report: 新最优解回调（problem的变量空间），可为空
+     * @param objective_offset: problem的目标值与原问题目标值之差（预处理删除的变量的贡献），
+     *                          只用于进度回调；返回的Solution仍在problem的目标意义下
+     */
+    Solution solveTree(const Problem& problem, const TreeMapping& mapping, const IncumbentCallback& report,
+                       double objective_offset = 0.0) {
+        auto start_time = std::chrono::high_resolution_clock::now();
+        
+        if (verbose_) {
+            std::cout << "\n------- Branch & Bound Solver -------" << std::endl;
+            problem.printStatistics();
+        }
+        
+        Solution solution(problem.getNumVariables());
+        
+        int num_threads = num_threads_ > 0 ? num_threads_
+                                           : std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+        
+        // Every worker owns an LP solver over the same read-only root problem;
+        // only bounds change along the tree
+        pure_binary_ = binary_specialization_ && BinaryPropagator::supports(problem);
+        std::vector<std::unique_ptr<Worker>> workers;
+        for (int t = 0; t < num_threads; ++t) {
+            workers.push_back(std::make_unique<Worker>());
+            workers.back()->simplex.loadProblem(problem);
+            workers.back()->simplex.setDeadline(deadline_);
+            workers.back()->simplex.setIterationLimit(lp_iteration_limit_);
+            initializeBounds(*workers.back(), problem);
+        }
+        
+        SearchState state(problem.getObjectiveType(), solution_pool_size_);
+        state.report = report ? &report : nullptr;
+        state.objective_offset = objective_offset;
+        state.mapping = &mapping;
+        if (progress_interval_ > 0.0) {
+            double interval = std::min(progress_interval_, kMaxTimeLimit);
+            state.next_report.store(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - solve_start_).count() + static_cast<long long>(interval * 1e9));
+        }
+        TreeStart start = loadWarmStart(problem, mapping);
+        if (start.pseudocosts) {
+            pseudocosts_.load(warm_state_.pseudocosts, mapping.variables, problem.getNumVariables());
+        } else {
+            pseudocosts_.resize(problem.getNumVariables());
+        }
+        if (verbose_ && warm_state_.model_id != 0) {
+            std::cout << "Warm start: " << (start.basis ? "root basis, " : "") << start.cuts.size() << " cuts, "
+                      << (!start.solutions.empty() ? "repaired incumbent" : !start.hint.empty() ? "incumbent hint" : "no incumbent")
+                      << std::endl;
+        }
+        loadMIPStarts(problem, mapping, start);
+        for (const std::vector<double>& x : start.solutions) {
+            double objective = problem.calculateObjectiveValue(x);
+            if (state.incumbent.update(objective, x)) {
+                reportIncumbent(state, x, objective);
+            }
+        }
+        if (!std::isnan(objective_cutoff_)) state.incumbent.tighten(objective_cutoff_ - objective_offset);
+        importSharedCutoff(state);
+        
+        // Deterministic rounds must not change the LPs while a round is in flight
+        bool deterministic = num_threads > 1 && deterministic_;
+        for (auto& worker : workers) {
+            worker->separate_in_place = !deterministic;
+        }
+        
+        // The primal heuristic runs next to the tree search and shares its incumbent
+        std::atomic<bool> heuristic_stop{false};
+        std::thread heuristic_thread;
+        bool has_integers = false;
+        for (int j = 0; j < problem.getNumVariables() && !has_integers; ++j) {
+            has_integers = problem.getVariable(j).getType() != VariableType::CONTINUOUS;
+        }
+        if (alns_enabled_ && !deterministic && has_integers) {
+            alns_ = std::make_unique<AdaptiveLargeNeighborhoodSearch>(random_seed_);
+            alns_->setParameters(alns_params_);
+            if (!start.hint.empty()) alns_->setHint(start.hint);
+            bool oversubscribed = num_threads + 1 > static_cast<int>(std::thread::hardware_concurrency());
+            heuristic_thread = std::thread([&, oversubscribed] {
+                MIPSOLVER_TRACE_THREAD(trace_session_, "heuristic");
+                runHeuristic(problem, state, heuristic_stop, oversubscribed);
+            });
+        }
+        
+        BBNode root_node;
+        {
+            MIPSOLVER_TRACE_SCOPE(ROOT_CUTS);
+            root_node.basis = separateRootCuts(problem, workers, start);
+        }
+        if (!root_node.basis) root_node.basis = start.basis;
+        root_node.depth = 0;
+        root_node.bound = (problem.getObjectiveType() == ObjectiveType::MINIMIZE) ? 
+                          -std::numeric_limits<double>::infinity() : 
+                          std::numeric_limits<double>::infinity();
+        root_node.estimate = root_node.bound;
+        for (const auto& worker : workers) {
+            state.work.fetch_add(worker->simplex.getWork());
+        }
+        
+        double open_bound;
+        if (deterministic) {
+            open_bound = runDeterministic(problem, workers, std::move(root_node), state);
+        } else {
+            open_bound = runWorkStealing(problem, workers, std::move(root_node), state);
+        }
+        
+        int heuristic_solutions = 0;
+        if (heuristic_thread.joinable()) {
+            heuristic_stop.store(true);
+            heuristic_thread.join();
+            heuristic_solutions = alns_->getNumImprovements();
+            alns_.reset();
+        }
+        
+        int nodes_processed = 0;
+        int nodes_pruned = 0;
+        int nodes_propagated = 0;
+        int nodes_unsolved = 0;
+        long long lp_iterations = 0;
+        long long tightenings = 0;
+        long long work = 0;
+        for (const auto& worker : workers) {
+            double gap_bound = worker->gap_bound.load();
+            if (!std::isnan(gap_bound)) {
+                open_bound = combineBound(open_bound, gap_bound, problem.getObjectiveType());
+            }
+            nodes_processed += worker->nodes_processed;
+            nodes_pruned += worker->nodes_pruned;
+            nodes_propagated += worker->nodes_propagated;
+            nodes_unsolved += worker->nodes_unsolved;
+            lp_iterations += worker->lp_iterations;
+            work += worker->simplex.getWork();
+            tightenings += pure_binary_ ? worker->binary_domain.getNumTightenings() : worker->domain.getNumTightenings();
+        }
+        if (warm_start_) saveWarmStart(problem, mapping, workers);
+        
+        if (state.unbounded.load()) {
+            solution.setStatus(Solution::Status::UNBOUNDED);
+            return solution;
+        }
+        
+        // Set final solution; a cutoff without a solution behind it still bounds the search
+        double best_objective = state.incumbent.solutionObjective();
+        std::vector<double> best_solution = state.incumbent.solution();
+        if (best_solution.empty()) {
+            best_solution.assign(problem.getNumVariables(), 0.0);
+        }
+        for (int i = 0; i < problem.getNumVariables(); ++i) {
+            solution.setValue(i, best_solution[i]);
+        }
+        solution.setObjectiveValue(best_objective);
+        solution.setIterations(nodes_processed);
+        solution.setDualBound(combineBound(open_bound, state.incumbent.objective(), problem.getObjectiveType()));
+        solution.setLPIterations(lp_iterations);
+        solution.setOpenNodes(state.open_nodes_left);
+        solution.setWorkUnits(work / kWorkPerUnit);
+        solution.setIncumbentHistory(state.history);
+        solution.setSolutionPool(state.incumbent.pool());
+        
+        auto end_time = std::chrono::high_resolution_clock::now();
+        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
+        solution.setSolveTime(duration.count() / 1000.0);
+        
+        // Set solution status
+        if (state.interrupted.load()) {
+            solution.setStatus(Solution::Status::INTERRUPTED);
+        } else if (state.time_limit_reached.load()) {
+            solution.setStatus(Solution::Status::TIME_LIMIT);
+        } else if (state.work_limit_reached.load()) {
+            solution.setStatus(Solution::Status::WORK_LIMIT);
+        } else if (state.limit_reached.load()) {
+            solution.setStatus(Solution::Status::ITERATION_LIMIT);
+        } else if (nodes_unsolved > 0) {
+            // Abandoned subtrees may hold better solutions (or the only ones)
+            bool found = std::isfinite(best_objective);
+            solution.setStatus(found ? Solution::Status::FEASIBLE : Solution::Status::UNKNOWN);
+        } else if (best_objective == std::numeric_limits<double>::infinity() || 
+                   best_objective == -std::numeric_limits<double>::infinity()) {
+            solution.setStatus(Solution::Status::INFEASIBLE);
+        } else {
+            solution.setStatus(Solution::Status::OPTIMAL);
+        }
+        
+        if (verbose_) {
+            std::cout << "\n------- Branch & Bound Complete -------" << std::endl;
+            std::cout << "Threads: " << num_threads << (deterministic_ && num_threads > 1 ? " (deterministic)" : "") << std::endl;
+            std::cout << "Nodes processed: " << nodes_processed << std::endl;
+            std::cout << "Nodes pruned: " << nodes_pruned << std::endl;
+            if (nodes_unsolved > 0) {
+                std::cout << "Nodes abandoned (LP not solved): " << nodes_unsolved << std::endl;
+            }
+            std::cout << "LP iterations: " << lp_iterations << std::endl;
+            if (domain_propagation_) {
+                std::cout << "Propagation: " << tightenings << (pure_binary_ ? " fixings (pure binary), " : " bound tightenings, ")
+                          << nodes_propagated << " nodes pruned without an LP" << std::endl;
+            }
+            if (alns_enabled_ && !deterministic && has_integers) {
+                std::cout << "ALNS: " << heuristic_solutions << " improving solutions" << std::endl;
+            }
+            if (cutting_planes_) {
+                std::cout << "Cuts: " << cut_pool_.numActive() << " in the LP, "
+                          << cut_pool_.size() - cut_pool_.numActive() << " in the pool" << std::endl;
+            }
+            solution.print();
+        }
+        
+        return solution;
+    }
+    
+    /*
+     * 边界改变记录
+     * 
+     * 每次分支产生一条记录：变量索引及其新的上下界。记录通过parent指针
+     * 串成一条从当前节点到根节点的链，兄弟节点共享父节点之前的全部记录，
+     * 因此每个节点只需O(1)的额外内存。
+     */
+    struct BoundChange {
+        int var_index;
+        double lower;
+        double upper;
+        std::shared_ptr<const BoundChange> parent;
+    };
+    
+    /*
+     * 分支节点结构
+     * 
+     * 表示分支树中的一个节点，包含：
+     * - bound_changes: 相对根问题的边界改变链（根节点为空）
+     * - bound: 父节点的线性松弛最优值（用于剪枝判断和最优界排序）
+     * - estimate: 该子树中最好整数解的估计值（用于最优估计排序）
+     * - depth: 节点在分支树中的深度（用于调试和统计）
+     * - basis: 父节点LP的最优基（两个子节点共享），用于对偶单纯形热启动；根节点为空
+     * - branch_var/branch_up/branch_distance: 产生该节点的分支（用于更新伪成本）；根节点branch_var为-1
+     */
+    struct BBNode {
+        std::shared_ptr<const BoundChange> bound_changes;  // 边界改变链
+        double bound;     // 线性松弛界限
+        double estimate;  // 整数解估计值
+        int depth;        // 分支深度
+        std::shared_ptr<const SimplexSolver::Basis> basis;  // 热启动基
+        int branch_var = -1;           // 分支变量
+        bool branch_up = false;        // 是否向上分支
+        double branch_distance = 0.0;  // 分支方向上的分数距离
+    };
+    
+    /*
+     * 工作线程状态
+     * 
+     * 每个线程独占一个单纯形求解器和一份工作边界（由域传播引擎持有），
+     * 节点在哪个线程上被处理，就在该线程的工作边界上激活；统计量在求解结束时汇总。
+     * 纯0-1问题的节点在binary_domain上激活，domain仍给出根节点边界（根割平面轮次使用）。
+     * 
+     * 本线程创建的子节点的边界改变记录和热启动基来自node_blocks/node_bases，
+     * 节点被窃取后可以在其他线程上释放；Worker比搜索中的所有节点活得更久。
+     * 其余成员是节点循环的工作区，每个节点覆盖使用，保留容量
+     */
+    struct Worker {
+        BlockPool node_blocks;                       // 边界改变记录及shared_ptr控制块
+        ObjectPool<SimplexSolver::Basis> node_bases;  // 子节点共享的热启动基
+        SimplexSolver simplex;
+        DomainPropagator domain;              // 当前激活节点的变量边界及行活动度
+        BinaryPropagator binary_domain;       // 纯0-1问题时代替domain
+        int cut_rows = 0;                     // 已追加到LP的活跃割数
+        bool separate_in_place = true;        // 节点内直接激活违反的池中割并重解LP
+        int nodes_processed = 0;
+        int nodes_pruned = 0;
+        int nodes_propagated = 0;             // 域传播证明不可行的节点数
+        int nodes_unsolved = 0;               // LP重解后仍未解出而放弃的节点数
+        long long lp_iterations = 0;
+        std::shared_ptr<const SimplexSolver::Basis> root_basis;  // 热启动模式下根节点LP的最优基
+        // 仅因间隙容差被剪除的节点、以及LP未能解出而放弃的节点中最好的界（计入对偶界），没有时为NaN；只由本线程写入
+        std::atomic<double> gap_bound{std::numeric_limits<double>::quiet_NaN()};
+        // 正在处理的节点的界，空闲时为NaN（供进度快照读取）
+        std::atomic<double> active_bound{std::numeric_limits<double>::quiet_NaN()};
+        
+        // Per-node workspaces
+        SimplexSolver::SimplexResult lp_result;     // node LP
+        SimplexSolver::SimplexResult lp_scratch;    // re-solve with pool cuts, strong branching children
+        SimplexSolver::Basis basis_scratch;         // warm start of those re-solves
+        std::ostringstream log;
+        std::vector<int> candidates;                // fractional integer variables
+        std::vector<PseudocostTable::Entry> entries;
+        std::vector<double> scores;
+        std::vector<size_t> unreliable;
+        std::vector<MLBranchingStrategy::BranchingFeatures> features;
+        
+        Worker() : simplex(false) {}
+        
+        DomainPropagator& propagator(GeneralVariables) { return domain; }
+        BinaryPropagator& propagator(BinaryVariables) { return binary_domain; }
+    };
+    
+    /*
+     * 节点激活作用域
+     * 
+     * 构造时把节点的边界改变链应用到工作边界上（与当前边界取交集），
+     * 析构时撤销此后的全部边界改变（包括传播推出的收紧），使工作边界回到根问题的状态
+     */
+    template <typename Propagator>
+    class BoundScope {
+    public:
+        BoundScope(Propagator& domain, const BoundChange* changes)
+            : domain_(domain), mark_(domain.mark()), feasible_(true) {
+            for (const BoundChange* change = changes; change && feasible_; change = change->parent.get()) {
+                feasible_ = domain_.tightenLower(change->var_index, change->lower) &&
+                            domain_.tightenUpper(change->var_index, change->upper);
+            }
+        }
+        ~BoundScope() { domain_.undo(mark_); }
+        
+        // 边界改变链相互矛盾时为false
+        bool feasible() const { return feasible_; }
+    private:
+        Propagator& domain_;
+        size_t mark_;
+        bool feasible_;
+    };
+    
+    /*
+     * 共享的当前最优解
+     * 
+     * 目标值以原子变量发布，剪枝时无锁读取；更新时加锁，
+     * 保证"比较-写入"不会被其他线程打断。提交的每个解（即使没有改进最优解）同时交给解池。
+     * 外部截断值（见setObjectiveCutoff）只收紧剪枝用的目标值，不对应任何解
+     */
+    class Incumbent {
+    public:
+        Incumbent(ObjectiveType obj_type, int pool_size)
+            : obj_type_(obj_type),
+              objective_(obj_type == ObjectiveType::MINIMIZE ? std::numeric_limits<double>::infinity()
+                                                             : -std::numeric_limits<double>::infinity()),
+              values_objective_(objective_.load()),
+              pool_(obj_type, pool_size) {}
+        
+        double objective() const { return objective_.load(std::memory_order_acquire); }
+        ObjectiveType objType() const { return obj_type_; }
+        
+        bool update(double objective, const std::vector<double>& values) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            pool_.add(objective, values);
+            if (!isBetterSolution(objective, objective_.load(std::memory_order_relaxed), obj_type_)) {
+                return false;
+            }
+            values_ = values;
+            values_objective_ = objective;
+            objective_.store(objective, std::memory_order_release);
+            return true;
+        }
+        
+        // Lowers the pruning objective to an externally known bound without a solution behind it
+        void tighten(double objective) {
+            if (!isBetterSolution(objective, objective_.load(std::memory_order_relaxed), obj_type_)) return;
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (isBetterSolution(objective, objective_.load(std::memory_order_relaxed), obj_type_)) {
+                objective_.store(objective, std::memory_order_release);
+            }
+        }
+        
+        // Empty while no solution has been found (the pruning objective may still be a cutoff)
+        std::vector<double> solution() const {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return values_;
+        }
+        
+        // Objective of solution(); infinite without one
+        double solutionObjective() const {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return values_objective_;
+        }
+        
+        std::vector<Solution::PoolEntry> pool() const {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return pool_.entries();
+        }
+    
+    private:
+        ObjectiveType obj_type_;
+        std::atomic<double> objective_;  // pruning objective: best solution or tighter cutoff
+        mutable std::mutex mutex_;
+        std::vector<double> values_;
+        double values_objective_;
+        SolutionPool pool_;
+    };
+    
+    // 一次搜索中所有线程共享的状态
+    struct SearchState {
+        Incumbent incumbent;
+        std::atomic<int> nodes_started{0};    // 已取出的节点数（用于节点数限制）
+        std::atomic<long long> outstanding{0};  // 开放节点数 + 正在处理的节点数
+        std::atomic<bool> stop{false};
+        std::atomic<bool> unbounded{false};
+        std::atomic<bool> limit_reached{false};
+        std::atomic<bool> interrupted{false};   // 外部停止标志结束了搜索
+        std::atomic<bool> time_limit_reached{false};
+        std::atomic<bool> work_limit_reached{false};
+        std::atomic<long long> work{0};         // 已合并的LP工作量（根节点 + 已处理的节点）
+        std::mutex log_mutex;
+        const IncumbentCallback* report = nullptr;  // 新最优解回调（可为空）
+        std::mutex report_mutex;                // 回调之间互斥；也保护下面三项
+        std::vector<Solution::IncumbentRecord> history;  // 最优解改进记录（problem的目标意义）
+        // 当前开放节点的最好LP界及开放节点数；由运行中的搜索模式设置，搜索开始前和结束后为空
+        std::function<double(long long& open_nodes)> snapshot;
+        double objective_offset = 0.0;          // 进度报告中加到目标值和界上的常数
+        const TreeMapping* mapping = nullptr;   // 导出开放节点时换算到原问题的变量下标
+        std::atomic<long long> next_report{0};  // 下一次INTERVAL报告的时刻（solve开始后的纳秒数）
+        long long open_nodes_left = 0;          // 搜索结束时剩余的开放节点数
+        
+        SearchState(ObjectiveType obj_type, int pool_size) : incumbent(obj_type, pool_size) {}
+    };
+    
+    // 单个线程的本地节点池；空闲线程从其他线程的池中窃取节点
+    struct NodePool {
+        std::mutex mutex;
+        std::unique_ptr<NodeSelector<BBNode>> nodes;
+    };
+    
+    // 处理一个节点的结果；搜索线程复用同一个对象，向量保留容量
+    struct NodeResult {
+        // UNFINISHED: 节点LP因截止时刻停止，节点需要放回开放节点
+        enum class Kind { PRUNED, INTEGER, BRANCHED, UNBOUNDED, UNFINISHED };
+        Kind kind = Kind::PRUNED;
+        long long work = 0;            // 处理该节点的LP工作量
+        double objective = 0.0;
+        std::vector<double> solution;  // INTEGER: 整数可行解
+        BBNode left_child;             // BRANCHED: x <= floor
+        BBNode right_child;            // BRANCHED: x >= ceil
+        std::vector<PseudocostObservation> observations;  // 待记录的伪成本观测
+        std::vector<double> separation_point;  // 确定性模式：合并时用此LP解检查割池
+        
+        void reset() {
+            kind = Kind::PRUNED;
+            work = 0;
+            objective = 0.0;
+            solution.clear();
+            left_child = BBNode();
+            right_child = BBNode();
+            observations.clear();
+            separation_point.clear();
+        }
+    };
+    
+    NodeSelectionRule node_selection_;  // 节点选择策略
+    bool deterministic_;                // 多线程时按同步轮次搜索，结果可复现
+    BranchingRule branching_rule_;      // 分支变量选择规则
+    BranchingParameters branching_params_;
+    PseudocostTable pseudocosts_;       // 所有线程共享的伪成本
+    std::shared_ptr<MLBranchingStrategy> ml_branching_;
+    bool presolve_;                     // 求解前是否预处理
+    bool cutting_planes_;               // 是否使用割平面
+    int max_cut_rounds_;                // 根节点割平面轮数上限
+    bool domain_propagation_;           // 节点LP之前是否做域传播
+    bool binary_specialization_ = true; // 纯0-1问题是否使用特化的节点处理
+    int lp_iteration_limit_ = -1;       // 节点LP的单纯形迭代上限，负数为自动
+    bool pure_binary_ = false;          // 本次搜索的问题是纯0-1问题且开启了特化
+    unsigned random_seed_ = 42;         // ALNS的随机数种子
+    double objective_cutoff_ = std::numeric_limits<double>::quiet_NaN();  // 原问题目标意义，NaN表示不截断
+    const std::atomic<double>* shared_cutoff_ = nullptr;  // 外部更新的截断值（可为空）
+    std::vector<Subtree>* open_node_output_ = nullptr;    // 提前停止时导出开放节点（可为空）
+    bool alns_enabled_;                 // 是否运行并发ALNS线程
+    AdaptiveLargeNeighborhoodSearch::ALNSParameters alns_params_;
+    std::unique_ptr<AdaptiveLargeNeighborhoodSearch> alns_;  // 本次搜索的ALNS（未运行时为空）
+    const std::atomic<bool>* stop_flag_ = nullptr;  // 外部停止标志（可为空）
+    double relative_gap_ = 0.0;                     // 相对最优性间隙容差
+    double absolute_gap_ = 0.0;                     // 绝对最优性间隙容差
+    std::chrono::steady_clock::time_point deadline_ = std::chrono::steady_clock::time_point::max();
+    long long work_budget_ = std::numeric_limits<long long>::max();  // 本次求解的工作量预算
+    std::chrono::steady_clock::time_point solve_start_;
+    Instrumentation::Session* trace_session_ = nullptr;  // 本次求解的记录会话（未编译插桩时为空）
+    IncumbentCallback incumbent_callback_;          // 新最优解回调（可为空）
+    CutPool cut_pool_;                  // 所有线程共享的割池
+    bool warm_start_ = false;           // 是否在两次求解之间保留状态
+    WarmState warm_state_;              // 上一次求解保留的状态
+    std::vector<std::vector<double>> start_solutions_;  // 本次求解中可行的初始解（原问题空间）
+    
+    static constexpr int kRootCutsPerRound = 50;   // 每轮根节点割平面最多加入LP的割数
+    static constexpr int kMaxGomoryRows = 100;     // 每轮最多用于Gomory割的单纯形表行数
+    static constexpr int kLocalCutsPerNode = 10;   // 局部节点每次最多激活的池中割数
+    static constexpr double kMinCutEfficacy = 1e-4;
+    static constexpr double kPruneTolerance = 1e-6;   // 精确剪枝容差
+    static constexpr double kMaxTimeLimit = 365.0 * 24 * 3600;  // 更大的时间限制视为不限时
+    static constexpr double kWorkPerUnit = 1e6;    // 一个工作量单位对应的LP非零元扫描次数
+    static constexpr int kHintInterval = 50;       // 每个线程每处理这么多个节点向ALNS提交一次LP解
+    static constexpr int kHeuristicIdleRatio = 4;      // CPU核不足时ALNS线程的初始休眠/运行时间比
+    static constexpr int kMaxHeuristicIdleRatio = 64;
+    static constexpr double kFeasibilityTolerance = 1e-6;  // 检查初始解和热启动修复后的解
+    static constexpr int kMIPStartNodes = 1000;    // 补全部分初始解的子MIP的节点上限
+    
+    void initializeBounds(Worker& worker, const Problem& problem) {
+        worker.domain.load(problem);
+        if (pure_binary_) worker.binary_domain.load(problem);
+    }
+    
+    /*
+     * 节点处理函数
+     * 
+     * 在给定线程上激活节点、求解LP松弛并判断剪枝/整数可行/分支，
+     * 不修改任何共享状态：新的整数解和子节点由调用者决定如何发布，
+     * 因此同一函数既服务于工作窃取搜索，也服务于确定性轮次搜索
+     * 
+     * @param worker: 处理该节点的线程状态
+     * @param node: 待处理节点
+     * @param best_objective: 用于剪枝的当前最优值
+     * @param node_number: 节点序号（仅用于日志）
+     * @param result: 处理结果，原有内容被覆盖
+     */
+    void processNode(Worker& worker, const BBNode& node, double best_objective,
+                     const Problem& problem, SearchState& state, int node_number, NodeResult& result) {
+        MIPSOLVER_TRACE_SCOPE(NODE);
+        MIPSOLVER_COUNT(NODES_PROCESSED, 1);
+        std::ostringstream& log = worker.log;
+        log.str(std::string());
+        long long work_before = worker.simplex.getWork();
+        result.reset();
+        if (pure_binary_) {
+            evaluateNode<BinaryVariables>(worker, node, best_objective, problem, node_number, log, result);
+        } else {
+            evaluateNode<GeneralVariables>(worker, node, best_objective, problem, node_number, log, result);
+        }
+        result.work = worker.simplex.getWork() - work_before;
+        if (verbose_ && log.tellp() > 0) {
+            std::lock_guard<std::mutex> lock(state.log_mutex);
+            std::cout << log.str() << std::flush;
+        }
+    }
+    
+    template <typename Vars>
+    void evaluateNode(Worker& worker, const BBNode& node, double best_objective,
+                      const Problem& problem, int node_number, std::ostringstream& log, NodeResult& result) {
+        typename Vars::Propagator& domain = worker.propagator(Vars());
+        worker.nodes_processed++;
+        
+        // The incumbent may have improved since this node was created
+        if (pruneByBound(worker, node.bound, best_objective, problem.getObjectiveType())) {
+            worker.nodes_pruned++;
+            MIPSOLVER_COUNT(NODES_PRUNED_BOUND, 1);
+            return;
+        }
+        
+        // Apply this node's bound changes on top of the root bounds (undone when the scope ends)
+        BoundScope<typename Vars::Propagator> bound_scope(domain, node.bound_changes.get());
+        
+        // Propagate the branching bounds through the rows; a proven conflict needs no LP
+        bool feasible = bound_scope.feasible();
+        if (feasible && domain_propagation_) {
+            MIPSOLVER_TRACE_SCOPE(PROPAGATION);
+            feasible = domain.propagate();
+        }
+        if (!feasible) {
+            worker.nodes_pruned++;
+            worker.nodes_propagated++;
+            MIPSOLVER_COUNT(NODES_PRUNED_PROPAGATION, 1);
+            if (verbose_) {
+                log << "Node " << node_number << ": infeasible by propagation, pruned\n";
+            }
+            return;
+        }
+        
+        // Solve LP relaxation for this node, warm-started from the parent's optimal basis
+        syncCuts(worker);
+        SimplexSolver::SimplexResult& lp_result = worker.lp_result;
+        worker.simplex.solveWithBounds(domain.lower(), domain.upper(), node.basis.get(), lp_result);
+        worker.lp_iterations += lp_result.iterations;
+        
+        // A warm start that hit the iteration limit or numerical trouble is retried once from scratch
+        if (!lp_result.is_optimal && !lp_result.is_infeasible && !lp_result.is_unbounded && !lp_result.is_time_limit) {
+            worker.simplex.solvePrimalWithBounds(domain.lower(), domain.upper(), lp_result);
+            worker.lp_iterations += lp_result.iterations;
+        }
+        bool cuts_failed = false;  // the re-solve with pool cuts stopped early; the pass-0 result stands
+        
+        // The second pass re-solves the LP after violated pool cuts were added
+        for (int pass = 0; ; ++pass) {
+            // Check if LP is infeasible
+            if (lp_result.is_infeasible) {
+                worker.nodes_pruned++;
+                MIPSOLVER_COUNT(NODES_PRUNED_INFEASIBLE, 1);
+                if (verbose_) {
+                    log << "Node " << node_number << ": LP infeasible, pruned\n";
+                }
+                return;
+            }
+            
+            // The deadline passed inside the LP: the node stays open
+            if (lp_result.is_time_limit) {
+                result.kind = NodeResult::Kind::UNFINISHED;
+                return;
+            }
+            
+            // Check if LP is unbounded
+            if (lp_result.is_unbounded) {
+                result.kind = NodeResult::Kind::UNBOUNDED;
+                return;
+            }
+            
+            // Even the re-solve failed: the subtree is given up, its parent bound stays in the dual bound
+            if (!lp_result.is_optimal) {
+                worker.nodes_unsolved++;
+                recordAbandonedBound(worker, node.bound, problem.getObjectiveType());
+                if (verbose_) {
+                    log << "Node " << node_number << ": LP not solved to optimality, abandoned at bound "
+                        << node.bound << "\n";
+                }
+                return;
+            }
+            
+            if (pass == 0 && node.depth == 0 && warm_start_) {
+                worker.root_basis = std::make_shared<const SimplexSolver::Basis>(worker.simplex.getBasis());
+            }
+            
+            if (verbose_) {
+                log << "Node " << node_number << " at depth " << node.depth 
+                    << (pass > 0 ? ": LP obj with pool cuts = " : ": LP obj = ") << lp_result.objective_value << "\n";
+            }
+            
+            // Objective degradation per unit of branching distance, observed from the parent
+            if (pass == 0 && node.branch_var >= 0 && node.branch_distance > 0.0) {
+                double gain = objectiveSense(problem) * (lp_result.objective_value - node.bound);
+                result.observations.push_back({node.branch_var, node.branch_up, gain / node.branch_distance});
+            }
+            
+            // Check bound (pruning condition)
+            if (pruneByBound(worker, lp_result.objective_value, best_objective, problem.getObjectiveType())) {
+                worker.nodes_pruned++;
+                MIPSOLVER_COUNT(NODES_PRUNED_BOUND, 1);
+                if (verbose_) {
+                    log << "Node " << node_number << ": Bound " << lp_result.objective_value 
+                        << " pruned (current best: " << best_objective << ")\n";
+                }
+                return;
+            }
+            
+            // Check if solution is integer feasible
+            if (isIntegerFeasible<Vars>(lp_result.solution, problem, domain)) {
+                MIPSOLVER_COUNT(NODES_INTEGER, 1);
+                result.kind = NodeResult::Kind::INTEGER;
+                result.objective = lp_result.objective_value;
+                result.solution.assign(lp_result.solution.begin(), lp_result.solution.end());
+                // Snap integer variables onto their integer values
+                const std::vector<VariableType>& types = problem.getVariableTypes();
+                for (int i = 0; i < problem.getNumVariables(); ++i) {
+                    if (Vars::isInteger(types[i])) {
+                        result.solution[i] = std::round(result.solution[i]);
+                    }
+                }
+                return;
+            }
+            
+            if (pass > 0 || !cutting_planes_) break;
+            if (!worker.separate_in_place) {
+                result.separation_point = lp_result.solution;
+                break;
+            }
+            if (cut_pool_.separate(lp_result.solution, kLocalCutsPerNode, kMinCutEfficacy) == 0) break;
+            syncCuts(worker);
+            worker.simplex.getBasis(worker.basis_scratch);
+            SimplexSolver::SimplexResult& with_cuts = worker.lp_scratch;
+            worker.simplex.solveWithBounds(domain.lower(), domain.upper(), &worker.basis_scratch, with_cuts);
+            worker.lp_iterations += with_cuts.iterations;
+            if (with_cuts.is_time_limit) {
+                result.kind = NodeResult::Kind::UNFINISHED;
+                return;
+            }
+            // Keep the LP result without the new cuts if the re-solve stopped early
+            if (!with_cuts.is_optimal && !with_cuts.is_infeasible) {
+                cuts_failed = true;
+                break;
+            }
+            std::swap(lp_result, with_cuts);
+        }
+        
+        // Fractional LP solutions steer the repair operators of the concurrent heuristic
+        if (alns_ && (node.depth == 0 || worker.nodes_processed % kHintInterval == 0)) {
+            alns_->setHint(lp_result.solution);
+        }
+        
+        // Capture the optimal basis before strong branching moves the LP away from it
+        std::shared_ptr<const SimplexSolver::Basis> parent_basis;
+        {
+            MIPSOLVER_TRACE_SCOPE(NODE_COPY);
+            std::shared_ptr<SimplexSolver::Basis> basis = worker.node_bases.share(worker.node_blocks);
+            if (cuts_failed) {
+                basis->assign(worker.basis_scratch.begin(), worker.basis_scratch.end());
+            } else {
+                worker.simplex.getBasis(*basis);
+            }
+            parent_basis = std::move(basis);
+        }
+        
+        bool node_infeasible = false;
+        int branch_var;
+        {
+            MIPSOLVER_TRACE_SCOPE(BRANCHING);
+            branch_var = selectBranchingVariable<Vars>(worker, domain, lp_result, problem, best_objective,
+                                                 result.observations, node_infeasible);
+        }
+        if (node_infeasible) {
+            worker.nodes_pruned++;
+            MIPSOLVER_COUNT(NODES_PRUNED_BRANCHING, 1);
+            if (verbose_) {
+                log << "Node " << node_number << ": pruned by strong branching\n";
+            }
+            return;
+        }
+        if (branch_var == -1) {
+            if (verbose_) {
+                log << "Node " << node_number << ": No fractional variables found, skipping\n";
+            }
+            return;
+        }
+        
+        double branch_value = lp_result.solution[branch_var];
+        
+        if (verbose_) {
+            log << "Node " << node_number << ": Branching on x" << branch_var 
+                << " = " << branch_value << "\n";
+        }
+        
+        // Create two child nodes; both share the parent's optimal basis
+        MIPSOLVER_TRACE_SCOPE(NODE_COPY);
+        MIPSOLVER_COUNT(NODES_CREATED, 2);
+        MIPSOLVER_COUNT(NODE_BYTES, 2 * static_cast<long long>(sizeof(BoundChange)) +
+                                    static_cast<long long>(sizeof(SimplexSolver::Basis) +
+                                                           parent_basis->size() * sizeof(SimplexSolver::VarStatus)));
+        BBNode& left_child = result.left_child;
+        BBNode& right_child = result.right_child;
+        left_child.basis = parent_basis;
+        right_child.basis = parent_basis;
+        
+        left_child.depth = node.depth + 1;
+        right_child.depth = node.depth + 1;
+        
+        double estimate = estimateObjective<Vars>(worker, domain, lp_result, problem);
+        
+        // Left child: x[branch_var] <= floor(branch_value)
+        double floor_val = std::floor(branch_value);
+        left_child.bound_changes = addBound(worker, node.bound_changes, branch_var,
+                                            domain.lower()[branch_var], floor_val);
+        left_child.bound = lp_result.objective_value;
+        left_child.estimate = estimate;
+        left_child.branch_var = branch_var;
+        left_child.branch_up = false;
+        left_child.branch_distance = branch_value - floor_val;
+        
+        // Right child: x[branch_var] >= ceil(branch_value)  
+        double ceil_val = std::ceil(branch_value);
+        right_child.bound_changes = addBound(worker, node.bound_changes, branch_var,
+                                             ceil_val, domain.upper()[branch_var]);
+        right_child.bound = lp_result.objective_value;
+        right_child.estimate = estimate;
+        right_child.branch_var = branch_var;
+        right_child.branch_up = true;
+        right_child.branch_distance = ceil_val - branch_value;
+        
+        result.kind = NodeResult::Kind::BRANCHED;
+    }
+    
+    /*
+     * 根节点割平面轮次
+     * 
+     * 每一轮在线程0的根LP最优基上分离割平面：分数整数基变量所在的单纯形表行
+     * 给出Gomory混合整数割，约束行给出背包覆盖割。新割先进入割池，
+     * 再由割池按有效度和平行度选出一批追加到LP并热启动重解。
+     * 没有可加入的割、连续两轮界几乎没有改善或达到轮数上限时停止。
+     * 
+     * 结束时只保留逻辑变量非基（在根LP最优解处起作用）的割作为全局LP行，
+     * 其余退回割池供局部节点检查；所有线程的LP都追加保留的行。
+     * 
+     * 热启动时上一次保留的割先进入割池，第一轮与新分离的割一起按有效度选择；
+     * 根LP从保留的基开始求解。
+     * 
+     * @return: 根LP的最优基，用作根节点的热启动基；没有保留任何割时为空
+     */
+    std::shared_ptr<const SimplexSolver::Basis> separateRootCuts(const Problem& problem,
+                                                                  std::vector<std::unique_ptr<Worker>>& workers,
+                                                                  const TreeStart& start) {
+        cut_pool_.clear();
+        for (auto& worker : workers) {
+            worker->cut_rows = 0;
+        }
+        if (!cutting_planes_ || max_cut_rounds_ <= 0) return nullptr;
+        
+        const int n = problem.getNumVariables();
+        const int m = problem.getNumConstraints();
+        bool has_integers = false;
+        for (int j = 0; j < n && !has_integers; ++j) {
+            has_integers = problem.getVariable(j).getType() != VariableType::CONTINUOUS;
+        }
+        if (!has_integers) return nullptr;
+        for (const CutPool::Cut& cut : start.cuts) {
+            cut_pool_.add(cut);
+        }
+        
+        Worker& worker = *workers[0];
+        DynamicCuttingPlanes separator(kMinCutEfficacy, 1e-6, 2 * kRootCutsPerRound);
+        Problem lp = problem;  // Rows of the root LP: the problem plus every cut added so far
+        SimplexSolver::SimplexResult result =
+            worker.simplex.solveWithBounds(worker.domain.lower(), worker.domain.upper(), start.basis.get());
+        worker.lp_iterations += result.iterations;
+        if (!result.is_optimal) return nullptr;
+        if (alns_) alns_->setHint(result.solution);
+        
+        const double sense = objectiveSense(problem);
+        const double first_bound = result.objective_value;
+        int stalled = 0;
+        int round = 0;
+        for (; round < max_cut_rounds_; ++round) {
+            if (isIntegerFeasible<GeneralVariables>(result.solution, problem, worker.domain) || stopRequested() ||
+                timeLimitReached() || worker.simplex.getWork() >= work_budget_) break;
+            
+            // Tableau rows of the most fractional integer basics
+            std::vector<std::pair<double, int>> fractional;  // (distance from 0.5, basis position)
+            for (int p = 0; p < lp.getNumConstraints(); ++p) {
+                int j = worker.simplex.getBasicVariable(p);
+                if (j >= n || problem.getVariable(j).getType() == VariableType::CONTINUOUS) continue;
+                double f = result.solution[j] - std::floor(result.solution[j]);
+                if (f > 0.01 && f < 0.99) fractional.push_back({std::abs(f - 0.5), p});
+            }
+            std::stable_sort(fractional.begin(), fractional.end());
+            if (static_cast<int>(fractional.size()) > kMaxGomoryRows) fractional.resize(kMaxGomoryRows);
+            
+            const SimplexSolver::Basis basis = worker.simplex.getBasis();
+            std::vector<DynamicCuttingPlanes::TableauRow> rows(fractional.size());
+            for (size_t r = 0; r < fractional.size(); ++r) {
+                DynamicCuttingPlanes::TableauRow& row = rows[r];
+                row.basic_var = worker.simplex.getBasicVariable(fractional[r].second);
+                row.value = result.solution[row.basic_var];
+                worker.simplex.getTableauRow(fractional[r].second, row.indices, row.alpha);
+                row.at_upper.resize(row.indices.size());
+                for (size_t k = 0; k < row.indices.size(); ++k) {
+                    row.at_upper[k] = basis[row.indices[k]] == SimplexSolver::VarStatus::AT_UPPER;
+                }
+            }
+            
+            for (const DynamicCuttingPlanes::Cut& cut : separator.generateCuts(lp, result.solution, rows)) {
+                cut_pool_.add(cut);
+            }
+            int first_new = cut_pool_.numActive();
+            if (cut_pool_.separate(result.solution, kRootCutsPerRound, kMinCutEfficacy) == 0) break;
+            
+            std::vector<CutPool::Cut> added = cut_pool_.getActive(first_new);
+            appendCutRows(worker.simplex, added);
+            for (const CutPool::Cut& cut : added) {
+                int row = lp.addConstraint("cut" + std::to_string(lp.getNumConstraints() - m),
+                                           ConstraintType::LESS_EQUAL, cut.rhs);
+                for (size_t k = 0; k < cut.indices.size(); ++k) {
+                    lp.addConstraintCoefficient(row, cut.indices[k], cut.coefficients[k]);
+                }
+            }
+            
+            double previous = result.objective_value;
+            const SimplexSolver::Basis warm = worker.simplex.getBasis();
+            result = worker.simplex.solveWithBounds(worker.domain.lower(), worker.domain.upper(), &warm);
+            worker.lp_iterations += result.iterations;
+            if (!result.is_optimal) break;
+            
+            if (verbose_) {
+                std::cout << "Cut round " << round + 1 << ": added " << added.size()
+                          << " cuts, LP bound = " << result.objective_value << std::endl;
+            }
+            double improvement = sense * (result.objective_value - previous);
+            if (improvement <= 1e-4 * std::max(1.0, std::abs(previous))) {
+                if (++stalled >= 2) break;
+            } else {
+                stalled = 0;
+            }
+        }
+        
+        // Keep the cuts that are tight at the root optimum; slack cuts go back to the pool
+        int num_cuts = cut_pool_.numActive();
+        std::vector<bool> keep(num_cuts, false);
+        SimplexSolver::Basis basis = worker.simplex.getBasis();
+        auto root_basis = std::make_shared<SimplexSolver::Basis>(basis.begin(), basis.begin() + n + m);
+        int kept = 0;
+        if (result.is_optimal) {
+            for (int k = 0; k < num_cuts; ++k) {
+                if (basis[n + m + k] == SimplexSolver::VarStatus::BASIC) continue;
+                keep[k] = true;
+                root_basis->push_back(basis[n + m + k]);
+                kept++;
+            }
+        }
+        cut_pool_.retainActive(keep);
+        
+        if (verbose_) {
+            std::cout << "Root cuts: " << round << " rounds, " << kept << " cuts kept in the LP, "
+                      << cut_pool_.size() - kept << " in the pool; bound " << first_bound;
+            if (result.is_optimal) std::cout << " -> " << result.objective_value;
+            std::cout << std::endl;
+        }
+        
+        // Rebuild every LP as the problem plus the retained cuts
+        std::vector<CutPool::Cut> retained = cut_pool_.getActive(0);
+        if (num_cuts > 0) {
+            worker.simplex.loadProblem(problem);
+        }
+        for (size_t t = 0; t < workers.size(); ++t) {
+            appendCutRows(workers[t]->simplex, retained);
+            workers[t]->cut_rows = kept;
+        }
+        if (!result.is_optimal) return nullptr;
+        return root_basis;
+    }
+    
+    /*
+     * 把保留的热启动状态换算到树问题上（没有本问题的状态时返回空的TreeStart）
+     * 
+     * - 基：变量和约束分别按原问题下标、getConstraintId查找，没有记录的变量按目标系数放在边界上，
+     *   没有记录的约束逻辑变量为基变量；基变量个数不等于行数时调整逻辑变量（其次是结构变量）补齐
+     * - 割：此后的修改没有放松可行域时才保留；被预处理固定的变量按固定值移到右端项
+     * - 最优解：在原问题上修复，再取树问题的分量并检查可行性
+     */
+    TreeStart loadWarmStart(const Problem& problem, const TreeMapping& mapping) {
+        TreeStart start;
+        const Problem& original = *mapping.original;
+        if (!warm_start_ || warm_state_.model_id != original.getModelId()) return start;
+        const WarmState& warm = warm_state_;
+        const int n = problem.getNumVariables();
+        const int m = problem.getNumConstraints();
+        
+        if (!warm.columns.empty()) {
+            using VarStatus = SimplexSolver::VarStatus;
+            auto basis = std::make_shared<SimplexSolver::Basis>(n + m, VarStatus::AT_ZERO);
+            int basic = 0;
+            for (int k = 0; k < n; ++k) {
+                int j = mapping.variable(k);
+                if (j < static_cast<int>(warm.columns.size())) (*basis)[k] = warm.columns[j];
+                basic += (*basis)[k] == VarStatus::BASIC;
+            }
+            for (int i = 0; i < m; ++i) {
+                long long id = original.getConstraintId(mapping.constraint(i));
+                auto it = std::lower_bound(warm.row_ids.begin(), warm.row_ids.end(), id);
+                bool known = it != warm.row_ids.end() && *it == id;
+                (*basis)[n + i] = known ? warm.rows[it - warm.row_ids.begin()] : VarStatus::BASIC;
+                basic += (*basis)[n + i] == VarStatus::BASIC;
+            }
+            // Rows and columns come and go between solves; the factorization repairs a singular result
+            for (int p = n + m - 1; p >= 0 && basic != m; --p) {
+                bool is_basic = (*basis)[p] == VarStatus::BASIC;
+                if (basic > m && is_basic) {
+                    (*basis)[p] = VarStatus::AT_ZERO;
+                    basic--;
+                } else if (basic < m && !is_basic && p >= n) {
+                    (*basis)[p] = VarStatus::BASIC;
+                    basic++;
+                }
+            }
+            if (basic == m) start.basis = std::move(basis);
+        }
+        
+        if (cutting_planes_ && !warm.cuts.empty() && !original.changesSince(warm.revision).relaxed) {
+            std::vector<int> position(original.getNumVariables(), -1);  // 原问题变量 -> 树问题变量
+            for (int k = 0; k < n; ++k) {
+                position[mapping.variable(k)] = k;
+            }
+            std::vector<std::pair<int, double>> entries;
+            for (const CutPool::Cut& cut : warm.cuts) {
+                CutPool::Cut mapped = cut;
+                mapped.indices.clear();
+                mapped.coefficients.clear();
+                entries.clear();
+                for (size_t t = 0; t < cut.indices.size(); ++t) {
+                    int k = position[cut.indices[t]];
+                    if (k >= 0) {
+                        entries.push_back({k, cut.coefficients[t]});
+                    } else if (!mapping.fixed.empty()) {
+                        mapped.rhs -= cut.coefficients[t] * mapping.fixed[cut.indices[t]];
+                    }
+                }
+                if (entries.empty()) continue;
+                std::sort(entries.begin(), entries.end());
+                for (const auto& entry : entries) {
+                    mapped.indices.push_back(entry.first);
+                    mapped.coefficients.push_back(entry.second);
+                }
+                start.cuts.push_back(std::move(mapped));
+            }
+        }
+        
+        if (!warm.incumbent.empty()) {
+            std::vector<double> x = warm.incumbent;
+            bool feasible = repairSolution(original, x);
+            std::vector<double> tree_x(n);
+            for (int k = 0; k < n; ++k) {
+                tree_x[k] = x[mapping.variable(k)];
+            }
+            if (feasible && isFeasiblePoint(problem, tree_x)) {
+                start.solutions.push_back(std::move(tree_x));
+            } else {
+                start.hint = std::move(tree_x);
+            }
+        }
+        
+        start.pseudocosts = !warm.pseudocosts.sum_down.empty();
+        return start;
+    }
+    
+    /*
+     * 保存本次树搜索的热启动状态（原问题下标）
+     * 
+     * 本次没有出现的变量和约束（被预处理删除）保留上一次的记录；根LP没有解到最优时基不更新
+     */
+    void saveWarmStart(const Problem& problem, const TreeMapping& mapping,
+                       const std::vector<std::unique_ptr<Worker>>& workers) {
+        const Problem& original = *mapping.original;
+        const int n = problem.getNumVariables();
+        const int m = problem.getNumConstraints();
+        const int original_n = original.getNumVariables();
+        const int original_m = original.getNumConstraints();
+        WarmState& warm = warm_state_;
+        
+        pseudocosts_.save(warm.pseudocosts, mapping.variables, original_n);
+        
+        std::shared_ptr<const SimplexSolver::Basis> root_basis;
+        for (const auto& worker : workers) {
+            if (worker->root_basis) root_basis = worker->root_basis;
+        }
+        if (root_basis) {
+            warm.columns.resize(original_n, SimplexSolver::VarStatus::AT_ZERO);
+            for (int k = 0; k < n; ++k) {
+                warm.columns[mapping.variable(k)] = (*root_basis)[k];
+            }
+            // Rows removed since the last solve drop out; rows missing from this tree keep their old status
+            std::vector<long long> row_ids(original_m);
+            std::vector<SimplexSolver::VarStatus> rows(original_m, SimplexSolver::VarStatus::BASIC);
+            size_t old = 0;
+            for (int r = 0; r < original_m; ++r) {
+                row_ids[r] = original.getConstraintId(r);
+                while (old < warm.row_ids.size() && warm.row_ids[old] < row_ids[r]) old++;
+                if (old < warm.row_ids.size() && warm.row_ids[old] == row_ids[r]) rows[r] = warm.rows[old];
+            }
+            for (int i = 0; i < m; ++i) {
+                rows[mapping.constraint(i)] = (*root_basis)[n + i];
+            }
+            warm.row_ids = std::move(row_ids);
+            warm.rows = std::move(rows);
+        }
+        
+        // The cuts left in the LP, expressed in the original variables
+        warm.cuts = cut_pool_.getActive(0);
+        if (mapping.variables) {
+            for (CutPool::Cut& cut : warm.cuts) {
+                for (int& index : cut.indices) {
+                    index = mapping.variable(index);
+                }
+            }
+        }
+    }
+    
+    /*
+     * 检查初始解（SolverInterface::addMIPStart），返回其中可行的解（原问题空间）
+     * 
+     * 整数变量的取值与最近的整数相差不超过kFeasibilityTolerance时取整，否则该初始解不可行；
+     * 取整后用Problem::isValidSolution（容差kFeasibilityTolerance）检查。只给出部分变量的初始解
+     * 固定这些变量后求解子MIP（至多kMIPStartNodes个节点，共用本次求解的截止时刻和停止标志），
+     * 补全后的解同样检查
+     */
+    std::vector<std::vector<double>> checkMIPStarts(const Problem& problem) const {
+        std::vector<std::vector<double>> feasible;
+        if (mip_starts_.empty()) return feasible;
+        const int n = problem.getNumVariables();
+        int completed = 0;
+        for (size_t s = 0; s < mip_starts_.size(); ++s) {
+            const MIPStart& start = mip_starts_[s];
+            std::vector<double> x(n, std::numeric_limits<double>::quiet_NaN());
+            for (size_t k = 0; k < start.indices.size(); ++k) {
+                int j = start.indices[k];
+                if (j < 0 || j >= n) {
+                    throw std::runtime_error("MIP start " + std::to_string(s) + ": variable index " +
+                                             std::to_string(j) + " out of range");
+                }
+                x[j] = start.values[k];
+            }
+            
+            const char* rejected = nullptr;
+            bool partial = std::any_of(x.begin(), x.end(), [](double value) { return std::isnan(value); });
+            if (!snapIntegers(problem, x)) {
+                rejected = "fractional value of an integer variable";
+            } else if (partial) {
+                if (!completeMIPStart(problem, x)) {
+                    rejected = "no completion found";
+                } else if (!snapIntegers(problem, x)) {
+                    rejected = "fractional value of an integer variable";
+                } else {
+                    completed++;
+                }
+            }
+            if (!rejected && !problem.isValidSolution(x, kFeasibilityTolerance)) rejected = "violates a bound or constraint";
+            
+            if (rejected) {
+                if (verbose_) std::cout << "MIP start " << s << " rejected: " << rejected << std::endl;
+            } else {
+                feasible.push_back(std::move(x));
+            }
+        }
+        if (verbose_) {
+            std::cout << "MIP starts: " << feasible.size() << " of " << mip_starts_.size() << " feasible ("
+                      << completed << " completed by a sub-MIP)" << std::endl;
+        }
+        return feasible;
+    }
+    
+    /*
+     * 补全部分初始解：x中非NaN的变量固定为给定值，求解子MIP得到其余变量
+     * 
+     * @return: 是否找到了补全（找到时x为完整的解）
+     */
+    bool completeMIPStart(const Problem& problem, std::vector<double>& x) const {
+        Problem restricted = problem;
+        for (int j = 0; j < problem.getNumVariables(); ++j) {
+            if (std::isnan(x[j])) continue;
+            ConstVariable var = problem.getVariable(j);
+            if (x[j] < var.getLowerBound() - kFeasibilityTolerance * std::max(1.0, std::abs(var.getLowerBound())) ||
+                x[j] > var.getUpperBound() + kFeasibilityTolerance * std::max(1.0, std::abs(var.getUpperBound()))) {
+                return false;
+            }
+            restricted.setVariableBounds(j, x[j], x[j]);
+        }
+        
+        BranchBoundSolver sub;
+        sub.setVerbose(false);
+        sub.setNumThreads(1);
+        sub.setIterationLimit(kMIPStartNodes);
+        sub.setPresolve(presolve_);
+        sub.setCuttingPlanes(cutting_planes_);
+        sub.setDomainPropagation(domain_propagation_);
+        sub.setALNS(false);
+        sub.setStopFlag(stop_flag_);
+        sub.setSolutionPoolSize(0);
+        if (deadline_ != std::chrono::steady_clock::time_point::max()) {
+            double remaining = std::chrono::duration<double>(deadline_ - std::chrono::steady_clock::now()).count();
+            if (remaining <= 0.0) return false;
+            sub.setTimeLimit(remaining);
+        } else {
+            sub.setTimeLimit(0.0);
+        }
+        Solution completion = sub.solve(restricted);
+        if (!std::isfinite(completion.getObjectiveValue()) ||
+            completion.getStatus() == Solution::Status::INFEASIBLE ||
+            completion.getStatus() == Solution::Status::UNBOUNDED) {
+            return false;
+        }
+        x = completion.getValues();
+        return true;
+    }
+    
+    // 把可行的初始解换算到树问题上；在树问题上不可行的（被预处理的约简排除）第一个交给ALNS作为提示
+    void loadMIPStarts(const Problem& problem, const TreeMapping& mapping, TreeStart& start) const {
+        for (const std::vector<double>& x : start_solutions_) {
+            std::vector<double> tree_x(problem.getNumVariables());
+            for (int k = 0; k < problem.getNumVariables(); ++k) {
+                tree_x[k] = x[mapping.variable(k)];
+            }
+            if (isFeasiblePoint(problem, tree_x)) {
+                start.solutions.push_back(std::move(tree_x));
+            } else if (start.hint.empty()) {
+                start.hint = std::move(tree_x);
+            }
+        }
+    }
+    
+    /*
+     * 把可行的初始解并入解池，并保证返回的解不差于其中最好的一个
+     * 
+     * 初始解在树问题上不可行时搜索不一定找到同样好的解，这时返回该初始解
+     * （搜索没有找到任何解时状态改为FEASIBLE）
+     */
+    void finishSolutionPool(const Problem& problem, Solution& solution) const {
+        if (solution.getStatus() == Solution::Status::UNBOUNDED) return;
+        ObjectiveType obj_type = problem.getObjectiveType();
+        SolutionPool pool(obj_type, solution_pool_size_);
+        for (const Solution::PoolEntry& entry : solution.getSolutionPool()) {
+            pool.add(entry.objective, entry.values);
+        }
+        const std::vector<double>* best = nullptr;
+        double best_objective = solution.getObjectiveValue();
+        for (const std::vector<double>& x : start_solutions_) {
+            double objective = problem.calculateObjectiveValue(x);
+            pool.add(objective, x);
+            if (isBetterSolution(objective, best_objective, obj_type)) {
+                best = &x;
+                best_objective = objective;
+            }
+        }
+        solution.setSolutionPool(pool.entries());
+        if (!best) return;
+        for (int j = 0; j < problem.getNumVariables(); ++j) {
+            solution.setValue(j, (*best)[j]);
+        }
+        solution.setObjectiveValue(best_objective);
+        if (solution.getStatus() == Solution::Status::INFEASIBLE) solution.setStatus(Solution::Status::FEASIBLE);
+    }
+    
+    // 整数变量的取值（NaN除外）在kFeasibilityTolerance内取整；有分数取值时返回false
+    static bool snapIntegers(const Problem& problem, std::vector<double>& x) {
+        const std::vector<VariableType>& types = problem.getVariableTypes();
+        for (int j = 0; j < problem.getNumVariables(); ++j) {
+            if (std::isnan(x[j]) || types[j] == VariableType::CONTINUOUS) continue;
+            double rounded = std::round(x[j]);
+            if (std::abs(x[j] - rounded) > kFeasibilityTolerance) return false;
+            x[j] = rounded;
+        }
+        return true;
+    }
+    
+    /*
+     * 把上一次的最优解修复为当前数据下的候选解
+     * 
+     * 截断到变量边界、整数变量取整（仍在边界内）；含连续变量时固定整数变量重解LP得到连续部分。
+     * x被改为修复后的点（新增的变量先取0再截断）
+     * 
+     * @return: 修复后的点是否可行
+     */
+    bool repairSolution(const Problem& problem, std::vector<double>& x) const {
+        const int n = problem.getNumVariables();
+        x.resize(n, 0.0);
+        bool has_continuous = false;
+        for (int j = 0; j < n; ++j) {
+            ConstVariable var = problem.getVariable(j);
+            double value = std::min(std::max(x[j], var.getLowerBound()), var.getUpperBound());
+            if (var.getType() == VariableType::CONTINUOUS) {
+                has_continuous = true;
+            } else {
+                value = std::round(value);
+                if (value < var.getLowerBound()) value = std::ceil(var.getLowerBound());
+                if (value > var.getUpperBound()) value = std::floor(var.getUpperBound());
+            }
+            x[j] = value;
+        }
+        
+        if (has_continuous) {
+            std::vector<double> lower(n), upper(n);
+            for (int j = 0; j < n; ++j) {
+                ConstVariable var = problem.getVariable(j);
+                bool fixed = var.getType() != VariableType::CONTINUOUS;
+                lower[j] = fixed ? x[j] : var.getLowerBound();
+                upper[j] = fixed ? x[j] : var.getUpperBound();
+            }
+            SimplexSolver completion(false);
+            completion.loadProblem(problem);
+            completion.setDeadline(deadline_);
+            SimplexSolver::SimplexResult result = completion.solveWithBounds(lower, upper);
+            if (!result.is_optimal) return false;
+            for (int j = 0; j < n; ++j) {
+                if (problem.getVariable(j).getType() == VariableType::CONTINUOUS) x[j] = result.solution[j];
+            }
+        }
+        return isFeasiblePoint(problem, x);
+    }
+    
+    // 边界、整数性与全部约束在kFeasibilityTolerance（按量级放大）内满足
+    static bool isFeasiblePoint(const Problem& problem, const std::vector<double>& x) {
+        auto violates = [](double value, double lower, double upper) {
+            return value < lower - kFeasibilityTolerance * std::max(1.0, std::abs(lower)) ||
+                   value > upper + kFeasibilityTolerance * std::max(1.0, std::abs(upper));
+        };
+        const std::vector<double>& lower = problem.getLowerBounds();
+        const std::vector<double>& upper = problem.getUpperBounds();
+        const std::vector<VariableType>& types = problem.getVariableTypes();
+        for (int j = 0; j < problem.getNumVariables(); ++j) {
+            if (violates(x[j], lower[j], upper[j])) return false;
+            if (types[j] != VariableType::CONTINUOUS && std::abs(x[j] - std::round(x[j])) > kFeasibilityTolerance) {
+                return false;
+            }
+        }
+        for (int i = 0; i < problem.getNumConstraints(); ++i) {
+            if (violates(problem.getRowActivity(i, x), problem.getRowLowerLimit(i), problem.getRowUpperLimit(i))) {
+                return false;
+            }
+        }
+        return true;
+    }
+    
+    /*
+     * 并发启发式线程
+     * 
+     * 反复运行ALNS直到树搜索结束：以共享最优解为起点，找到的更好解写回共享最优解；
+     * 含连续变量时用本线程自己的LP（固定整数变量）补全连续部分。
+     * 
+     * 没有空闲的CPU核（oversubscribed）时，已有可行解之后每轮ALNS结束后休眠：
+     * 休眠/运行时间比从kHeuristicIdleRatio开始，某一轮没有找到更好解时加倍（至多
+     * kMaxHeuristicIdleRatio），找到时恢复，把其余CPU时间留给树搜索
+     */
+    void runHeuristic(const Problem& problem, SearchState& state, const std::atomic<bool>& stop,
+                      bool oversubscribed) {
+        const int n = problem.getNumVariables();
+        AdaptiveLargeNeighborhoodSearch& alns = *alns_;
+        alns.setStopFlag(&stop);
+        alns.setSolutionSource([&](double objective, std::vector<double>& values) {
+            if (!isBetterSolution(state.incumbent.objective(), objective, problem.getObjectiveType())) return false;
+            values = state.incumbent.solution();
+            return !values.empty();
+        });
+        alns.setSolutionCallback([&](const std::vector<double>& values, double objective) {
+            if (!state.incumbent.update(objective, values)) return;
+            reportIncumbent(state, values, objective);
+            if (!verbose_) return;
+            std::lock_guard<std::mutex> lock(state.log_mutex);
+            std::cout << "ALNS: New integer solution found! Objective: " << objective << std::endl;
+        });
+        
+        bool has_continuous = false;
+        for (int j = 0; j < n && !has_continuous; ++j) {
+            has_continuous = problem.getVariable(j).getType() == VariableType::CONTINUOUS;
+        }
+        SimplexSolver completion(false);
+        SimplexSolver::Basis basis;
+        std::vector<double> lower(n), upper(n);
+        if (has_continuous) {
+            completion.loadProblem(problem);
+            completion.setDeadline(deadline_);
+            alns.setContinuousCompletion([&](std::vector<double>& x) {
+                for (int j = 0; j < n; ++j) {
+                    ConstVariable var = problem.getVariable(j);
+                    bool fixed = var.getType() != VariableType::CONTINUOUS;
+                    lower[j] = fixed ? x[j] : var.getLowerBound();
+                    upper[j] = fixed ? x[j] : var.getUpperBound();
+                }
+                SimplexSolver::SimplexResult result =
+                    completion.solveWithBounds(lower, upper, basis.empty() ? nullptr : &basis);
+                if (!result.is_optimal) return false;
+                basis = completion.getBasis();
+                for (int j = 0; j < n; ++j) {
+                    if (problem.getVariable(j).getType() == VariableType::CONTINUOUS) x[j] = result.solution[j];
+                }
+                return true;
+            });
+        }
+        
+        const double no_solution = objectiveSense(problem) * std::numeric_limits<double>::infinity();
+        int idle_ratio = kHeuristicIdleRatio;
+        while (!stop.load()) {
+            auto start = std::chrono::steady_clock::now();
+            int improvements = alns.getNumImprovements();
+            {
+                MIPSOLVER_TRACE_SCOPE(HEURISTIC);
+                alns.solve(problem, Solution(n));
+            }
+            if (!oversubscribed || state.incumbent.objective() == no_solution) continue;
+            
+            idle_ratio = alns.getNumImprovements() > improvements ? kHeuristicIdleRatio
+                                                                  : std::min(2 * idle_ratio, kMaxHeuristicIdleRatio);
+            auto idle_until = std::chrono::steady_clock::now() + (std::chrono::steady_clock::now() - start) * idle_ratio;
+            while (!stop.load() && std::chrono::steady_clock::now() < idle_until) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            }
+        }
+    }
+    
+    // 把割池中尚未加入该线程LP的活跃割追加为LP的行
+    void syncCuts(Worker& worker) {
+        if (cut_pool_.numActive() <= worker.cut_rows) return;
+        std::vector<CutPool::Cut> cuts = cut_pool_.getActive(worker.cut_rows);
+        appendCutRows(worker.simplex, cuts);
+        worker.cut_rows += static_cast<int>(cuts.size());
+    }
+    
+    static void appendCutRows(SimplexSolver& simplex, const std::vector<CutPool::Cut>& cuts) {
+        std::vector<int> row_start(1, 0);
+        std::vector<int> col_index;
+        std::vector<double> values;
+        std::vector<double> lower(cuts.size(), -std::numeric_limits<double>::infinity());
+        std::vector<double> upper;
+        for (const CutPool::Cut& cut : cuts) {
+            col_index.insert(col_index.end(), cut.indices.begin(), cut.indices.end());
+            values.insert(values.end(), cut.coefficients.begin(), cut.coefficients.end());
+            row_start.push_back(static_cast<int>(col_index.size()));
+            upper.push_back(cut.rhs);
+        }
+        simplex.addRows(row_start, col_index, values, lower, upper);
+    }
+    
     /*
-     * 构造函数
+     * 把刚写入共享最优解的整数解交给回调
      * 
-     * 初始化分支定界求解器，配置内部的单纯形求解器为非详细模式
-     * 这样可以避免在分支定界过程中产生过多的调试输出
+     * 回调之间互斥；等到锁时若已有更好的解被发布，这个解不再回调，
+     * 因此回调看到的目标值严格单调改进
+     */
+    void reportIncumbent(SearchState& state, const std::vector<double>& values, double objective) {
+        std::lock_guard<std::mutex> lock(state.report_mutex);
+        if (state.incumbent.objective() != objective) return;
+        state.history.push_back({elapsedSeconds(), state.nodes_started.load(), objective});
+        if (state.report) (*state.report)(values, objective);
+        if (progress_callback_) progress_callback_(makeProgress(state, SolveProgress::Event::INCUMBENT));
+    }
+    
+    double elapsedSeconds() const {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - solve_start_).count();
+    }
+    
+    // 进度快照；调用者持有report_mutex
+    SolveProgress makeProgress(SearchState& state, SolveProgress::Event event) const {
+        ObjectiveType obj_type = state.incumbent.objType();
+        double objective = state.incumbent.solutionObjective();
+        long long open_nodes = 0;
+        // Before the tree search starts nothing is proven yet
+        double bound = state.snapshot ? state.snapshot(open_nodes)
+                                      : -(obj_type == ObjectiveType::MINIMIZE ? 1.0 : -1.0) * std::numeric_limits<double>::infinity();
+        bound = combineBound(bound, state.incumbent.objective(), obj_type);
+        
+        SolveProgress progress;
+        progress.event = event;
+        progress.time = elapsedSeconds();
+        progress.nodes = state.nodes_started.load();
+        progress.open_nodes = open_nodes;
+        progress.objective = objective + state.objective_offset;
+        progress.dual_bound = bound + state.objective_offset;
+        progress.gap = Solution::relativeGap(progress.objective, progress.dual_bound);
+        return progress;
+    }
+    
+    // 安装（或清除）当前搜索模式的进度快照函数
+    static void setSnapshot(SearchState& state, std::function<double(long long&)> snapshot) {
+        std::lock_guard<std::mutex> lock(state.report_mutex);
+        state.snapshot = std::move(snapshot);
+    }
+    
+    /*
+     * 搜索结束后把快照换成最终的界（仍在运行的启发式线程之后的报告使用它），
+     * 并记录剩余的开放节点数；搜索模式的快照引用的局部状态随后失效
      */
-    BranchBoundSolver() : simplex_solver_(false) {}
+    static void finishSnapshot(SearchState& state, const std::vector<std::unique_ptr<Worker>>& workers,
+                               double open_bound, long long open_nodes_left, ObjectiveType obj_type) {
+        for (const auto& worker : workers) {
+            double gap_bound = worker->gap_bound.load();
+            if (!std::isnan(gap_bound)) open_bound = combineBound(open_bound, gap_bound, obj_type);
+        }
+        state.open_nodes_left = open_nodes_left;
+        setSnapshot(state, [open_bound, open_nodes_left](long long& open_nodes) {
+            open_nodes = open_nodes_left;
+            return open_bound;
+        });
+    }
     
     /*
-     * 核心求解方法
+     * 到达报告时刻时给出INTERVAL进度；interval不为正时不做定时报告。
+     * 由搜索线程在节点（或轮次）之间调用，另一个线程正在回调时直接跳过
+     */
+    void maybeReportProgress(SearchState& state) {
+        if (!progress_callback_ || !(progress_interval_ > 0.0)) return;
+        long long now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - solve_start_).count();
+        if (now < state.next_report.load(std::memory_order_relaxed)) return;
+        std::unique_lock<std::mutex> lock(state.report_mutex, std::try_to_lock);
+        if (!lock.owns_lock() || now < state.next_report.load()) return;
+        state.next_report.store(now + static_cast<long long>(std::min(progress_interval_, kMaxTimeLimit) * 1e9));
+        progress_callback_(makeProgress(state, SolveProgress::Event::INTERVAL));
+    }
+    
+    bool stopRequested() const {
+        return stop_flag_ && stop_flag_->load(std::memory_order_relaxed);
+    }
+    
+    // 读取共享截断值（见setSharedCutoff），更紧时收紧剪枝用的目标值
+    void importSharedCutoff(SearchState& state) const {
+        if (!shared_cutoff_) return;
+        double cutoff = shared_cutoff_->load(std::memory_order_relaxed);
+        if (std::isfinite(cutoff)) state.incumbent.tighten(cutoff - state.objective_offset);
+    }
+    
+    /*
+     * 把剩余的开放节点导出为子树（见setOpenNodeOutput），取空nodes
      * 
-     * 实现完整的分支定界算法流程：
-     * 1. 初始化：设置根节点和最优值界限
-     * 2. 主循环：处理分支树中的每个节点
-     * 3. 线性松弛：使用单纯形法求解当前节点的LP松弛
-     * 4. 可行性检查：判断解是否满足整数约束
-     * 5. 分支操作：对非整数变量创建子问题
-     * 6. 剪枝判断：根据界限剪除不必要的分支
-     * 7. 结果返回：设置最终解的状态和数值
+     * 边界改变链从节点指向根，同一变量的多条记录取交集；树问题的变量都原样保留在原问题中，
+     * 换算下标后的边界在原问题上同样有效
+     */
+    void exportOpenNodes(NodeSelector<BBNode>& nodes, const SearchState& state) {
+        if (!open_node_output_) return;
+        while (!nodes.empty()) {
+            BBNode node = nodes.pop();
+            Subtree subtree;
+            subtree.bound = node.bound + state.objective_offset;
+            for (const BoundChange* change = node.bound_changes.get(); change; change = change->parent.get()) {
+                int j = state.mapping->variable(change->var_index);
+                size_t k = std::find(subtree.indices.begin(), subtree.indices.end(), j) - subtree.indices.begin();
+                if (k == subtree.indices.size()) {
+                    subtree.indices.push_back(j);
+                    subtree.lower.push_back(change->lower);
+                    subtree.upper.push_back(change->upper);
+                } else {
+                    subtree.lower[k] = std::max(subtree.lower[k], change->lower);
+                    subtree.upper[k] = std::min(subtree.upper[k], change->upper);
+                }
+            }
+            open_node_output_->push_back(std::move(subtree));
+        }
+    }
+    
+    // 由time_limit_得到截止时刻；非正、非有限或超过一年的限制视为不限时
+    std::chrono::steady_clock::time_point computeDeadline() const {
+        if (!(time_limit_ > 0.0) || time_limit_ > kMaxTimeLimit) {
+            return std::chrono::steady_clock::time_point::max();
+        }
+        return std::chrono::steady_clock::now() +
+               std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(time_limit_));
+    }
+    
+    bool timeLimitReached() const {
+        return deadline_ != std::chrono::steady_clock::time_point::max() && std::chrono::steady_clock::now() >= deadline_;
+    }
+    
+    // 由work_limit_得到以LP非零元计的预算；非正表示不限
+    long long computeWorkBudget() const {
+        if (!(work_limit_ > 0.0)) return std::numeric_limits<long long>::max();
+        double budget = work_limit_ * kWorkPerUnit;
+        if (budget >= static_cast<double>(std::numeric_limits<long long>::max())) return std::numeric_limits<long long>::max();
+        return static_cast<long long>(budget);
+    }
+    
+    // 发布新的整数解（仅当它优于当前最优解）
+    void publishIncumbent(SearchState& state, const NodeResult& result, int node_number) {
+        if (!state.incumbent.update(result.objective, result.solution)) return;
+        reportIncumbent(state, result.solution, result.objective);
+        if (!verbose_) return;
+        std::lock_guard<std::mutex> lock(state.log_mutex);
+        std::cout << "Node " << node_number << ": New integer solution found! Objective: " 
+                  << result.objective << " [";
+        for (size_t i = 0; i < result.solution.size(); ++i) {
+            std::cout << result.solution[i];
+            if (i < result.solution.size() - 1) std::cout << ", ";
+        }
+        std::cout << "]" << std::endl;
+    }
+    
+    /*
+     * 工作窃取树搜索
      * 
-     * @param problem: 要求解的混合整数规划问题
-     * @return: 包含最优解信息的Solution对象
+     * 每个线程从自己的节点池按节点选择策略取节点，子节点放回自己的池中；
+     * 本地池为空时依次尝试从其他线程的池中窃取（取走对方最不会马上处理的节点，
+     * 即深度优先栈底或最优界堆顶）。outstanding计数开放和正在处理的节点，
+     * 降为零时说明整棵树已搜索完毕。单线程时在调用线程上直接运行。
+     * 
+     * @return: 剩余开放节点的最好LP界
      */
-    Solution solve(const Problem& problem) override {
-        auto start_time = std::chrono::high_resolution_clock::now();
+    double runWorkStealing(const Problem& problem, std::vector<std::unique_ptr<Worker>>& workers,
+                           BBNode root_node, SearchState& state) {
+        int num_threads = static_cast<int>(workers.size());
+        std::vector<std::unique_ptr<NodePool>> pools;
+        for (int t = 0; t < num_threads; ++t) {
+            pools.push_back(std::make_unique<NodePool>());
+            pools.back()->nodes = createNodeSelector<BBNode>(node_selection_, problem.getObjectiveType());
+        }
         
-        if (verbose_) {
-            std::cout << "\n------- Branch & Bound Solver -------" << std::endl;
-            problem.printStatistics();
+        pools[0]->nodes->push(std::move(root_node));
+        state.outstanding.store(1);
+        
+        auto work = [&](int id) {
+            MIPSOLVER_TRACE_THREAD(trace_session_, "worker " + std::to_string(id));
+            MIPSOLVER_TRACE_SCOPE(SEARCH);
+            Worker& worker = *workers[id];
+            NodePool& own = *pools[id];
+            NodeResult result;
+            int idle_rounds = 0;
+            
+            while (!state.stop.load(std::memory_order_relaxed)) {
+                BBNode node;
+                bool found = false;
+                {
+                    std::lock_guard<std::mutex> lock(own.mutex);
+                    if (!own.nodes->empty()) {
+                        node = own.nodes->pop();
+                        worker.active_bound.store(node.bound);
+                        found = true;
+                    }
+                }
+                for (int k = 1; !found && k < num_threads; ++k) {
+                    NodePool& victim = *pools[(id + k) % num_threads];
+                    std::lock_guard<std::mutex> lock(victim.mutex);
+                    if (!victim.nodes->empty()) {
+                        node = victim.nodes->steal();
+                        worker.active_bound.store(node.bound);
+                        found = true;
+                    }
+                }
+                
+                if (!found) {
+                    if (state.outstanding.load() == 0) break;
+                    if (++idle_rounds > 16) {
+                        std::this_thread::sleep_for(std::chrono::microseconds(50));
+                    } else {
+                        std::this_thread::yield();
+                    }
+                    continue;
+                }
+                idle_rounds = 0;
+                
+                if (stopRequested() || timeLimitReached()) {
+                    // Keep the node open so that it still counts towards the dual bound
+                    std::lock_guard<std::mutex> lock(own.mutex);
+                    own.nodes->push(std::move(node));
+                    worker.active_bound.store(std::numeric_limits<double>::quiet_NaN());
+                    (stopRequested() ? state.interrupted : state.time_limit_reached).store(true);
+                    state.stop.store(true);
+                    break;
+                }
+                
+                if (state.work.load(std::memory_order_relaxed) >= work_budget_) {
+                    std::lock_guard<std::mutex> lock(own.mutex);
+                    own.nodes->push(std::move(node));
+                    worker.active_bound.store(std::numeric_limits<double>::quiet_NaN());
+                    state.work_limit_reached.store(true);
+                    state.stop.store(true);
+                    break;
+                }
+                
+                int node_number = state.nodes_started.fetch_add(1) + 1;
+                if (node_number > iteration_limit_) {
+                    // Keep the node open so that it still counts towards the dual bound
+                    std::lock_guard<std::mutex> lock(own.mutex);
+                    own.nodes->push(std::move(node));
+                    worker.active_bound.store(std::numeric_limits<double>::quiet_NaN());
+                    state.limit_reached.store(true);
+                    state.stop.store(true);
+                    break;
+                }
+                
+                if (verbose_ && node_number % 10 == 0) {
+                    std::lock_guard<std::mutex> lock(state.log_mutex);
+                    std::cout << "Processed " << node_number << " nodes, best: " 
+                              << state.incumbent.objective() << std::endl;
+                }
+                
+                importSharedCutoff(state);
+                processNode(worker, node, state.incumbent.objective(), problem, state, node_number, result);
+                state.work.fetch_add(result.work, std::memory_order_relaxed);
+                pseudocosts_.record(result.observations);
+                switch (result.kind) {
+                    case NodeResult::Kind::UNBOUNDED:
+                        state.unbounded.store(true);
+                        state.stop.store(true);
+                        break;
+                    case NodeResult::Kind::INTEGER:
+                        publishIncumbent(state, result, node_number);
+                        break;
+                    case NodeResult::Kind::BRANCHED: {
+                        // Count the children before retiring the parent so that outstanding never dips to zero early
+                        state.outstanding.fetch_add(2);
+                        std::lock_guard<std::mutex> lock(own.mutex);
+                        // The left child is pushed last so depth-first explores it first
+                        own.nodes->push(std::move(result.right_child));
+                        own.nodes->push(std::move(result.left_child));
+                        break;
+                    }
+                    case NodeResult::Kind::UNFINISHED: {
+                        state.outstanding.fetch_add(1);
+                        std::lock_guard<std::mutex> lock(own.mutex);
+                        own.nodes->push(std::move(node));
+                        state.time_limit_reached.store(true);
+                        state.stop.store(true);
+                        break;
+                    }
+                    case NodeResult::Kind::PRUNED:
+                        break;
+                }
+                // Children are already in the pool, so the bound never loses this subtree
+                worker.active_bound.store(std::numeric_limits<double>::quiet_NaN());
+                state.outstanding.fetch_sub(1);
+                maybeReportProgress(state);
+            }
+        };
+        
+        ObjectiveType obj_type = problem.getObjectiveType();
+        double worst = (obj_type == ObjectiveType::MINIMIZE) ? std::numeric_limits<double>::infinity()
+                                                             : -std::numeric_limits<double>::infinity();
+        auto accumulate = [&](double bound, double into) {
+            return std::isnan(bound) ? into : combineBound(into, bound, obj_type);
+        };
+        setSnapshot(state, [&](long long& open_nodes) {
+            // Active bounds are read before and after the pools so that a node moving from
+            // a worker to a pool (or back) is seen at least once in the common case
+            double bound = worst;
+            for (const auto& worker : workers) {
+                bound = accumulate(worker->active_bound.load(), bound);
+                bound = accumulate(worker->gap_bound.load(), bound);
+            }
+            for (const auto& pool : pools) {
+                std::lock_guard<std::mutex> lock(pool->mutex);
+                bound = combineBound(bound, pool->nodes->bestBound(), obj_type);
+            }
+            for (const auto& worker : workers) {
+                bound = accumulate(worker->active_bound.load(), bound);
+            }
+            open_nodes = state.outstanding.load();
+            return bound;
+        });
+        
+        std::vector<std::thread> threads;
+        for (int t = 1; t < num_threads; ++t) {
+            threads.emplace_back(work, t);
+        }
+        work(0);
+        for (auto& thread : threads) {
+            thread.join();
         }
         
-        Solution solution(problem.getNumVariables());
+        double open_bound = worst;
+        long long open_nodes_left = 0;
+        for (const auto& pool : pools) {
+            open_bound = combineBound(open_bound, pool->nodes->bestBound(), obj_type);
+            open_nodes_left += static_cast<long long>(pool->nodes->size());
+        }
+        finishSnapshot(state, workers, open_bound, open_nodes_left, obj_type);
+        for (const auto& pool : pools) {
+            exportOpenNodes(*pool->nodes, state);
+        }
+        return open_bound;
+    }
+    
+    /*
+     * 确定性轮次搜索
+     * 
+     * 全局只有一个节点池。每一轮按节点选择顺序取出至多num_threads个节点，
+     * 以本轮开始时的最优值为剪枝界并行处理；轮末按取出顺序合并结果
+     * （更新最优解、压入子节点）。节点LP只依赖于节点本身的边界和热启动基，
+     * 与处理它的线程无关；伪成本观测和割池检查也在轮末按顺序进行，
+     * 轮内伪成本和各线程的LP行都只读，
+     * 因此相同输入的搜索过程和结果完全一致。
+     * 
+     * @return: 剩余开放节点的最好LP界
+     */
+    double runDeterministic(const Problem& problem, std::vector<std::unique_ptr<Worker>>& workers,
+                            BBNode root_node, SearchState& state) {
+        int num_threads = static_cast<int>(workers.size());
+        std::unique_ptr<NodeSelector<BBNode>> open_nodes =
+            createNodeSelector<BBNode>(node_selection_, problem.getObjectiveType());
+        open_nodes->push(std::move(root_node));
         
-        // Initialize branch and bound
-        double best_objective = (problem.getObjectiveType() == ObjectiveType::MINIMIZE) ? 
-                               std::numeric_limits<double>::infinity() : 
-                               -std::numeric_limits<double>::infinity();
-        std::vector<double> best_solution(problem.getNumVariables(), 0.0);
+        std::vector<BBNode> batch;
+        std::vector<NodeResult> results;
+        int first_number = 0;
+        double round_objective = 0.0;
         
-        // Create root node - use a STACK for depth-first search
-        std::vector<BBNode> node_stack;
+        // Persistent helper threads wait for a new round, process their share and report back
+        std::mutex round_mutex;
+        std::condition_variable round_start;
+        std::condition_variable round_done;
+        int generation = 0;
+        int pending = 0;
+        bool quit = false;
         
-        BBNode root_node;
-        root_node.problem = problem;
-        root_node.depth = 0;
-        root_node.bound = (problem.getObjectiveType() == ObjectiveType::MINIMIZE) ? 
-                          -std::numeric_limits<double>::infinity() : 
-                          std::numeric_limits<double>::infinity();
+        auto process_share = [&](int id) {
+            for (size_t i = id; i < batch.size(); i += num_threads) {
+                processNode(*workers[id], batch[i], round_objective, problem, state,
+                            first_number + static_cast<int>(i) + 1, results[i]);
+            }
+        };
+        auto helper = [&](int id) {
+            MIPSOLVER_TRACE_THREAD(trace_session_, "worker " + std::to_string(id));
+            int seen = 0;
+            std::unique_lock<std::mutex> lock(round_mutex);
+            while (true) {
+                round_start.wait(lock, [&] { return quit || generation != seen; });
+                if (quit) return;
+                seen = generation;
+                lock.unlock();
+                process_share(id);
+                lock.lock();
+                if (--pending == 0) round_done.notify_one();
+            }
+        };
         
-        node_stack.push_back(root_node);
+        std::vector<std::thread> threads;
+        for (int t = 1; t < num_threads; ++t) {
+            threads.emplace_back(helper, t);
+        }
         
-        int nodes_processed = 0;
-        int nodes_pruned = 0;
+        MIPSOLVER_TRACE_SCOPE(SEARCH);
         
-        while (!node_stack.empty() && nodes_processed < iteration_limit_) {
-            BBNode current_node = node_stack.back();
-            node_stack.pop_back();
-            nodes_processed++;
-            
-            if (verbose_ && nodes_processed % 10 == 0) {
-                std::cout << "Processed " << nodes_processed << " nodes, best: " << best_objective << std::endl;
+        // Snapshots are only taken between rounds or from the merge, never while the batch is being filled
+        ObjectiveType obj_type = problem.getObjectiveType();
+        setSnapshot(state, [&](long long& open_nodes_count) {
+            double bound = open_nodes->bestBound();
+            for (const BBNode& node : batch) {
+                bound = combineBound(bound, node.bound, obj_type);
             }
-            
-            // Solve LP relaxation for current node
-            SimplexSolver::SimplexResult lp_result = simplex_solver_.solveLPRelaxation(current_node.problem);
-            
-            // Check if LP is infeasible
-            if (lp_result.is_infeasible) {
-                nodes_pruned++;
-                if (verbose_) {
-                    std::cout << "Node " << nodes_processed << ": LP infeasible, pruned" << std::endl;
-                }
-                continue;
+            for (const auto& worker : workers) {
+                double gap_bound = worker->gap_bound.load();
+                if (!std::isnan(gap_bound)) bound = combineBound(bound, gap_bound, obj_type);
             }
-            
-            // Check if LP is unbounded
-            if (lp_result.is_unbounded) {
-                if (problem.getObjectiveType() == ObjectiveType::MINIMIZE) {
-                    solution.setStatus(Solution::Status::UNBOUNDED);
-                    return solution;
-                }
+            open_nodes_count = static_cast<long long>(open_nodes->size() + batch.size());
+            return bound;
+        });
+        
+        while (!open_nodes->empty()) {
+            if (stopRequested()) {
+                state.interrupted.store(true);
+                break;
             }
-            
-            if (verbose_) {
-                std::cout << "Node " << nodes_processed << " at depth " << current_node.depth 
-                          << ": LP obj = " << lp_result.objective_value << std::endl;
+            if (timeLimitReached()) {
+                state.time_limit_reached.store(true);
+                break;
             }
-            
-            // Check bound (pruning condition)
-            if (shouldPrune(lp_result.objective_value, best_objective, problem.getObjectiveType())) {
-                nodes_pruned++;
-                if (verbose_) {
-                    std::cout << "Node " << nodes_processed << ": Bound " << lp_result.objective_value 
-                              << " pruned (current best: " << best_objective << ")" << std::endl;
-                }
-                continue;
+            if (state.work.load() >= work_budget_) {
+                state.work_limit_reached.store(true);
+                break;
             }
-            
-            // Check if solution is integer feasible
-            if (isIntegerFeasible(lp_result.solution, problem)) {
-                // Found feasible integer solution
-                if (isBetterSolution(lp_result.objective_value, best_objective, problem.getObjectiveType())) {
-                    best_objective = lp_result.objective_value;
-                    best_solution = lp_result.solution;
-                    
-                    if (verbose_) {
-                        std::cout << "Node " << nodes_processed << ": New integer solution found! Objective: " 
-                                  << best_objective << " [";
-                        for (size_t i = 0; i < best_solution.size(); ++i) {
-                            std::cout << best_solution[i];
-                            if (i < best_solution.size() - 1) std::cout << ", ";
-                        }
-                        std::cout << "]" << std::endl;
-                    }
-                }
-                continue;
+            if (state.nodes_started.load() >= iteration_limit_) {
+                state.limit_reached.store(true);
+                break;
             }
             
-            // Branch: find most fractional variable
-            int branch_var = findBranchingVariable(lp_result.solution, problem);
-            if (branch_var == -1) {
-                if (verbose_) {
-                    std::cout << "Node " << nodes_processed << ": No fractional variables found, skipping" << std::endl;
-                }
-                continue;
+            batch.clear();
+            while (static_cast<int>(batch.size()) < num_threads && !open_nodes->empty() &&
+                   state.nodes_started.load() + static_cast<int>(batch.size()) < iteration_limit_) {
+                batch.push_back(open_nodes->pop());
             }
+            if (results.size() < batch.size()) results.resize(batch.size());
+            first_number = state.nodes_started.load();
+            importSharedCutoff(state);
+            round_objective = state.incumbent.objective();
             
-            double branch_value = lp_result.solution[branch_var];
-            
-            if (verbose_) {
-                std::cout << "Node " << nodes_processed << ": Branching on x" << branch_var 
-                          << " = " << branch_value << std::endl;
+            {
+                std::lock_guard<std::mutex> lock(round_mutex);
+                pending = num_threads - 1;
+                generation++;
+            }
+            round_start.notify_all();
+            process_share(0);
+            {
+                std::unique_lock<std::mutex> lock(round_mutex);
+                round_done.wait(lock, [&] { return pending == 0; });
             }
             
-            // Create two child nodes
-            BBNode right_child = current_node;
-            BBNode left_child = current_node;
-            
-            left_child.depth = current_node.depth + 1;
-            right_child.depth = current_node.depth + 1;
-            
-            // Left child: x[branch_var] <= floor(branch_value)
-            double floor_val = std::floor(branch_value);
-            addBound(left_child.problem, branch_var, -std::numeric_limits<double>::infinity(), floor_val);
-            left_child.bound = lp_result.objective_value;
-            
-            // Right child: x[branch_var] >= ceil(branch_value)  
-            double ceil_val = std::ceil(branch_value);
-            addBound(right_child.problem, branch_var, ceil_val, std::numeric_limits<double>::infinity());
-            right_child.bound = lp_result.objective_value;
-            
-            // Add children to stack
-            node_stack.push_back(right_child);
-            node_stack.push_back(left_child);
+            // Merge in selection order
+            for (size_t i = 0; i < batch.size(); ++i) {
+                NodeResult& result = results[i];
+                int node_number = first_number + static_cast<int>(i) + 1;
+                state.work.fetch_add(result.work);
+                pseudocosts_.record(result.observations);
+                if (!result.separation_point.empty()) {
+                    cut_pool_.separate(result.separation_point, kLocalCutsPerNode, kMinCutEfficacy);
+                }
+                if (result.kind == NodeResult::Kind::UNBOUNDED) {
+                    state.unbounded.store(true);
+                } else if (result.kind == NodeResult::Kind::INTEGER) {
+                    publishIncumbent(state, result, node_number);
+                } else if (result.kind == NodeResult::Kind::BRANCHED) {
+                    open_nodes->push(std::move(result.right_child));
+                    open_nodes->push(std::move(result.left_child));
+                } else if (result.kind == NodeResult::Kind::UNFINISHED) {
+                    open_nodes->push(batch[i]);
+                    state.time_limit_reached.store(true);
+                }
+            }
+            state.nodes_started.fetch_add(static_cast<int>(batch.size()));
+            batch.clear();
+            if (state.unbounded.load() || state.time_limit_reached.load()) break;
+            maybeReportProgress(state);
             
             if (verbose_) {
-                std::cout << "Node " << nodes_processed << ": Created 2 children (depths " 
-                          << left_child.depth << ", " << right_child.depth << ")" << std::endl;
+                std::cout << "Processed " << state.nodes_started.load() << " nodes, best: " 
+                          << state.incumbent.objective() << ", open: " << open_nodes->size() << std::endl;
             }
         }
         
-        // Set final solution
-        for (int i = 0; i < problem.getNumVariables(); ++i) {
-            solution.setValue(i, best_solution[i]);
-        }
-        solution.setObjectiveValue(best_objective);
-        solution.setIterations(nodes_processed);
-        
-        auto end_time = std::chrono::high_resolution_clock::now();
-        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
-        solution.setSolveTime(duration.count() / 1000.0);
-        
-        // Set solution status
-        if (best_objective == std::numeric_limits<double>::infinity() || 
-            best_objective == -std::numeric_limits<double>::infinity()) {
-            solution.setStatus(Solution::Status::INFEASIBLE);
-        } else if (nodes_processed >= iteration_limit_) {
-            solution.setStatus(Solution::Status::ITERATION_LIMIT);
-        } else {
-            solution.setStatus(Solution::Status::OPTIMAL);
+        {
+            std::lock_guard<std::mutex> lock(round_mutex);
+            quit = true;
         }
-        
-        if (verbose_) {
-            std::cout << "\n------- Branch & Bound Complete -------" << std::endl;
-            std::cout << "Nodes processed: " << nodes_processed << std::endl;
-            std::cout << "Nodes pruned: " << nodes_pruned << std::endl;
-            solution.print();
+        round_start.notify_all();
+        for (auto& thread : threads) {
+            thread.join();
         }
         
-        return solution;
+        double open_bound = open_nodes->bestBound();
+        finishSnapshot(state, workers, open_bound, static_cast<long long>(open_nodes->size()), obj_type);
+        exportOpenNodes(*open_nodes, state);
+        return open_bound;
     }
-
-private:
-    SimplexSolver simplex_solver_;  // 内部单纯形求解器，用于求解线性松弛问题
-    
-    /*
-     * 分支节点结构
-     * 
-     * 表示分支树中的一个节点，包含：
-     * - problem: 当前节点对应的子问题（包含额外的边界约束）
-     * - bound: 当前节点的线性松弛最优值（用于剪枝判断）
-     * - depth: 节点在分支树中的深度（用于调试和统计）
-     */
-    struct BBNode {
-        Problem problem;  // 子问题定义
-        double bound;     // 线性松弛界限
-        int depth;        // 分支深度
-    };
     
     /*
      * 剪枝判断函数
@@ -256,11 +2369,11 @@ private:
      * @param node_bound: 当前节点的界限值
      * @param best_objective: 当前已知的最优目标函数值
      * @param obj_type: 目标函数类型（最大化或最小化）
+     * @param tolerance: 节点界至少要把最优值改进这么多才继续探索
      * @return: true表示可以剪枝，false表示需要继续探索
      */
-    bool shouldPrune(double node_bound, double best_objective, ObjectiveType obj_type) {
-        const double tolerance = 1e-6;
-        
+    static bool shouldPrune(double node_bound, double best_objective, ObjectiveType obj_type,
+                            double tolerance = kPruneTolerance) {
         if (obj_type == ObjectiveType::MINIMIZE) {
             return node_bound >= best_objective - tolerance;
         } else {
@@ -268,6 +2381,82 @@ private:
         }
     }
     
+    // 剪枝容差：精确容差与用户给定的最优性间隙中较大的一个
+    double pruneTolerance(double best_objective) const {
+        if (!std::isfinite(best_objective)) return kPruneTolerance;
+        return std::max({kPruneTolerance, absolute_gap_, relative_gap_ * std::abs(best_objective)});
+    }
+    
+    // 按间隙容差剪枝；仅因间隙被剪除的节点把它的界记入该线程的gap_bound
+    bool pruneByBound(Worker& worker, double bound, double best_objective, ObjectiveType obj_type) const {
+        if (!shouldPrune(bound, best_objective, obj_type, pruneTolerance(best_objective))) return false;
+        if (!shouldPrune(bound, best_objective, obj_type)) recordAbandonedBound(worker, bound, obj_type);
+        return true;
+    }
+    
+    // 没有搜索完的节点的界记入该线程的gap_bound
+    static void recordAbandonedBound(Worker& worker, double bound, ObjectiveType obj_type) {
+        double previous = worker.gap_bound.load(std::memory_order_relaxed);
+        worker.gap_bound.store(std::isnan(previous) ? bound : combineBound(previous, bound, obj_type),
+                               std::memory_order_relaxed);
+    }
+    
+    /*
+     * 界合并函数
+     * 
+     * 返回两个界中较弱（对最小化较小、对最大化较大）的一个。
+     * 全局对偶界 = 开放节点最好LP界与当前最优值的合并；树搜索完毕时等于最优值
+     */
+    static double combineBound(double a, double b, ObjectiveType obj_type) {
+        if (obj_type == ObjectiveType::MINIMIZE) {
+            return std::min(a, b);
+        } else {
+            return std::max(a, b);
+        }
+    }
+    
+    static double objectiveSense(const Problem& problem) {
+        return problem.getObjectiveType() == ObjectiveType::MINIMIZE ? 1.0 : -1.0;
+    }
+    
+    /*
+     * 子树最优整数解估计
+     * 
+     * 在LP目标值基础上，为每个分数整数变量加上把它取整的预计目标损失：
+     * 取向下（伪成本×f）和向上（伪成本×(1-f)）中较小的一个；
+     * 还没有任何伪成本观测时，以该变量目标系数的绝对值作为单位损失
+     */
+    template <typename Vars>
+    double estimateObjective(Worker& worker, const typename Vars::Propagator& domain,
+                             const SimplexSolver::SimplexResult& lp_result, const Problem& problem) {
+        std::vector<int>& fractional_vars = worker.candidates;
+        fractional_vars.clear();
+        const std::vector<VariableType>& types = problem.getVariableTypes();
+        const int n = problem.getNumVariables();
+        for (int i = Vars::firstCandidate(domain); i < n; i = Vars::nextCandidate(domain, i)) {
+            if (!Vars::isInteger(types[i])) continue;
+            double val = lp_result.solution[i];
+            if (val != std::floor(val)) fractional_vars.push_back(i);
+        }
+        
+        bool use_pseudocosts = !pseudocosts_.empty();
+        std::vector<PseudocostTable::Entry>& entries = worker.entries;
+        if (use_pseudocosts) pseudocosts_.lookup(fractional_vars, entries);
+        
+        double degradation = 0.0;
+        for (size_t k = 0; k < fractional_vars.size(); ++k) {
+            int i = fractional_vars[k];
+            double val = lp_result.solution[i];
+            double fractional = val - std::floor(val);
+            if (use_pseudocosts) {
+                degradation += std::min(entries[k].down * fractional, entries[k].up * (1.0 - fractional));
+            } else {
+                degradation += std::min(fractional, 1.0 - fractional) * std::abs(problem.getObjectiveCoefficients()[i]);
+            }
+        }
+        return lp_result.objective_value + objectiveSense(problem) * degradation;
+    }
+    
     /*
      * 解质量比较函数
      * 
@@ -279,7 +2468,7 @@ private:
      * @param obj_type: 目标函数类型
      * @return: true表示新解更好，false表示当前解更好或相等
      */
-    bool isBetterSolution(double new_obj, double current_best, ObjectiveType obj_type) {
+    static bool isBetterSolution(double new_obj, double current_best, ObjectiveType obj_type) {
         const double tolerance = 1e-6;
         
         if (obj_type == ObjectiveType::MINIMIZE) {
@@ -293,22 +2482,23 @@ private:
      * 整数可行性检查函数
      * 
      * 检查给定的解是否满足所有整数变量的整数约束
-     * 使用数值容忍度处理浮点误差
+     * 使用数值容忍度处理浮点误差；纯0-1问题只检查当前定义域中的自由变量
      * 
      * @param solution: 待检查的解向量
      * @param problem: 原问题定义（包含变量类型信息）
+     * @param domain: 产生该解的节点定义域
      * @return: true表示解满足整数约束，false表示存在非整数的整数变量
      */
-    bool isIntegerFeasible(const std::vector<double>& solution, const Problem& problem) {
+    template <typename Vars>
+    static bool isIntegerFeasible(const std::vector<double>& solution, const Problem& problem,
+                                  const typename Vars::Propagator& domain) {
         const double tolerance = 1e-6;
+        const std::vector<VariableType>& types = problem.getVariableTypes();
+        const int n = problem.getNumVariables();
         
-        for (int i = 0; i < problem.getNumVariables(); ++i) {
-            const Variable& var = problem.getVariable(i);
-            if (var.getType() == VariableType::INTEGER || var.getType() == VariableType::BINARY) {
-                double val = solution[i];
-                if (std::abs(val - std::round(val)) > tolerance) {
-                    return false;
-                }
+        for (int i = Vars::firstCandidate(domain); i < n; i = Vars::nextCandidate(domain, i)) {
+            if (Vars::isInteger(types[i]) && Vars::fractionality(solution[i]) > tolerance) {
+                return false;
             }
         }
         return true;
@@ -324,19 +2514,22 @@ private:
      * 
      * @param solution: 当前线性松弛的最优解
      * @param problem: 问题定义（包含变量类型信息）
+     * @param domain: 当前节点的定义域（纯0-1问题跳过已固定的变量）
      * @return: 选中的分支变量索引，-1表示没有需要分支的变量
      */
-    int findBranchingVariable(const std::vector<double>& solution, const Problem& problem) {
+    template <typename Vars>
+    static int findBranchingVariable(const std::vector<double>& solution, const Problem& problem,
+                                     const typename Vars::Propagator& domain) {
         int branch_var = -1;
         double max_fractional = 0.0;
         const double tolerance = 1e-6;
+        const std::vector<VariableType>& types = problem.getVariableTypes();
+        const int n = problem.getNumVariables();
         
         // 遍历所有变量，寻找分数部分最大的整数变量
-        for (int i = 0; i < problem.getNumVariables(); ++i) {
-            const Variable& var = problem.getVariable(i);
-            if (var.getType() == VariableType::INTEGER || var.getType() == VariableType::BINARY) {
-                double val = solution[i];
-                double fractional_part = std::abs(val - std::round(val));
+        for (int i = Vars::firstCandidate(domain); i < n; i = Vars::nextCandidate(domain, i)) {
+            if (Vars::isInteger(types[i])) {
+                double fractional_part = Vars::fractionality(solution[i]);
                 
                 if (fractional_part > tolerance && fractional_part > max_fractional) {
                     max_fractional = fractional_part;
@@ -348,26 +2541,173 @@ private:
         return branch_var;
     }
     
+    /*
+     * 分支变量选择函数
+     * 
+     * 按branching_rule_选择分支变量：
+     * - MOST_FRACTIONAL: findBranchingVariable
+     * - PSEUDOCOST: 伪成本乘积打分最高者
+     * - RELIABILITY: 伪成本不可靠的候选先做强分支，用真实恶化量打分
+     * - LEARNED: 由ml_branching_按候选特征打分
+     * 
+     * 强分支在当前节点的工作边界上临时收紧分支变量，从节点最优基出发
+     * 做有限迭代的对偶单纯形；两个方向都不可行（或都被当前最优值剪枝）时，
+     * 节点本身可以剪枝，由node_infeasible返回
+     * 
+     * @param domain: 当前节点的定义域，强分支在其上临时收紧
+     * @param observations: 强分支得到的伪成本观测追加到这里
+     * @return: 分支变量索引，-1表示没有需要分支的变量
+     */
+    template <typename Vars>
+    int selectBranchingVariable(Worker& worker, typename Vars::Propagator& domain,
+                                const SimplexSolver::SimplexResult& lp_result,
+                                const Problem& problem, double best_objective,
+                                std::vector<PseudocostObservation>& observations, bool& node_infeasible) {
+        if (branching_rule_ == BranchingRule::MOST_FRACTIONAL) {
+            return findBranchingVariable<Vars>(lp_result.solution, problem, domain);
+        }
+        
+        const double tolerance = 1e-6;
+        const std::vector<double>& x = lp_result.solution;
+        std::vector<int>& candidates = worker.candidates;
+        candidates.clear();
+        const std::vector<VariableType>& types = problem.getVariableTypes();
+        const int n = problem.getNumVariables();
+        for (int i = Vars::firstCandidate(domain); i < n; i = Vars::nextCandidate(domain, i)) {
+            if (!Vars::isInteger(types[i])) continue;
+            if (Vars::fractionality(x[i]) > tolerance) candidates.push_back(i);
+        }
+        if (candidates.empty()) return -1;
+        
+        std::vector<PseudocostTable::Entry>& entries = worker.entries;
+        pseudocosts_.lookup(candidates, entries);
+        
+        if (branching_rule_ == BranchingRule::LEARNED && ml_branching_) {
+            std::vector<MLBranchingStrategy::BranchingFeatures>& features = worker.features;
+            features.assign(problem.getNumVariables(), MLBranchingStrategy::BranchingFeatures());
+            int num_rows = std::max(1, problem.getNumConstraints());
+            for (size_t k = 0; k < candidates.size(); ++k) {
+                int j = candidates[k];
+                double down = x[j] - std::floor(x[j]);
+                MLBranchingStrategy::BranchingFeatures& f = features[j];
+                f.pseudocost_down = entries[k].down * down;
+                f.pseudocost_up = entries[k].up * (1.0 - down);
+                f.infeasibility = std::min(down, 1.0 - down);
+                f.obj_coefficient = std::abs(problem.getObjectiveCoefficients()[j]);
+                f.constraint_density = static_cast<double>(problem.getMatrix().column(j).size) / num_rows;
+                f.variable_age = entries[k].down_count + entries[k].up_count;
+            }
+            return ml_branching_->selectBranchingVariable(problem, x, features);
+        }
+        
+        std::vector<double>& scores = worker.scores;
+        scores.assign(candidates.size(), 0.0);
+        size_t best = 0;
+        for (size_t k = 0; k < candidates.size(); ++k) {
+            double down = x[candidates[k]] - std::floor(x[candidates[k]]);
+            scores[k] = PseudocostTable::score(entries[k].down * down, entries[k].up * (1.0 - down));
+            if (scores[k] > scores[best]) best = k;
+        }
+        if (branching_rule_ != BranchingRule::RELIABILITY) {
+            return candidates[best];
+        }
+        
+        // Unreliable candidates, most promising (by pseudocost score) first
+        std::vector<size_t>& unreliable = worker.unreliable;
+        unreliable.clear();
+        for (size_t k = 0; k < candidates.size(); ++k) {
+            if (std::min(entries[k].down_count, entries[k].up_count) < branching_params_.reliability_threshold) {
+                unreliable.push_back(k);
+            }
+        }
+        if (unreliable.empty()) return candidates[best];
+        std::stable_sort(unreliable.begin(), unreliable.end(),
+                         [&](size_t a, size_t b) { return scores[a] > scores[b]; });
+        if (static_cast<int>(unreliable.size()) > branching_params_.max_strong_candidates) {
+            unreliable.resize(branching_params_.max_strong_candidates);
+        }
+        
+        SimplexSolver::Basis& basis = worker.basis_scratch;
+        worker.simplex.getBasis(basis);
+        const double sense = objectiveSense(problem);
+        const double cutoff_gain = 1e20;  // Stand-in degradation for an infeasible or cut-off child
+        worker.simplex.setIterationLimit(branching_params_.strong_iteration_limit);
+        
+        // Degradation of one strong-branching child; records an observation when its LP was solved
+        auto probe = [&](int j, bool up, double distance, double estimate) {
+            size_t mark = domain.mark();
+            bool feasible = up ? domain.tightenLower(j, std::ceil(x[j]))
+                               : domain.tightenUpper(j, std::floor(x[j]));
+            feasible = feasible && (!domain_propagation_ || domain.propagate());
+            SimplexSolver::SimplexResult& child = worker.lp_scratch;
+            if (feasible) {
+                worker.simplex.solveWithBounds(domain.lower(), domain.upper(), &basis, child);
+                worker.lp_iterations += child.iterations;
+            }
+            domain.undo(mark);
+            
+            if (!feasible || child.is_infeasible) return cutoff_gain;
+            if (!child.is_optimal) return estimate;
+            double gain = std::max(0.0, sense * (child.objective_value - lp_result.objective_value));
+            observations.push_back({j, up, gain / distance});
+            if (shouldPrune(child.objective_value, best_objective, problem.getObjectiveType(),
+                            pruneTolerance(best_objective))) return cutoff_gain;
+            return gain;
+        };
+        
+        // Strong-branching scores replace the pseudocost estimates they were ranked by
+        size_t strong_best = unreliable.front();
+        double strong_best_score = -1.0;
+        int without_improvement = 0;
+        for (size_t k : unreliable) {
+            int j = candidates[k];
+            double down = x[j] - std::floor(x[j]);
+            double down_gain = probe(j, false, down, entries[k].down * down);
+            double up_gain = probe(j, true, 1.0 - down, entries[k].up * (1.0 - down));
+            
+            if (down_gain >= cutoff_gain && up_gain >= cutoff_gain) {
+                node_infeasible = true;
+                break;
+            }
+            
+            scores[k] = PseudocostTable::score(down_gain, up_gain);
+            if (scores[k] > strong_best_score) {
+                strong_best = k;
+                strong_best_score = scores[k];
+                without_improvement = 0;
+            } else if (++without_improvement >= branching_params_.strong_lookahead) {
+                break;
+            }
+        }
+        worker.simplex.setIterationLimit(lp_iteration_limit_);
+        if (node_infeasible) return -1;
+        
+        // A reliable candidate still wins if its pseudocost score beats every strong-branching score
+        best = strong_best;
+        for (size_t k = 0; k < candidates.size(); ++k) {
+            bool reliable = std::min(entries[k].down_count, entries[k].up_count) >= branching_params_.reliability_threshold;
+            if (reliable && scores[k] > scores[best]) best = k;
+        }
+        return candidates[best];
+    }
+    
     /*
      * 添加变量边界约束函数
      * 
-     * 为指定变量添加新的边界约束，用于分支操作
-     * 新边界与原边界取交集，确保约束只会更加严格
+     * 在父节点的边界改变链上追加一条记录，用于分支操作
+     * 激活节点时新边界与已有边界取交集，确保约束只会更加严格。
+     * 记录与其控制块一起从worker的块池分配
      * 
-     * @param problem: 要修改的问题实例
+     * @param parent: 父节点的边界改变链
      * @param var_index: 目标变量的索引
      * @param lower: 新的下界
      * @param upper: 新的上界
+     * @return: 子节点的边界改变链
      */
-    void addBound(Problem& problem, int var_index, double lower, double upper) {
-        Variable& var = problem.getVariable(var_index);
-        double current_lower = var.getLowerBound();
-        double current_upper = var.getUpperBound();
-        
-        double new_lower = std::max(current_lower, lower);
-        double new_upper = std::min(current_upper, upper);
-        
-        var.setBounds(new_lower, new_upper);
+    std::shared_ptr<const BoundChange> addBound(Worker& worker, const std::shared_ptr<const BoundChange>& parent,
+                                                int var_index, double lower, double upper) {
+        return std::allocate_shared<const BoundChange>(PoolAllocator<BoundChange>(worker.node_blocks),
+                                                       BoundChange{var_index, lower, upper, parent});
     }
 };
 
@@ -0,0 +1,188 @@
+#ifndef BRANCHING_H
+#define BRANCHING_H
+
+/*
+ * 分支变量选择
+ *
+ * 1. MOST_FRACTIONAL（最大分数部分）：
+ *    - 选择离整数最远的变量，实现简单但效果接近随机选择
+ *
+ * 2. PSEUDOCOST（伪成本）：
+ *    - 记录每个变量向下/向上分支时，单位分数距离带来的LP目标恶化量
+ *    - 以 score = max(Δ下, ε) × max(Δ上, ε) 的乘积规则打分
+ *
+ * 3. RELIABILITY（可靠性分支，默认）：
+ *    - 伪成本观测次数不足阈值的变量先做有限迭代的强分支，
+ *      用真实的子节点LP恶化量打分并初始化其伪成本
+ *    - 观测足够后退化为纯伪成本分支
+ *
+ * 4. LEARNED（学习打分）：
+ *    - 为每个候选变量提取特征（见MLBranchingStrategy::BranchingFeatures），
+ *      由 MLBranchingStrategy 的打分模型选择分支变量
+ *
+ * 伪成本表在并行搜索的所有线程间共享，读写均在内部加锁。
+ */
+
+#include <vector>
+#include <mutex>
+#include <algorithm>
+
+namespace MIPSolver {
+
+enum class BranchingRule {
+    MOST_FRACTIONAL,
+    PSEUDOCOST,
+    RELIABILITY,
+    LEARNED
+};
+
+struct BranchingParameters {
+    int reliability_threshold = 4;     // 每个方向至少这么多次观测才视为可靠
+    int max_strong_candidates = 8;     // 每个节点最多强分支的候选数
+    int strong_lookahead = 4;          // 连续这么多个候选没有改进最好分数时停止强分支
+    int strong_iteration_limit = 100;  // 强分支子LP的单纯形迭代上限
+};
+
+// 单次观测：对变量var在某个方向分支后，单位分数距离的目标恶化量
+struct PseudocostObservation {
+    int var_index;
+    bool up;
+    double gain;
+};
+
+class PseudocostTable {
+public:
+    struct Entry {
+        double down;     // 平均向下单位恶化量（无观测时为全局平均）
+        double up;       // 平均向上单位恶化量
+        int down_count;
+        int up_count;
+    };
+
+    void resize(int num_variables) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        sum_down_.assign(num_variables, 0.0);
+        sum_up_.assign(num_variables, 0.0);
+        count_down_.assign(num_variables, 0);
+        count_up_.assign(num_variables, 0);
+        total_down_ = total_up_ = 0.0;
+        total_down_count_ = total_up_count_ = 0;
+    }
+
+    void record(const std::vector<PseudocostObservation>& observations) {
+        if (observations.empty()) return;
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const PseudocostObservation& obs : observations) {
+            double gain = std::max(obs.gain, 0.0);
+            if (obs.up) {
+                sum_up_[obs.var_index] += gain;
+                count_up_[obs.var_index]++;
+                total_up_ += gain;
+                total_up_count_++;
+            } else {
+                sum_down_[obs.var_index] += gain;
+                count_down_[obs.var_index]++;
+                total_down_ += gain;
+                total_down_count_++;
+            }
+        }
+    }
+
+    // 一次加锁查询多个变量
+    void lookup(const std::vector<int>& vars, std::vector<Entry>& entries) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        double avg_down = total_down_count_ > 0 ? total_down_ / total_down_count_ : 1.0;
+        double avg_up = total_up_count_ > 0 ? total_up_ / total_up_count_ : 1.0;
+        entries.resize(vars.size());
+        for (size_t k = 0; k < vars.size(); ++k) {
+            int j = vars[k];
+            Entry& e = entries[k];
+            e.down_count = count_down_[j];
+            e.up_count = count_up_[j];
+            e.down = e.down_count > 0 ? sum_down_[j] / e.down_count : avg_down;
+            e.up = e.up_count > 0 ? sum_up_[j] / e.up_count : avg_up;
+        }
+    }
+
+    bool empty() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return total_down_count_ == 0 && total_up_count_ == 0;
+    }
+
+    /*
+     * 伪成本的副本，用于在多次求解之间保留（见BranchBoundSolver::setWarmStart）
+     *
+     * 副本的变量下标可以与表不同：mapping[k]给出表中第k个变量在副本中的下标，为nullptr表示相同
+     */
+    struct Snapshot {
+        std::vector<double> sum_down;
+        std::vector<double> sum_up;
+        std::vector<int> count_down;
+        std::vector<int> count_up;
+        double total_down = 0.0;
+        double total_up = 0.0;
+        long long total_down_count = 0;
+        long long total_up_count = 0;
+    };
+
+    // 写入副本中映射到的位置（副本至少有num_snapshot_vars个变量），其余位置保持不变
+    void save(Snapshot& snapshot, const std::vector<int>* mapping, int num_snapshot_vars) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (static_cast<int>(snapshot.sum_down.size()) < num_snapshot_vars) {
+            snapshot.sum_down.resize(num_snapshot_vars, 0.0);
+            snapshot.sum_up.resize(num_snapshot_vars, 0.0);
+            snapshot.count_down.resize(num_snapshot_vars, 0);
+            snapshot.count_up.resize(num_snapshot_vars, 0);
+        }
+        for (size_t k = 0; k < sum_down_.size(); ++k) {
+            int j = mapping ? (*mapping)[k] : static_cast<int>(k);
+            snapshot.sum_down[j] = sum_down_[k];
+            snapshot.sum_up[j] = sum_up_[k];
+            snapshot.count_down[j] = count_down_[k];
+            snapshot.count_up[j] = count_up_[k];
+        }
+        snapshot.total_down = total_down_;
+        snapshot.total_up = total_up_;
+        snapshot.total_down_count = total_down_count_;
+        snapshot.total_up_count = total_up_count_;
+    }
+
+    // 重置为num_variables个变量并从副本载入；副本中没有的变量没有观测
+    void load(const Snapshot& snapshot, const std::vector<int>* mapping, int num_variables) {
+        resize(num_variables);
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (int k = 0; k < num_variables; ++k) {
+            int j = mapping ? (*mapping)[k] : k;
+            if (j < 0 || j >= static_cast<int>(snapshot.sum_down.size())) continue;
+            sum_down_[k] = snapshot.sum_down[j];
+            sum_up_[k] = snapshot.sum_up[j];
+            count_down_[k] = snapshot.count_down[j];
+            count_up_[k] = snapshot.count_up[j];
+        }
+        total_down_ = snapshot.total_down;
+        total_up_ = snapshot.total_up;
+        total_down_count_ = snapshot.total_down_count;
+        total_up_count_ = snapshot.total_up_count;
+    }
+
+    // 乘积打分规则
+    static double score(double down_gain, double up_gain) {
+        const double epsilon = 1e-6;
+        return std::max(down_gain, epsilon) * std::max(up_gain, epsilon);
+    }
+
+private:
+    mutable std::mutex mutex_;
+    std::vector<double> sum_down_;
+    std::vector<double> sum_up_;
+    std::vector<int> count_down_;
+    std::vector<int> count_up_;
+    double total_down_ = 0.0;
+    double total_up_ = 0.0;
+    long long total_down_count_ = 0;
+    long long total_up_count_ = 0;
+};
+
+} // namespace MIPSolver
+
+#endif
@@ -0,0 +1,1028 @@
+#ifndef DISTRIBUTED_SOLVER_H
+#define DISTRIBUTED_SOLVER_H
+
+/*
+ * 跨机器的分布式树搜索
+ *
+ * 一台机器上的并行分支定界受限于核数；DistributedSolver把搜索树切成子树，
+ * 通过TCP交给其他机器上的工作进程（DistributedWorker）求解：
+ *
+ * 1. 子树：相对原问题的一组变量边界收紧加上它的LP界（BranchBoundSolver::Subtree）。
+ *    根子树没有收紧；每个子树在工作进程上作为一个受节点数限制的分支定界任务求解，
+ *    没有做完的部分以开放节点（setOpenNodeOutput）的形式变成新的子树交回协调进程
+ *
+ * 2. 协调进程：
+ *    - 连接所有工作进程，把原问题的二进制快照（ProblemSnapshot::serialize）各发送一次
+ *    - 待处理的子树按LP界排序，空闲的工作进程总是领到界最好的子树；不能优于当前最优值的子树直接丢弃
+ *    - 任何任务找到更好的解时，把新的截断值广播给所有工作进程（正在运行的任务立即用它剪枝）
+ *    - 节点数、时间和停止标志到达上限时取消正在运行的任务，它们剩余的开放节点计入最终的对偶界
+ *    - 工作进程断开或出错时，它手上的子树重新排队交给其他工作进程
+ *
+ * 3. 工作进程：一次服务一个协调进程的连接（开始服务时先发送HELLO；正在服务其他协调进程的工作进程
+ *    不会及时应答，协调进程等待几秒后跳过它），在后台线程上求解任务，同时接收截断值和取消请求；
+ *    求解使用configure给出的设置（默认设置加预处理），节点上限、时间上限和截断值来自任务
+ *
+ * 连接时先握手：工作进程的HELLO带协议版本，协调进程回复版本和共享口令（setAuthToken），
+ * 两者都相符时工作进程回复READY，之后才接受LOAD等消息；握手前的消息限制在很小的长度内，
+ * 握手失败或超时即断开。工作进程默认只监听127.0.0.1；监听其他地址接受别的机器连接时应设置口令。
+ * 口令以明文传送，只用于挡住误连和未授权的访问者，不可信的网络上应通过加密隧道连接
+ *
+ * 4. 消息：帧格式见SocketChannel；负载内的数值按本机字节序编码，
+ *    与快照一样要求协调进程和工作进程字节序相同（快照载入时检查）。
+ *    两端都限制单条消息的大小（setMaxMessageSize），超过时断开连接
+ *
+ * 初始解只使用给出了全部变量的（直接作为最优解），部分初始解被忽略。
+ * 结果的节点数和LP迭代数是全部任务之和；子树内部的并行由工作进程的线程数决定
+ */
+
+#include "core.h"
+#include "solution.h"
+#include "problem_snapshot.h"
+#include "socket_channel.h"
+#include "branch_bound_solver.h"
+#include <vector>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <limits>
+#include <chrono>
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+#include <cmath>
+#include <stdexcept>
+#include <type_traits>
+
+namespace MIPSolver {
+
+namespace DistributedProtocol {
+
+enum MessageType : uint32_t {
+    LOAD = 1,    // coordinator -> worker: problem snapshot
+    TASK = 2,    // coordinator -> worker: subtree to search
+    CUTOFF = 3,  // coordinator -> worker: better objective found elsewhere
+    CANCEL = 4,  // coordinator -> worker: stop the running task and report what is left
+    RESULT = 5,  // worker -> coordinator: outcome of a task
+    FAILURE = 6, // worker -> coordinator: the request could not be served
+    HELLO = 7,   // worker -> coordinator: the connection is being served, with the protocol version
+    AUTH = 8,    // coordinator -> worker: protocol version and shared token
+    READY = 9    // worker -> coordinator: handshake accepted
+};
+
+constexpr uint32_t kMagic = 0x4450494d;  // "MIPD"; also rejects peers of the other byte order
+constexpr uint32_t kVersion = 1;
+
+using Subtree = BranchBoundSolver::Subtree;
+
+struct Task {
+    uint64_t id = 0;
+    long long node_limit = 0;
+    double time_limit = 0.0;
+    double cutoff = std::numeric_limits<double>::quiet_NaN();  // NaN when there is none
+    Subtree subtree;
+};
+
+struct Result {
+    uint64_t id = 0;
+    Solution::Status status = Solution::Status::UNKNOWN;
+    long long nodes = 0;
+    long long lp_iterations = 0;
+    double objective = 0.0;
+    double dual_bound = 0.0;
+    std::vector<double> values;  // empty when the task found no solution
+    std::vector<Subtree> open;   // subtrees left when the task stopped early
+};
+
+// Appends fixed-size values in host byte order
+class Writer {
+public:
+    template <typename T>
+    void put(T value) {
+        static_assert(std::is_trivially_copyable<T>::value, "plain values only");
+        size_t at = data_.size();
+        data_.resize(at + sizeof(T));
+        std::memcpy(&data_[at], &value, sizeof(T));
+    }
+
+    template <typename T>
+    void putArray(const std::vector<T>& values) {
+        put<uint64_t>(values.size());
+        size_t at = data_.size();
+        data_.resize(at + values.size() * sizeof(T));
+        if (!values.empty()) std::memcpy(&data_[at], values.data(), values.size() * sizeof(T));
+    }
+
+    void putString(std::string_view text) {
+        put<uint64_t>(text.size());
+        data_.append(text.data(), text.size());
+    }
+
+    void putSubtree(const Subtree& subtree) {
+        put(subtree.bound);
+        putArray(subtree.indices);
+        putArray(subtree.lower);
+        putArray(subtree.upper);
+    }
+
+    const std::string& data() const { return data_; }
+
+private:
+    std::string data_;
+};
+
+// Reads what Writer wrote; throws on truncated or inconsistent payloads
+class Reader {
+public:
+    explicit Reader(std::string_view data) : data_(data) {}
+
+    template <typename T>
+    T get() {
+        if (data_.size() - offset_ < sizeof(T)) malformed();
+        T value;
+        std::memcpy(&value, data_.data() + offset_, sizeof(T));
+        offset_ += sizeof(T);
+        return value;
+    }
+
+    template <typename T>
+    std::vector<T> getArray() {
+        uint64_t count = get<uint64_t>();
+        if (count > (data_.size() - offset_) / sizeof(T)) malformed();
+        std::vector<T> values(static_cast<size_t>(count));
+        if (count > 0) std::memcpy(values.data(), data_.data() + offset_, values.size() * sizeof(T));
+        offset_ += values.size() * sizeof(T);
+        return values;
+    }
+
+    std::string getString() {
+        uint64_t length = get<uint64_t>();
+        if (length > data_.size() - offset_) malformed();
+        std::string text(data_.substr(offset_, static_cast<size_t>(length)));
+        offset_ += text.size();
+        return text;
+    }
+
+    Subtree getSubtree(int num_variables) {
+        Subtree subtree;
+        subtree.bound = get<double>();
+        subtree.indices = getArray<int>();
+        subtree.lower = getArray<double>();
+        subtree.upper = getArray<double>();
+        if (subtree.lower.size() != subtree.indices.size() || subtree.upper.size() != subtree.indices.size()) malformed();
+        for (int j : subtree.indices) {
+            if (j < 0 || j >= num_variables) malformed();
+        }
+        return subtree;
+    }
+
+    void finish() const {
+        if (offset_ != data_.size()) malformed();
+    }
+
+private:
+    std::string_view data_;
+    size_t offset_ = 0;
+
+    [[noreturn]] static void malformed() { throw std::runtime_error("Malformed distributed solver message"); }
+};
+
+inline std::string encodeTask(const Task& task) {
+    Writer writer;
+    writer.put(task.id);
+    writer.put<int64_t>(task.node_limit);
+    writer.put(task.time_limit);
+    writer.put(task.cutoff);
+    writer.putSubtree(task.subtree);
+    return writer.data();
+}
+
+inline Task decodeTask(std::string_view data, int num_variables) {
+    Reader reader(data);
+    Task task;
+    task.id = reader.get<uint64_t>();
+    task.node_limit = reader.get<int64_t>();
+    task.time_limit = reader.get<double>();
+    task.cutoff = reader.get<double>();
+    task.subtree = reader.getSubtree(num_variables);
+    reader.finish();
+    return task;
+}
+
+inline std::string encodeResult(const Result& result) {
+    Writer writer;
+    writer.put(result.id);
+    writer.put<uint32_t>(static_cast<uint32_t>(result.status));
+    writer.put<int64_t>(result.nodes);
+    writer.put<int64_t>(result.lp_iterations);
+    writer.put(result.objective);
+    writer.put(result.dual_bound);
+    writer.putArray(result.values);
+    writer.put<uint64_t>(result.open.size());
+    for (const Subtree& subtree : result.open) {
+        writer.putSubtree(subtree);
+    }
+    return writer.data();
+}
+
+inline Result decodeResult(std::string_view data, int num_variables) {
+    Reader reader(data);
+    Result result;
+    result.id = reader.get<uint64_t>();
+    uint32_t status = reader.get<uint32_t>();
+    if (status > static_cast<uint32_t>(Solution::Status::WORK_LIMIT)) {
+        throw std::runtime_error("Malformed distributed solver message");
+    }
+    result.status = static_cast<Solution::Status>(status);
+    result.nodes = reader.get<int64_t>();
+    result.lp_iterations = reader.get<int64_t>();
+    result.objective = reader.get<double>();
+    result.dual_bound = reader.get<double>();
+    result.values = reader.getArray<double>();
+    if (!result.values.empty() && result.values.size() != static_cast<size_t>(num_variables)) {
+        throw std::runtime_error("Malformed distributed solver message");
+    }
+    uint64_t count = reader.get<uint64_t>();
+    for (uint64_t k = 0; k < count; ++k) {
+        result.open.push_back(reader.getSubtree(num_variables));
+    }
+    reader.finish();
+    return result;
+}
+
+inline std::string encodeHello() {
+    Writer writer;
+    writer.put(kMagic);
+    writer.put(kVersion);
+    return writer.data();
+}
+
+// False for a peer speaking another protocol version (or byte order)
+inline bool decodeHello(std::string_view data) {
+    Reader reader(data);
+    uint32_t magic = reader.get<uint32_t>();
+    uint32_t version = reader.get<uint32_t>();
+    reader.finish();
+    return magic == kMagic && version == kVersion;
+}
+
+inline std::string encodeAuth(std::string_view token) {
+    Writer writer;
+    writer.put(kMagic);
+    writer.put(kVersion);
+    writer.putString(token);
+    return writer.data();
+}
+
+// Compares in time independent of where the tokens differ
+inline bool sameToken(std::string_view a, std::string_view b) {
+    unsigned char difference = a.size() == b.size() ? 0 : 1;
+    for (size_t k = 0; k < std::max(a.size(), b.size()); ++k) {
+        unsigned char x = k < a.size() ? static_cast<unsigned char>(a[k]) : 0;
+        unsigned char y = k < b.size() ? static_cast<unsigned char>(b[k]) : 0;
+        difference |= static_cast<unsigned char>(x ^ y);
+    }
+    return difference == 0;
+}
+
+inline std::string encodeDouble(double value) {
+    Writer writer;
+    writer.put(value);
+    return writer.data();
+}
+
+inline double decodeDouble(std::string_view data) {
+    Reader reader(data);
+    double value = reader.get<double>();
+    reader.finish();
+    return value;
+}
+
+// The subtree's tightenings intersected with inner ones found below it
+inline Subtree intersect(const Subtree& outer, const Subtree& inner, ObjectiveType obj_type) {
+    Subtree result = outer;
+    for (size_t k = 0; k < inner.indices.size(); ++k) {
+        auto it = std::find(result.indices.begin(), result.indices.end(), inner.indices[k]);
+        if (it == result.indices.end()) {
+            result.indices.push_back(inner.indices[k]);
+            result.lower.push_back(inner.lower[k]);
+            result.upper.push_back(inner.upper[k]);
+        } else {
+            size_t at = static_cast<size_t>(it - result.indices.begin());
+            result.lower[at] = std::max(result.lower[at], inner.lower[k]);
+            result.upper[at] = std::min(result.upper[at], inner.upper[k]);
+        }
+    }
+    result.bound = obj_type == ObjectiveType::MINIMIZE ? std::max(outer.bound, inner.bound)
+                                                        : std::min(outer.bound, inner.bound);
+    return result;
+}
+
+} // namespace DistributedProtocol
+
+class DistributedWorker {
+public:
+    // Applied to a solver with the default settings before each task (limits and cutoff are set afterwards)
+    using Configure = std::function<void(BranchBoundSolver& solver)>;
+
+    /*
+     * @param port: 监听端口，0表示由系统选择（用getPort取得）
+     * @param bind_address: 监听的本机地址，默认只接受本机连接；""表示所有IPv4地址
+     */
+    explicit DistributedWorker(int port = 0, const std::string& bind_address = "127.0.0.1")
+        : listener_(bind_address, port) {}
+
+    int getPort() const { return listener_.getPort(); }
+
+    void setConfigure(Configure configure) { configure_ = std::move(configure); }
+
+    // 共享口令，必须与协调进程的DistributedSolver::setAuthToken相同（默认为空）
+    void setAuthToken(std::string token) { token_ = std::move(token); }
+
+    // 单条消息的最大字节数（默认1GiB），需要容纳问题快照
+    void setMaxMessageSize(uint64_t bytes) { max_message_ = std::max<uint64_t>(bytes, kMinMessageBytes); }
+    uint64_t getMaxMessageSize() const { return max_message_; }
+
+    /*
+     * 接受并服务协调进程的连接，直到stop被置位（为nullptr时一直运行）
+     *
+     * 一次只服务一个连接；连接断开时停止正在运行的任务，然后等待下一个连接
+     */
+    void serve(const std::atomic<bool>* stop = nullptr) {
+        auto stopped = [stop] { return stop && stop->load(); };
+        while (!stopped()) {
+            SocketChannel channel = listener_.accept(kPollMillis);
+            if (!channel.isOpen()) continue;
+            try {
+                serveConnection(channel, stopped);
+            } catch (const std::exception&) {
+                // A broken connection ends the session; the coordinator requeues the work it had sent
+            }
+        }
+    }
+
+private:
+    static constexpr int kPollMillis = 100;
+    static constexpr int kHandshakeMillis = 5000;
+    static constexpr uint64_t kHandshakeBytes = 1024;  // plus the token
+    static constexpr uint64_t kMinMessageBytes = uint64_t(1) << 16;
+
+    SocketListener listener_;
+    Configure configure_;
+    std::string token_;
+    uint64_t max_message_ = uint64_t(1) << 30;
+
+    struct Session {
+        std::unique_ptr<Problem> problem;
+        std::thread runner;
+        std::atomic<bool> task_stop{false};
+        std::atomic<double> cutoff{std::numeric_limits<double>::quiet_NaN()};
+
+        void finishTask() {
+            if (!runner.joinable()) return;
+            task_stop.store(true);
+            runner.join();
+        }
+    };
+
+    template <typename Stopped>
+    void serveConnection(SocketChannel& channel, const Stopped& stopped) {
+        Session session;
+        // Stops the running task when this function leaves, including by exception
+        struct Finish {
+            Session& session;
+            ~Finish() { session.finishTask(); }
+        } finish{session};
+
+        channel.send(DistributedProtocol::HELLO, DistributedProtocol::encodeHello());
+        uint32_t type;
+        std::string payload;
+        if (!handshake(channel, stopped)) return;
+        channel.send(DistributedProtocol::READY, std::string_view());
+        while (true) {
+            while (!channel.poll(kPollMillis)) {
+                if (stopped()) return;
+            }
+            if (!channel.receive(type, payload, max_message_)) return;
+            if (type == DistributedProtocol::LOAD) {
+                session.finishTask();
+                try {
+                    session.problem = std::make_unique<Problem>(ProblemSnapshot::deserialize(payload));
+                    session.problem->getMatrix().buildColumnView();
+                } catch (const std::exception& error) {
+                    session.problem.reset();
+                    channel.send(DistributedProtocol::FAILURE, error.what());
+                }
+            } else if (type == DistributedProtocol::TASK) {
+                session.finishTask();
+                if (!session.problem) {
+                    channel.send(DistributedProtocol::FAILURE, "no problem loaded");
+                    continue;
+                }
+                DistributedProtocol::Task task = DistributedProtocol::decodeTask(payload, session.problem->getNumVariables());
+                session.task_stop.store(false);
+                session.cutoff.store(task.cutoff);
+                session.runner = std::thread([this, &channel, &session, task = std::move(task)] {
+                    std::string reply;
+                    uint32_t reply_type = DistributedProtocol::RESULT;
+                    try {
+                        reply = DistributedProtocol::encodeResult(runTask(*session.problem, task, session));
+                    } catch (const std::exception& error) {
+                        reply_type = DistributedProtocol::FAILURE;
+                        reply = error.what();
+                    }
+                    try {
+                        channel.send(reply_type, reply);
+                    } catch (const std::exception&) {
+                        channel.shutdown();  // the reading side notices and ends the session
+                    }
+                });
+            } else if (type == DistributedProtocol::CUTOFF) {
+                double cutoff = DistributedProtocol::decodeDouble(payload);
+                double current = session.cutoff.load();
+                if (session.problem && (std::isnan(current) ||
+                    (session.problem->getObjectiveType() == ObjectiveType::MINIMIZE ? cutoff < current : cutoff > current))) {
+                    session.cutoff.store(cutoff);
+                }
+            } else if (type == DistributedProtocol::CANCEL) {
+                session.task_stop.store(true);
+            }
+        }
+    }
+
+    // Waits for AUTH; anything else, a wrong version or token, or silence ends the connection
+    template <typename Stopped>
+    bool handshake(SocketChannel& channel, const Stopped& stopped) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(kHandshakeMillis);
+        while (!channel.poll(kPollMillis)) {
+            if (stopped() || std::chrono::steady_clock::now() >= deadline) return false;
+        }
+        uint32_t type = 0;
+        std::string payload;
+        if (!channel.receive(type, payload, kHandshakeBytes + token_.size()) || type != DistributedProtocol::AUTH) return false;
+        DistributedProtocol::Reader reader(payload);
+        bool same_version = reader.get<uint32_t>() == DistributedProtocol::kMagic &&
+                            reader.get<uint32_t>() == DistributedProtocol::kVersion;
+        if (!same_version) {
+            channel.send(DistributedProtocol::FAILURE, "protocol version mismatch");
+            return false;
+        }
+        std::string token = reader.getString();
+        reader.finish();
+        if (!DistributedProtocol::sameToken(token, token_)) {
+            channel.send(DistributedProtocol::FAILURE, "authentication failed");
+            return false;
+        }
+        return true;
+    }
+
+    DistributedProtocol::Result runTask(const Problem& original, const DistributedProtocol::Task& task, Session& session) {
+        DistributedProtocol::Result result;
+        result.id = task.id;
+        const ObjectiveType obj_type = original.getObjectiveType();
+        const double worst = (obj_type == ObjectiveType::MINIMIZE ? 1.0 : -1.0) * std::numeric_limits<double>::infinity();
+
+        Problem problem = original;
+        bool empty = false;
+        for (size_t k = 0; k < task.subtree.indices.size(); ++k) {
+            Variable var = problem.getVariable(task.subtree.indices[k]);
+            double lower = std::max(var.getLowerBound(), task.subtree.lower[k]);
+            double upper = std::min(var.getUpperBound(), task.subtree.upper[k]);
+            if (lower > upper + 1e-9 * std::max(1.0, std::abs(upper))) empty = true;
+            var.setBounds(lower, std::max(lower, upper));
+        }
+        if (empty) {
+            result.status = Solution::Status::INFEASIBLE;
+            result.objective = worst;
+            result.dual_bound = worst;
+            return result;
+        }
+
+        BranchBoundSolver solver;
+        if (configure_) configure_(solver);
+        solver.setIterationLimit(static_cast<int>(std::min<long long>(task.node_limit, std::numeric_limits<int>::max())));
+        solver.setTimeLimit(task.time_limit);
+        solver.setObjectiveCutoff(task.cutoff);
+        solver.setSharedCutoff(&session.cutoff);
+        solver.setStopFlag(&session.task_stop);
+        std::vector<DistributedProtocol::Subtree> open;
+        solver.setOpenNodeOutput(&open);
+        Solution solution = solver.solve(problem);
+
+        result.status = solution.getStatus();
+        result.nodes = solution.getNodeCount();
+        result.lp_iterations = solution.getLPIterations();
+        result.objective = solution.getObjectiveValue();
+        result.dual_bound = solution.getDualBound();
+        if (std::isfinite(result.objective) && result.status != Solution::Status::UNBOUNDED) {
+            result.values = solution.getValues();
+        }
+        for (const DistributedProtocol::Subtree& subtree : open) {
+            result.open.push_back(DistributedProtocol::intersect(task.subtree, subtree, obj_type));
+        }
+        return result;
+    }
+};
+
+class DistributedSolver : public SolverInterface {
+public:
+    // 添加一个工作进程的地址；solve时连接不上的工作进程被跳过
+    void addWorker(const std::string& host, int port) { workers_.push_back({host, port}); }
+    void clearWorkers() { workers_.clear(); }
+
+    /*
+     * 每个任务的节点数上限（默认500）
+     *
+     * 越小负载越均衡、通信越多；开始阶段待处理的子树少于工作进程数时，任务的上限缩小到每个工作进程两个节点，
+     * 让搜索树尽快分散到所有工作进程
+     */
+    void setSubtreeNodeLimit(int nodes) { subtree_node_limit_ = std::max(nodes, 1); }
+    int getSubtreeNodeLimit() const { return subtree_node_limit_; }
+
+    // 外部停止标志（可为nullptr），语义同BranchBoundSolver::setStopFlag
+    void setStopFlag(const std::atomic<bool>* stop) { stop_flag_ = stop; }
+
+    /*
+     * 工作进程发回的单条消息的最大字节数
+     *
+     * 0（默认）表示按问题快照大小自动确定：快照的4倍，至少64MiB。任务结果含解和开放子树，
+     * 子树节点数上限很大或变量很多时可能需要调大
+     */
+    void setMaxMessageSize(uint64_t bytes) { max_message_ = bytes; }
+    uint64_t getMaxMessageSize() const { return max_message_; }
+
+    // 共享口令，必须与工作进程的DistributedWorker::setAuthToken相同（默认为空）
+    void setAuthToken(std::string token) { token_ = std::move(token); }
+
+    /*
+     * 分布式求解
+     *
+     * 所有工作进程都连接不上时抛出std::runtime_error；求解中途失去全部工作进程时返回已有的结果，状态为UNKNOWN
+     */
+    Solution solve(const Problem& problem) override {
+        Coordinator coordinator(*this, problem);
+        return coordinator.run();
+    }
+
+private:
+    struct Address {
+        std::string host;
+        int port;
+    };
+
+    std::vector<Address> workers_;
+    int subtree_node_limit_ = 500;
+    const std::atomic<bool>* stop_flag_ = nullptr;
+    uint64_t max_message_ = 0;
+    std::string token_;
+
+    // One solve: connections, the subtree queue and the incumbent
+    class Coordinator {
+    public:
+        Coordinator(const DistributedSolver& owner, const Problem& problem)
+            : owner_(owner), problem_(problem), obj_type_(problem.getObjectiveType()),
+              worst_((obj_type_ == ObjectiveType::MINIMIZE ? 1.0 : -1.0) * std::numeric_limits<double>::infinity()),
+              incumbent_objective_(worst_), pool_(obj_type_, owner.solution_pool_size_),
+              start_(std::chrono::steady_clock::now()) {}
+
+        ~Coordinator() {
+            for (auto& peer : peers_) {
+                peer->channel.shutdown();
+            }
+            for (auto& peer : peers_) {
+                if (peer->reader.joinable()) peer->reader.join();
+            }
+        }
+
+        Solution run() {
+            connect();
+            loadStarts();
+            pushSubtree(DistributedProtocol::Subtree{-worst_, {}, {}, {}});
+
+            auto last_progress = std::chrono::steady_clock::now();
+            while (true) {
+                if (!stopping_) checkLimits();
+                if (!stopping_) dispatch();
+                int busy = 0;
+                int alive = 0;
+                for (const auto& peer : peers_) {
+                    busy += peer->busy ? 1 : 0;
+                    alive += peer->alive ? 1 : 0;
+                }
+                if (busy == 0 && (stopping_ || queue_.empty() || alive == 0)) break;
+
+                Event event;
+                if (waitEvent(event)) handle(event);
+                if (owner_.progress_callback_ && owner_.progress_interval_ > 0.0 &&
+                    std::chrono::duration<double>(std::chrono::steady_clock::now() - last_progress).count() >= owner_.progress_interval_) {
+                    last_progress = std::chrono::steady_clock::now();
+                    report(SolveProgress::Event::INTERVAL);
+                }
+            }
+            return finish();
+        }
+
+    private:
+        struct Peer {
+            SocketChannel channel;
+            std::thread reader;
+            bool alive = true;
+            bool busy = false;
+            DistributedProtocol::Task task;  // the task being searched while busy
+        };
+
+        struct Event {
+            size_t peer;
+            bool closed;
+            uint32_t type;
+            std::string payload;
+        };
+
+        static constexpr int kWaitMillis = 50;
+        static constexpr int kHelloMillis = 5000;
+        static constexpr uint64_t kHelloBytes = 1024;
+        static constexpr uint64_t kMinMessageBytes = uint64_t(64) << 20;
+        static constexpr double kFeasibilityTolerance = 1e-6;  // as BranchBoundSolver checks MIP starts
+
+        const DistributedSolver& owner_;
+        const Problem& problem_;
+        const ObjectiveType obj_type_;
+        const double worst_;
+        std::vector<std::unique_ptr<Peer>> peers_;
+        uint64_t max_message_ = 0;  // largest result accepted from a worker
+        std::vector<DistributedProtocol::Subtree> queue_;  // heap, best bound on top
+        uint64_t next_task_ = 1;
+
+        std::mutex inbox_mutex_;
+        std::condition_variable inbox_ready_;
+        std::deque<Event> inbox_;
+
+        double incumbent_objective_;
+        std::vector<double> incumbent_;
+        SolutionPool pool_;
+        std::vector<Solution::IncumbentRecord> history_;
+        long long nodes_ = 0;
+        long long lp_iterations_ = 0;
+        bool stopping_ = false;
+        bool unbounded_ = false;
+        bool workers_lost_ = false;
+        Solution::Status stop_status_ = Solution::Status::UNKNOWN;
+        std::chrono::steady_clock::time_point start_;
+
+        bool better(double a, double b) const { return obj_type_ == ObjectiveType::MINIMIZE ? a < b : a > b; }
+
+        // Heap order: the subtree with the best bound first
+        bool laterInQueue(const DistributedProtocol::Subtree& a, const DistributedProtocol::Subtree& b) const {
+            return better(b.bound, a.bound);
+        }
+
+        double elapsed() const { return std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count(); }
+
+        void connect() {
+            if (owner_.workers_.empty()) throw std::runtime_error("DistributedSolver: no workers configured");
+            std::string snapshot = ProblemSnapshot::serialize(problem_, false);
+            max_message_ = owner_.max_message_ > 0 ? owner_.max_message_
+                                                   : std::max<uint64_t>(kMinMessageBytes, 4 * uint64_t(snapshot.size()));
+            for (const Address& address : owner_.workers_) {
+                try {
+                    auto peer = std::make_unique<Peer>();
+                    peer->channel = SocketChannel::connect(address.host, address.port);
+                    // A worker busy with another coordinator accepts at the TCP level but does not greet
+                    uint32_t type = 0;
+                    std::string payload;
+                    if (!peer->channel.poll(kHelloMillis) || !peer->channel.receive(type, payload, kHelloBytes) ||
+                        type != DistributedProtocol::HELLO) {
+                        throw std::runtime_error("no greeting");
+                    }
+                    if (!DistributedProtocol::decodeHello(payload)) throw std::runtime_error("protocol version mismatch");
+                    peer->channel.send(DistributedProtocol::AUTH, DistributedProtocol::encodeAuth(owner_.token_));
+                    if (!peer->channel.poll(kHelloMillis) || !peer->channel.receive(type, payload, kHelloBytes)) {
+                        throw std::runtime_error("no reply to the handshake");
+                    }
+                    if (type == DistributedProtocol::FAILURE) throw std::runtime_error(payload);
+                    if (type != DistributedProtocol::READY) throw std::runtime_error("unexpected handshake reply");
+                    peer->channel.send(DistributedProtocol::LOAD, snapshot);
+                    peers_.push_back(std::move(peer));
+                } catch (const std::exception& error) {
+                    if (owner_.verbose_) {
+                        std::cout << "Distributed: skipping worker " << address.host << ":" << address.port
+                                  << " (" << error.what() << ")" << std::endl;
+                    }
+                }
+            }
+            if (peers_.empty()) throw std::runtime_error("DistributedSolver: no worker reachable");
+            for (size_t p = 0; p < peers_.size(); ++p) {
+                peers_[p]->reader = std::thread([this, p] { readLoop(p); });
+            }
+        }
+
+        void readLoop(size_t p) {
+            Event event{p, false, 0, std::string()};
+            try {
+                while (peers_[p]->channel.receive(event.type, event.payload, max_message_)) {
+                    post(event);
+                }
+            } catch (const std::exception&) {
+            }
+            event.closed = true;
+            event.type = 0;
+            event.payload.clear();
+            post(std::move(event));
+        }
+
+        void post(Event event) {
+            {
+                std::lock_guard<std::mutex> lock(inbox_mutex_);
+                inbox_.push_back(std::move(event));
+            }
+            inbox_ready_.notify_one();
+        }
+
+        bool waitEvent(Event& event) {
+            std::unique_lock<std::mutex> lock(inbox_mutex_);
+            if (!inbox_ready_.wait_for(lock, std::chrono::milliseconds(kWaitMillis), [this] { return !inbox_.empty(); })) {
+                return false;
+            }
+            event = std::move(inbox_.front());
+            inbox_.pop_front();
+            return true;
+        }
+
+        // Complete MIP starts become the first incumbent; partial ones would need a local sub-MIP
+        void loadStarts() {
+            const int n = problem_.getNumVariables();
+            for (const MIPStart& start : owner_.mip_starts_) {
+                std::vector<double> values(n, std::numeric_limits<double>::quiet_NaN());
+                for (size_t k = 0; k < start.indices.size(); ++k) {
+                    if (start.indices[k] < 0 || start.indices[k] >= n) {
+                        throw std::runtime_error("MIP start index out of range: " + std::to_string(start.indices[k]));
+                    }
+                    values[start.indices[k]] = start.values[k];
+                }
+                if (std::any_of(values.begin(), values.end(), [](double x) { return std::isnan(x); })) continue;
+                if (!checkSolution(values)) continue;
+                updateIncumbent(values, problem_.calculateObjectiveValue(values));
+            }
+        }
+
+        // Integer variables are snapped within the tolerance, then bounds and rows are checked on the original problem
+        bool checkSolution(std::vector<double>& values) const {
+            if (values.size() != static_cast<size_t>(problem_.getNumVariables())) return false;
+            const std::vector<VariableType>& types = problem_.getVariableTypes();
+            for (size_t j = 0; j < values.size(); ++j) {
+                if (!std::isfinite(values[j])) return false;
+                if (types[j] == VariableType::CONTINUOUS) continue;
+                double rounded = std::round(values[j]);
+                if (std::abs(values[j] - rounded) > kFeasibilityTolerance) return false;
+                values[j] = rounded;
+            }
+            return problem_.isValidSolution(values, kFeasibilityTolerance);
+        }
+
+        void updateIncumbent(const std::vector<double>& values, double objective) {
+            pool_.add(objective, values);
+            if (!better(objective, incumbent_objective_)) return;
+            incumbent_objective_ = objective;
+            incumbent_ = values;
+            history_.push_back({elapsed(), nodes_, objective});
+            std::string cutoff = DistributedProtocol::encodeDouble(objective);
+            for (auto& peer : peers_) {
+                if (!peer->alive) continue;
+                try {
+                    peer->channel.send(DistributedProtocol::CUTOFF, cutoff);
+                } catch (const std::exception&) {
+                    peer->channel.shutdown();  // its reader reports the loss
+                }
+            }
+            report(SolveProgress::Event::INCUMBENT);
+        }
+
+        void pushSubtree(DistributedProtocol::Subtree subtree) {
+            queue_.push_back(std::move(subtree));
+            std::push_heap(queue_.begin(), queue_.end(),
+                           [this](const auto& a, const auto& b) { return laterInQueue(a, b); });
+        }
+
+        DistributedProtocol::Subtree popSubtree() {
+            std::pop_heap(queue_.begin(), queue_.end(), [this](const auto& a, const auto& b) { return laterInQueue(a, b); });
+            DistributedProtocol::Subtree subtree = std::move(queue_.back());
+            queue_.pop_back();
+            return subtree;
+        }
+
+        bool pruned(const DistributedProtocol::Subtree& subtree) const {
+            return !incumbent_.empty() && !better(subtree.bound, incumbent_objective_);
+        }
+
+        void checkLimits() {
+            if (owner_.stop_flag_ && owner_.stop_flag_->load(std::memory_order_relaxed)) {
+                stop(Solution::Status::INTERRUPTED);
+            } else if (owner_.time_limit_ > 0.0 && elapsed() >= owner_.time_limit_) {
+                stop(Solution::Status::TIME_LIMIT);
+            } else if (nodes_ >= owner_.iteration_limit_) {
+                stop(Solution::Status::ITERATION_LIMIT);
+            }
+        }
+
+        // Running tasks are cancelled; their results (with the nodes they leave open) are still collected
+        void stop(Solution::Status status) {
+            stopping_ = true;
+            stop_status_ = status;
+            for (auto& peer : peers_) {
+                if (!peer->busy) continue;
+                try {
+                    peer->channel.send(DistributedProtocol::CANCEL, std::string_view());
+                } catch (const std::exception&) {
+                    peer->channel.shutdown();
+                }
+            }
+        }
+
+        void dispatch() {
+            for (auto& peer : peers_) {
+                if (!peer->alive || peer->busy) continue;
+                while (!queue_.empty() && pruned(queue_.front())) {
+                    popSubtree();
+                }
+                if (queue_.empty()) return;
+                // Running tasks may still use their whole budget, so only the rest is handed out
+                long long budget = owner_.iteration_limit_ - nodes_ - reservedNodes();
+                if (budget <= 0) return;
+
+                DistributedProtocol::Task task;
+                task.id = next_task_++;
+                long long limit = owner_.subtree_node_limit_;
+                if (queue_.size() < peers_.size()) limit = std::min<long long>(limit, 2 * static_cast<long long>(peers_.size()));
+                task.node_limit = std::min(limit, budget);
+                task.time_limit = owner_.time_limit_ > 0.0 ? std::max(owner_.time_limit_ - elapsed(), 1e-3) : 0.0;
+                task.cutoff = incumbent_.empty() ? std::numeric_limits<double>::quiet_NaN() : incumbent_objective_;
+                task.subtree = popSubtree();
+                try {
+                    peer->channel.send(DistributedProtocol::TASK, DistributedProtocol::encodeTask(task));
+                } catch (const std::exception&) {
+                    pushSubtree(std::move(task.subtree));
+                    peer->channel.shutdown();
+                    peer->alive = false;
+                    continue;
+                }
+                peer->busy = true;
+                peer->task = std::move(task);
+            }
+        }
+
+        long long reservedNodes() const {
+            long long reserved = 0;
+            for (const auto& peer : peers_) {
+                if (peer->busy) reserved += peer->task.node_limit;
+            }
+            return reserved;
+        }
+
+        void handle(Event& event) {
+            Peer& peer = *peers_[event.peer];
+            if (event.closed || event.type == DistributedProtocol::FAILURE) {
+                if (owner_.verbose_ && event.type == DistributedProtocol::FAILURE) {
+                    std::cout << "Distributed: worker " << event.peer << " failed: " << event.payload << std::endl;
+                }
+                lose(peer);
+                return;
+            }
+            if (event.type != DistributedProtocol::RESULT || !peer.busy) return;
+
+            DistributedProtocol::Result result;
+            try {
+                result = DistributedProtocol::decodeResult(event.payload, problem_.getNumVariables());
+            } catch (const std::exception&) {
+                lose(peer);
+                return;
+            }
+            if (result.id != peer.task.id) return;
+            // The reported objective is not trusted; a solution that fails the check discards the whole result,
+            // since the worker's pruning relied on it
+            if (!result.values.empty() && !checkSolution(result.values)) {
+                if (owner_.verbose_) {
+                    std::cout << "Distributed: worker " << event.peer << " sent an infeasible solution" << std::endl;
+                }
+                lose(peer);
+                return;
+            }
+            peer.busy = false;
+            nodes_ += result.nodes;
+            lp_iterations_ += result.lp_iterations;
+            if (!result.values.empty()) updateIncumbent(result.values, problem_.calculateObjectiveValue(result.values));
+
+            switch (result.status) {
+                case Solution::Status::OPTIMAL:
+                case Solution::Status::INFEASIBLE:
+                    break;  // the subtree is closed
+                case Solution::Status::UNBOUNDED:
+                    unbounded_ = true;
+                    if (!stopping_) stop(Solution::Status::UNBOUNDED);
+                    break;
+                default:
+                    if (result.open.empty()) {
+                        // Stopped before its tree search started: nothing was split off, so the whole subtree remains
+                        DistributedProtocol::Subtree subtree = std::move(peer.task.subtree);
+                        if (std::isfinite(result.dual_bound) && better(subtree.bound, result.dual_bound)) {
+                            subtree.bound = result.dual_bound;
+                        }
+                        pushSubtree(std::move(subtree));
+                    }
+                    for (DistributedProtocol::Subtree& subtree : result.open) {
+                        pushSubtree(std::move(subtree));
+                    }
+                    break;
+            }
+            if (owner_.verbose_) {
+                std::cout << "Distributed: task " << result.id << " on worker " << event.peer << " done, "
+                          << result.nodes << " nodes, " << queue_.size() << " subtrees queued, best "
+                          << incumbent_objective_ << std::endl;
+            }
+        }
+
+        // A lost worker's subtree goes back to the queue for the others
+        void lose(Peer& peer) {
+            if (!peer.alive) return;
+            peer.alive = false;
+            peer.channel.shutdown();
+            if (peer.busy) {
+                peer.busy = false;
+                pushSubtree(std::move(peer.task.subtree));
+            }
+            if (std::none_of(peers_.begin(), peers_.end(), [](const auto& other) { return other->alive; })) {
+                workers_lost_ = true;
+            }
+        }
+
+        double openBound() const {
+            double bound = worst_;
+            for (const auto& subtree : queue_) {
+                if (better(subtree.bound, bound)) bound = subtree.bound;
+            }
+            for (const auto& peer : peers_) {
+                if (peer->busy && better(peer->task.subtree.bound, bound)) bound = peer->task.subtree.bound;
+            }
+            // Nothing left open: the incumbent (or infeasibility) is proven
+            return better(incumbent_objective_, bound) ? incumbent_objective_ : bound;
+        }
+
+        void report(SolveProgress::Event event) {
+            if (!owner_.progress_callback_) return;
+            SolveProgress progress;
+            progress.event = event;
+            progress.time = elapsed();
+            progress.nodes = nodes_;
+            progress.open_nodes = static_cast<long long>(queue_.size());
+            for (const auto& peer : peers_) {
+                progress.open_nodes += peer->busy ? 1 : 0;
+            }
+            progress.objective = incumbent_objective_;
+            progress.dual_bound = openBound();
+            progress.gap = Solution::relativeGap(progress.objective, progress.dual_bound);
+            owner_.progress_callback_(progress);
+        }
+
+        Solution finish() {
+            const int n = problem_.getNumVariables();
+            Solution solution(n);
+            const bool found = !incumbent_.empty();
+            if (found) {
+                for (int j = 0; j < n; ++j) {
+                    solution.setValue(j, incumbent_[j]);
+                }
+            }
+            solution.setObjectiveValue(found ? incumbent_objective_ : worst_);
+            solution.setDualBound(openBound());
+            solution.setIterations(static_cast<int>(std::min<long long>(nodes_, std::numeric_limits<int>::max())));
+            solution.setLPIterations(lp_iterations_);
+            solution.setOpenNodes(static_cast<long long>(queue_.size()));
+            solution.setIncumbentHistory(history_);
+            solution.setSolutionPool(pool_.entries());
+            solution.setSolveTime(elapsed());
+
+            if (unbounded_) {
+                solution.setStatus(Solution::Status::UNBOUNDED);
+            } else if (stopping_) {
+                solution.setStatus(stop_status_);
+            } else if (workers_lost_ && !queue_.empty()) {
+                solution.setStatus(Solution::Status::UNKNOWN);
+            } else {
+                solution.setStatus(found ? Solution::Status::OPTIMAL : Solution::Status::INFEASIBLE);
+            }
+            if (owner_.verbose_) {
+                std::cout << "Distributed: " << peers_.size() << " workers, " << nodes_ << " nodes, objective "
+                          << solution.getObjectiveValue() << ", bound " << solution.getDualBound() << std::endl;
+            }
+            return solution;
+        }
+    };
+};
+
+} // namespace MIPSolver
+
+#endif
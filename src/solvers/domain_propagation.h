@@ -0,0 +1,315 @@
+#ifndef DOMAIN_PROPAGATION_H
+#define DOMAIN_PROPAGATION_H
+
+/*
+ * 节点域传播（边界传播）
+ *
+ * 分支只直接改变一个变量的边界，但通过约束它往往隐含着其他变量的更紧边界，
+ * 甚至直接说明节点不可行。传播引擎在求解节点LP之前推出这些结论：
+ *
+ * 1. 行活动度：
+ *    - 对每一行维护 min/max 活动度（当前边界下 a_i^T x 的最小值和最大值），
+ *      分别保存有限部分之和以及取无穷的项数
+ *    - 变量边界改变时沿该变量所在的列（CSC视图）增量更新各行的活动度
+ *
+ * 2. 传播：
+ *    - min 活动度超过行上限或 max 活动度低于行下限时节点不可行
+ *    - 否则对行内每个变量 x_j，由其余项的活动度范围推出 a_j x_j 的范围，
+ *      收紧 x_j 的边界（整数变量取整）；活动度发生变化的行进入队列继续传播
+ *    - 连续变量只接受有实质改进的收紧，并限制单次传播处理的行数，避免无穷小步的连锁收紧
+ *
+ * 3. 回溯：
+ *    - 每次边界改变把旧边界压入trail，mark()记下当前位置，undo(mark)按逆序恢复
+ *    - 恢复后被影响的行的活动度从当前边界重新精确计算，增量更新的舍入误差不会累积
+ *
+ * 引擎持有指向问题约束矩阵的指针，问题须在引擎使用期间保持有效；
+ * 矩阵的列视图在load中生成，之后多个线程的引擎可以共享同一个只读矩阵。
+ */
+
+#include "core.h"
+#include <vector>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+namespace MIPSolver {
+
+class DomainPropagator {
+public:
+    /*
+     * 载入问题：复制变量边界与行界，计算全部行的活动度
+     */
+    void load(const Problem& problem) {
+        matrix_ = &problem.getMatrix();
+        matrix_->buildColumnView();
+        int n = problem.getNumVariables();
+        int m = problem.getNumConstraints();
+
+        lower_.resize(n);
+        upper_.resize(n);
+        is_integer_.resize(n);
+        for (int j = 0; j < n; ++j) {
+            ConstVariable var = problem.getVariable(j);
+            lower_[j] = var.getLowerBound();
+            upper_[j] = var.getUpperBound();
+            is_integer_[j] = var.getType() != VariableType::CONTINUOUS;
+        }
+        row_lower_.resize(m);
+        row_upper_.resize(m);
+        activity_.resize(m);
+        for (int i = 0; i < m; ++i) {
+            row_lower_[i] = problem.getConstraint(i).getLowerLimit();
+            row_upper_[i] = problem.getConstraint(i).getUpperLimit();
+            computeActivity(i);
+        }
+
+        trail_.clear();
+        queue_.clear();
+        queued_.assign(m, false);
+        row_stamp_.assign(m, 0);
+        stamp_ = 0;
+        tightenings_ = 0;
+    }
+
+    const std::vector<double>& lower() const { return lower_; }
+    const std::vector<double>& upper() const { return upper_; }
+
+    /*
+     * 收紧单个变量的边界（与当前边界取交集）
+     *
+     * @return: false表示收紧后定义域为空，此时边界不被修改
+     */
+    bool tightenLower(int j, double value) { return setLower(j, value, false); }
+    bool tightenUpper(int j, double value) { return setUpper(j, value, false); }
+
+    /*
+     * 从上次传播以来活动度发生变化的行开始传播
+     *
+     * @return: false表示证明了当前节点不可行
+     */
+    bool propagate() {
+        int work_limit = 2 * static_cast<int>(activity_.size()) + 1000;
+        bool feasible = true;
+        for (size_t head = 0; head < queue_.size(); ++head) {
+            int i = queue_[head];
+            queued_[i] = false;
+            if (!feasible || --work_limit < 0) continue;
+            feasible = propagateRow(i);
+        }
+        queue_.clear();
+        return feasible;
+    }
+
+    // trail的当前位置
+    size_t mark() const { return trail_.size(); }
+
+    // 撤销mark之后的全部边界改变
+    void undo(size_t mark) {
+        if (trail_.size() <= mark) return;
+        stamp_++;
+        std::vector<int>& dirty = dirty_rows_;
+        dirty.clear();
+        while (trail_.size() > mark) {
+            const TrailEntry& entry = trail_.back();
+            lower_[entry.var_index] = entry.lower;
+            upper_[entry.var_index] = entry.upper;
+            SparseMatrix::VectorView column = matrix_->column(entry.var_index);
+            for (int k = 0; k < column.size; ++k) {
+                int i = column.indices[k];
+                if (row_stamp_[i] != stamp_) {
+                    row_stamp_[i] = stamp_;
+                    dirty.push_back(i);
+                }
+            }
+            trail_.pop_back();
+        }
+        for (int i : dirty) {
+            computeActivity(i);
+        }
+        for (int i : queue_) {
+            queued_[i] = false;
+        }
+        queue_.clear();
+    }
+
+    // 传播推出的边界收紧次数（不含tightenLower/tightenUpper的直接调用）
+    long long getNumTightenings() const { return tightenings_; }
+
+private:
+    static constexpr double kInfinity = 1e20;
+    static constexpr double kFeasibilityTolerance = 1e-6;
+
+    // Row activity bounds: finite parts plus the number of infinite contributions
+    struct Activity {
+        double min;
+        double max;
+        int min_inf;
+        int max_inf;
+    };
+
+    struct TrailEntry {
+        int var_index;
+        double lower;   // bounds before the change
+        double upper;
+    };
+
+    const SparseMatrix* matrix_ = nullptr;
+    std::vector<double> lower_;
+    std::vector<double> upper_;
+    std::vector<bool> is_integer_;
+    std::vector<double> row_lower_;
+    std::vector<double> row_upper_;
+    std::vector<Activity> activity_;
+
+    std::vector<TrailEntry> trail_;
+    std::vector<int> queue_;
+    std::vector<bool> queued_;
+    std::vector<unsigned> row_stamp_;
+    std::vector<int> dirty_rows_;
+    unsigned stamp_ = 0;
+    long long tightenings_ = 0;
+
+    static bool isInfinite(double bound) { return std::abs(bound) >= kInfinity; }
+
+    static void addTerm(double& sum, int& inf_count, double a, double bound, double sign) {
+        if (isInfinite(bound)) {
+            inf_count += static_cast<int>(sign);
+        } else {
+            sum += sign * a * bound;
+        }
+    }
+
+    void computeActivity(int i) {
+        Activity& act = activity_[i];
+        act = {0.0, 0.0, 0, 0};
+        SparseMatrix::VectorView row = matrix_->row(i);
+        for (int k = 0; k < row.size; ++k) {
+            int j = row.indices[k];
+            double a = row.values[k];
+            addTerm(act.min, act.min_inf, a, a > 0.0 ? lower_[j] : upper_[j], 1.0);
+            addTerm(act.max, act.max_inf, a, a > 0.0 ? upper_[j] : lower_[j], 1.0);
+        }
+    }
+
+    // Incremental activity update after the bounds of j changed from (old_lower, old_upper)
+    void updateActivities(int j, double old_lower, double old_upper) {
+        SparseMatrix::VectorView column = matrix_->column(j);
+        for (int k = 0; k < column.size; ++k) {
+            int i = column.indices[k];
+            double a = column.values[k];
+            Activity& act = activity_[i];
+            double old_min = a > 0.0 ? old_lower : old_upper;
+            double new_min = a > 0.0 ? lower_[j] : upper_[j];
+            double old_max = a > 0.0 ? old_upper : old_lower;
+            double new_max = a > 0.0 ? upper_[j] : lower_[j];
+            if (old_min != new_min) {
+                addTerm(act.min, act.min_inf, a, old_min, -1.0);
+                addTerm(act.min, act.min_inf, a, new_min, 1.0);
+            }
+            if (old_max != new_max) {
+                addTerm(act.max, act.max_inf, a, old_max, -1.0);
+                addTerm(act.max, act.max_inf, a, new_max, 1.0);
+            }
+            if (!queued_[i]) {
+                queued_[i] = true;
+                queue_.push_back(i);
+            }
+        }
+    }
+
+    /*
+     * 设置新下界；derived表示该边界由传播推出：
+     * 整数变量向上取整，连续变量只接受有实质改进的收紧
+     */
+    bool setLower(int j, double value, bool derived) {
+        if (derived) {
+            if (is_integer_[j]) {
+                value = std::ceil(value - kFeasibilityTolerance);
+            } else if (!isInfinite(lower_[j]) &&
+                       value <= lower_[j] + 1e-3 * std::max(1.0, std::abs(value))) {
+                return true;
+            }
+        }
+        if (value <= lower_[j] || isInfinite(value)) return true;
+        if (value > upper_[j]) {
+            if (value > upper_[j] + kFeasibilityTolerance * std::max(1.0, std::abs(value))) return false;
+            value = upper_[j];
+            if (value <= lower_[j]) return true;
+        }
+        trail_.push_back({j, lower_[j], upper_[j]});
+        double old_lower = lower_[j];
+        lower_[j] = value;
+        updateActivities(j, old_lower, upper_[j]);
+        if (derived) tightenings_++;
+        return true;
+    }
+
+    bool setUpper(int j, double value, bool derived) {
+        if (derived) {
+            if (is_integer_[j]) {
+                value = std::floor(value + kFeasibilityTolerance);
+            } else if (!isInfinite(upper_[j]) &&
+                       value >= upper_[j] - 1e-3 * std::max(1.0, std::abs(value))) {
+                return true;
+            }
+        }
+        if (value >= upper_[j] || isInfinite(value)) return true;
+        if (value < lower_[j]) {
+            if (value < lower_[j] - kFeasibilityTolerance * std::max(1.0, std::abs(value))) return false;
+            value = lower_[j];
+            if (value >= upper_[j]) return true;
+        }
+        trail_.push_back({j, lower_[j], upper_[j]});
+        double old_upper = upper_[j];
+        upper_[j] = value;
+        updateActivities(j, lower_[j], old_upper);
+        if (derived) tightenings_++;
+        return true;
+    }
+
+    // Infeasibility check and bound tightening for one row
+    bool propagateRow(int i) {
+        const Activity& act = activity_[i];
+        double row_lower = row_lower_[i];
+        double row_upper = row_upper_[i];
+        if (act.min_inf == 0 && act.min > row_upper + kFeasibilityTolerance * std::max(1.0, std::abs(row_upper))) {
+            return false;
+        }
+        if (act.max_inf == 0 && act.max < row_lower - kFeasibilityTolerance * std::max(1.0, std::abs(row_lower))) {
+            return false;
+        }
+
+        SparseMatrix::VectorView row = matrix_->row(i);
+        for (int k = 0; k < row.size; ++k) {
+            int j = row.indices[k];
+            double a = row.values[k];
+            if (std::abs(a) < 1e-9) continue;
+
+            // a_j x_j <= upper - (min activity of the other terms)
+            if (!isInfinite(row_upper) && act.min_inf <= 1) {
+                double bound = a > 0.0 ? lower_[j] : upper_[j];
+                bool infinite = isInfinite(bound);
+                if (act.min_inf == (infinite ? 1 : 0)) {
+                    double residual = infinite ? act.min : act.min - a * bound;
+                    double limit = (row_upper - residual) / a;
+                    if (!(a > 0.0 ? setUpper(j, limit, true) : setLower(j, limit, true))) return false;
+                }
+            }
+            // a_j x_j >= lower - (max activity of the other terms)
+            if (!isInfinite(row_lower) && act.max_inf <= 1) {
+                double bound = a > 0.0 ? upper_[j] : lower_[j];
+                bool infinite = isInfinite(bound);
+                if (act.max_inf == (infinite ? 1 : 0)) {
+                    double residual = infinite ? act.max : act.max - a * bound;
+                    double limit = (row_lower - residual) / a;
+                    if (!(a > 0.0 ? setLower(j, limit, true) : setUpper(j, limit, true))) return false;
+                }
+            }
+        }
+        return true;
+    }
+};
+
+} // namespace MIPSolver
+
+#endif
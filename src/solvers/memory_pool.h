@@ -0,0 +1,190 @@
+#ifndef MEMORY_POOL_H
+#define MEMORY_POOL_H
+
+/*
+ * 分支定界节点内存池
+ *
+ * 每个节点都会创建边界改变记录、热启动基和开放节点集合中的条目，并在子树搜索完后释放。
+ * 这些对象大小固定、生命周期很短，而且常常在一个线程上创建、在另一个线程上释放
+ * （节点被窃取后由窃取者处理），直接使用全局堆会在多线程下争用分配器并产生缺页。
+ *
+ * 1. BlockPool：固定大小内存块的池，按块组（chunk）向系统申请，块组只在池析构时归还。
+ *    通过PoolAllocator交给std::allocate_shared或标准容器，对象与shared_ptr控制块一次分配
+ * 2. ObjectPool<T>：可重复使用的对象池，归还的对象保留内部缓冲区（例如vector的容量），
+ *    下一次取出时由调用者覆盖内容
+ *
+ * 线程约定：分配/取出不能并发（由所属的搜索线程调用，或由持有同一把锁的线程调用）；
+ * 释放/归还可以在任意线程并发进行。释放压入无锁的归还栈，本地空闲链表用完时
+ * 一次取走整个归还栈，因此分配路径上没有锁，也不存在ABA问题。
+ * 池必须比从中分配的所有对象活得更久。
+ */
+
+#include "instrumentation.h"
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <vector>
+
+namespace MIPSolver {
+
+class BlockPool {
+public:
+    static constexpr size_t kBlockSize = 64;        // 能放下边界改变记录及其shared_ptr控制块
+    static constexpr size_t kBlocksPerChunk = 1024;
+
+    BlockPool() = default;
+    BlockPool(const BlockPool&) = delete;
+    BlockPool& operator=(const BlockPool&) = delete;
+
+    ~BlockPool() {
+        for (void* chunk : chunks_) ::operator delete(chunk);
+    }
+
+    void* allocate() {
+        if (!local_) local_ = returned_.exchange(nullptr, std::memory_order_acquire);
+        if (!local_) addChunk();
+        FreeBlock* block = local_;
+        local_ = block->next;
+        return block;
+    }
+
+    void deallocate(void* p) noexcept {
+        FreeBlock* block = new (p) FreeBlock{returned_.load(std::memory_order_relaxed)};
+        while (!returned_.compare_exchange_weak(block->next, block, std::memory_order_release,
+                                                std::memory_order_relaxed)) {}
+    }
+
+    // 已向系统申请的字节数
+    size_t capacityBytes() const { return chunks_.size() * kBlockSize * kBlocksPerChunk; }
+
+private:
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    FreeBlock* local_ = nullptr;                // 只由分配方访问
+    std::atomic<FreeBlock*> returned_{nullptr};  // 其他线程（或本线程）释放的块
+    std::vector<void*> chunks_;
+
+    void addChunk() {
+        char* chunk = static_cast<char*>(::operator new(kBlockSize * kBlocksPerChunk));
+        chunks_.push_back(chunk);
+        MIPSOLVER_COUNT(POOL_BYTES, static_cast<long long>(kBlockSize * kBlocksPerChunk));
+        FreeBlock* next = nullptr;
+        for (size_t b = kBlocksPerChunk; b-- > 0;) {
+            next = new (chunk + b * kBlockSize) FreeBlock{next};
+        }
+        local_ = next;
+    }
+};
+
+/*
+ * 从BlockPool分配单个对象的分配器
+ *
+ * 单个对象放得进一个块时使用池，否则（数组或过大的类型）退回全局堆；
+ * 判断只依赖于类型和数量，因此释放时总能回到原来的地方
+ */
+template <typename T>
+class PoolAllocator {
+public:
+    using value_type = T;
+
+    explicit PoolAllocator(BlockPool& pool) noexcept : pool_(&pool) {}
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U>& other) noexcept : pool_(other.pool_) {}
+
+    T* allocate(size_t n) {
+        if (fitsBlock(n)) return static_cast<T*>(pool_->allocate());
+        return std::allocator<T>().allocate(n);
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        if (fitsBlock(n)) {
+            pool_->deallocate(p);
+        } else {
+            std::allocator<T>().deallocate(p, n);
+        }
+    }
+
+    template <typename U>
+    bool operator==(const PoolAllocator<U>& other) const noexcept { return pool_ == other.pool_; }
+    template <typename U>
+    bool operator!=(const PoolAllocator<U>& other) const noexcept { return pool_ != other.pool_; }
+
+private:
+    template <typename U> friend class PoolAllocator;
+
+    BlockPool* pool_;
+
+    static constexpr bool fitsBlock(size_t n) {
+        return n == 1 && sizeof(T) <= BlockPool::kBlockSize && alignof(T) <= alignof(std::max_align_t);
+    }
+};
+
+/*
+ * 可重复使用的对象池
+ *
+ * T必须是可以派生的类类型。取出的对象保留上一次使用留下的内容和容量；
+ * share()把取出的对象包装为shared_ptr，最后一个引用释放时对象回到池中，
+ * 控制块从给定的BlockPool分配
+ */
+template <typename T>
+class ObjectPool {
+public:
+    ObjectPool() = default;
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+    ~ObjectPool() {
+        deleteList(local_);
+        deleteList(returned_.load(std::memory_order_acquire));
+    }
+
+    T* acquire() {
+        if (!local_) local_ = returned_.exchange(nullptr, std::memory_order_acquire);
+        if (!local_) {
+            MIPSOLVER_COUNT(POOL_BYTES, static_cast<long long>(sizeof(Slot)));
+            return new Slot();
+        }
+        Slot* slot = local_;
+        local_ = slot->next;
+        return slot;
+    }
+
+    void release(T* object) noexcept {
+        Slot* slot = static_cast<Slot*>(object);
+        slot->next = returned_.load(std::memory_order_relaxed);
+        while (!returned_.compare_exchange_weak(slot->next, slot, std::memory_order_release,
+                                                std::memory_order_relaxed)) {}
+    }
+
+    std::shared_ptr<T> share(BlockPool& blocks) {
+        return std::shared_ptr<T>(acquire(), Recycler{this}, PoolAllocator<T>(blocks));
+    }
+
+private:
+    struct Slot : T {
+        Slot* next = nullptr;
+    };
+
+    struct Recycler {
+        ObjectPool* pool;
+        void operator()(T* object) const noexcept { pool->release(object); }
+    };
+
+    Slot* local_ = nullptr;
+    std::atomic<Slot*> returned_{nullptr};
+
+    static void deleteList(Slot* slot) {
+        while (slot) {
+            Slot* next = slot->next;
+            delete slot;
+            slot = next;
+        }
+    }
+};
+
+} // namespace MIPSolver
+
+#endif
@@ -0,0 +1,252 @@
+#ifndef NODE_SELECTION_H
+#define NODE_SELECTION_H
+
+/*
+ * 分支定界节点选择策略
+ *
+ * 决定下一个处理哪个未探索节点，直接影响求解效率：
+ *
+ * 1. DEPTH_FIRST（深度优先）：
+ *    - 总是处理最新生成的节点，内存占用小，容易尽早得到可行解
+ *    - 界限改善慢，难以在时间限制内证明最优
+ *
+ * 2. BEST_BOUND（最优界优先）：
+ *    - 总是处理LP界最好的节点，全局对偶界单调改善
+ *    - 最小化被处理的节点数，但可行解往往出现得晚
+ *
+ * 3. BEST_ESTIMATE（最优估计优先）：
+ *    - 按节点的估计值（LP界加上消除分数部分的预计损失）排序
+ *    - 倾向于尽快找到好的可行解
+ *
+ * 4. HYBRID（混合潜水）：
+ *    - 从当前节点沿子节点向下"潜水"若干层，寻找可行解
+ *    - 潜水结束后跳回最优界节点，兼顾可行解与界限改善
+ *
+ * 节点类型为模板参数，需要提供bound（LP界，原始目标意义）、estimate和depth成员。
+ * 所有策略都维护开放节点界的有序集合，以O(1)给出全局对偶界；集合的树节点来自选择器自己的
+ * 块池，节点数稳定后进出开放节点不再访问全局堆。
+ * 选择器本身不加锁；并行搜索时由持有它的节点池负责同步。
+ */
+
+#include "core.h"
+#include "memory_pool.h"
+#include <vector>
+#include <set>
+#include <memory>
+#include <algorithm>
+#include <limits>
+
+namespace MIPSolver {
+
+enum class NodeSelectionRule {
+    DEPTH_FIRST,
+    BEST_BOUND,
+    BEST_ESTIMATE,
+    HYBRID
+};
+
+template <typename Node>
+class NodeSelector {
+public:
+    explicit NodeSelector(ObjectiveType objective_type)
+        : sense_(objective_type == ObjectiveType::MAXIMIZE ? -1.0 : 1.0),
+          bounds_(std::less<double>(), PoolAllocator<double>(bound_blocks_)) {}
+    virtual ~NodeSelector() = default;
+
+    void push(Node node) {
+        bounds_.insert(key(node.bound));
+        doPush(std::move(node));
+    }
+
+    Node pop() {
+        Node node = doPop();
+        bounds_.erase(bounds_.find(key(node.bound)));
+        return node;
+    }
+
+    // 供其他线程窃取的节点：取本选择器近期最不会处理、子树最大的节点
+    Node steal() {
+        Node node = doSteal();
+        bounds_.erase(bounds_.find(key(node.bound)));
+        return node;
+    }
+
+    bool empty() const { return bounds_.empty(); }
+    size_t size() const { return bounds_.size(); }
+
+    // 开放节点中最好的LP界（原始目标意义）；没有开放节点时返回"最差"的无穷值
+    double bestBound() const {
+        if (bounds_.empty()) return sense_ * std::numeric_limits<double>::infinity();
+        return sense_ * *bounds_.begin();
+    }
+
+protected:
+    double sense_;  // +1 最小化，-1 最大化；key越小越好
+
+    double key(double objective) const { return sense_ * objective; }
+
+    virtual void doPush(Node node) = 0;
+    virtual Node doPop() = 0;
+    virtual Node doSteal() { return doPop(); }
+
+    // Heap order: the node with the smallest key comes out first
+    struct HeapCompare {
+        double sense;
+        bool use_estimate;
+        bool operator()(const Node& a, const Node& b) const {
+            double ka = sense * (use_estimate ? a.estimate : a.bound);
+            double kb = sense * (use_estimate ? b.estimate : b.bound);
+            if (ka != kb) return ka > kb;
+            return a.depth < b.depth;  // deeper first on ties
+        }
+    };
+
+private:
+    BlockPool bound_blocks_;  // bounds_的树节点
+    std::multiset<double, std::less<double>, PoolAllocator<double>> bounds_;
+};
+
+// 深度优先：后进先出，窃取时从另一端取最浅的节点
+template <typename Node>
+class DepthFirstSelector : public NodeSelector<Node> {
+public:
+    using NodeSelector<Node>::NodeSelector;
+
+protected:
+    void doPush(Node node) override { stack_.push_back(std::move(node)); }
+    Node doPop() override {
+        Node node = std::move(stack_.back());
+        stack_.pop_back();
+        if (stack_.size() == bottom_) {
+            stack_.clear();
+            bottom_ = 0;
+        }
+        return node;
+    }
+    Node doSteal() override {
+        Node node = std::move(stack_[bottom_++]);
+        // Compact once the stolen prefix dominates, keeping steals amortized O(1)
+        if (bottom_ == stack_.size()) {
+            stack_.clear();
+            bottom_ = 0;
+        } else if (2 * bottom_ >= stack_.size()) {
+            stack_.erase(stack_.begin(), stack_.begin() + bottom_);
+            bottom_ = 0;
+        }
+        return node;
+    }
+
+private:
+    // A vector keeps its capacity across the push/pop oscillation of a dive, unlike a deque's blocks;
+    // entries before bottom_ have been stolen
+    std::vector<Node> stack_;
+    size_t bottom_ = 0;
+};
+
+// 最优界 / 最优估计：二叉堆
+template <typename Node>
+class BestFirstSelector : public NodeSelector<Node> {
+public:
+    BestFirstSelector(ObjectiveType objective_type, bool use_estimate)
+        : NodeSelector<Node>(objective_type), compare_{this->sense_, use_estimate} {}
+
+protected:
+    void doPush(Node node) override {
+        heap_.push_back(std::move(node));
+        std::push_heap(heap_.begin(), heap_.end(), compare_);
+    }
+    Node doPop() override {
+        std::pop_heap(heap_.begin(), heap_.end(), compare_);
+        Node node = std::move(heap_.back());
+        heap_.pop_back();
+        return node;
+    }
+
+private:
+    typename NodeSelector<Node>::HeapCompare compare_;
+    std::vector<Node> heap_;
+};
+
+/*
+ * 混合潜水策略
+ *
+ * 新生成的子节点先进入潜水栈，下次选择时优先取最后压入的子节点继续向下；
+ * 潜水长度达到上限或潜水栈为空时，把剩余的潜水节点并入最优界堆，
+ * 然后从堆中取出当前最优界节点开始新的一轮潜水
+ */
+template <typename Node>
+class HybridDivingSelector : public NodeSelector<Node> {
+public:
+    HybridDivingSelector(ObjectiveType objective_type, int max_dive_length = 20)
+        : NodeSelector<Node>(objective_type), compare_{this->sense_, false},
+          max_dive_length_(max_dive_length), dive_length_(0) {}
+
+protected:
+    void doPush(Node node) override { dive_.push_back(std::move(node)); }
+
+    Node doPop() override {
+        if (!dive_.empty() && dive_length_ < max_dive_length_) {
+            Node node = std::move(dive_.back());
+            dive_.pop_back();
+            flushDive();
+            dive_length_++;
+            return node;
+        }
+
+        flushDive();
+        dive_length_ = 0;
+        return popHeap();
+    }
+
+    // 窃取最优界节点，不打断当前潜水
+    Node doSteal() override {
+        if (heap_.empty()) {
+            Node node = std::move(dive_.front());
+            dive_.erase(dive_.begin());
+            return node;
+        }
+        return popHeap();
+    }
+
+private:
+    typename NodeSelector<Node>::HeapCompare compare_;
+    std::vector<Node> heap_;
+    std::vector<Node> dive_;
+    int max_dive_length_;
+    int dive_length_;
+
+    Node popHeap() {
+        std::pop_heap(heap_.begin(), heap_.end(), compare_);
+        Node node = std::move(heap_.back());
+        heap_.pop_back();
+        return node;
+    }
+
+    // Siblings not chosen for the dive wait in the best-bound heap
+    void flushDive() {
+        for (auto& node : dive_) {
+            heap_.push_back(std::move(node));
+            std::push_heap(heap_.begin(), heap_.end(), compare_);
+        }
+        dive_.clear();
+    }
+};
+
+template <typename Node>
+std::unique_ptr<NodeSelector<Node>> createNodeSelector(NodeSelectionRule rule, ObjectiveType objective_type) {
+    switch (rule) {
+        case NodeSelectionRule::DEPTH_FIRST:
+            return std::make_unique<DepthFirstSelector<Node>>(objective_type);
+        case NodeSelectionRule::BEST_BOUND:
+            return std::make_unique<BestFirstSelector<Node>>(objective_type, false);
+        case NodeSelectionRule::BEST_ESTIMATE:
+            return std::make_unique<BestFirstSelector<Node>>(objective_type, true);
+        case NodeSelectionRule::HYBRID:
+        default:
+            return std::make_unique<HybridDivingSelector<Node>>(objective_type);
+    }
+}
+
+} // namespace MIPSolver
+
+#endif
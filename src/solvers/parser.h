@@ -1,139 +1,586 @@
+#ifndef PARSER_H
+#define PARSER_H
+
+/*
+ * MPS文件解析器
+ *
+ * 一次流式扫描读取完整的MPS格式：
+ * 1. 段：NAME、OBJSENSE、OBJNAME、ROWS、COLUMNS、RHS、RANGES、BOUNDS、ENDATA
+ *    - OBJSENSE 可以写在同一行（OBJSENSE MAX）或下一行
+ *    - 第一个N行（或OBJNAME指定的N行）为目标函数，其余N行是自由行，被丢弃
+ *    - COLUMNS中位于 'INTORG' / 'INTEND' 标记之间的列在创建时即设为整数变量
+ *    - RANGES把约束变为区间约束，语义见Constraint的说明
+ *    - 边界类型 LO UP FX FR MI PL BV LI UI；UP/UI给出负上界且下界为0时，下界改为负无穷
+ *    - 目标行上的RHS（目标常数项）被忽略；半连续（SC）和二次、SOS等段不支持，遇到时抛出异常
+ *
+ * 2. 格式：
+ *    - FREE（默认）：字段以空白分隔，也能读取名字不含空格的固定格式文件
+ *    - FIXED：按固定格式的列位置切分字段，名字可以包含空格
+ *    - RHS、RANGES、BOUNDS中的集合名字段可以省略
+ *
+ * 3. 压缩输入：
+ *    - 按文件头的魔数识别gzip（.mps.gz）和zstd（.mps.zst），与扩展名无关
+ *    - 压缩数据映射进内存后按块流式解压，边解压边解析，不生成临时文件，也不保留完整的解压文本
+ *    - gzip需要以MIPSOLVER_HAVE_ZLIB编译并链接zlib，zstd需要MIPSOLVER_HAVE_ZSTD并链接libzstd；
+ *      未启用时读取压缩文件抛出异常
+ *
+ * 4. 并行COLUMNS（num_threads != 1，仅未压缩文件）：
+ *    - 先顺序找到COLUMNS段的字节范围，按字节把它切成每线程一块（切分点落在行首）
+ *    - 各线程把自己块内的系数解析到独立的三元组缓冲区，此时行名表只读，列按出现的顺序编号为块内局部编号
+ *    - 合并时按块的顺序创建变量（整数标记状态跨块传递），再把局部列号换成全局列号，
+ *      整块追加到问题的稀疏矩阵中；结果与顺序解析完全相同
+ *    - COLUMNS段太小时退回顺序解析
+ *
+ * 快速路径：
+ * 1. 文件整体内存映射（见MappedFile），无法映射时一次性读入内存
+ * 2. 在映射的缓冲区上逐行就地切分，记号都是指向缓冲区的string_view，不产生字符串拷贝
+ * 3. 数值用std::from_chars解析
+ * 4. 行名和列名的哈希表以string_view为键，每个名字只做一次查找；
+ *    COLUMNS中同一列的连续行直接复用上一行查到的列，不再查表
+ *
+ * 名字只在创建变量和约束时拷贝一次到Problem的名字表中（keep_names为false时不拷贝；
+ * 流式解压时另在名字池中保留一份作为哈希表的键）。
+ * 格式错误（无法解析的数值、未知的行或边界类型）抛出std::runtime_error，并给出行号。
+ */
+
 #include "core.h"
-#include <fstream>
-#include <sstream>
-#include <iostream>
+#include "mapped_file.h"
+#include "instrumentation.h"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <cstring>
+#include <charconv>
 #include <unordered_map>
-#include <unordered_set>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+#include <exception>
+#include <algorithm>
+
+#ifdef MIPSOLVER_HAVE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef MIPSOLVER_HAVE_ZSTD
+#include <zstd.h>
+#endif
 
 namespace MIPSolver {
+    enum class MPSFormat {
+        FREE,
+        FIXED
+    };
+
     class MPSParser {
         private:
             enum class Section {
                 NONE,
                 NAME,
+                OBJSENSE,
+                OBJNAME,
                 ROWS,
                 COLUMNS,
                 RHS,
+                RANGES,
                 BOUNDS,
                 ENDATA
             };
 
-            // Helper function to trim whitespace from a string
-            static std::string trim(const std::string& str) {
-                size_t first = str.find_first_not_of(" \t\n\r");
-                if (first == std::string::npos) return "";
-                size_t last = str.find_last_not_of(" \t\n\r");
-                return str.substr(first, (last - first + 1));
+#ifdef MIPSOLVER_HAVE_ZLIB
+            // Streaming gzip decoder over an in-memory compressed buffer; concatenated members are read in sequence
+            class GzipReader {
+                public:
+                    explicit GzipReader(std::string_view compressed) {
+                        std::memset(&stream_, 0, sizeof(stream_));
+                        if (inflateInit2(&stream_, 15 + 32) != Z_OK) {  // 15 + 32: zlib or gzip header
+                            throw std::runtime_error("Could not initialize gzip decoder");
+                        }
+                        stream_.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(compressed.data()));
+                        remaining_ = compressed.size();
+                    }
+                    ~GzipReader() { inflateEnd(&stream_); }
+
+                    GzipReader(const GzipReader&) = delete;
+                    GzipReader& operator=(const GzipReader&) = delete;
+
+                    // Fills up to capacity bytes; returns 0 only at the end of the input
+                    size_t read(char* out, size_t capacity) {
+                        stream_.next_out = reinterpret_cast<Bytef*>(out);
+                        stream_.avail_out = static_cast<uInt>(std::min<size_t>(capacity, 1u << 30));
+                        const uInt requested = stream_.avail_out;
+                        while (stream_.avail_out > 0 && !finished_) {
+                            if (stream_.avail_in == 0) {
+                                stream_.avail_in = static_cast<uInt>(std::min<size_t>(remaining_, 1u << 30));
+                                remaining_ -= stream_.avail_in;
+                            }
+                            int status = inflate(&stream_, Z_NO_FLUSH);
+                            if (status == Z_STREAM_END) {
+                                if (stream_.avail_in == 0 && remaining_ == 0) {
+                                    finished_ = true;
+                                } else if (inflateReset(&stream_) != Z_OK) {
+                                    throw std::runtime_error("Corrupt gzip stream");
+                                }
+                            } else if (status != Z_OK) {
+                                if (status == Z_BUF_ERROR && stream_.avail_in == 0 && remaining_ == 0) {
+                                    throw std::runtime_error("Truncated gzip stream");
+                                }
+                                throw std::runtime_error(std::string("Corrupt gzip stream: ") +
+                                                         (stream_.msg ? stream_.msg : "inflate failed"));
+                            }
+                        }
+                        return requested - stream_.avail_out;
+                    }
+
+                private:
+                    z_stream stream_;
+                    size_t remaining_ = 0;   // compressed bytes not yet handed to zlib
+                    bool finished_ = false;
+            };
+#endif
+
+#ifdef MIPSOLVER_HAVE_ZSTD
+            // Streaming zstd decoder over an in-memory compressed buffer
+            class ZstdReader {
+                public:
+                    explicit ZstdReader(std::string_view compressed)
+                        : stream_(ZSTD_createDStream()), input_{compressed.data(), compressed.size(), 0} {
+                        if (!stream_ || ZSTD_isError(ZSTD_initDStream(stream_))) {
+                            ZSTD_freeDStream(stream_);
+                            throw std::runtime_error("Could not initialize zstd decoder");
+                        }
+                    }
+                    ~ZstdReader() { ZSTD_freeDStream(stream_); }
+
+                    ZstdReader(const ZstdReader&) = delete;
+                    ZstdReader& operator=(const ZstdReader&) = delete;
+
+                    // Fills up to capacity bytes; returns 0 only at the end of the input
+                    size_t read(char* out, size_t capacity) {
+                        ZSTD_outBuffer output{out, capacity, 0};
+                        while (output.pos < output.size) {
+                            if (input_.pos == input_.size && pending_ == 0) break;  // all frames complete
+                            size_t consumed = input_.pos;
+                            size_t produced = output.pos;
+                            pending_ = ZSTD_decompressStream(stream_, &output, &input_);
+                            if (ZSTD_isError(pending_)) {
+                                throw std::runtime_error(std::string("Corrupt zstd stream: ") +
+                                                         ZSTD_getErrorName(pending_));
+                            }
+                            if (input_.pos == consumed && output.pos == produced) {
+                                throw std::runtime_error("Truncated zstd stream");
+                            }
+                        }
+                        return output.pos;
+                    }
+
+                private:
+                    ZSTD_DStream* stream_;
+                    ZSTD_inBuffer input_;
+                    size_t pending_ = 0;  // nonzero while a frame is incomplete
+            };
+#endif
+
+            // Stable storage for names whose source buffer is reused (streamed input)
+            class NameArena {
+                public:
+                    std::string_view store(std::string_view name) {
+                        if (name.empty()) return std::string_view();
+                        char* target;
+                        if (name.size() > kBlockSize) {
+                            blocks_.emplace_back(new char[name.size()]);
+                            target = blocks_.back().get();
+                        } else {
+                            if (name.size() > kBlockSize - used_) {
+                                blocks_.emplace_back(new char[kBlockSize]);
+                                current_ = blocks_.back().get();
+                                used_ = 0;
+                            }
+                            target = current_ + used_;
+                            used_ += name.size();
+                        }
+                        std::memcpy(target, name.data(), name.size());
+                        return std::string_view(target, name.size());
+                    }
+
+                private:
+                    static constexpr size_t kBlockSize = 1 << 16;
+                    std::vector<std::unique_ptr<char[]>> blocks_;
+                    char* current_ = nullptr;
+                    size_t used_ = kBlockSize;
+            };
+
+            // Fields of one line; views into the parsed buffer
+            static constexpr int kMaxTokens = 8;
+            struct Line {
+                std::string_view tokens[kMaxTokens];
+                int count = 0;
+                long long number = 0;  // 1-based line number for error messages
+            };
+
+            // Single-lookup name tables; keys point into the parsed buffer (or the name arena)
+            using NameMap = std::unordered_map<std::string_view, int>;
+
+            // Row table entries that are not constraint indices
+            static constexpr int kObjectiveRow = -1;
+            static constexpr int kFreeRow = -2;
+
+            struct ParseState {
+                Problem& problem;
+                MPSFormat format;
+                bool transient_input = false;  // line buffers are reused, names must be copied
+                NameArena names;
+                NameMap variables;
+                NameMap rows;
+                bool has_objective = false;
+                std::string_view objective_name;  // from OBJNAME, empty if not given
+                bool in_integer_section = false;
+                std::string_view last_column;  // column of the previous COLUMNS line
+                int last_column_index = -1;
+
+                ParseState(Problem& p, MPSFormat f) : problem(p), format(f) {}
+            };
+
+            /*
+             * 并行解析的一块COLUMNS
+             *
+             * 列按块内出现的顺序编号（同一列连续的行共用一个编号）；
+             * entries和objective中的列号先是块内局部编号，合并时换成全局编号
+             */
+            struct ColumnChunk {
+                size_t begin = 0;
+                size_t end = 0;
+                long long first_line = 0;  // number of the line before begin
+                std::vector<std::string_view> columns;
+                std::vector<signed char> integrality;  // 1 / 0, or -1 if no marker was seen earlier in the chunk
+                std::vector<SparseMatrixBuilder::Triplet> entries;
+                std::vector<std::pair<int, double>> objective;
+                bool marker_seen = false;
+                bool in_integer_section = false;  // marker state at the end of the chunk
+                std::exception_ptr error;
+            };
+
+            // Decompressed text is parsed in blocks of this size
+            static constexpr size_t kStreamBlockSize = 1 << 20;
+            // Smallest COLUMNS section worth splitting, and the granularity of chunk boundaries
+            static constexpr size_t kMinParallelBytes = 4 << 20;
+            static constexpr size_t kCheckpointBytes = 1 << 16;
+
+            static bool isSpace(char c) {
+                return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\f' || c == '\v';
+            }
+
+            static std::string_view trimView(std::string_view text) {
+                size_t first = 0;
+                size_t last = text.size();
+                while (first < last && isSpace(text[first])) ++first;
+                while (last > first && isSpace(text[last - 1])) --last;
+                return text.substr(first, last - first);
+            }
+
+            static void tokenize(std::string_view text, Line& line) {
+                line.count = 0;
+                size_t pos = 0;
+                const size_t size = text.size();
+                while (line.count < kMaxTokens) {
+                    while (pos < size && isSpace(text[pos])) ++pos;
+                    if (pos >= size) break;
+                    size_t start = pos;
+                    while (pos < size && !isSpace(text[pos])) ++pos;
+                    line.tokens[line.count++] = text.substr(start, pos - start);
+                }
+            }
+
+            // Fixed format data line: fields at columns 2-3, 5-12, 15-22, 25-36, 40-47, 50-61; blank fields are dropped
+            static void tokenizeFixed(std::string_view text, Line& line) {
+                static constexpr size_t kFieldStart[6] = {1, 4, 14, 24, 39, 49};
+                static constexpr size_t kFieldEnd[6] = {3, 12, 22, 36, 47, 61};
+                line.count = 0;
+                for (int f = 0; f < 6 && kFieldStart[f] < text.size(); ++f) {
+                    std::string_view field = trimView(text.substr(kFieldStart[f], kFieldEnd[f] - kFieldStart[f]));
+                    if (!field.empty()) line.tokens[line.count++] = field;
+                }
             }
 
-            // Helper function to split string by whitespace
-            static std::vector<std::string> split(const std::string& str) {
-                std::istringstream iss(str);
-                std::vector<std::string> tokens;
-                std::string token;
-                while (iss >> token) {
-                    tokens.push_back(token);
+            // Re-split an indented data line by column positions in fixed format (marker lines stay free-form)
+            static void splitDataLine(std::string_view text, MPSFormat format, Line& line) {
+                if (format == MPSFormat::FIXED && isSpace(text[0]) &&
+                    text.find("'MARKER'") == std::string_view::npos) {
+                    tokenizeFixed(text, line);
                 }
-                return tokens;
+            }
+
+            static double parseNumber(std::string_view token, const Line& line) {
+                const char* first = token.data();
+                const char* last = first + token.size();
+                if (first != last && *first == '+') ++first;  // from_chars rejects a leading '+'
+                double value = 0.0;
+                std::from_chars_result result = std::from_chars(first, last, value);
+                if (result.ec != std::errc() || result.ptr != last) {
+                    throw std::runtime_error("Invalid number '" + std::string(token) +
+                                             "' on line " + std::to_string(line.number));
+                }
+                return value;
+            }
+
+            [[noreturn]] static void fail(const std::string& message, const Line& line) {
+                throw std::runtime_error(message + " on line " + std::to_string(line.number));
+            }
+
+            static bool sectionFromName(std::string_view head, Section& section) {
+                if (head == "NAME") section = Section::NAME;
+                else if (head == "OBJSENSE" || head == "OBJSENS") section = Section::OBJSENSE;
+                else if (head == "OBJNAME") section = Section::OBJNAME;
+                else if (head == "ROWS") section = Section::ROWS;
+                else if (head == "COLUMNS") section = Section::COLUMNS;
+                else if (head == "RHS") section = Section::RHS;
+                else if (head == "RANGES") section = Section::RANGES;
+                else if (head == "BOUNDS") section = Section::BOUNDS;
+                else if (head == "ENDATA") section = Section::ENDATA;
+                else return false;
+                return true;
+            }
+
+            static bool isUnsupportedSection(std::string_view head) {
+                return head == "QUADOBJ" || head == "QMATRIX" || head == "QSECTION" || head == "QCMATRIX" ||
+                       head == "SOS" || head == "INDICATORS" || head == "CSECTION";
+            }
+
+            // Whether a line starting in column 1 opens a new section
+            static bool isSectionHeader(std::string_view text) {
+                if (text.empty() || isSpace(text[0]) || text[0] == '*') return false;
+                size_t length = 0;
+                while (length < text.size() && !isSpace(text[length])) ++length;
+                Section section = Section::NONE;
+                std::string_view head = text.substr(0, length);
+                return sectionFromName(head, section) || isUnsupportedSection(head);
             }
 
         public:
-            static Problem parseFromFile(const std::string& filename) {
-                std::ifstream file(filename);
-                if (!file.is_open()) {
-                    throw std::runtime_error("Could not open file: " + filename);
+            /*
+             * 读取MPS文件
+             *
+             * @param format: 字段的切分方式
+             * @param num_threads: 解析COLUMNS段的线程数，1为顺序解析，0为全部硬件线程
+             * @param keep_names: 是否在Problem中保存行名和列名（见Problem::setKeepNames）
+             */
+            static Problem parseFromFile(const std::string& filename, MPSFormat format = MPSFormat::FREE,
+                                         int num_threads = 1, bool keep_names = true) {
+                MIPSOLVER_TRACE_SCOPE(PARSE);
+                MappedFile file(filename);
+                std::string_view data = file.data();
+                if (data.size() >= 2 && static_cast<unsigned char>(data[0]) == 0x1f &&
+                    static_cast<unsigned char>(data[1]) == 0x8b) {
+#ifdef MIPSOLVER_HAVE_ZLIB
+                    GzipReader reader(data);
+                    return parseStream(reader, filename, format, keep_names);
+#else
+                    throw std::runtime_error("gzip-compressed MPS input requires MIPSOLVER_HAVE_ZLIB: " + filename);
+#endif
+                }
+                if (data.size() >= 4 && static_cast<unsigned char>(data[0]) == 0x28 &&
+                    static_cast<unsigned char>(data[1]) == 0xb5 && static_cast<unsigned char>(data[2]) == 0x2f &&
+                    static_cast<unsigned char>(data[3]) == 0xfd) {
+#ifdef MIPSOLVER_HAVE_ZSTD
+                    ZstdReader reader(data);
+                    return parseStream(reader, filename, format, keep_names);
+#else
+                    throw std::runtime_error("zstd-compressed MPS input requires MIPSOLVER_HAVE_ZSTD: " + filename);
+#endif
+                }
+                return parse(data, filename, format, num_threads, keep_names);
+            }
+
+            // 解析内存中的MPS文本
+            static Problem parseFromString(std::string_view content, const std::string& name = "MIP",
+                                           MPSFormat format = MPSFormat::FREE, int num_threads = 1,
+                                           bool keep_names = true) {
+                MIPSOLVER_TRACE_SCOPE(PARSE);
+                return parse(content, name, format, num_threads, keep_names);
+            }
+
+        private:
+            static Problem parse(std::string_view data, const std::string& name, MPSFormat format, int num_threads,
+                                 bool keep_names) {
+                if (num_threads <= 0) {
+                    num_threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
                 }
-                Problem problem(filename);
+                Problem problem(name);
+                problem.setKeepNames(keep_names);
+                ParseState state(problem, format);
                 Section currentSection = Section::NONE;
+                Line line;
 
-                // Maps to track variables and constraints by name
-                std::unordered_map<std::string, int> variableMap;
-                std::unordered_map<std::string, int> constraintMap;
-                std::unordered_set<std::string> integerVariables;
-
-                std::string line;
-                bool inIntegerSection = false;
-
-                while (std::getline(file, line)) {
-                    line = trim(line);
-                    if (line.empty() || line[0] == '*') continue; // Skip empty lines and comments
-
-                    // Determine current section
-                    if (line.find("NAME") == 0) {
-                        currentSection = Section::NAME;
-                        continue;
-                    } else if (line == "ROWS") {
-                        currentSection = Section::ROWS;
-                        continue;
-                    } else if (line == "COLUMNS") {
-                        currentSection = Section::COLUMNS;
-                        continue;
-                    } else if (line == "RHS") {
-                        currentSection = Section::RHS;
-                        continue;
-                    } else if (line == "BOUNDS") {
-                        currentSection = Section::BOUNDS;
-                        continue;
-                    } else if (line == "ENDATA") {
-                        currentSection = Section::ENDATA;
-                        break;
-                    } 
-                    // Process each section
-                    switch (currentSection) {
-                        case Section::NAME:
-                            // Problem name is already set in constructor
-                            break;
-                            
-                        case Section::ROWS:
-                            parseRowsLine(line, problem, constraintMap);
-                            break;
-                            
-                        case Section::COLUMNS:
-                            parseColumnsLine(line, problem, variableMap, constraintMap, 
-                                        inIntegerSection, integerVariables);
-                            break;
-                            
-                        case Section::RHS:
-                            parseRHSLine(line, problem, constraintMap);
-                            break;
-                            
-                        case Section::BOUNDS:
-                            parseBoundsLine(line, problem, variableMap);
-                            break;
-                            
-                        default:
-                            break;
+                size_t pos = 0;
+                while (pos < data.size()) {
+                    const char* begin = data.data() + pos;
+                    const char* newline = static_cast<const char*>(std::memchr(begin, '\n', data.size() - pos));
+                    size_t length = newline ? static_cast<size_t>(newline - begin) : data.size() - pos;
+                    pos += length + 1;
+                    line.number++;
+
+                    Section previous = currentSection;
+                    if (!processLine(std::string_view(begin, length), line, state, currentSection)) break;
+                    if (num_threads > 1 && currentSection == Section::COLUMNS && previous != Section::COLUMNS) {
+                        pos = parseColumnsParallel(data, pos, line, state, num_threads);
                     }
                 }
 
-                // Set integer variable types
-                for (const auto& varName : integerVariables) {
-                    if (variableMap.find(varName) != variableMap.end()) {
-                        int varIndex = variableMap[varName];
-                        problem.getVariable(varIndex).setType(VariableType::INTEGER);
+                return problem;
+            }
+
+            // Decompressed input: complete lines are parsed block by block, a partial last line is carried over
+            template <typename Reader>
+            static Problem parseStream(Reader& reader, const std::string& name, MPSFormat format, bool keep_names) {
+                Problem problem(name);
+                problem.setKeepNames(keep_names);
+                ParseState state(problem, format);
+                state.transient_input = true;
+                Section currentSection = Section::NONE;
+                Line line;
+
+                std::vector<char> buffer(kStreamBlockSize);
+                size_t filled = 0;
+                bool more = true;
+                bool done = false;
+                while (more && !done) {
+                    if (filled == buffer.size()) buffer.resize(buffer.size() * 2);  // line longer than the block
+                    size_t received = reader.read(buffer.data() + filled, buffer.size() - filled);
+                    more = received > 0;
+                    filled += received;
+
+                    size_t start = 0;
+                    while (start < filled && !done) {
+                        const char* begin = buffer.data() + start;
+                        const char* newline = static_cast<const char*>(std::memchr(begin, '\n', filled - start));
+                        if (!newline && more) break;
+                        size_t length = newline ? static_cast<size_t>(newline - begin) : filled - start;
+                        start += length + 1;
+                        line.number++;
+                        done = !processLine(std::string_view(begin, length), line, state, currentSection);
                     }
+                    start = std::min(start, filled);
+                    std::memmove(buffer.data(), buffer.data() + start, filled - start);
+                    filled -= start;
                 }
-                
-                file.close();
+
                 return problem;
             }
 
+            // Parses one line; returns false at ENDATA
+            static bool processLine(std::string_view text, Line& line, ParseState& state, Section& currentSection) {
+                tokenize(text, line);
+                if (line.count == 0 || line.tokens[0][0] == '*') return true; // Skip empty lines and comments
 
+                // Section headers start in column 1; a lone keyword is accepted anywhere
+                std::string_view head = line.tokens[0];
+                bool header = !isSpace(text[0]) || line.count == 1;
+                Section section = Section::NONE;
+                if (header && sectionFromName(head, section)) {
+                    currentSection = section;
+                    if (section == Section::ENDATA) return false;
+                    // Free format allows the section value on the header line
+                    if (line.count >= 2 && section == Section::OBJSENSE) {
+                        parseObjectiveSense(line.tokens[1], line, state);
+                    } else if (line.count >= 2 && section == Section::OBJNAME) {
+                        state.objective_name = state.names.store(line.tokens[1]);
+                    }
+                    return true;
+                }
+                if (!isSpace(text[0]) && isUnsupportedSection(head)) {
+                    fail("Unsupported MPS section " + std::string(head), line);
+                }
+
+                splitDataLine(text, state.format, line);
+                if (line.count == 0) return true;
+
+                // Process each section
+                switch (currentSection) {
+                    case Section::NAME:
+                        // Problem name is already set in constructor
+                        break;
+
+                    case Section::OBJSENSE:
+                        parseObjectiveSense(line.tokens[0], line, state);
+                        break;
+
+                    case Section::OBJNAME:
+                        state.objective_name = state.names.store(line.tokens[0]);
+                        break;
+
+                    case Section::ROWS:
+                        parseRowsLine(line, state);
+                        break;
+
+                    case Section::COLUMNS:
+                        parseColumnsLine(line, state);
+                        break;
+
+                    case Section::RHS:
+                    case Section::RANGES:
+                        parseRowValuesLine(line, state, currentSection == Section::RANGES);
+                        break;
+
+                    case Section::BOUNDS:
+                        parseBoundsLine(line, state);
+                        break;
+
+                    default:
+                        break;
+                }
+                return true;
+            }
+
+            // Inserts a name, copying it to the arena first when the input buffer is transient
+            static std::pair<NameMap::iterator, bool> insertName(NameMap& map, std::string_view name, int value,
+                                                                 ParseState& state) {
+                if (!state.transient_input) return map.try_emplace(name, value);
+                auto found = map.find(name);
+                if (found != map.end()) return {found, false};
+                return map.try_emplace(state.names.store(name), value);
+            }
+
+            // Name handed to the Problem; skips the copy when the Problem drops names anyway
+            static std::string problemName(std::string_view name, const ParseState& state) {
+                return state.problem.getKeepNames() ? std::string(name) : std::string();
+            }
+
+            static NameMap::iterator findOrAddVariable(std::string_view name, bool integer, ParseState& state) {
+                auto inserted = insertName(state.variables, name, state.problem.getNumVariables(), state);
+                if (inserted.second) {
+                    int varIndex = state.problem.addVariable(problemName(name, state),
+                                                             integer ? VariableType::INTEGER : VariableType::CONTINUOUS);
+                    // MPS default bounds are [0, +inf)
+                    state.problem.getVariable(varIndex).setBounds(0.0, std::numeric_limits<double>::infinity());
+                }
+                return inserted.first;
+            }
+
+            static void parseObjectiveSense(std::string_view value, const Line& line, ParseState& state) {
+                if (value == "MAX" || value == "MAXIMIZE") {
+                    state.problem.setObjectiveType(ObjectiveType::MAXIMIZE);
+                } else if (value == "MIN" || value == "MINIMIZE") {
+                    state.problem.setObjectiveType(ObjectiveType::MINIMIZE);
+                } else {
+                    fail("Unknown objective sense '" + std::string(value) + "'", line);
+                }
+            }
+
+            static void parseRowsLine(const Line& line, ParseState& state) {
+                if (line.count < 2) return;
+
+                std::string_view rowType = line.tokens[0];
+                std::string_view rowName = line.tokens[1];
 
-        private:
-            static void parseRowsLine(const std::string& line, Problem& problem, 
-                                    std::unordered_map<std::string, int>& constraintMap) {
-                std::vector<std::string> tokens = split(line);
-                if (tokens.size() < 2) return;
-                
-                std::string rowType = tokens[0];
-                std::string rowName = tokens[1];
-                
                 if (rowType == "N") {
-                    // Objective function - don't create constraint
+                    // The first N row (or the one named by OBJNAME) is the objective; other free rows are dropped
+                    bool objective = !state.has_objective &&
+                                     (state.objective_name.empty() || state.objective_name == rowName);
+                    state.has_objective = state.has_objective || objective;
+                    insertName(state.rows, rowName, objective ? kObjectiveRow : kFreeRow, state);
                     return;
                 }
-                
+
                 ConstraintType type;
                 if (rowType == "E") {
                     type = ConstraintType::EQUAL;
@@ -142,120 +589,263 @@ namespace MIPSolver {
                 } else if (rowType == "G") {
                     type = ConstraintType::GREATER_EQUAL;
                 } else {
-                    return; // Unknown constraint type
+                    fail("Unknown row type '" + std::string(rowType) + "'", line);
+                }
+
+                if (insertName(state.rows, rowName, state.problem.getNumConstraints(), state).second) {
+                    state.problem.addConstraint(problemName(rowName, state), type, 0.0);
                 }
-                
-                int constraintIndex = problem.addConstraint(rowName, type, 0.0);
-                constraintMap[rowName] = constraintIndex;
             }
-            
-            static void parseColumnsLine(const std::string& line, Problem& problem,
-                                    std::unordered_map<std::string, int>& variableMap,
-                                    std::unordered_map<std::string, int>& constraintMap,
-                                    bool& inIntegerSection,
-                                    std::unordered_set<std::string>& integerVariables) {
-                std::vector<std::string> tokens = split(line);
-                if (tokens.size() < 3) return;
-                
+
+            // Integer marker line; returns false for ordinary coefficient lines
+            static bool parseMarker(const Line& line, bool& in_integer_section) {
+                if (line.tokens[1] != "'MARKER'") return false;
+                if (line.tokens[2] == "'INTORG'") {
+                    in_integer_section = true;
+                } else if (line.tokens[2] == "'INTEND'") {
+                    in_integer_section = false;
+                }
+                return true;
+            }
+
+            static void parseColumnsLine(const Line& line, ParseState& state) {
+                if (line.count < 3) return;
+
                 // Check for integer markers
-                if (tokens.size() >= 3 && tokens[1] == "'MARKER'") {
-                    if (tokens[2] == "'INTORG'") {
-                        inIntegerSection = true;
-                    } else if (tokens[2] == "'INTEND'") {
-                        inIntegerSection = false;
+                if (parseMarker(line, state.in_integer_section)) return;
+
+                // Consecutive lines of the same column skip the lookup
+                std::string_view varName = line.tokens[0];
+                int varIndex = state.last_column_index;
+                if (varIndex < 0 || varName != state.last_column) {
+                    // Columns first seen inside an INTORG/INTEND block are integer
+                    auto found = findOrAddVariable(varName, state.in_integer_section, state);
+                    varIndex = found->second;
+                    state.last_column = found->first;
+                    state.last_column_index = varIndex;
+                }
+
+                // Process coefficient pairs (row_name coefficient)
+                for (int i = 1; i + 1 < line.count; i += 2) {
+                    auto found = state.rows.find(line.tokens[i]);
+                    if (found == state.rows.end() || found->second == kFreeRow) continue;
+
+                    double coefficient = parseNumber(line.tokens[i + 1], line);
+                    if (found->second == kObjectiveRow) {
+                        state.problem.setObjectiveCoefficient(varIndex, coefficient);
+                    } else {
+                        state.problem.addConstraintCoefficient(found->second, varIndex, coefficient);
                     }
-                    return;
                 }
-                
-                std::string varName = tokens[0];
-                
-                // Create variable if it doesn't exist
-                if (variableMap.find(varName) == variableMap.end()) {
-                    int varIndex = problem.addVariable(varName, VariableType::CONTINUOUS);
-                    variableMap[varName] = varIndex;
-                    
-                    if (inIntegerSection) {
-                        integerVariables.insert(varName);
+            }
+
+            /*
+             * 并行解析COLUMNS段
+             *
+             * @param pos: COLUMNS标题行之后的位置
+             * @return: 下一个段标题行的位置；段太小时原样返回pos，由调用者继续顺序解析
+             */
+            static size_t parseColumnsParallel(std::string_view data, size_t pos, Line& line, ParseState& state,
+                                               int num_threads) {
+                // Find the end of the section, remembering line starts with their numbers as split points
+                std::vector<std::pair<size_t, long long>> checkpoints;
+                size_t end = pos;
+                long long lines = line.number;
+                size_t next_checkpoint = pos;
+                while (end < data.size()) {
+                    const char* begin = data.data() + end;
+                    const char* newline = static_cast<const char*>(std::memchr(begin, '\n', data.size() - end));
+                    size_t length = newline ? static_cast<size_t>(newline - begin) : data.size() - end;
+                    if (isSectionHeader(std::string_view(begin, length))) break;
+                    if (end >= next_checkpoint) {
+                        checkpoints.push_back({end, lines});
+                        next_checkpoint = end + kCheckpointBytes;
+                    }
+                    end += length + 1;
+                    lines++;
+                }
+                end = std::min(end, data.size());
+                if (end - pos < kMinParallelBytes) return pos;
+
+                // One chunk per thread, each starting at a checkpoint
+                std::vector<ColumnChunk> chunks;
+                size_t next = 0;
+                for (int k = 0; k < num_threads && next < checkpoints.size(); ++k) {
+                    ColumnChunk chunk;
+                    chunk.begin = checkpoints[next].first;
+                    chunk.first_line = checkpoints[next].second;
+                    size_t target = pos + (end - pos) * (k + 1) / num_threads;
+                    while (next < checkpoints.size() && checkpoints[next].first < target) ++next;
+                    chunk.end = next < checkpoints.size() ? checkpoints[next].first : end;
+                    chunks.push_back(std::move(chunk));
+                }
+
+                std::vector<std::thread> threads;
+                for (size_t k = 1; k < chunks.size(); ++k) {
+                    threads.emplace_back([&, k]() { parseColumnChunk(data, chunks[k], state); });
+                }
+                parseColumnChunk(data, chunks[0], state);
+                for (std::thread& thread : threads) thread.join();
+
+                // Create the variables in file order; the marker state carries across chunks
+                std::vector<std::vector<int>> global(chunks.size());
+                bool in_integer_section = state.in_integer_section;
+                for (size_t k = 0; k < chunks.size(); ++k) {
+                    ColumnChunk& chunk = chunks[k];
+                    if (chunk.error) std::rethrow_exception(chunk.error);
+                    global[k].resize(chunk.columns.size());
+                    for (size_t c = 0; c < chunk.columns.size(); ++c) {
+                        bool integer = chunk.integrality[c] < 0 ? in_integer_section : chunk.integrality[c] > 0;
+                        global[k][c] = findOrAddVariable(chunk.columns[c], integer, state)->second;
                     }
+                    if (chunk.marker_seen) in_integer_section = chunk.in_integer_section;
+                }
+                state.in_integer_section = in_integer_section;
+                state.last_column_index = -1;
+
+                // Local to global column numbers, then append the buffers in order
+                threads.clear();
+                for (size_t k = 1; k < chunks.size(); ++k) {
+                    threads.emplace_back([&, k]() {
+                        for (auto& entry : chunks[k].entries) entry.col = global[k][entry.col];
+                    });
                 }
-                
-                int varIndex = variableMap[varName];
-                
-                // Process coefficient pairs (constraint_name coefficient)
-                for (size_t i = 1; i + 1 < tokens.size(); i += 2) {
-                    std::string constraintName = tokens[i];
-                    double coefficient = std::stod(tokens[i + 1]);
-                    
-                    if (constraintName == "COST") {
-                        // This is objective function coefficient
-                        problem.setObjectiveCoefficient(varIndex, coefficient);
-                    } else if (constraintMap.find(constraintName) != constraintMap.end()) {
-                        // This is a constraint coefficient
-                        int constraintIndex = constraintMap[constraintName];
-                        problem.getConstraint(constraintIndex).addVariable(varIndex, coefficient);
+                for (auto& entry : chunks[0].entries) entry.col = global[0][entry.col];
+                for (std::thread& thread : threads) thread.join();
+
+                for (size_t k = 0; k < chunks.size(); ++k) {
+                    for (const auto& objective : chunks[k].objective) {
+                        state.problem.setObjectiveCoefficient(global[k][objective.first], objective.second);
                     }
+                    state.problem.addConstraintCoefficients(chunks[k].entries);
+                    std::vector<SparseMatrixBuilder::Triplet>().swap(chunks[k].entries);
                 }
+
+                line.number = lines;
+                return end;
             }
-            
-            static void parseRHSLine(const std::string& line, Problem& problem,
-                                std::unordered_map<std::string, int>& constraintMap) {
-                std::vector<std::string> tokens = split(line);
-                if (tokens.size() < 3) return;
-                
-                // Skip RHS name (tokens[0])
-                // Process constraint_name rhs_value pairs
-                for (size_t i = 1; i + 1 < tokens.size(); i += 2) {
-                    std::string constraintName = tokens[i];
-                    double rhsValue = std::stod(tokens[i + 1]);
-                    
-                    if (constraintMap.find(constraintName) != constraintMap.end()) {
-                        int constraintIndex = constraintMap[constraintName];
-                        // Update constraint RHS (need to modify Constraint class)
-                        // For now, we'll store it - you may need to add a setRHS method
-                        problem.getConstraint(constraintIndex).setRHS(rhsValue);
+
+            // Worker side of parseColumnsParallel; only reads the row table
+            static void parseColumnChunk(std::string_view data, ColumnChunk& chunk, const ParseState& state) {
+                try {
+                    Line line;
+                    line.number = chunk.first_line;
+                    size_t pos = chunk.begin;
+                    std::string_view last_column;
+                    int column = -1;
+                    while (pos < chunk.end) {
+                        const char* begin = data.data() + pos;
+                        const char* newline = static_cast<const char*>(std::memchr(begin, '\n', chunk.end - pos));
+                        size_t length = newline ? static_cast<size_t>(newline - begin) : chunk.end - pos;
+                        std::string_view text(begin, length);
+                        pos += length + 1;
+                        line.number++;
+
+                        tokenize(text, line);
+                        if (line.count == 0 || line.tokens[0][0] == '*') continue;
+                        splitDataLine(text, state.format, line);
+                        if (line.count < 3) continue;
+
+                        if (parseMarker(line, chunk.in_integer_section)) {
+                            chunk.marker_seen = true;
+                            continue;
+                        }
+
+                        if (column < 0 || line.tokens[0] != last_column) {
+                            last_column = line.tokens[0];
+                            column = static_cast<int>(chunk.columns.size());
+                            chunk.columns.push_back(last_column);
+                            chunk.integrality.push_back(chunk.marker_seen ? (chunk.in_integer_section ? 1 : 0) : -1);
+                        }
+
+                        for (int i = 1; i + 1 < line.count; i += 2) {
+                            auto found = state.rows.find(line.tokens[i]);
+                            if (found == state.rows.end() || found->second == kFreeRow) continue;
+
+                            double coefficient = parseNumber(line.tokens[i + 1], line);
+                            if (found->second == kObjectiveRow) {
+                                chunk.objective.push_back({column, coefficient});
+                            } else {
+                                chunk.entries.push_back({found->second, column, coefficient});
+                            }
+                        }
                     }
+                } catch (...) {
+                    chunk.error = std::current_exception();
                 }
             }
-            
-            static void parseBoundsLine(const std::string& line, Problem& problem,
-                                    std::unordered_map<std::string, int>& variableMap) {
-                std::vector<std::string> tokens = split(line);
-                if (tokens.size() < 3) return;
-                
-                std::string boundType = tokens[0];
-                std::string boundName = tokens[1]; // Usually "bnd"
-                std::string varName = tokens[2];
-                
-                if (variableMap.find(varName) == variableMap.end()) {
+
+            // RHS and RANGES lines: [set_name] row_name value [row_name value]
+            static void parseRowValuesLine(const Line& line, ParseState& state, bool ranges) {
+                for (int i = line.count % 2; i + 1 < line.count; i += 2) {
+                    auto found = state.rows.find(line.tokens[i]);
+                    if (found == state.rows.end() || found->second < 0) continue; // Objective constant is ignored
+
+                    double value = parseNumber(line.tokens[i + 1], line);
+                    Constraint constraint = state.problem.getConstraint(found->second);
+                    if (ranges) {
+                        constraint.setRange(value);
+                    } else {
+                        constraint.setRHS(value);
+                    }
+                }
+            }
+
+            // BOUNDS lines: type [set_name] column [value]
+            static void parseBoundsLine(const Line& line, ParseState& state) {
+                if (line.count < 2) return;
+
+                const double inf = std::numeric_limits<double>::infinity();
+                std::string_view boundType = line.tokens[0];
+                bool needs_value = !(boundType == "FR" || boundType == "MI" || boundType == "PL" || boundType == "BV");
+
+                // Without a value field a BV/FR/MI/PL line is "type column" or "type set column"
+                int column_field = 1;
+                if (needs_value ? line.count >= 4
+                                : line.count >= 3 && state.variables.count(line.tokens[2]) > 0) {
+                    column_field = 2;
+                }
+                auto found = state.variables.find(line.tokens[column_field]);
+                if (found == state.variables.end()) {
                     return; // Variable not found
                 }
-                
-                int varIndex = variableMap[varName];
-                Variable& var = problem.getVariable(varIndex);
-                
-                if (boundType == "BV") {
+                Variable var = state.problem.getVariable(found->second);
+
+                double value = 0.0;
+                if (needs_value) {
+                    if (column_field + 1 >= line.count) return;
+                    value = parseNumber(line.tokens[column_field + 1], line);
+                }
+
+                if (boundType == "LO" || boundType == "LI") {
+                    var.setBounds(value, var.getUpperBound());
+                } else if (boundType == "UP" || boundType == "UI") {
+                    // A negative upper bound on a default lower bound frees the lower bound
+                    double lower = (value < 0.0 && var.getLowerBound() == 0.0) ? -inf : var.getLowerBound();
+                    var.setBounds(lower, value);
+                } else if (boundType == "FX") {
+                    var.setBounds(value, value);
+                } else if (boundType == "FR") {
+                    var.setBounds(-inf, inf);
+                } else if (boundType == "MI") {
+                    var.setBounds(-inf, var.getUpperBound());
+                } else if (boundType == "PL") {
+                    var.setBounds(var.getLowerBound(), inf);
+                } else if (boundType == "BV") {
                     // Binary variable: 0 <= x <= 1
                     var.setType(VariableType::BINARY);
                     var.setBounds(0.0, 1.0);
-                } else if (boundType == "LO") {
-                    // Lower bound
-                    if (tokens.size() >= 4) {
-                        double lowerBound = std::stod(tokens[3]);
-                        var.setBounds(lowerBound, var.getUpperBound());
-                    }
-                } else if (boundType == "UP") {
-                    // Upper bound
-                    if (tokens.size() >= 4) {
-                        double upperBound = std::stod(tokens[3]);
-                        var.setBounds(var.getLowerBound(), upperBound);
-                    }
-                } else if (boundType == "FX") {
-                    // Fixed variable
-                    if (tokens.size() >= 4) {
-                        double fixedValue = std::stod(tokens[3]);
-                        var.setBounds(fixedValue, fixedValue);
-                    }
+                } else if (boundType == "SC") {
+                    fail("Semi-continuous bound type SC is not supported", line);
+                } else {
+                    fail("Unknown bound type '" + std::string(boundType) + "'", line);
+                }
+
+                if ((boundType == "LI" || boundType == "UI") && var.getType() == VariableType::CONTINUOUS) {
+                    var.setType(VariableType::INTEGER);
                 }
             }
         };
-}
\ No newline at end of file
+}
+
+#endif
@@ -0,0 +1,292 @@
+#ifndef PORTFOLIO_SOLVER_H
+#define PORTFOLIO_SOLVER_H
+
+/*
+ * 并发竞速求解
+ *
+ * 同一个问题上不同设置的分支定界求解时间可能相差数倍，而事先很难知道哪一种最快。
+ * PortfolioSolver同时运行几个设置不同的BranchBoundSolver（参赛者），每个参赛者占用自己的线程：
+ *
+ * 1. 参赛者：节点选择策略、分支规则、随机数种子（交给ALNS）不同，
+ *    其余设置来自SolverInterface（限制、每个参赛者的线程数、初始解、解池容量）和configure回调；
+ *    时间、节点数和工作量上限对每个参赛者分别生效
+ *
+ * 2. 协作：
+ *    - 任何参赛者找到更好的解时，写入共享的最优解和截断值（BranchBoundSolver::setSharedCutoff），
+ *      其他参赛者在下一个节点用它剪枝
+ *    - 第一个完成证明的参赛者（OPTIMAL、INFEASIBLE或UNBOUNDED）获胜，其余参赛者被停止
+ *    - 因截断值而"没有更好的解"（INFEASIBLE）的证明，在已有共享解时即为该解的最优性证明
+ *
+ * 3. 结果：最好的解、获胜者的状态，对偶界取各参赛者中最紧的一个，
+ *    节点数和LP迭代数是全部参赛者之和，解池合并各参赛者的解池
+ *
+ * 进度回调收到的目标值是共享的最优值、对偶界是各参赛者最近一次报告中最紧的界，回调之间互斥。
+ * 多个参赛者各自用满setNumThreads个线程，默认每个参赛者单线程
+ */
+
+#include "core.h"
+#include "solution.h"
+#include "branch_bound_solver.h"
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <exception>
+#include <limits>
+#include <chrono>
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+
+namespace MIPSolver {
+
+class PortfolioSolver : public SolverInterface {
+public:
+    using IncumbentCallback = BranchBoundSolver::IncumbentCallback;
+    // Applied to racer `index` after the portfolio settings and the racer's own strategies
+    using Configure = std::function<void(BranchBoundSolver& solver, size_t index)>;
+
+    struct Racer {
+        NodeSelectionRule node_selection;
+        BranchingRule branching_rule;
+        unsigned seed;
+    };
+
+    /*
+     * 默认的四个参赛者：默认设置、最优界优先加伪成本分支、深度优先、最优估计加最大分数分支
+     */
+    PortfolioSolver()
+        : racers_{{NodeSelectionRule::HYBRID, BranchingRule::RELIABILITY, 42},
+                  {NodeSelectionRule::BEST_BOUND, BranchingRule::PSEUDOCOST, 1},
+                  {NodeSelectionRule::DEPTH_FIRST, BranchingRule::RELIABILITY, 2},
+                  {NodeSelectionRule::BEST_ESTIMATE, BranchingRule::MOST_FRACTIONAL, 3}} {}
+
+    void setRacers(std::vector<Racer> racers) { racers_ = std::move(racers); }
+    const std::vector<Racer>& getRacers() const { return racers_; }
+
+    /*
+     * 每个参赛者求解前的附加设置（可为空）
+     *
+     * 在参赛者的默认设置、本求解器的限制与初始解、参赛者的策略和种子之后调用；
+     * 停止标志、新最优解回调、共享截断值和进度回调由PortfolioSolver安装，configure中设置的会被替换
+     */
+    void setConfigure(Configure configure) { configure_ = std::move(configure); }
+
+    // 外部停止标志（可为nullptr），语义同BranchBoundSolver::setStopFlag
+    void setStopFlag(const std::atomic<bool>* stop) { stop_flag_ = stop; }
+
+    // 共享最优解改进时回调（为空时不回调）；在参赛者的求解线程上运行，调用之间互斥
+    void setIncumbentCallback(IncumbentCallback callback) { incumbent_callback_ = std::move(callback); }
+
+    // 上一次求解的获胜者在getRacers中的下标，没有参赛者完成证明时为-1
+    int getWinner() const { return winner_; }
+
+    Solution solve(const Problem& problem) override {
+        if (racers_.empty()) {
+            throw std::runtime_error("PortfolioSolver: no racers configured");
+        }
+        auto start_time = std::chrono::steady_clock::now();
+        const ObjectiveType obj_type = problem.getObjectiveType();
+        const double worst = (obj_type == ObjectiveType::MINIMIZE ? 1.0 : -1.0) * std::numeric_limits<double>::infinity();
+        problem.getMatrix().buildColumnView();  // built once here rather than raced by the threads
+
+        Race race(racers_.size(), worst);
+        std::vector<std::unique_ptr<BranchBoundSolver>> solvers;
+        for (size_t r = 0; r < racers_.size(); ++r) {
+            solvers.push_back(std::make_unique<BranchBoundSolver>());
+            configureRacer(*solvers[r], r, race, obj_type);
+        }
+
+        std::vector<std::unique_ptr<Solution>> results(racers_.size());
+        std::vector<std::exception_ptr> errors(racers_.size());
+        std::vector<std::thread> threads;
+        for (size_t r = 0; r < racers_.size(); ++r) {
+            threads.emplace_back([&, r] {
+                try {
+                    results[r] = std::make_unique<Solution>(solvers[r]->solve(problem));
+                } catch (...) {
+                    errors[r] = std::current_exception();
+                }
+                std::lock_guard<std::mutex> lock(race.mutex);
+                if (results[r] && race.winner < 0 && isProof(results[r]->getStatus())) {
+                    race.winner = static_cast<int>(r);
+                    race.stop.store(true);
+                }
+                race.running--;
+                race.finished.notify_all();
+            });
+        }
+        {
+            // The external flag is polled and forwarded so that racers only watch the portfolio's own flag
+            std::unique_lock<std::mutex> lock(race.mutex);
+            while (race.running > 0) {
+                race.finished.wait_for(lock, std::chrono::milliseconds(kStopPollMillis));
+                if (stop_flag_ && stop_flag_->load(std::memory_order_relaxed)) race.stop.store(true);
+            }
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        for (const std::exception_ptr& error : errors) {
+            if (error) std::rethrow_exception(error);
+        }
+        winner_ = race.winner;
+
+        Solution solution = combine(problem, race, results, worst);
+        solution.setSolveTime(std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count());
+        if (verbose_) {
+            std::cout << "Portfolio: " << racers_.size() << " racers, winner "
+                      << (winner_ >= 0 ? std::to_string(winner_) : std::string("none"))
+                      << ", objective " << solution.getObjectiveValue() << ", bound " << solution.getDualBound()
+                      << ", nodes " << solution.getNodeCount() << std::endl;
+        }
+        return solution;
+    }
+
+private:
+    static constexpr int kStopPollMillis = 20;
+
+    // State shared by the racers of one solve
+    struct Race {
+        Race(size_t racers, double worst)
+            : cutoff(worst), best_objective(worst), running(static_cast<int>(racers)),
+              nodes(racers, 0), bounds(racers, -worst) {}
+
+        std::atomic<bool> stop{false};
+        std::atomic<double> cutoff;   // best shared objective, read by the racers before each node
+        std::mutex mutex;             // guards everything below
+        std::condition_variable finished;
+        double best_objective;
+        std::vector<double> best_values;
+        std::vector<Solution::IncumbentRecord> history;
+        int winner = -1;
+        int running;
+        std::vector<long long> nodes;  // latest progress report of each racer
+        std::vector<double> bounds;
+        std::mutex progress_mutex;     // serializes the user's progress callback
+    };
+
+    std::vector<Racer> racers_;
+    Configure configure_;
+    const std::atomic<bool>* stop_flag_ = nullptr;
+    IncumbentCallback incumbent_callback_;
+    int winner_ = -1;
+
+    static bool isProof(Solution::Status status) {
+        return status == Solution::Status::OPTIMAL || status == Solution::Status::INFEASIBLE ||
+               status == Solution::Status::UNBOUNDED;
+    }
+
+    static bool isBetter(double a, double b, ObjectiveType obj_type) {
+        return obj_type == ObjectiveType::MINIMIZE ? a < b : a > b;
+    }
+
+    void configureRacer(BranchBoundSolver& solver, size_t r, Race& race, ObjectiveType obj_type) {
+        solver.setTimeLimit(time_limit_);
+        solver.setIterationLimit(iteration_limit_);
+        solver.setWorkLimit(work_limit_);
+        solver.setNumThreads(num_threads_);
+        solver.setSolutionPoolSize(solution_pool_size_);
+        for (const MIPStart& start : mip_starts_) {
+            solver.addMIPStart(start.indices, start.values);
+        }
+        solver.setNodeSelection(racers_[r].node_selection);
+        solver.setBranchingRule(racers_[r].branching_rule);
+        solver.setRandomSeed(racers_[r].seed);
+        if (configure_) configure_(solver, r);
+
+        solver.setStopFlag(&race.stop);
+        solver.setSharedCutoff(&race.cutoff);
+        solver.setIncumbentCallback([this, &race, obj_type, start = std::chrono::steady_clock::now()](
+                                        const std::vector<double>& values, double objective) {
+            std::lock_guard<std::mutex> lock(race.mutex);
+            if (!isBetter(objective, race.best_objective, obj_type)) return;
+            race.best_objective = objective;
+            race.best_values = values;
+            race.cutoff.store(objective);
+            long long nodes = 0;
+            for (long long count : race.nodes) nodes += count;
+            race.history.push_back({std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(),
+                                    nodes, objective});
+            if (incumbent_callback_) incumbent_callback_(values, objective);
+        });
+        // Installed even without a user callback: the reports keep the per-racer node counts of the history
+        solver.setProgressCallback([this, &race, r, obj_type](const SolveProgress& progress) {
+            SolveProgress merged = progress;
+            {
+                std::lock_guard<std::mutex> lock(race.mutex);
+                race.nodes[r] = progress.nodes;
+                race.bounds[r] = progress.dual_bound;
+                merged.nodes = 0;
+                merged.dual_bound = race.bounds[0];
+                for (size_t k = 0; k < race.bounds.size(); ++k) {
+                    merged.nodes += race.nodes[k];
+                    if (isBetter(merged.dual_bound, race.bounds[k], obj_type)) merged.dual_bound = race.bounds[k];
+                }
+                merged.objective = race.best_objective;
+            }
+            if (!progress_callback_) return;
+            merged.gap = Solution::relativeGap(merged.objective, merged.dual_bound);
+            std::lock_guard<std::mutex> lock(race.progress_mutex);
+            progress_callback_(merged);
+        }, progress_interval_);
+    }
+
+    Solution combine(const Problem& problem, const Race& race, const std::vector<std::unique_ptr<Solution>>& results,
+                     double worst) const {
+        const ObjectiveType obj_type = problem.getObjectiveType();
+        const bool found = !race.best_values.empty();
+        const Solution& lead = *results[race.winner >= 0 ? race.winner : 0];
+
+        Solution solution(problem.getNumVariables());
+        if (found) {
+            for (int j = 0; j < problem.getNumVariables(); ++j) {
+                solution.setValue(j, race.best_values[j]);
+            }
+        }
+        solution.setObjectiveValue(found ? race.best_objective : worst);
+
+        // The tightest bound any racer proved; a finished proof closes the gap to the shared solution
+        double bound = -worst;
+        long long nodes = 0;
+        long long lp_iterations = 0;
+        double work = 0.0;
+        SolutionPool pool(obj_type, solution_pool_size_);
+        for (const auto& result : results) {
+            if (isBetter(result->getDualBound(), bound, obj_type)) continue;
+            bound = result->getDualBound();
+        }
+        for (const auto& result : results) {
+            nodes += result->getNodeCount();
+            lp_iterations += result->getLPIterations();
+            work += result->getWorkUnits();
+            for (const Solution::PoolEntry& entry : result->getSolutionPool()) {
+                pool.add(entry.objective, entry.values);
+            }
+        }
+        if (found && isBetter(race.best_objective, bound, obj_type)) bound = race.best_objective;
+        solution.setDualBound(bound);
+        solution.setIterations(static_cast<int>(std::min<long long>(nodes, std::numeric_limits<int>::max())));
+        solution.setLPIterations(lp_iterations);
+        solution.setWorkUnits(work);
+        solution.setOpenNodes(race.winner >= 0 ? 0 : lead.getOpenNodes());
+        solution.setIncumbentHistory(race.history);
+        solution.setSolutionPool(pool.entries());
+
+        Solution::Status status = lead.getStatus();
+        if (race.winner >= 0) {
+            if (status == Solution::Status::INFEASIBLE && found) status = Solution::Status::OPTIMAL;
+        } else if (stop_flag_ && stop_flag_->load()) {
+            status = Solution::Status::INTERRUPTED;
+        }
+        solution.setStatus(status);
+        return solution;
+    }
+};
+
+} // namespace MIPSolver
+
+#endif
@@ -3,34 +3,45 @@
 
 /*
  * 单纯形法求解器
- * 
+ *
  * 这是MIPSolver中用于求解线性规划问题的核心组件，主要用途：
- * 
+ *
  * 1. 分支定界中的线性松弛求解：
  *    - 将混合整数规划的整数约束松弛为连续约束
- *    - 为分支定界提供上界（最小化）或下界（最大化）
- *    - 快速判断子问题的可行性
- * 
- * 2. 算法特点：
- *    - 简化的单纯形实现，适用于中小规模问题
- *    - 重点处理变量边界约束
- *    - 启发式约束满足方法，快速收敛
- *    - 鲁棒的数值稳定性处理
- * 
+ *    - 为分支定界提供上界（最大化）或下界（最小化）
+ *    - 可靠地判断子问题的可行性与无界性
+ *
+ * 2. 算法：有界变量修正单纯形法
+ *    - 计算形式：A x - s = 0，每行引入一个逻辑变量 s，
+ *      约束的左右端限制转化为 s 的上下界，所有变量都可以有上下界
+ *    - 基矩阵以稀疏LU分解表示（BasisFactorization），换基后做乘积形式更新，
+ *      更新次数达到上限时重新分解
+ *    - 原始单纯形：第一阶段最小化不可行量之和，第二阶段优化原目标
+ *    - 对偶单纯形：初始基对偶可行时直接使用（例如分支后仅边界改变的情形）
+ *    - Harris两遍比值检验提高数值稳定性，退化时切换到Bland规则防止循环
+ *
  * 3. 性能考虑：
- *    - 避免复杂的基变换操作
- *    - 使用迭代修正方法处理约束违反
- *    - 适合分支定界中的频繁调用
- * 
- * 注意：这不是完整的标准单纯形法实现，而是针对MIP求解优化的简化版本
+ *    - 约束矩阵同时保留列存储（FTRAN、定价）和行存储（对偶单纯形的主元行）
+ *    - 工作向量在多次求解间复用
+ *
+ * 4. 资源限制：
+ *    - setDeadline：每kDeadlineCheckInterval次迭代读取一次时钟，超过截止时刻时停止（is_time_limit）
+ *    - getWork：累计工作量，按每次迭代实际扫描的非零元和向量长度计数（定价、FTRAN/BTRAN、
+ *      比值检验、主元行、分解）。它只取决于LP数据和迭代路径，与机器速度、线程数无关，
+ *      可以作为可复现的确定性预算
  */
 
 #include "core.h"
 #include "solution.h"
+#include "basis_factorization.h"
+#include "instrumentation.h"
 #include <vector>
 #include <iostream>
 #include <iomanip>
 #include <cmath>
+#include <limits>
+#include <algorithm>
+#include <chrono>
 
 namespace MIPSolver {
 
@@ -38,9 +49,9 @@ class SimplexSolver {
 public:
     /*
      * 单纯形求解结果结构
-     * 
+     *
      * 封装线性规划求解的所有相关信息：
-     * - 求解状态：最优、无界、不可行
+     * - 求解状态：最优、无界、不可行（三者均为false表示达到迭代上限、截止时刻或数值失败）
      * - 解向量：变量的最优取值
      * - 目标函数值：最优解对应的目标函数值
      * - 迭代次数：算法收敛所需的迭代步数
@@ -49,27 +60,28 @@ public:
         bool is_optimal;      // 是否找到最优解
         bool is_unbounded;    // 是否无界（目标函数可以无限增大/减小）
         bool is_infeasible;   // 是否不可行（约束条件矛盾）
+        bool is_time_limit;   // 是否因超过截止时刻而停止
         std::vector<double> solution;    // 最优解向量
         double objective_value;          // 最优目标函数值
         int iterations;                  // 迭代次数统计
     };
-    
+
     /*
      * 构造函数
-     * 
+     *
      * @param verbose: 是否输出详细的求解过程信息
      *                 在调试模式下有助于理解算法行为
      */
-    SimplexSolver(bool verbose = false) : verbose_(verbose) {}
-    
+    SimplexSolver(bool verbose = false) : verbose_(verbose), iteration_limit_(-1) {}
+
     /*
      * 求解线性规划松弛问题
-     * 
+     *
      * 这是单纯形求解器的主要接口，用于分支定界算法中：
      * - 移除所有整数约束，将问题转换为纯线性规划
      * - 保留所有线性约束和变量边界
      * - 返回线性松弛的最优解（如果存在）
-     * 
+     *
      * @param problem: 混合整数规划问题实例
      * @return: 包含求解结果的SimplexResult结构
      */
@@ -77,118 +89,440 @@ public:
         if (verbose_) {
             std::cout << "------- Solving LP Relaxation -------" << std::endl;
         }
-        
-        return solveLPWithBounds(problem);
+
+        loadProblem(problem);
+        SimplexResult result;
+        solve(nullptr, result);
+        return result;
+    }
+
+    // 非基变量/基变量状态
+    enum class VarStatus : signed char {
+        BASIC,
+        AT_LOWER,
+        AT_UPPER,
+        AT_ZERO     // 自由非基变量，取值为0
+    };
+
+    // 紧凑的基描述：结构变量在前、逻辑变量（每行一个）在后的状态数组
+    using Basis = std::vector<VarStatus>;
+
+    /*
+     * 从给定基热启动求解
+     *
+     * 分支定界的子节点与父节点只差一个变量边界，父节点的最优基仍然对偶可行，
+     * 通常只需少量对偶单纯形迭代即可重新最优。基的维数与问题不符时退回冷启动。
+     *
+     * @param problem: 子节点问题
+     * @param warm_start: 父节点求解后由getBasis()得到的基
+     */
+    SimplexResult solveLPRelaxation(const Problem& problem, const Basis& warm_start) {
+        loadProblem(problem);
+        SimplexResult result;
+        solve(&warm_start, result);
+        return result;
+    }
+
+    /*
+     * 载入问题后按给定边界反复求解
+     *
+     * 分支定界只在根节点调用一次loadProblem，之后每个节点只传入当前的变量边界，
+     * 避免每个节点复制整个问题和约束矩阵
+     *
+     * @param lower/upper: 结构变量的当前边界（长度为变量数）
+     * @param warm_start: 热启动基，可为空
+     */
+    SimplexResult solveWithBounds(const std::vector<double>& lower, const std::vector<double>& upper,
+                                  const Basis* warm_start = nullptr) {
+        SimplexResult result;
+        solveWithBounds(lower, upper, warm_start, result);
+        return result;
+    }
+
+    // 同上，结果写入调用者持有的result，复用其解向量的容量（节点循环中不分配内存）
+    void solveWithBounds(const std::vector<double>& lower, const std::vector<double>& upper,
+                         const Basis* warm_start, SimplexResult& result) {
+        for (int j = 0; j < n_; ++j) {
+            lower_[j] = normalizeBound(lower[j]);
+            upper_[j] = normalizeBound(upper[j]);
+        }
+        solve(warm_start, result);
+    }
+
+    /*
+     * 从松弛基重新分解，只用原始单纯形求解
+     *
+     * 热启动的求解因迭代上限或数值问题停止时的恢复路径：不沿用可能已经病态的基和对偶单纯形的迭代路径
+     */
+    void solvePrimalWithBounds(const std::vector<double>& lower, const std::vector<double>& upper,
+                               SimplexResult& result) {
+        for (int j = 0; j < n_; ++j) {
+            lower_[j] = normalizeBound(lower[j]);
+            upper_[j] = normalizeBound(upper[j]);
+        }
+        solve(nullptr, result, true);
+    }
+
+    // 最近一次求解结束时的基
+    Basis getBasis() const { return status_; }
+    void getBasis(Basis& basis) const { basis.assign(status_.begin(), status_.end()); }
+
+    /*
+     * 载入问题数据
+     *
+     * 复制约束矩阵的列存储和行存储，建立逻辑变量的边界，
+     * 并将目标统一转化为最小化形式
+     */
+    void loadProblem(const Problem& problem) {
+        const SparseMatrix& matrix = problem.getMatrix();
+        matrix.buildColumnView();
+        n_ = problem.getNumVariables();
+        m_ = problem.getNumConstraints();
+        objective_sign_ = (problem.getObjectiveType() == ObjectiveType::MAXIMIZE) ? -1.0 : 1.0;
+
+        col_start_.assign(n_ + 1, 0);
+        col_index_.clear();
+        col_value_.clear();
+        col_index_.reserve(matrix.getNumNonzeros());
+        col_value_.reserve(matrix.getNumNonzeros());
+        for (int j = 0; j < n_; ++j) {
+            SparseMatrix::VectorView column = matrix.column(j);
+            col_index_.insert(col_index_.end(), column.indices, column.indices + column.size);
+            col_value_.insert(col_value_.end(), column.values, column.values + column.size);
+            col_start_[j + 1] = static_cast<int>(col_index_.size());
+        }
+        row_start_ = matrix.getRowStarts();
+        row_index_ = matrix.getColumnIndices();
+        row_value_ = matrix.getValues();
+
+        int total = n_ + m_;
+        cost_.assign(total, 0.0);
+        lower_.resize(total);
+        upper_.resize(total);
+        for (int j = 0; j < n_; ++j) {
+            ConstVariable var = problem.getVariable(j);
+            cost_[j] = objective_sign_ * var.getCoefficient();
+            lower_[j] = normalizeBound(var.getLowerBound());
+            upper_[j] = normalizeBound(var.getUpperBound());
+        }
+        for (int i = 0; i < m_; ++i) {
+            ConstConstraint constraint = problem.getConstraint(i);
+            lower_[n_ + i] = normalizeBound(constraint.getLowerLimit());
+            upper_[n_ + i] = normalizeBound(constraint.getUpperLimit());
+        }
+
+        x_.assign(total, 0.0);
+        status_.assign(total, VarStatus::AT_LOWER);
+        dual_.assign(total, 0.0);
+        row_alpha_.assign(total, 0.0);
+        basis_head_.assign(m_, 0);
+        alpha_.assign(m_, 0.0);
+        rho_.assign(m_, 0.0);
+        y_.assign(m_, 0.0);
+        refactor_needed_ = true;
+    }
+
+    // 单次求解的迭代上限（负数表示按问题规模自动确定）
+    void setIterationLimit(int limit) { iteration_limit_ = limit; }
+
+    // 求解的截止时刻；time_point::max()表示不限时
+    void setDeadline(std::chrono::steady_clock::time_point deadline) { deadline_ = deadline; }
+
+    // 自构造以来累计的工作量（扫描的非零元数），loadProblem不清零
+    long long getWork() const { return work_; }
+
+    // 已载入问题的维数
+    int getNumColumns() const { return n_; }
+    int getNumRows() const { return m_; }
+
+    /*
+     * 在已载入的LP末尾追加约束行（用于割平面）
+     *
+     * 新行的逻辑变量进入基，因此当前基仍然有效。追加之前保存的较短的基
+     * 仍可用于热启动：缺少的行按逻辑变量在基中处理
+     *
+     * @param row_start/col_index/values: 新行的CSR存储（row_start长度为新行数+1）
+     * @param lower/upper: 新行活动度的上下限
+     */
+    void addRows(const std::vector<int>& row_start, const std::vector<int>& col_index,
+                 const std::vector<double>& values, const std::vector<double>& lower,
+                 const std::vector<double>& upper) {
+        int added = static_cast<int>(lower.size());
+        if (added == 0) return;
+
+        for (int r = 0; r < added; ++r) {
+            double activity = 0.0;
+            for (int k = row_start[r]; k < row_start[r + 1]; ++k) {
+                row_index_.push_back(col_index[k]);
+                row_value_.push_back(values[k]);
+                activity += values[k] * x_[col_index[k]];
+            }
+            row_start_.push_back(static_cast<int>(row_index_.size()));
+            cost_.push_back(0.0);
+            lower_.push_back(normalizeBound(lower[r]));
+            upper_.push_back(normalizeBound(upper[r]));
+            x_.push_back(activity);
+            status_.push_back(VarStatus::BASIC);
+            dual_.push_back(0.0);
+            basis_head_.push_back(n_ + m_ + r);
+        }
+        m_ += added;
+        row_alpha_.assign(n_ + m_, 0.0);
+        alpha_.assign(m_, 0.0);
+        rho_.assign(m_, 0.0);
+        y_.assign(m_, 0.0);
+
+        // Rebuild the column copy; rows are visited in order so columns stay sorted by row
+        std::vector<int> next(n_ + 1, 0);
+        for (int c : row_index_) next[c + 1]++;
+        for (int j = 0; j < n_; ++j) next[j + 1] += next[j];
+        col_start_ = next;
+        col_index_.resize(row_index_.size());
+        col_value_.resize(row_index_.size());
+        for (int i = 0; i < m_; ++i) {
+            for (int k = row_start_[i]; k < row_start_[i + 1]; ++k) {
+                int pos = next[row_index_[k]]++;
+                col_index_[pos] = i;
+                col_value_[pos] = row_value_[k];
+            }
+        }
+        refactor_needed_ = true;
     }
 
+    /*
+     * 单纯形表的一行（用于Gomory割）
+     *
+     * 计算形式 A x - s = 0 下，基位置position上的基变量满足
+     *   x_B + sum_j alpha_j x_j = 0（对全部非基列j求和，逻辑变量n+i的列为 -e_i）
+     * 只返回非零的alpha_j。须在最近一次求解达到最优之后、改变LP之前调用
+     */
+    void getTableauRow(int position, std::vector<int>& indices, std::vector<double>& values) {
+        std::fill(rho_.begin(), rho_.end(), 0.0);
+        rho_[position] = 1.0;
+        lu_.btran(rho_);
+        computePivotRow();
+        indices.clear();
+        values.clear();
+        for (int j = 0; j < n_ + m_; ++j) {
+            if (status_[j] == VarStatus::BASIC || std::abs(row_alpha_[j]) <= 1e-12) continue;
+            indices.push_back(j);
+            values.push_back(row_alpha_[j]);
+        }
+    }
+
+    // 最近一次求解结束时第position个基位置上的变量（结构变量 < n，逻辑变量 n+i）
+    int getBasicVariable(int position) const { return basis_head_[position]; }
+
+    // 最近一次求解结束时变量的取值（包括逻辑变量，即行活动度）
+    double getValue(int j) const { return x_[j]; }
+
 private:
+    enum class LPStatus {
+        OPTIMAL,
+        INFEASIBLE,
+        UNBOUNDED,
+        ITERATION_LIMIT,
+        TIME_LIMIT,
+        NUMERICAL_ERROR
+    };
+
+    static constexpr double kInfinity = 1e20;            // 绝对值不小于此值的边界视为无穷
+    static constexpr double kPrimalTolerance = 1e-7;     // 原始可行性容差
+    static constexpr double kDualTolerance = 1e-7;       // 对偶可行性容差
+    static constexpr double kPivotTolerance = 1e-7;      // 比值检验中可接受的最小主元
+    static constexpr int kRefactorInterval = 100;        // 两次重新分解之间的最大更新次数
+    static constexpr int kDegenerateSwitch = 50;         // 连续退化迭代多少次后启用Bland规则
+    static constexpr int kDeadlineCheckInterval = 32;    // 每隔多少次迭代检查一次截止时刻
+
     bool verbose_;  // 是否输出详细求解信息的标志
-    
+    int iteration_limit_;
+
+    // LP data in computational form: columns 0..n-1 structural, n..n+m-1 logical (-e_i)
+    int n_ = 0;
+    int m_ = 0;
+    double objective_sign_ = 1.0;        // -1 for maximization (solved as min -c^T x)
+    std::vector<int> col_start_;
+    std::vector<int> col_index_;
+    std::vector<double> col_value_;
+    std::vector<int> row_start_;
+    std::vector<int> row_index_;
+    std::vector<double> row_value_;
+    std::vector<double> cost_;
+    std::vector<double> lower_;
+    std::vector<double> upper_;
+
+    // Simplex state
+    std::vector<double> x_;
+    std::vector<VarStatus> status_;
+    std::vector<int> basis_head_;        // variable at each basis position
+    std::vector<double> dual_;           // reduced costs d_j
+    BasisFactorization lu_;
+    bool refactor_needed_ = true;
+    int iterations_ = 0;
+    int limit_ = 0;
+    std::chrono::steady_clock::time_point deadline_ = std::chrono::steady_clock::time_point::max();
+    long long work_ = 0;
+
+    // Work vectors
+    std::vector<double> alpha_;          // B^{-1} a_q, by position
+    std::vector<double> rho_;            // e_r^T B^{-1}, by row
+    std::vector<double> row_alpha_;      // rho^T a_j for all j
+    std::vector<double> y_;              // simplex multipliers, by row
+    std::vector<int> basis_col_start_;
+    std::vector<int> basis_row_index_;
+    std::vector<double> basis_value_;
+
+    static bool isFinite(double bound) { return std::abs(bound) < kInfinity; }
+    static double normalizeBound(double bound) {
+        if (bound >= kInfinity) return std::numeric_limits<double>::infinity();
+        if (bound <= -kInfinity) return -std::numeric_limits<double>::infinity();
+        return bound;
+    }
+
+    // 迭代上限与截止时刻；时钟只在每kDeadlineCheckInterval次迭代时读取
+    bool limitReached(LPStatus& status) const {
+        if (iterations_ >= limit_) {
+            status = LPStatus::ITERATION_LIMIT;
+            return true;
+        }
+        if (iterations_ % kDeadlineCheckInterval == 0 && deadline_ != std::chrono::steady_clock::time_point::max() &&
+            std::chrono::steady_clock::now() >= deadline_) {
+            status = LPStatus::TIME_LIMIT;
+            return true;
+        }
+        return false;
+    }
+
+    // 一次FTRAN或BTRAN扫描的元素数
+    long long solveWork() const {
+        return static_cast<long long>(lu_.getFactorNonzeros() + lu_.getEtaNonzeros()) + m_;
+    }
+
     /*
-     * 带边界处理的线性规划求解方法
-     * 
-     * 这是简化的单纯形法实现，核心思想：
-     * 1. 初始解构造：根据目标函数系数和变量边界设置初始点
-     * 2. 约束满足：使用迭代方法调整解以满足所有线性约束
-     * 3. 可行性检查：验证最终解是否在可行域内
-     * 
-     * 算法特点：
-     * - 不使用标准的基变换操作
-     * - 采用启发式方法快速找到可行解
-     * - 适合分支定界中的频繁调用场景
-     * 
-     * @param problem: 要求解的线性规划问题
-     * @return: 求解结果结构
+     * 求解入口
+     *
+     * 有可用的热启动基时直接安装该基；否则从松弛基开始：结构变量全部置于非基，
+     * 盒式变量按目标系数符号选择边界。之后若基对偶可行则使用对偶单纯形，
+     * 否则使用原始单纯形
      */
-    SimplexResult solveLPWithBounds(const Problem& problem) {
-        SimplexResult result;
-        result.is_optimal = true;
-        result.is_unbounded = false;
-        result.is_infeasible = false;
-        result.iterations = 1;
-        result.solution.resize(problem.getNumVariables());
-        
-        if (verbose_) {
-            std::cout << "Variables and bounds:" << std::endl;
-            for (int i = 0; i < problem.getNumVariables(); ++i) {
-                const Variable& var = problem.getVariable(i);
-                std::cout << "  x" << i << ": [" << var.getLowerBound() 
-                          << ", " << var.getUpperBound() << "], coeff=" << var.getCoefficient() << std::endl;
-            }
-        }
-        
-        // Check for obvious infeasibility (lower bound > upper bound)
-        for (int i = 0; i < problem.getNumVariables(); ++i) {
-            const Variable& var = problem.getVariable(i);
-            if (var.getLowerBound() > var.getUpperBound() + 1e-9) {
-                if (verbose_) {
-                    std::cout << "Variable x" << i << " has infeasible bounds: [" 
-                              << var.getLowerBound() << ", " << var.getUpperBound() << "]" << std::endl;
-                }
-                result.is_infeasible = true;
-                return result;
-            }
-        }
-        
-        // Initialize solution with variable bounds
-        for (int i = 0; i < problem.getNumVariables(); ++i) {
-            const Variable& var = problem.getVariable(i);
-            
-            // If variable is fixed (lower == upper), use that value
-            if (std::abs(var.getLowerBound() - var.getUpperBound()) < 1e-9) {
-                result.solution[i] = var.getLowerBound();
+    void solve(const Basis* warm_start, SimplexResult& result, bool primal_only = false) {
+        MIPSOLVER_TRACE_SCOPE(LP_SOLVE);
+        MIPSOLVER_COUNT(LP_CALLS, 1);
+        iterations_ = 0;
+        limit_ = iteration_limit_ >= 0 ? iteration_limit_ : 10000 + 50 * (n_ + m_);
+
+        for (int j = 0; j < n_ + m_; ++j) {
+            if (lower_[j] > upper_[j] + kPrimalTolerance) {
                 if (verbose_) {
-                    std::cout << "  x" << i << " is fixed to " << result.solution[i] << std::endl;
+                    std::cout << "Variable " << j << " has infeasible bounds: ["
+                              << lower_[j] << ", " << upper_[j] << "]" << std::endl;
                 }
-            } else {
-                // Set based on objective coefficient and bounds
-                double coeff = var.getCoefficient();
-                if (problem.getObjectiveType() == ObjectiveType::MAXIMIZE) {
-                    // For maximization: positive coeff → upper bound, negative coeff → lower bound
-                    if (coeff > 0) {
-                        result.solution[i] = var.getUpperBound();
-                    } else {
-                        result.solution[i] = var.getLowerBound();
-                    }
-                } else {
-                    // For minimization: positive coeff → lower bound, negative coeff → upper bound
-                    if (coeff > 0) {
-                        result.solution[i] = var.getLowerBound();
-                    } else {
-                        result.solution[i] = var.getUpperBound();
-                    }
-                }
-                
-                // Handle infinite bounds
-                if (std::isinf(result.solution[i])) {
-                    if (result.solution[i] > 0) {
-                        result.solution[i] = 100.0;  // Large positive value
-                    } else {
-                        result.solution[i] = 0.0;    // Default to 0 for negative infinity
+                makeResult(LPStatus::INFEASIBLE, result);
+                return;
+            }
+        }
+
+        if (!warm_start || !installBasis(*warm_start)) {
+            for (int i = 0; i < m_; ++i) {
+                basis_head_[i] = n_ + i;
+                status_[n_ + i] = VarStatus::BASIC;
+            }
+            for (int j = 0; j < n_; ++j) {
+                placeNonbasic(j, cost_[j] >= 0.0);
+            }
+        }
+        refactor_needed_ = true;
+
+        makeResult(optimize(primal_only), result);
+    }
+
+    // Install a basis status array; nonbasic variables are moved onto their (possibly new) bounds.
+    // Rows appended after the basis was saved get their logicals basic.
+    bool installBasis(const Basis& basis) {
+        int size = static_cast<int>(basis.size());
+        if (size < n_ || size > n_ + m_) return false;
+        int basic_count = n_ + m_ - size;
+        for (VarStatus st : basis) {
+            if (st == VarStatus::BASIC) basic_count++;
+        }
+        if (basic_count != m_) return false;
+
+        int position = 0;
+        for (int j = 0; j < n_ + m_; ++j) {
+            if (j >= size) {
+                status_[j] = VarStatus::BASIC;
+                basis_head_[position++] = j;
+                continue;
+            }
+            switch (basis[j]) {
+                case VarStatus::BASIC:
+                    status_[j] = VarStatus::BASIC;
+                    basis_head_[position++] = j;
+                    break;
+                case VarStatus::AT_LOWER:
+                    placeNonbasic(j, true);
+                    break;
+                case VarStatus::AT_UPPER:
+                    placeNonbasic(j, !isFinite(upper_[j]));
+                    break;
+                case VarStatus::AT_ZERO:
+                    placeNonbasic(j, cost_[j] >= 0.0);
+                    break;
+            }
+        }
+        return true;
+    }
+
+    /*
+     * 主优化流程：根据当前基的对偶可行性选择对偶或原始单纯形（primal_only时总是原始单纯形），
+     * 最后从头重算原始解和对偶解以确认最优性
+     */
+    LPStatus optimize(bool primal_only = false) {
+        LPStatus status = LPStatus::NUMERICAL_ERROR;
+        for (int attempt = 0; attempt < 3; ++attempt) {
+            refreshFactorization();
+            computeDuals(false);
+            if (!primal_only && makeDualFeasible()) {
+                status = runDual();
+                if (status == LPStatus::OPTIMAL) {
+                    refreshFactorization();
+                    computeDuals(false);
+                    if (maxDualInfeasibility() > kDualTolerance) {
+                        status = runPrimal();
                     }
                 }
+            } else {
+                status = runPrimal();
             }
+
+            if (status != LPStatus::OPTIMAL) break;
+
+            // Final check against a fresh factorization
+            refreshFactorization();
+            if (maxPrimalInfeasibility() <= kPrimalTolerance * 10) break;
+            status = LPStatus::NUMERICAL_ERROR;
         }
-        
+
         if (verbose_) {
-            std::cout << "Initial solution: [";
-            for (size_t i = 0; i < result.solution.size(); ++i) {
-                std::cout << std::fixed << std::setprecision(2) << result.solution[i];
-                if (i < result.solution.size() - 1) std::cout << ", ";
-            }
-            std::cout << "]" << std::endl;
+            std::cout << "Simplex finished after " << iterations_ << " iterations" << std::endl;
         }
-        
-        // Adjust solution to satisfy constraints
-        if (!satisfyConstraints(problem, result.solution)) {
-            result.is_infeasible = true;
-            return result;
+        return status;
+    }
+
+    void makeResult(LPStatus status, SimplexResult& result) {
+        result.is_optimal = (status == LPStatus::OPTIMAL);
+        result.is_unbounded = (status == LPStatus::UNBOUNDED);
+        result.is_infeasible = (status == LPStatus::INFEASIBLE);
+        result.is_time_limit = (status == LPStatus::TIME_LIMIT);
+        result.iterations = iterations_;
+        MIPSOLVER_COUNT(LP_PIVOTS, iterations_);
+        result.solution.assign(x_.begin(), x_.begin() + n_);
+        result.objective_value = 0.0;
+        for (int j = 0; j < n_; ++j) {
+            result.objective_value += objective_sign_ * cost_[j] * x_[j];
         }
-        
-        // Calculate objective value
-        result.objective_value = problem.calculateObjectiveValue(result.solution);
-        
-        if (verbose_) {
+
+        if (verbose_ && result.is_optimal) {
             std::cout << "Final LP solution: [";
             for (size_t i = 0; i < result.solution.size(); ++i) {
                 std::cout << std::fixed << std::setprecision(3) << result.solution[i];
@@ -197,182 +531,478 @@ private:
             std::cout << "]" << std::endl;
             std::cout << "LP objective: " << result.objective_value << std::endl;
         }
-        
-        return result;
     }
-    
-    bool satisfyConstraints(const Problem& problem, std::vector<double>& solution) {
-        const int MAX_ITERATIONS = 20;
-        const double tolerance = 1e-6;
-        
-        for (int iter = 0; iter < MAX_ITERATIONS; ++iter) {
-            bool all_satisfied = true;
-            double max_violation = 0.0;
-            
-            // Check each constraint
-            for (int c = 0; c < problem.getNumConstraints(); ++c) {
-                const Constraint& constraint = problem.getConstraint(c);
-                
-                // Calculate LHS
-                double lhs = 0.0;
-                for (const auto& [var_idx, coeff] : constraint.getCoefficients()) {
-                    if (var_idx < solution.size()) {
-                        lhs += coeff * solution[var_idx];
-                    }
-                }
-                
-                double rhs = constraint.getRHS();
-                double violation = 0.0;
-                bool violated = false;
-                
-                // Check violation
-                switch (constraint.getType()) {
-                    case ConstraintType::LESS_EQUAL:
-                        if (lhs > rhs + tolerance) {
-                            violation = lhs - rhs;
-                            violated = true;
-                        }
-                        break;
-                    case ConstraintType::GREATER_EQUAL:
-                        if (lhs < rhs - tolerance) {
-                            violation = rhs - lhs;
-                            violated = true;
-                        }
-                        break;
-                    case ConstraintType::EQUAL:
-                        if (std::abs(lhs - rhs) > tolerance) {
-                            violation = std::abs(lhs - rhs);
-                            violated = true;
-                        }
-                        break;
+
+    // Put variable j at a bound; prefer_lower selects the side for boxed variables
+    void placeNonbasic(int j, bool prefer_lower) {
+        bool has_lower = isFinite(lower_[j]);
+        bool has_upper = isFinite(upper_[j]);
+        if (has_lower && (!has_upper || prefer_lower || lower_[j] == upper_[j])) {
+            status_[j] = VarStatus::AT_LOWER;
+            x_[j] = lower_[j];
+        } else if (has_upper) {
+            status_[j] = VarStatus::AT_UPPER;
+            x_[j] = upper_[j];
+        } else {
+            status_[j] = VarStatus::AT_ZERO;
+            x_[j] = 0.0;
+        }
+    }
+
+    // Scatter column j of [A | -I] into a dense row-indexed vector
+    void loadColumn(int j, std::vector<double>& dense) const {
+        std::fill(dense.begin(), dense.end(), 0.0);
+        if (j < n_) {
+            for (int k = col_start_[j]; k < col_start_[j + 1]; ++k) {
+                dense[col_index_[k]] = col_value_[k];
+            }
+        } else {
+            dense[j - n_] = -1.0;
+        }
+    }
+
+    // a_j^T v for a row-indexed vector v
+    double columnDot(int j, const std::vector<double>& v) const {
+        if (j >= n_) return -v[j - n_];
+        double sum = 0.0;
+        for (int k = col_start_[j]; k < col_start_[j + 1]; ++k) {
+            sum += col_value_[k] * v[col_index_[k]];
+        }
+        return sum;
+    }
+
+    /*
+     * 分解当前基矩阵
+     *
+     * 若分解发现奇异，把无法覆盖的基位置替换为对应行的逻辑变量后重新分解
+     */
+    void factorizeBasis() {
+        for (int attempt = 0; attempt <= m_; ++attempt) {
+            basis_col_start_.assign(1, 0);
+            basis_row_index_.clear();
+            basis_value_.clear();
+            for (int p = 0; p < m_; ++p) {
+                int j = basis_head_[p];
+                if (j < n_) {
+                    basis_row_index_.insert(basis_row_index_.end(),
+                                            col_index_.begin() + col_start_[j], col_index_.begin() + col_start_[j + 1]);
+                    basis_value_.insert(basis_value_.end(),
+                                        col_value_.begin() + col_start_[j], col_value_.begin() + col_start_[j + 1]);
+                } else {
+                    basis_row_index_.push_back(j - n_);
+                    basis_value_.push_back(-1.0);
                 }
-                
-                if (violated) {
-                    all_satisfied = false;
-                    max_violation = std::max(max_violation, violation);
-                    
-                    if (verbose_ && iter == 0) {
-                        std::cout << "Constraint " << constraint.getName() 
-                                  << ": " << lhs << " vs " << rhs 
-                                  << " (violation: " << violation << ")" << std::endl;
-                    }
-                    
-                    // Try to fix this constraint
-                    fixConstraintViolation(problem, solution, c, lhs, rhs, constraint.getType());
+                basis_col_start_.push_back(static_cast<int>(basis_row_index_.size()));
+            }
+
+            int singular = lu_.factorize(m_, basis_col_start_, basis_row_index_, basis_value_);
+            if (singular == 0) break;
+
+            const std::vector<int>& positions = lu_.getSingularPositions();
+            const std::vector<int>& rows = lu_.getSingularRows();
+            for (int k = 0; k < singular; ++k) {
+                int leaving = basis_head_[positions[k]];
+                placeNonbasic(leaving, dual_[leaving] >= 0.0);
+                basis_head_[positions[k]] = n_ + rows[k];
+                status_[n_ + rows[k]] = VarStatus::BASIC;
+            }
+            if (verbose_) {
+                std::cout << "Singular basis: replaced " << singular << " columns by slacks" << std::endl;
+            }
+        }
+        refactor_needed_ = false;
+    }
+
+    // Basic values from B x_B = -N x_N
+    void computePrimal() {
+        std::vector<double>& rhs = alpha_;
+        std::fill(rhs.begin(), rhs.end(), 0.0);
+        for (int j = 0; j < n_ + m_; ++j) {
+            if (status_[j] == VarStatus::BASIC || x_[j] == 0.0) continue;
+            if (j < n_) {
+                for (int k = col_start_[j]; k < col_start_[j + 1]; ++k) {
+                    rhs[col_index_[k]] -= col_value_[k] * x_[j];
                 }
+            } else {
+                rhs[j - n_] += x_[j];
             }
-            
-            if (all_satisfied) {
-                if (verbose_ && iter > 0) {
-                    std::cout << "Constraints satisfied after " << iter << " adjustments" << std::endl;
+        }
+        lu_.ftran(rhs);
+        for (int p = 0; p < m_; ++p) {
+            x_[basis_head_[p]] = rhs[p];
+        }
+    }
+
+    void refreshFactorization() {
+        MIPSOLVER_COUNT(REFACTORIZATIONS, 1);
+        factorizeBasis();
+        computePrimal();
+        work_ += static_cast<long long>(basis_value_.size() + col_index_.size()) + solveWork();
+    }
+
+    double phaseOneCost(int j) const {
+        if (x_[j] < lower_[j] - kPrimalTolerance) return -1.0;
+        if (x_[j] > upper_[j] + kPrimalTolerance) return 1.0;
+        return 0.0;
+    }
+
+    // Simplex multipliers and reduced costs; phase_one uses the infeasibility costs
+    void computeDuals(bool phase_one) {
+        for (int p = 0; p < m_; ++p) {
+            int j = basis_head_[p];
+            y_[p] = phase_one ? phaseOneCost(j) : cost_[j];
+        }
+        lu_.btran(y_);
+        work_ += solveWork() + static_cast<long long>(col_index_.size()) + n_ + m_;
+        for (int j = 0; j < n_ + m_; ++j) {
+            if (status_[j] == VarStatus::BASIC) {
+                dual_[j] = 0.0;
+            } else {
+                dual_[j] = (phase_one ? 0.0 : cost_[j]) - columnDot(j, y_);
+            }
+        }
+    }
+
+    double maxPrimalInfeasibility() const {
+        double worst = 0.0;
+        for (int p = 0; p < m_; ++p) {
+            int j = basis_head_[p];
+            worst = std::max(worst, std::max(lower_[j] - x_[j], x_[j] - upper_[j]));
+        }
+        return worst;
+    }
+
+    double maxDualInfeasibility() const {
+        double worst = 0.0;
+        for (int j = 0; j < n_ + m_; ++j) {
+            if (lower_[j] == upper_[j]) continue;
+            switch (status_[j]) {
+                case VarStatus::AT_LOWER: worst = std::max(worst, -dual_[j]); break;
+                case VarStatus::AT_UPPER: worst = std::max(worst, dual_[j]); break;
+                case VarStatus::AT_ZERO: worst = std::max(worst, std::abs(dual_[j])); break;
+                default: break;
+            }
+        }
+        return worst;
+    }
+
+    /*
+     * 使非基变量与其对偶值符号一致
+     *
+     * 盒式变量通过边界翻转恢复对偶可行；单侧有界或自由变量无法翻转时返回false，
+     * 此时改用原始单纯形
+     */
+    bool makeDualFeasible() {
+        bool flipped = false;
+        bool feasible = true;
+        for (int j = 0; j < n_ + m_ && feasible; ++j) {
+            if (status_[j] == VarStatus::BASIC || lower_[j] == upper_[j]) continue;
+            double d = dual_[j];
+            if (status_[j] == VarStatus::AT_LOWER && d < -kDualTolerance) {
+                if (!isFinite(upper_[j])) { feasible = false; break; }
+                status_[j] = VarStatus::AT_UPPER;
+                x_[j] = upper_[j];
+                flipped = true;
+            } else if (status_[j] == VarStatus::AT_UPPER && d > kDualTolerance) {
+                if (!isFinite(lower_[j])) { feasible = false; break; }
+                status_[j] = VarStatus::AT_LOWER;
+                x_[j] = lower_[j];
+                flipped = true;
+            } else if (status_[j] == VarStatus::AT_ZERO && std::abs(d) > kDualTolerance) {
+                feasible = false;
+            }
+        }
+        if (flipped) computePrimal();
+        return feasible;
+    }
+
+    void pivot(int position, int entering, VarStatus leaving_status) {
+        int leaving = basis_head_[position];
+        status_[leaving] = leaving_status;
+        x_[leaving] = (leaving_status == VarStatus::AT_UPPER) ? upper_[leaving] : lower_[leaving];
+        basis_head_[position] = entering;
+        status_[entering] = VarStatus::BASIC;
+        lu_.update(position, alpha_);
+        if (lu_.getNumUpdates() >= kRefactorInterval) {
+            refactor_needed_ = true;
+        }
+    }
+
+    /*
+     * 原始单纯形（两阶段合并）
+     *
+     * 每次迭代根据基变量当前的不可行情况选择第一阶段或第二阶段费用：
+     * 存在不可行基变量时最小化不可行量之和，否则优化原目标
+     */
+    LPStatus runPrimal() {
+        int degenerate_steps = 0;
+        int numerical_retries = 0;
+
+        LPStatus limit_status;
+        while (true) {
+            if (limitReached(limit_status)) return limit_status;
+            if (refactor_needed_) refreshFactorization();
+
+            bool phase_one = maxPrimalInfeasibility() > kPrimalTolerance;
+            computeDuals(phase_one);
+            bool bland = degenerate_steps >= kDegenerateSwitch;
+
+            // Pricing: Dantzig rule, or the first eligible index under Bland's rule
+            int entering = -1;
+            double best_score = 0.0;
+            for (int j = 0; j < n_ + m_; ++j) {
+                if (status_[j] == VarStatus::BASIC || lower_[j] == upper_[j]) continue;
+                double d = dual_[j];
+                double score = 0.0;
+                if (status_[j] == VarStatus::AT_LOWER && d < -kDualTolerance) score = -d;
+                else if (status_[j] == VarStatus::AT_UPPER && d > kDualTolerance) score = d;
+                else if (status_[j] == VarStatus::AT_ZERO && std::abs(d) > kDualTolerance) score = std::abs(d);
+                if (score > best_score) {
+                    best_score = score;
+                    entering = j;
+                    if (bland) break;
                 }
-                return true;
             }
-            
-            // If violation is not decreasing, we might be infeasible
-            if (iter > 5 && max_violation > 1.0) {
-                if (verbose_) {
-                    std::cout << "Large violation persists: " << max_violation << std::endl;
+
+            if (entering < 0) {
+                return phase_one ? LPStatus::INFEASIBLE : LPStatus::OPTIMAL;
+            }
+
+            double direction = dual_[entering] < 0.0 ? 1.0 : -1.0;
+            loadColumn(entering, alpha_);
+            lu_.ftran(alpha_);
+            // Pricing, FTRAN, two ratio passes and the primal update
+            work_ += (n_ + m_) + solveWork() + 3LL * m_;
+
+            // Harris ratio test, pass 1: largest step with relaxed bounds
+            double max_step = std::numeric_limits<double>::infinity();
+            for (int p = 0; p < m_; ++p) {
+                if (std::abs(alpha_[p]) < kPivotTolerance) continue;
+                double relaxed, exact;
+                VarStatus target;
+                if (!primalRatio(p, direction, bland ? 0.0 : kPrimalTolerance, relaxed, exact, target)) continue;
+                max_step = std::min(max_step, relaxed);
+            }
+
+            // Pass 2: among steps within the bound, pick the largest pivot
+            int leaving_position = -1;
+            double step = std::numeric_limits<double>::infinity();
+            VarStatus leaving_status = VarStatus::AT_LOWER;
+            double best_pivot = 0.0;
+            for (int p = 0; p < m_; ++p) {
+                if (std::abs(alpha_[p]) < kPivotTolerance) continue;
+                double relaxed, exact;
+                VarStatus target;
+                if (!primalRatio(p, direction, 0.0, relaxed, exact, target)) continue;
+                if (exact > max_step) continue;
+                bool better = bland
+                    ? (leaving_position < 0 || exact < step ||
+                       (exact == step && basis_head_[p] < basis_head_[leaving_position]))
+                    : std::abs(alpha_[p]) > best_pivot;
+                if (better) {
+                    best_pivot = std::abs(alpha_[p]);
+                    leaving_position = p;
+                    step = std::max(exact, 0.0);
+                    leaving_status = target;
                 }
-                return false;
-            }
-        }
-        
-        // Check if final solution is approximately feasible
-        double total_violation = 0.0;
-        for (int c = 0; c < problem.getNumConstraints(); ++c) {
-            const Constraint& constraint = problem.getConstraint(c);
-            double lhs = 0.0;
-            for (const auto& [var_idx, coeff] : constraint.getCoefficients()) {
-                if (var_idx < solution.size()) {
-                    lhs += coeff * solution[var_idx];
+            }
+
+            // The entering variable may reach its own opposite bound first
+            double range = upper_[entering] - lower_[entering];
+            bool bound_flip = isFinite(lower_[entering]) && isFinite(upper_[entering]) &&
+                              (leaving_position < 0 || range <= step);
+
+            if (leaving_position < 0 && !bound_flip) {
+                if (!phase_one) return LPStatus::UNBOUNDED;
+                if (++numerical_retries > 3) return LPStatus::NUMERICAL_ERROR;
+                refactor_needed_ = true;
+                continue;
+            }
+            if (bound_flip) step = range;
+
+            x_[entering] += direction * step;
+            for (int p = 0; p < m_; ++p) {
+                if (alpha_[p] != 0.0) x_[basis_head_[p]] -= direction * step * alpha_[p];
+            }
+
+            if (bound_flip) {
+                status_[entering] = (status_[entering] == VarStatus::AT_LOWER) ? VarStatus::AT_UPPER : VarStatus::AT_LOWER;
+                x_[entering] = (status_[entering] == VarStatus::AT_LOWER) ? lower_[entering] : upper_[entering];
+            } else {
+                pivot(leaving_position, entering, leaving_status);
+            }
+
+            degenerate_steps = (step < 1e-12) ? degenerate_steps + 1 : 0;
+            iterations_++;
+        }
+    }
+
+    /*
+     * 原始比值检验中单个基变量的步长限制
+     *
+     * @param tolerance: Harris第一遍放宽的边界容差
+     * @param relaxed/exact: 放宽边界和精确边界下的最大步长
+     * @param target: 该变量离基时所处的边界
+     * @return: 该基变量是否限制步长
+     */
+    bool primalRatio(int p, double direction, double tolerance,
+                     double& relaxed, double& exact, VarStatus& target) const {
+        int j = basis_head_[p];
+        double rate = -direction * alpha_[p];   // change of x_j per unit step
+        double value = x_[j];
+        bool below = value < lower_[j] - kPrimalTolerance;
+        bool above = value > upper_[j] + kPrimalTolerance;
+
+        if (rate < 0.0) {
+            // Decreasing: blocked by the lower bound unless already below it, or by the upper bound if above
+            double bound = above ? upper_[j] : lower_[j];
+            if (below || !isFinite(bound)) return false;
+            exact = (value - bound) / -rate;
+            relaxed = (value - bound + tolerance) / -rate;
+            target = above ? VarStatus::AT_UPPER : VarStatus::AT_LOWER;
+        } else {
+            double bound = below ? lower_[j] : upper_[j];
+            if (above || !isFinite(bound)) return false;
+            exact = (bound - value) / rate;
+            relaxed = (bound - value + tolerance) / rate;
+            target = below ? VarStatus::AT_LOWER : VarStatus::AT_UPPER;
+        }
+        return true;
+    }
+
+    // rho^T a_j for every nonbasic j, choosing row- or column-wise evaluation by the density of rho
+    void computePivotRow() {
+        int rho_nonzeros = 0;
+        for (int i = 0; i < m_; ++i) {
+            if (rho_[i] != 0.0) rho_nonzeros++;
+        }
+
+        work_ += n_ + 2LL * m_;
+        if (rho_nonzeros * 10 < m_) {
+            std::fill(row_alpha_.begin(), row_alpha_.begin() + n_, 0.0);
+            for (int i = 0; i < m_; ++i) {
+                double r = rho_[i];
+                if (r == 0.0) continue;
+                work_ += row_start_[i + 1] - row_start_[i];
+                for (int k = row_start_[i]; k < row_start_[i + 1]; ++k) {
+                    row_alpha_[row_index_[k]] += r * row_value_[k];
                 }
             }
-            
-            double rhs = constraint.getRHS();
-            switch (constraint.getType()) {
-                case ConstraintType::LESS_EQUAL:
-                    if (lhs > rhs + tolerance) total_violation += lhs - rhs;
-                    break;
-                case ConstraintType::GREATER_EQUAL:
-                    if (lhs < rhs - tolerance) total_violation += rhs - lhs;
-                    break;
-                case ConstraintType::EQUAL:
-                    total_violation += std::abs(lhs - rhs);
-                    break;
+        } else {
+            work_ += static_cast<long long>(col_index_.size());
+            for (int j = 0; j < n_; ++j) {
+                row_alpha_[j] = (status_[j] == VarStatus::BASIC) ? 0.0 : columnDot(j, rho_);
             }
         }
-        
-        return total_violation < 0.1;  // Accept small violations
+        for (int i = 0; i < m_; ++i) {
+            row_alpha_[n_ + i] = -rho_[i];
+        }
     }
-    
-    void fixConstraintViolation(const Problem& problem, std::vector<double>& solution, 
-                               int constraint_idx, double lhs, double rhs, ConstraintType type) {
-        const Constraint& constraint = problem.getConstraint(constraint_idx);
-        const auto& coeffs = constraint.getCoefficients();
-        
-        // Strategy: adjust variables proportionally to their contribution and flexibility
-        double target_change = 0.0;
-        
-        switch (type) {
-            case ConstraintType::LESS_EQUAL:
-                if (lhs > rhs) target_change = rhs - lhs;  // Need to decrease LHS
-                break;
-            case ConstraintType::GREATER_EQUAL:
-                if (lhs < rhs) target_change = rhs - lhs;  // Need to increase LHS
-                break;
-            case ConstraintType::EQUAL:
-                target_change = rhs - lhs;  // Move towards RHS
-                break;
-        }
-        
-        if (std::abs(target_change) < 1e-9) return;
-        
-        // Find adjustable variables (not fixed by bounds)
-        std::vector<int> adjustable_vars;
-        double total_weight = 0.0;
-        
-        for (const auto& [var_idx, coeff] : coeffs) {
-            if (var_idx < solution.size() && std::abs(coeff) > 1e-9) {
-                const Variable& var = problem.getVariable(var_idx);
-                double lower = var.getLowerBound();
-                double upper = var.getUpperBound();
-                
-                // Check if variable can be adjusted
-                bool can_adjust = false;
-                if (target_change * coeff > 0) {
-                    // Need to increase this variable's contribution
-                    can_adjust = (solution[var_idx] < upper - 1e-9);
-                } else {
-                    // Need to decrease this variable's contribution
-                    can_adjust = (solution[var_idx] > lower + 1e-9);
+
+    /*
+     * 对偶单纯形
+     *
+     * 要求当前基对偶可行：每次选择不可行量最大的基变量离基，
+     * 经对偶比值检验确定进基变量，保持对偶可行并逐步消除原始不可行
+     */
+    LPStatus runDual() {
+        int numerical_retries = 0;
+
+        LPStatus limit_status;
+        while (true) {
+            if (limitReached(limit_status)) return limit_status;
+            if (refactor_needed_) {
+                refreshFactorization();
+                computeDuals(false);
+            }
+
+            // Leaving row: largest primal infeasibility
+            int leaving_position = -1;
+            double worst = kPrimalTolerance;
+            for (int p = 0; p < m_; ++p) {
+                int j = basis_head_[p];
+                double infeasibility = std::max(lower_[j] - x_[j], x_[j] - upper_[j]);
+                if (infeasibility > worst) {
+                    worst = infeasibility;
+                    leaving_position = p;
                 }
-                
-                if (can_adjust) {
-                    adjustable_vars.push_back(var_idx);
-                    total_weight += std::abs(coeff);
+            }
+            if (leaving_position < 0) return LPStatus::OPTIMAL;
+
+            int leaving = basis_head_[leaving_position];
+            bool below = x_[leaving] < lower_[leaving];
+            double sign = below ? -1.0 : 1.0;
+
+            std::fill(rho_.begin(), rho_.end(), 0.0);
+            rho_[leaving_position] = 1.0;
+            lu_.btran(rho_);
+            computePivotRow();
+            // Leaving row choice, BTRAN, two ratio passes, FTRAN and the primal and dual updates
+            work_ += 2LL * m_ + 2 * solveWork() + 3LL * (n_ + m_);
+
+            // Harris dual ratio test
+            double max_ratio = std::numeric_limits<double>::infinity();
+            for (int j = 0; j < n_ + m_; ++j) {
+                if (status_[j] == VarStatus::BASIC || lower_[j] == upper_[j]) continue;
+                double a = sign * row_alpha_[j];
+                if (status_[j] == VarStatus::AT_LOWER && a > kPivotTolerance) {
+                    max_ratio = std::min(max_ratio, (dual_[j] + kDualTolerance) / a);
+                } else if (status_[j] == VarStatus::AT_UPPER && a < -kPivotTolerance) {
+                    max_ratio = std::min(max_ratio, (dual_[j] - kDualTolerance) / a);
+                } else if (status_[j] == VarStatus::AT_ZERO && std::abs(a) > kPivotTolerance) {
+                    max_ratio = std::min(max_ratio, kDualTolerance / std::abs(a));
                 }
             }
-        }
-        
-        if (adjustable_vars.empty() || total_weight < 1e-9) return;
-        
-        // Adjust variables proportionally
-        for (int var_idx : adjustable_vars) {
-            double coeff = coeffs.at(var_idx);
-            double weight = std::abs(coeff) / total_weight;
-            double var_change = target_change * weight / coeff;
-            
-            const Variable& var = problem.getVariable(var_idx);
-            double new_value = solution[var_idx] + var_change;
-            
-            // Respect bounds
-            new_value = std::max(var.getLowerBound(), std::min(var.getUpperBound(), new_value));
-            solution[var_idx] = new_value;
+
+            int entering = -1;
+            double best_pivot = 0.0;
+            for (int j = 0; j < n_ + m_; ++j) {
+                if (status_[j] == VarStatus::BASIC || lower_[j] == upper_[j]) continue;
+                double a = sign * row_alpha_[j];
+                double ratio;
+                if (status_[j] == VarStatus::AT_LOWER && a > kPivotTolerance) ratio = dual_[j] / a;
+                else if (status_[j] == VarStatus::AT_UPPER && a < -kPivotTolerance) ratio = dual_[j] / a;
+                else if (status_[j] == VarStatus::AT_ZERO && std::abs(a) > kPivotTolerance) ratio = 0.0;
+                else continue;
+                if (ratio <= max_ratio && std::abs(a) > best_pivot) {
+                    best_pivot = std::abs(a);
+                    entering = j;
+                }
+            }
+
+            if (entering < 0) return LPStatus::INFEASIBLE;
+
+            loadColumn(entering, alpha_);
+            lu_.ftran(alpha_);
+            double pivot_value = alpha_[leaving_position];
+            if (std::abs(pivot_value - row_alpha_[entering]) > 1e-6 * (1.0 + std::abs(pivot_value))) {
+                // Row and column disagree: the factorization has drifted
+                if (++numerical_retries > 3) return LPStatus::NUMERICAL_ERROR;
+                refactor_needed_ = true;
+                continue;
+            }
+
+            double dual_step = dual_[entering] / row_alpha_[entering];
+            double bound = below ? lower_[leaving] : upper_[leaving];
+            double primal_step = (x_[leaving] - bound) / pivot_value;
+
+            for (int p = 0; p < m_; ++p) {
+                if (alpha_[p] != 0.0) x_[basis_head_[p]] -= primal_step * alpha_[p];
+            }
+            x_[entering] += primal_step;
+
+            for (int j = 0; j < n_ + m_; ++j) {
+                if (status_[j] != VarStatus::BASIC) dual_[j] -= dual_step * row_alpha_[j];
+            }
+            dual_[entering] = 0.0;
+            dual_[leaving] = -dual_step;
+
+            pivot(leaving_position, entering, below ? VarStatus::AT_LOWER : VarStatus::AT_UPPER);
+            iterations_++;
         }
     }
 };
 
 } // namespace MIPSolver
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,143 @@
+/*
+ * 0-1问题的专用传播：BinaryPropagator与通用DomainPropagator在同样的固定序列下给出相同的定义域，
+ * 分支定界开、关0-1特化求得相同的最优值
+ */
+
+#include "test_common.h"
+#include "parser.h"
+#include "binary_domain.h"
+#include "branch_bound_solver.h"
+#include <random>
+#include <vector>
+
+using namespace MIPSolver;
+
+// Adds n binary variables with the given objective coefficients
+static void addBinaries(Problem& problem, const std::vector<double>& objective) {
+    int n = static_cast<int>(objective.size());
+    std::vector<double> lower(n, 0.0), upper(n, 1.0);
+    std::vector<VariableType> types(n, VariableType::BINARY);
+    problem.addVariables(n, lower.data(), upper.data(), objective.data(), types.data());
+}
+
+// max c^T x  s.t.  A x <= b  with positive weights (multi-dimensional knapsack)
+static Problem knapsack(int n, int m, unsigned seed) {
+    std::mt19937 rng(seed);
+    Problem problem("knapsack", ObjectiveType::MAXIMIZE);
+    std::vector<double> objective(n);
+    for (double& c : objective) c = 10 + rng() % 90;
+    addBinaries(problem, objective);
+    for (int i = 0; i < m; ++i) {
+        double total = 0.0;
+        std::vector<double> weights(n);
+        for (double& w : weights) total += w = 5 + rng() % 60;
+        int row = problem.addConstraint("cap" + std::to_string(i), ConstraintType::LESS_EQUAL, std::floor(total / 3));
+        for (int j = 0; j < n; ++j) problem.addConstraintCoefficient(row, j, weights[j]);
+    }
+    return problem;
+}
+
+// min c^T x  s.t.  every row covered at least once
+static Problem setCover(int n, int m, unsigned seed) {
+    std::mt19937 rng(seed);
+    Problem problem("cover", ObjectiveType::MINIMIZE);
+    std::vector<double> objective(n);
+    for (double& c : objective) c = 1 + rng() % 20;
+    addBinaries(problem, objective);
+    for (int i = 0; i < m; ++i) {
+        int row = problem.addConstraint("cover" + std::to_string(i), ConstraintType::GREATER_EQUAL, 1.0);
+        for (int j = 0; j < n; ++j) {
+            if (rng() % 8 == 0 || j == static_cast<int>(rng() % n)) problem.addConstraintCoefficient(row, j, 1.0);
+        }
+    }
+    return problem;
+}
+
+// Generalized assignment: each job to exactly one agent, agent capacities, plus a mixed-sign side row
+static Problem assignment(int agents, int jobs, unsigned seed) {
+    std::mt19937 rng(seed);
+    Problem problem("gap", ObjectiveType::MINIMIZE);
+    std::vector<double> objective(agents * jobs);
+    for (double& c : objective) c = 5 + rng() % 40;
+    addBinaries(problem, objective);
+    for (int t = 0; t < jobs; ++t) {
+        int row = problem.addConstraint("job" + std::to_string(t), ConstraintType::EQUAL, 1.0);
+        for (int a = 0; a < agents; ++a) problem.addConstraintCoefficient(row, a * jobs + t, 1.0);
+    }
+    for (int a = 0; a < agents; ++a) {
+        int row = problem.addConstraint("agent" + std::to_string(a), ConstraintType::LESS_EQUAL,
+                                        static_cast<double>(2 * jobs / agents + 2));
+        for (int t = 0; t < jobs; ++t) problem.addConstraintCoefficient(row, a * jobs + t, 1.0 + rng() % 4);
+    }
+    int side = problem.addConstraint("side", ConstraintType::GREATER_EQUAL, -2.0);
+    for (int t = 0; t < jobs; ++t) problem.addConstraintCoefficient(side, t, t % 2 ? 1.0 : -1.0);
+    return problem;
+}
+
+// Random dives: both engines get the same fixings and must agree after every propagation and undo
+static void compareDives(const Problem& problem, unsigned seed) {
+    CHECK(BinaryPropagator::supports(problem));
+    DomainPropagator general;
+    BinaryPropagator binary;
+    general.load(problem);
+    binary.load(problem);
+    CHECK(general.lower() == binary.lower() && general.upper() == binary.upper());
+
+    std::mt19937 rng(seed);
+    const int n = problem.getNumVariables();
+    int infeasible = 0;
+    for (int dive = 0; dive < 3000; ++dive) {
+        size_t general_mark = general.mark();
+        size_t binary_mark = binary.mark();
+        bool feasible = true;
+        for (int depth = 0; depth < 12 && feasible; ++depth) {
+            int j = static_cast<int>(rng() % n);
+            bool up = rng() & 1;
+            bool a = up ? general.tightenLower(j, 1.0) : general.tightenUpper(j, 0.0);
+            bool b = up ? binary.tightenLower(j, 1.0) : binary.tightenUpper(j, 0.0);
+            CHECK(a == b);
+            a = a && general.propagate();
+            b = b && binary.propagate();
+            CHECK(a == b);
+            feasible = a && b;
+            // After an infeasible propagation the engines may stop at different rows
+            if (feasible) CHECK(general.lower() == binary.lower() && general.upper() == binary.upper());
+        }
+        infeasible += !feasible;
+        general.undo(general_mark);
+        binary.undo(binary_mark);
+        CHECK(general.lower() == binary.lower() && general.upper() == binary.upper());
+    }
+    CHECK(infeasible > 0);  // the dives reach conflicts, so that path is covered too
+}
+
+static Solution solve(const Problem& problem, bool specialize) {
+    BranchBoundSolver solver;
+    solver.setALNS(false);
+    solver.setBinarySpecialization(specialize);
+    return solver.solve(problem);
+}
+
+int main() {
+    // General integer examples keep the generic engine
+    CHECK(!BinaryPropagator::supports(MPSParser::parseFromFile("examples/mps/bk4x3.mps")));
+    Problem fractional = knapsack(5, 1, 1);
+    fractional.setVariableBounds(2, 0.0, 2.0);
+    CHECK(!BinaryPropagator::supports(fractional));
+
+    const Problem models[] = {knapsack(30, 5, 11), setCover(60, 40, 12), assignment(5, 15, 13)};
+    unsigned seed = 100;
+    for (const Problem& problem : models) {
+        compareDives(problem, seed++);
+
+        Solution specialized = solve(problem, true);
+        Solution general = solve(problem, false);
+        CHECK(specialized.getStatus() == Solution::Status::OPTIMAL);
+        CHECK(general.getStatus() == Solution::Status::OPTIMAL);
+        CHECK_NEAR(specialized.getObjectiveValue(), general.getObjectiveValue());
+        CHECK(problem.isValidSolution(specialized.getValues(), 1e-6));
+        std::printf("%-9s optimum %g (binary %d nodes, general %d nodes)\n", problem.getName().c_str(),
+                    specialized.getObjectiveValue(), specialized.getNodeCount(), general.getNodeCount());
+    }
+    return MIPSolverTest::finish("test_binary_propagation");
+}
@@ -0,0 +1,100 @@
+/*
+ * C API批量装载：非法的变量类型、约束类型和下标返回-1且问题保持不变；
+ * 按行（CSR）和按列（CSC）装入的同一模型求得相同的最优值
+ */
+
+#include "test_common.h"
+#include "mipsolver_c_api.h"
+
+// max 5x0 + 4x1 + 3x2  s.t.  2x0 + 3x1 + x2 <= 5,  4x0 + x1 + 2x2 <= 11,  3x0 + 4x1 + 2x2 <= 8,  x >= 0 integer
+static const double kObjective[] = {5.0, 4.0, 3.0};
+static const double kLower[] = {0.0, 0.0, 0.0};
+static const int kIntegerTypes[] = {MIPSOLVER_VAR_INTEGER, MIPSOLVER_VAR_INTEGER, MIPSOLVER_VAR_INTEGER};
+static const int kRowTypes[] = {MIPSOLVER_CONSTRAINT_LESS_EQUAL, MIPSOLVER_CONSTRAINT_LESS_EQUAL,
+                                MIPSOLVER_CONSTRAINT_LESS_EQUAL};
+static const double kRHS[] = {5.0, 11.0, 8.0};
+static const int kRowStart[] = {0, 3, 6, 9};
+static const int kColIndex[] = {0, 1, 2, 0, 1, 2, 0, 1, 2};
+static const double kRowValues[] = {2.0, 3.0, 1.0, 4.0, 1.0, 2.0, 3.0, 4.0, 2.0};
+static const int kColStart[] = {0, 3, 6, 9};
+static const int kRowIndex[] = {0, 1, 2, 0, 1, 2, 0, 1, 2};
+static const double kColValues[] = {2.0, 4.0, 3.0, 3.0, 1.0, 4.0, 1.0, 2.0, 2.0};
+static const double kOptimum = 13.0;
+
+static void expectOptimum(MIPSolver_ProblemHandle problem) {
+    MIPSolver_SolutionHandle solution = MIPSolver_Solve(problem);
+    CHECK(solution != nullptr);
+    CHECK(MIPSolver_GetStatus(solution) == MIPSOLVER_STATUS_OPTIMAL);
+    CHECK_NEAR(MIPSolver_GetObjectiveValue(solution), kOptimum);
+    CHECK(MIPSolver_GetSolutionNumVars(solution) == 3);
+    double values[3] = {};
+    MIPSolver_GetVariableValues(solution, values);
+    CHECK_NEAR(values[0], 2.0);
+    CHECK_NEAR(values[1], 0.0);
+    CHECK_NEAR(values[2], 1.0);
+    MIPSolver_DestroySolution(solution);
+}
+
+static void testVariables() {
+    MIPSolver_ProblemHandle problem = MIPSolver_CreateProblem("vars", MIPSOLVER_OBJ_MAXIMIZE);
+    const int bad_high[] = {MIPSOLVER_VAR_INTEGER, 5, MIPSOLVER_VAR_CONTINUOUS};
+    const int bad_low[] = {-1, MIPSOLVER_VAR_BINARY, MIPSOLVER_VAR_CONTINUOUS};
+    CHECK(MIPSolver_AddVariables(problem, 3, kLower, nullptr, kObjective, bad_high, nullptr) == -1);
+    CHECK(MIPSolver_AddVariables(problem, 3, kLower, nullptr, kObjective, bad_low, nullptr) == -1);
+    CHECK(MIPSolver_AddVariables(problem, -1, nullptr, nullptr, nullptr, nullptr, nullptr) == -1);
+    CHECK(MIPSolver_AddVariables(nullptr, 3, kLower, nullptr, kObjective, kIntegerTypes, nullptr) == -1);
+    CHECK(MIPSolver_AddColsCSC(problem, 3, kColStart, kRowIndex, kColValues, kLower, nullptr, kObjective, bad_high,
+                               nullptr) == -1);
+
+    // Nothing was added: the first valid call starts at index 0
+    const char* names[] = {"a", "b", "c"};
+    CHECK(MIPSolver_AddVariables(problem, 3, kLower, nullptr, kObjective, kIntegerTypes, names) == 0);
+    CHECK(MIPSolver_AddVariables(problem, 0, nullptr, nullptr, nullptr, nullptr, nullptr) == 3);
+    MIPSolver_DestroyProblem(problem);
+}
+
+static void testRowsCSR() {
+    MIPSolver_ProblemHandle problem = MIPSolver_CreateProblem("rows", MIPSOLVER_OBJ_MAXIMIZE);
+    CHECK(MIPSolver_AddVariables(problem, 3, kLower, nullptr, kObjective, kIntegerTypes, nullptr) == 0);
+
+    const int bad_types[] = {MIPSOLVER_CONSTRAINT_LESS_EQUAL, 3, MIPSOLVER_CONSTRAINT_EQUAL};
+    CHECK(MIPSolver_AddRowsCSR(problem, 3, kRowStart, kColIndex, kRowValues, bad_types, kRHS, nullptr) == -1);
+    const int out_of_range[] = {0, 1, 2, 0, 3, 2, 0, 1, 2};
+    CHECK(MIPSolver_AddRowsCSR(problem, 3, kRowStart, out_of_range, kRowValues, kRowTypes, kRHS, nullptr) == -1);
+    const int negative[] = {0, 1, 2, 0, 1, 2, 0, 1, -1};
+    CHECK(MIPSolver_AddRowsCSR(problem, 3, kRowStart, negative, kRowValues, kRowTypes, kRHS, nullptr) == -1);
+    const int decreasing[] = {0, 3, 2, 9};
+    CHECK(MIPSolver_AddRowsCSR(problem, 3, decreasing, kColIndex, kRowValues, kRowTypes, kRHS, nullptr) == -1);
+    CHECK(MIPSolver_AddRowsCSR(problem, 3, kRowStart, nullptr, kRowValues, kRowTypes, kRHS, nullptr) == -1);
+    CHECK(MIPSolver_AddRowsCSR(problem, 3, kRowStart, kColIndex, kRowValues, nullptr, kRHS, nullptr) == -1);
+
+    // The failed calls left no rows behind, so the model is exactly the valid one
+    const char* names[] = {"r0", "r1", "r2"};
+    CHECK(MIPSolver_AddRowsCSR(problem, 3, kRowStart, kColIndex, kRowValues, kRowTypes, kRHS, names) == 0);
+    expectOptimum(problem);
+    MIPSolver_DestroyProblem(problem);
+}
+
+static void testColumnsCSC() {
+    MIPSolver_ProblemHandle problem = MIPSolver_CreateProblem("cols", MIPSOLVER_OBJ_MAXIMIZE);
+    const int empty[] = {0, 0, 0, 0};
+    CHECK(MIPSolver_AddRowsCSR(problem, 3, empty, nullptr, nullptr, kRowTypes, kRHS, nullptr) == 0);
+
+    const int out_of_range[] = {0, 1, 2, 0, 1, 3, 0, 1, 2};
+    CHECK(MIPSolver_AddColsCSC(problem, 3, kColStart, out_of_range, kColValues, kLower, nullptr, kObjective,
+                               kIntegerTypes, nullptr) == -1);
+    CHECK(MIPSolver_AddColsCSC(problem, 3, kColStart, nullptr, kColValues, kLower, nullptr, kObjective, kIntegerTypes,
+                               nullptr) == -1);
+
+    CHECK(MIPSolver_AddColsCSC(problem, 3, kColStart, kRowIndex, kColValues, kLower, nullptr, kObjective,
+                               kIntegerTypes, nullptr) == 0);
+    expectOptimum(problem);
+    MIPSolver_DestroyProblem(problem);
+}
+
+int main() {
+    testVariables();
+    testRowsCSR();
+    testColumnsCSC();
+    return MIPSolverTest::finish("test_c_api");
+}
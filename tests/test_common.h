@@ -0,0 +1,67 @@
+#ifndef MIPSOLVER_TEST_COMMON_H
+#define MIPSOLVER_TEST_COMMON_H
+
+/*
+ * C++回归测试的公共部分
+ *
+ * 每个 tests/test_*.cpp 是一个独立的程序，由 tests/test_native.py 编译运行（python -m pytest tests/）。
+ * 检查失败时打印位置并计数，main返回失败数；工作目录为仓库根目录，示例模型用 examples/mps 下的相对路径
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+
+namespace MIPSolverTest {
+
+inline int& failures() {
+    static int count = 0;
+    return count;
+}
+
+inline void fail(const char* file, int line, const std::string& message) {
+    std::printf("%s:%d: FAILED: %s\n", file, line, message.c_str());
+    failures()++;
+}
+
+// Equal within a tolerance scaled by the magnitude (exactly equal infinities also match)
+inline bool near(double a, double b, double tolerance = 1e-6) {
+    return a == b || std::abs(a - b) <= tolerance * std::max(1.0, std::abs(b));
+}
+
+inline int finish(const char* name) {
+    if (failures() == 0) std::printf("%s: all checks passed\n", name);
+    return failures();
+}
+
+} // namespace MIPSolverTest
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) MIPSolverTest::fail(__FILE__, __LINE__, #condition); \
+    } while (0)
+
+#define CHECK_NEAR(actual, expected) \
+    do { \
+        double actual_value = (actual), expected_value = (expected); \
+        if (!MIPSolverTest::near(actual_value, expected_value)) { \
+            MIPSolverTest::fail(__FILE__, __LINE__, std::string(#actual) + " = " + std::to_string(actual_value) + \
+                                                    ", expected " + std::to_string(expected_value)); \
+        } \
+    } while (0)
+
+// Runs a statement that must throw std::runtime_error (or a subclass)
+#define CHECK_THROWS(statement) \
+    do { \
+        bool thrown = false; \
+        try { \
+            statement; \
+        } catch (const std::runtime_error&) { \
+            thrown = true; \
+        } \
+        if (!thrown) MIPSolverTest::fail(__FILE__, __LINE__, std::string("no exception from ") + #statement); \
+    } while (0)
+
+#endif
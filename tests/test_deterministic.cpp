@@ -0,0 +1,52 @@
+/*
+ * 确定性并行模式：相同输入和线程数的多次求解逐位相同，并与单线程求解的最优值一致
+ */
+
+#include "test_common.h"
+#include "parser.h"
+#include "branch_bound_solver.h"
+
+using namespace MIPSolver;
+
+static Solution solveDeterministic(const Problem& problem, int threads) {
+    BranchBoundSolver solver;
+    solver.setNumThreads(threads);
+    solver.setDeterministic(true);
+    return solver.solve(problem);
+}
+
+int main() {
+    for (const char* name : {"bk4x3", "gr4x6", "bal8x12", "ran10x10b"}) {
+        Problem problem = MPSParser::parseFromFile(std::string("examples/mps/") + name + ".mps");
+
+        BranchBoundSolver sequential;
+        sequential.setALNS(false);
+        Solution reference = sequential.solve(problem);
+        CHECK(reference.getStatus() == Solution::Status::OPTIMAL);
+
+        Solution first = solveDeterministic(problem, 4);
+        CHECK(first.getStatus() == Solution::Status::OPTIMAL);
+        CHECK_NEAR(first.getObjectiveValue(), reference.getObjectiveValue());
+        for (int run = 0; run < 2; ++run) {
+            Solution again = solveDeterministic(problem, 4);
+            CHECK(again.getStatus() == first.getStatus());
+            CHECK(again.getObjectiveValue() == first.getObjectiveValue());
+            CHECK(again.getNodeCount() == first.getNodeCount());
+            CHECK(again.getLPIterations() == first.getLPIterations());
+            CHECK(again.getValues() == first.getValues());
+        }
+
+        // A node limit stops every run at the same node
+        BranchBoundSolver limited;
+        limited.setNumThreads(3);
+        limited.setDeterministic(true);
+        limited.setIterationLimit(5);
+        Solution a = limited.solve(problem);
+        Solution b = limited.solve(problem);
+        CHECK(a.getNodeCount() == b.getNodeCount());
+        CHECK(a.getDualBound() == b.getDualBound());
+        CHECK(a.getObjectiveValue() == b.getObjectiveValue());
+        std::printf("%s: deterministic objective %g, %d nodes\n", name, first.getObjectiveValue(), first.getNodeCount());
+    }
+    return MIPSolverTest::finish("test_deterministic");
+}
@@ -0,0 +1,94 @@
+/*
+ * 分布式树搜索：本机回环上的工作进程线程与协调进程求得与顺序求解相同的最优值；
+ * 口令不符或跳过握手的连接被拒绝
+ */
+
+#include "test_common.h"
+#include "parser.h"
+#include "distributed_solver.h"
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace MIPSolver;
+
+static const char* kToken = "test-token";
+
+static DistributedSolver coordinator(const std::vector<std::unique_ptr<DistributedWorker>>& workers) {
+    DistributedSolver solver;
+    for (const auto& worker : workers) solver.addWorker("127.0.0.1", worker->getPort());
+    solver.setAuthToken(kToken);
+    solver.setSubtreeNodeLimit(20);  // small subtrees, so the search really is split across workers
+    return solver;
+}
+
+static void testHandshake(const DistributedWorker& worker, const Problem& problem) {
+    DistributedSolver wrong;
+    wrong.addWorker("127.0.0.1", worker.getPort());
+    wrong.setAuthToken("not-the-token");
+    CHECK_THROWS(wrong.solve(problem));
+
+    // A LOAD sent before the handshake closes the connection
+    SocketChannel channel = SocketChannel::connect("127.0.0.1", worker.getPort());
+    uint32_t type = 0;
+    std::string payload;
+    CHECK(channel.receive(type, payload, 1024));
+    CHECK(type == DistributedProtocol::HELLO);
+    channel.send(DistributedProtocol::LOAD, ProblemSnapshot::serialize(problem, false));
+    bool open = true;
+    try {
+        open = channel.receive(type, payload, 1024);
+    } catch (const std::runtime_error&) {
+        open = false;
+    }
+    CHECK(!open);
+}
+
+int main() {
+    std::atomic<bool> quit{false};
+    std::vector<std::unique_ptr<DistributedWorker>> workers;
+    for (int w = 0; w < 2; ++w) {
+        workers.push_back(std::make_unique<DistributedWorker>(0));
+        workers.back()->setAuthToken(kToken);
+        workers.back()->setConfigure([](BranchBoundSolver& solver) { solver.setALNS(false); });
+    }
+    std::vector<std::thread> threads;
+    for (const auto& worker : workers) threads.emplace_back([&quit, &worker]() { worker->serve(&quit); });
+
+    for (const char* name : {"bk4x3", "gr4x6", "bal8x12", "ran10x10b"}) {
+        Problem problem = MPSParser::parseFromFile(std::string("examples/mps/") + name + ".mps");
+        BranchBoundSolver sequential;
+        sequential.setALNS(false);
+        Solution reference = sequential.solve(problem);
+
+        DistributedSolver solver = coordinator(workers);
+        solver.addWorker("127.0.0.1", 1);  // unreachable workers are skipped
+        Solution solution = solver.solve(problem);
+        CHECK(solution.getStatus() == Solution::Status::OPTIMAL);
+        CHECK_NEAR(solution.getObjectiveValue(), reference.getObjectiveValue());
+        CHECK(problem.isValidSolution(solution.getValues(), 1e-6));
+        CHECK_NEAR(problem.calculateObjectiveValue(solution.getValues()), solution.getObjectiveValue());
+
+        // A node limit leaves a valid bound on the optimum
+        DistributedSolver limited = coordinator(workers);
+        limited.setIterationLimit(30);
+        Solution partial = limited.solve(problem);
+        const double sign = problem.getObjectiveType() == ObjectiveType::MINIMIZE ? 1.0 : -1.0;
+        CHECK(sign * partial.getDualBound() <= sign * reference.getObjectiveValue() + 1e-6);
+        CHECK(sign * partial.getObjectiveValue() >= sign * reference.getObjectiveValue() - 1e-6);
+        std::printf("%-10s distributed %g (%d nodes), sequential %g\n", name, solution.getObjectiveValue(),
+                    solution.getNodeCount(), reference.getObjectiveValue());
+    }
+
+    testHandshake(*workers[0], MPSParser::parseFromFile("examples/mps/bk4x3.mps"));
+
+    // The workers still serve a coordinator after the rejected connections
+    Problem problem = MPSParser::parseFromFile("examples/mps/gr4x6.mps");
+    DistributedSolver solver = coordinator(workers);
+    CHECK(solver.solve(problem).getStatus() == Solution::Status::OPTIMAL);
+
+    quit = true;
+    for (std::thread& thread : threads) thread.join();
+    return MIPSolverTest::finish("test_distributed");
+}
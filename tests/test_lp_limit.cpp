@@ -0,0 +1,70 @@
+/*
+ * 节点LP未能解出：很小的LP迭代上限下，被放弃的子树不会被当作已经搜索完，
+ * 状态不是OPTIMAL / INFEASIBLE，对偶界和找到的解仍然有效；
+ * 从保存的根基热启动时根LP能解出，只有部分子节点被放弃
+ */
+
+#include "test_common.h"
+#include "parser.h"
+#include "branch_bound_solver.h"
+
+using namespace MIPSolver;
+
+static Solution solve(const Problem& problem, int lp_iteration_limit, int threads) {
+    BranchBoundSolver solver;
+    solver.setALNS(false);
+    solver.setNumThreads(threads);
+    solver.setLPIterationLimit(lp_iteration_limit);
+    return solver.solve(problem);
+}
+
+int main() {
+    int partial_trees = 0;
+    for (const char* name : {"bk4x3", "gr4x6", "bal8x12", "ran10x10b"}) {
+        Problem problem = MPSParser::parseFromFile(std::string("examples/mps/") + name + ".mps");
+        Solution reference = solve(problem, -1, 1);
+        CHECK(reference.getStatus() == Solution::Status::OPTIMAL);
+        const double optimum = reference.getObjectiveValue();
+        const double sign = problem.getObjectiveType() == ObjectiveType::MINIMIZE ? 1.0 : -1.0;
+        const double tolerance = 1e-6 * std::max(1.0, std::abs(optimum));
+
+        // A single pivot cannot solve the root LP, so nothing can be proven
+        Solution starved = solve(problem, 1, 1);
+        CHECK(starved.getStatus() != Solution::Status::OPTIMAL);
+        CHECK(starved.getStatus() != Solution::Status::INFEASIBLE);
+
+        for (int limit : {1, 3, 10, 30, 100}) {
+            for (int threads : {1, 3}) {
+                Solution solution = solve(problem, limit, threads);
+                CHECK(sign * solution.getDualBound() <= sign * optimum + tolerance);
+                if (solution.getStatus() == Solution::Status::OPTIMAL) CHECK_NEAR(solution.getObjectiveValue(), optimum);
+                CHECK(solution.getStatus() != Solution::Status::INFEASIBLE);
+                if (std::isfinite(solution.getObjectiveValue())) {
+                    CHECK(sign * solution.getObjectiveValue() >= sign * optimum - tolerance);
+                    CHECK(problem.isValidSolution(solution.getValues(), 1e-5));
+                }
+            }
+        }
+
+        // Re-solving from the saved root basis solves the root within the limit; child LPs may still fail
+        for (int limit : {3, 5, 8, 12}) {
+            BranchBoundSolver warm;
+            warm.setALNS(false);
+            warm.setWarmStart(true);
+            warm.solve(problem);
+            warm.setLPIterationLimit(limit);
+            Solution solution = warm.solve(problem);
+            CHECK(sign * solution.getDualBound() <= sign * optimum + tolerance);
+            if (solution.getStatus() == Solution::Status::OPTIMAL) {
+                CHECK_NEAR(solution.getObjectiveValue(), optimum);
+                CHECK_NEAR(solution.getDualBound(), optimum);
+            } else if (std::isfinite(solution.getDualBound())) {
+                partial_trees++;  // the root was solved and only some subtrees were abandoned
+            }
+        }
+        std::printf("%-10s optimum %g; with a 1-pivot LP limit: status %d, bound %g\n", name, optimum,
+                    static_cast<int>(starved.getStatus()), starved.getDualBound());
+    }
+    CHECK(partial_trees > 0);
+    return MIPSolverTest::finish("test_lp_limit");
+}
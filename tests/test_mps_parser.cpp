@@ -0,0 +1,199 @@
+/*
+ * MPS解析：OBJSENSE、自由行、RANGES、各种边界类型和格式错误，以及并行与顺序COLUMNS解析结果相同
+ */
+
+#include "test_common.h"
+#include "parser.h"
+#include <limits>
+#include <sstream>
+
+using namespace MIPSolver;
+
+static const double kInf = std::numeric_limits<double>::infinity();
+
+static const char* kBoundsModel =
+    "NAME          BOUNDS\n"
+    "OBJSENSE\n"
+    "    MAX\n"
+    "ROWS\n"
+    " N  COST\n"
+    " N  FREE\n"
+    " L  R1\n"
+    " E  R2\n"
+    " E  R3\n"
+    " G  R4\n"
+    "COLUMNS\n"
+    "    X         COST           1.0   R1             1.0\n"
+    "    X         FREE           9.0   R2             1.0\n"
+    "    MARKER    'MARKER'       'INTORG'\n"
+    "    Y         COST           2.0   R1             1.0\n"
+    "    Y         R2            -1.0   R4             1.0\n"
+    "    MARKER    'MARKER'       'INTEND'\n"
+    "    Z         COST          -1.0   R3             1.0\n"
+    "    W         R4             1.0\n"
+    "    B         R3             2.0\n"
+    "    F         R1             1.0\n"
+    "    G         R2             1.0\n"
+    "    P         R4             1.0\n"
+    "RHS\n"
+    "    RHS       COST          10.0   R1             4.0\n"
+    "    RHS       R2             0.0   R3             1.0\n"
+    "    R4        1.0\n"
+    "RANGES\n"
+    "    RNG       R1             2.0   R2            -1.0\n"
+    "    RNG       R3             3.0   R4            -5.0\n"
+    "BOUNDS\n"
+    " UI BND       X              3.0\n"
+    " MI BND       Z\n"
+    " UP BND       Z              2.0\n"
+    " UP BND       W             -2.0\n"
+    " BV BND       B\n"
+    " FR BND       F\n"
+    " FX BND       G              3.5\n"
+    " PL BND       P\n"
+    " LO BND       P              1.5\n"
+    " LI           Y              1\n"
+    "ENDATA\n";
+
+static void testBoundsAndRanges() {
+    Problem problem = MPSParser::parseFromString(kBoundsModel);
+    CHECK(problem.getObjectiveType() == ObjectiveType::MAXIMIZE);
+    CHECK(problem.getNumVariables() == 8);
+    CHECK(problem.getNumConstraints() == 4);  // the second N row is dropped
+
+    // X Y Z W B F G P, in COLUMNS order; the first N row is the objective
+    const double coefficients[] = {1.0, 2.0, -1.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+    const double lower[] = {0.0, 1.0, -kInf, -kInf, 0.0, -kInf, 3.5, 1.5};
+    const double upper[] = {3.0, kInf, 2.0, -2.0, 1.0, kInf, 3.5, kInf};
+    const bool integral[] = {true, true, false, false, true, false, false, false};
+    for (int j = 0; j < problem.getNumVariables(); ++j) {
+        ConstVariable variable = problem.getVariable(j);
+        CHECK_NEAR(variable.getCoefficient(), coefficients[j]);
+        CHECK(variable.getLowerBound() == lower[j]);
+        CHECK(variable.getUpperBound() == upper[j]);
+        CHECK((variable.getType() != VariableType::CONTINUOUS) == integral[j]);
+    }
+    CHECK(problem.getVariable(0).getName() == "X");
+    CHECK(problem.getVariable(4).getType() == VariableType::BINARY);
+
+    // L: [rhs-|R|, rhs]; E: [rhs+R, rhs] for R<0, [rhs, rhs+R] for R>0; G: [rhs, rhs+|R|]
+    const double row_lower[] = {2.0, -1.0, 1.0, 1.0};
+    const double row_upper[] = {4.0, 0.0, 4.0, 6.0};
+    for (int i = 0; i < problem.getNumConstraints(); ++i) {
+        ConstConstraint constraint = problem.getConstraint(i);
+        CHECK(constraint.hasRange());
+        CHECK_NEAR(constraint.getLowerLimit(), row_lower[i]);
+        CHECK_NEAR(constraint.getUpperLimit(), row_upper[i]);
+    }
+    CHECK(problem.getConstraint(0).getName() == "R1");
+    CHECK(problem.getConstraint(3).getType() == ConstraintType::GREATER_EQUAL);
+
+    // Coefficients on the free row are not part of the matrix
+    const SparseMatrix& matrix = problem.getMatrix();
+    int nonzeros = 0;
+    for (int i = 0; i < problem.getNumConstraints(); ++i) nonzeros += matrix.row(i).size;
+    CHECK(nonzeros == 11);
+}
+
+static void testObjectiveSense() {
+    const char* same_line =
+        "NAME T\nOBJSENSE MAXIMIZE\nROWS\n N obj\n L c\nCOLUMNS\n x obj 1 c 1\nRHS\n rhs c 1\nENDATA\n";
+    CHECK(MPSParser::parseFromString(same_line).getObjectiveType() == ObjectiveType::MAXIMIZE);
+    const char* minimize = "NAME T\nOBJSENSE\n MIN\nROWS\n N obj\n L c\nCOLUMNS\n x obj 1 c 1\nENDATA\n";
+    CHECK(MPSParser::parseFromString(minimize).getObjectiveType() == ObjectiveType::MINIMIZE);
+    const char* unset = "NAME T\nROWS\n N obj\n L c\nCOLUMNS\n x obj 1 c 1\nENDATA\n";
+    CHECK(MPSParser::parseFromString(unset).getObjectiveType() == ObjectiveType::MINIMIZE);
+
+    // OBJNAME picks a later N row; the first one becomes a free row
+    const char* objname =
+        "NAME T\nOBJNAME\n cost\nROWS\n N free\n N cost\n L c\nCOLUMNS\n x free 5 cost 2\n x c 1\nENDATA\n";
+    Problem problem = MPSParser::parseFromString(objname);
+    CHECK(problem.getNumConstraints() == 1);
+    CHECK_NEAR(problem.getVariable(0).getCoefficient(), 2.0);
+}
+
+static void testErrors() {
+    const char* unknown_bound = "NAME T\nROWS\n N obj\nCOLUMNS\n x obj 1\nBOUNDS\n XX BND x 1\nENDATA\n";
+    CHECK_THROWS(MPSParser::parseFromString(unknown_bound));
+    const char* bad_number = "NAME T\nROWS\n N obj\nCOLUMNS\n x obj 1.2.3\nENDATA\n";
+    CHECK_THROWS(MPSParser::parseFromString(bad_number));
+    const char* semicontinuous = "NAME T\nROWS\n N obj\nCOLUMNS\n x obj 1\nBOUNDS\n SC BND x 4\nENDATA\n";
+    CHECK_THROWS(MPSParser::parseFromString(semicontinuous));
+    const char* sos = "NAME T\nROWS\n N obj\nCOLUMNS\n x obj 1\nSOS\n S1 SOS s1 1\nENDATA\n";
+    CHECK_THROWS(MPSParser::parseFromString(sos));
+
+    // Entries for undeclared rows are skipped, not an error
+    const char* unknown_row = "NAME T\nROWS\n N obj\n L c\nCOLUMNS\n x obj 1 nosuch 1\n x c 2\nENDATA\n";
+    Problem problem = MPSParser::parseFromString(unknown_row);
+    CHECK(problem.getMatrix().row(0).size == 1);
+}
+
+// Everything the parser produces, as text, so two problems compare with ==
+static std::string dump(const Problem& problem) {
+    std::ostringstream out;
+    out.precision(17);
+    out << static_cast<int>(problem.getObjectiveType()) << " " << problem.getNumVariables() << " "
+        << problem.getNumConstraints() << "\n";
+    for (int j = 0; j < problem.getNumVariables(); ++j) {
+        ConstVariable variable = problem.getVariable(j);
+        out << variable.getName() << " " << static_cast<int>(variable.getType()) << " " << variable.getLowerBound()
+            << " " << variable.getUpperBound() << " " << variable.getCoefficient() << "\n";
+    }
+    const SparseMatrix& matrix = problem.getMatrix();
+    for (int i = 0; i < problem.getNumConstraints(); ++i) {
+        ConstConstraint constraint = problem.getConstraint(i);
+        out << constraint.getName() << " " << static_cast<int>(constraint.getType()) << " "
+            << constraint.getLowerLimit() << " " << constraint.getUpperLimit() << ":";
+        auto row = matrix.row(i);
+        for (int k = 0; k < row.size; ++k) out << " " << row.indices[k] << "=" << row.values[k];
+        out << "\n";
+    }
+    return out.str();
+}
+
+// A COLUMNS section well above the parallel threshold, with integer markers that span chunk boundaries
+static std::string largeModel() {
+    const int rows = 500;
+    const int columns = 40000;
+    std::string text = "NAME LARGE\nROWS\n N obj\n";
+    for (int i = 0; i < rows; ++i) text += " L r" + std::to_string(i) + "\n";
+    text += "COLUMNS\n";
+    unsigned state = 12345;
+    auto next = [&state]() { return state = state * 1103515245u + 12345u, (state >> 16) & 0x7fff; };
+    for (int j = 0; j < columns; ++j) {
+        if (j % 7000 == 1000) text += "    MARKER    'MARKER'    'INTORG'\n";
+        if (j % 7000 == 4500) text += "    MARKER    'MARKER'    'INTEND'\n";
+        std::string name = "    c" + std::to_string(j);
+        text += name + "  obj  " + std::to_string(static_cast<int>(next() % 100) - 50) + "\n";
+        for (int k = 0; k < 5; ++k) {
+            text += name + "  r" + std::to_string(next() % rows) + "  " + std::to_string(next() % 1000 / 10.0) + "\n";
+        }
+    }
+    text += "RHS\n";
+    for (int i = 0; i < rows; ++i) text += "    rhs  r" + std::to_string(i) + "  " + std::to_string(100 + i) + "\n";
+    text += "BOUNDS\n UP BND c7 4\n BV BND c1500\nENDATA\n";
+    return text;
+}
+
+static void testParallelColumns() {
+    std::string text = largeModel();
+    CHECK(text.size() > (5u << 20));
+    std::string sequential = dump(MPSParser::parseFromString(text, "LARGE", MPSFormat::FREE, 1));
+    for (int threads : {2, 3, 4}) {
+        CHECK(dump(MPSParser::parseFromString(text, "LARGE", MPSFormat::FREE, threads)) == sequential);
+    }
+    // A parse error inside a chunk still surfaces as an exception
+    std::string broken = text;
+    size_t at = broken.find("\n    c30000  r");
+    at = broken.find('\n', at + 1);
+    broken.insert(at, "e");
+    CHECK_THROWS(MPSParser::parseFromString(broken, "LARGE", MPSFormat::FREE, 4));
+}
+
+int main() {
+    testBoundsAndRanges();
+    testObjectiveSense();
+    testErrors();
+    testParallelColumns();
+    return MIPSolverTest::finish("test_mps_parser");
+}
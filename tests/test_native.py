@@ -0,0 +1,96 @@
+#!/usr/bin/env python3
+"""
+C++ 回归测试
+
+tests/ 下的每个 test_*.cpp 是一个独立的测试程序（公共检查宏见 test_common.h）。
+这里用系统的 C++ 编译器（环境变量 CXX，默认 g++ / clang++）逐个编译并在仓库根目录运行，
+返回值非 0 即失败。没有编译器时跳过。
+
+直接运行本文件会编译运行全部程序；也可以只运行一个：
+    python tests/test_native.py test_snapshot
+"""
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+
+try:
+    import pytest
+except ImportError:  # running this file directly does not need pytest
+    pytest = None
+
+TESTS_DIR = os.path.dirname(os.path.abspath(__file__))
+REPO_DIR = os.path.dirname(TESTS_DIR)
+
+# Sources linked into a test besides the test itself
+EXTRA_SOURCES = {
+    "test_c_api": ["api/mipsolver_c_api.cpp"],
+}
+
+
+def find_compiler():
+    for candidate in (os.environ.get("CXX"), "g++", "clang++"):
+        if candidate and shutil.which(candidate):
+            return candidate
+    return None
+
+
+def native_tests():
+    return sorted(name[:-4] for name in os.listdir(TESTS_DIR)
+                  if name.startswith("test_") and name.endswith(".cpp"))
+
+
+def flat_include_dir(work_dir):
+    """api/ 和 bindings/ 的源文件按打包时的平铺布局包含 "../src/<头文件>"，这里用一个临时目录提供该布局"""
+    flat = os.path.join(work_dir, "src")
+    os.makedirs(flat, exist_ok=True)
+    for sub in ("core", "solvers"):
+        directory = os.path.join(REPO_DIR, "src", sub)
+        for name in os.listdir(directory):
+            if name.endswith(".h"):
+                shutil.copyfile(os.path.join(directory, name), os.path.join(flat, name))
+    include = os.path.join(work_dir, "include")
+    os.makedirs(include, exist_ok=True)
+    return include
+
+
+def build_and_run(name, work_dir):
+    compiler = find_compiler()
+    if compiler is None:
+        if pytest is None:
+            raise AssertionError("no C++ compiler found")
+        pytest.skip("no C++ compiler found")
+    executable = os.path.join(work_dir, name)
+    command = [compiler, "-std=c++17", "-O2", "-pthread",
+               "-I" + os.path.join(REPO_DIR, "src", "core"),
+               "-I" + os.path.join(REPO_DIR, "src", "solvers"),
+               "-I" + os.path.join(REPO_DIR, "api"),
+               "-I" + flat_include_dir(work_dir),
+               os.path.join(TESTS_DIR, name + ".cpp")]
+    command += [os.path.join(REPO_DIR, source) for source in EXTRA_SOURCES.get(name, [])]
+    command += ["-o", executable]
+    build = subprocess.run(command, capture_output=True, text=True)
+    assert build.returncode == 0, "compile failed:\n" + build.stderr
+    run = subprocess.run([executable], cwd=REPO_DIR, capture_output=True, text=True, timeout=900)
+    assert run.returncode == 0, run.stdout + run.stderr
+    return run.stdout
+
+
+if pytest is not None:
+    @pytest.mark.parametrize("name", native_tests())
+    def test_native(name, tmp_path):
+        print(build_and_run(name, str(tmp_path)))
+
+
+if __name__ == "__main__":
+    selected = sys.argv[1:] or native_tests()
+    failed = 0
+    for test in selected:
+        with tempfile.TemporaryDirectory() as work:
+            try:
+                print(build_and_run(test, work), end="")
+            except (AssertionError, subprocess.TimeoutExpired) as error:
+                print(f"{test}: {error}")
+                failed += 1
+    sys.exit(1 if failed else 0)
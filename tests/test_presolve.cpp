@@ -0,0 +1,48 @@
+/*
+ * 预处理：examples/mps 的模型开、关预处理的结果一致
+ *
+ * 两次求解都证明最优时目标值相同；受节点上限停止时，找到的解对原问题可行，
+ * 且任何一方的解都不优于另一方的对偶界
+ */
+
+#include "test_common.h"
+#include "parser.h"
+#include "branch_bound_solver.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace MIPSolver;
+
+static Solution solve(const Problem& problem, bool presolve) {
+    BranchBoundSolver solver;
+    solver.setPresolve(presolve);
+    solver.setALNS(false);
+    solver.setIterationLimit(2000);
+    return solver.solve(problem);
+}
+
+int main() {
+    for (const char* name : {"bk4x3", "gr4x6", "bal8x12", "ran4x64", "ran6x43", "ran10x10a", "ran10x10b",
+                             "ran10x10c", "ran10x12", "ran8x32"}) {
+        Problem problem = MPSParser::parseFromFile(std::string("examples/mps/") + name + ".mps");
+        Solution on = solve(problem, true);
+        Solution off = solve(problem, false);
+        const double sign = problem.getObjectiveType() == ObjectiveType::MINIMIZE ? 1.0 : -1.0;
+
+        // Postsolve must map the solution back to a point of the original problem
+        for (const Solution* solution : {&on, &off}) {
+            if (!std::isfinite(solution->getObjectiveValue())) continue;  // no incumbent within the node limit
+            CHECK(solution->getValues().size() == static_cast<size_t>(problem.getNumVariables()));
+            CHECK_NEAR(problem.calculateObjectiveValue(solution->getValues()), solution->getObjectiveValue());
+            CHECK(problem.isValidSolution(solution->getValues(), 1e-5));
+        }
+        if (on.getStatus() == Solution::Status::OPTIMAL && off.getStatus() == Solution::Status::OPTIMAL) {
+            CHECK_NEAR(on.getObjectiveValue(), off.getObjectiveValue());
+        }
+        CHECK(sign * on.getObjectiveValue() >= sign * off.getDualBound() - 1e-6 * std::max(1.0, std::abs(off.getDualBound())));
+        CHECK(sign * off.getObjectiveValue() >= sign * on.getDualBound() - 1e-6 * std::max(1.0, std::abs(on.getDualBound())));
+        std::printf("%-10s presolve on %g (bound %g)  off %g (bound %g)\n", name, on.getObjectiveValue(),
+                    on.getDualBound(), off.getObjectiveValue(), off.getDualBound());
+    }
+    return MIPSolverTest::finish("test_presolve");
+}
@@ -0,0 +1,162 @@
+/*
+ * 快照：文件和内存缓冲区的往返保持问题不变（含与不含名字表），损坏的快照被拒绝
+ */
+
+#include "test_common.h"
+#include "parser.h"
+#include "problem_snapshot.h"
+#include "branch_bound_solver.h"
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <unistd.h>
+
+using namespace MIPSolver;
+
+static const char* kRangedModel =
+    "NAME RANGED\nOBJSENSE MAX\nROWS\n N obj\n L r1\n E r2\n G r3\n E r4\nCOLUMNS\n"
+    " x obj 1 r1 1\n x r2 1\n MARKER 'MARKER' 'INTORG'\n y obj 2 r1 1\n y r2 -1\n MARKER 'MARKER' 'INTEND'\n"
+    " z obj -1 r3 1\n z r4 3.5\n b r4 1\nRHS\n rhs r1 4 r2 0\n rhs r3 1 r4 2\n"
+    "RANGES\n rng r1 2 r2 -1\n rng r3 5\nBOUNDS\n UI bnd y 3\n MI bnd z\n UP bnd z 2\n BV bnd b\nENDATA\n";
+
+// Problem contents as text; names are left out when the copy has none
+static std::string dump(const Problem& problem, bool names) {
+    std::ostringstream out;
+    out.precision(17);
+    out << static_cast<int>(problem.getObjectiveType()) << " " << problem.getNumVariables() << " "
+        << problem.getNumConstraints() << "\n";
+    for (int j = 0; j < problem.getNumVariables(); ++j) {
+        ConstVariable variable = problem.getVariable(j);
+        if (names) out << variable.getName() << " ";
+        out << static_cast<int>(variable.getType()) << " " << variable.getLowerBound() << " "
+            << variable.getUpperBound() << " " << variable.getCoefficient() << "\n";
+    }
+    const SparseMatrix& matrix = problem.getMatrix();
+    for (int i = 0; i < problem.getNumConstraints(); ++i) {
+        ConstConstraint constraint = problem.getConstraint(i);
+        if (names) out << constraint.getName() << " ";
+        out << static_cast<int>(constraint.getType()) << " " << constraint.getRHS() << " " << constraint.hasRange()
+            << " " << (constraint.hasRange() ? constraint.getRange() : 0.0) << ":";
+        auto row = matrix.row(i);
+        for (int k = 0; k < row.size; ++k) out << " " << row.indices[k] << "=" << row.values[k];
+        out << "\n";
+    }
+    return out.str();
+}
+
+static std::string readFile(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+static void testRoundTrip(const Problem& problem, const std::string& path) {
+    for (bool names : {true, false}) {
+        ProblemSnapshot::save(problem, path, names);
+        Problem loaded = ProblemSnapshot::load(path);
+        CHECK(dump(loaded, names) == dump(problem, names));
+        CHECK(loaded.getName() == problem.getName());
+        if (!names && problem.getNumVariables() > 0) CHECK(loaded.getVariable(0).getName() == "x0");
+
+        // The file and the in-memory buffer share one layout
+        std::string buffer = ProblemSnapshot::serialize(problem, names);
+        CHECK(readFile(path) == buffer);
+        CHECK(dump(ProblemSnapshot::deserialize(buffer), names) == dump(problem, names));
+    }
+}
+
+template <typename T>
+static void patch(std::string& buffer, size_t offset, T value) {
+    std::memcpy(&buffer[offset], &value, sizeof(value));
+}
+
+static void testCorruptInput(const Problem& problem) {
+    const std::string good = ProblemSnapshot::serialize(problem, true);
+    const size_t n = static_cast<size_t>(problem.getNumVariables());
+    const size_t m = static_cast<size_t>(problem.getNumConstraints());
+    size_t nonzeros;
+    std::memcpy(&nonzeros, good.data() + 32, sizeof(nonzeros));
+
+    CHECK_THROWS(ProblemSnapshot::deserialize(std::string_view()));
+    CHECK_THROWS(ProblemSnapshot::deserialize(std::string_view(good.data(), 63)));
+    CHECK_THROWS(ProblemSnapshot::deserialize(std::string_view(good.data(), good.size() - 8)));
+    CHECK_THROWS(ProblemSnapshot::deserialize(good + std::string(8, '\0')));
+
+    // Header fields: magic, version, byte order mark, dimensions, name bytes
+    std::string bad = good;
+    bad[0] = 'X';
+    CHECK_THROWS(ProblemSnapshot::deserialize(bad));
+    bad = good;
+    patch<uint32_t>(bad, 8, 99);
+    CHECK_THROWS(ProblemSnapshot::deserialize(bad));
+    bad = good;
+    patch<uint32_t>(bad, 12, 0x04030201);
+    CHECK_THROWS(ProblemSnapshot::deserialize(bad));
+    bad = good;
+    patch<int32_t>(bad, 20, -1);
+    CHECK_THROWS(ProblemSnapshot::deserialize(bad));
+    bad = good;
+    patch<int32_t>(bad, 24, static_cast<int32_t>(m + 1));
+    CHECK_THROWS(ProblemSnapshot::deserialize(bad));
+    bad = good;
+    patch<uint64_t>(bad, 32, uint64_t(1) << 40);
+    CHECK_THROWS(ProblemSnapshot::deserialize(bad));
+    bad = good;
+    patch<uint64_t>(bad, 40, uint64_t(1) << 62);
+    CHECK_THROWS(ProblemSnapshot::deserialize(bad));
+
+    // Body sections: row starts, column indices, type bytes
+    const size_t row_start_at = 64 + 8 * (nonzeros + 3 * n + 2 * m);
+    const size_t col_index_at = row_start_at + ((4 * (m + 1) + 7) & ~size_t(7));
+    const size_t var_type_at = col_index_at + ((4 * nonzeros + 7) & ~size_t(7));
+    const size_t row_type_at = var_type_at + ((n + 7) & ~size_t(7));
+    bad = good;
+    patch<int32_t>(bad, row_start_at, 1);
+    CHECK_THROWS(ProblemSnapshot::deserialize(bad));
+    bad = good;
+    patch<int32_t>(bad, row_start_at + 4, static_cast<int32_t>(nonzeros + 1));
+    CHECK_THROWS(ProblemSnapshot::deserialize(bad));
+    bad = good;
+    patch<int32_t>(bad, col_index_at, static_cast<int32_t>(n));
+    CHECK_THROWS(ProblemSnapshot::deserialize(bad));
+    bad = good;
+    patch<int32_t>(bad, col_index_at, -1);
+    CHECK_THROWS(ProblemSnapshot::deserialize(bad));
+    bad = good;
+    patch<uint8_t>(bad, var_type_at, 7);
+    CHECK_THROWS(ProblemSnapshot::deserialize(bad));
+    bad = good;
+    patch<uint8_t>(bad, row_type_at, 5);
+    CHECK_THROWS(ProblemSnapshot::deserialize(bad));
+
+    CHECK(dump(ProblemSnapshot::deserialize(good), true) == dump(problem, true));
+    CHECK_THROWS(ProblemSnapshot::load("examples/mps/bk4x3.mps"));
+    CHECK_THROWS(ProblemSnapshot::load("no/such/snapshot.bin"));
+}
+
+int main() {
+    const std::string path = "/tmp/mipsolver_test_snapshot_" + std::to_string(getpid()) + ".bin";
+
+    Problem ranged = MPSParser::parseFromString(kRangedModel, "RANGED");
+    CHECK(ranged.getConstraint(0).hasRange());
+    testRoundTrip(ranged, path);
+    testCorruptInput(ranged);
+
+    for (const char* name : {"bk4x3", "gr4x6", "ran10x26"}) {
+        Problem problem = MPSParser::parseFromFile(std::string("examples/mps/") + name + ".mps");
+        testRoundTrip(problem, path);
+    }
+
+    // A loaded snapshot solves to the same optimum as the parsed model
+    Problem parsed = MPSParser::parseFromFile("examples/mps/gr4x6.mps");
+    ProblemSnapshot::save(parsed, path);
+    BranchBoundSolver solver;
+    Solution from_mps = solver.solve(parsed);
+    Solution from_snapshot = solver.solve(ProblemSnapshot::load(path));
+    CHECK(from_snapshot.getStatus() == Solution::Status::OPTIMAL);
+    CHECK_NEAR(from_snapshot.getObjectiveValue(), from_mps.getObjectiveValue());
+
+    std::remove(path.c_str());
+    return MIPSolverTest::finish("test_snapshot");
+}